@@ -1,240 +1,280 @@
-/*
- * Description: BoeBot controller - autonomous navigation, obstacle avoidance,
- *              detects specific obstacles as "survivors" via recognition,
- *              emits a signal on survivor detection, stops on tilt.
- *              Implements slightly smarter turning.
- */
-
- #include <webots/robot.h>
- #include <webots/motor.h>
- #include <webots/distance_sensor.h>
- #include <webots/accelerometer.h>
- #include <webots/emitter.h> // <-- Added Emitter
- #include <webots/supervisor.h> // <-- Added Supervisor (to get node info)
- #include <webots/led.h>
- // #include <webots/touch_sensor.h> // Optional whiskers
- 
- #include <math.h>
- #include <stdio.h>
- #include <stdlib.h>
- #include <string.h>
- 
- // --- Time Step ---
- #define TIME_STEP 64
- 
- // --- Movement Speeds ---
- #define FORWARD_SPEED 5.0
- #define TURN_SPEED 4.0
- #define BACKUP_SPEED 3.0 // Optional
- 
- // --- Behavior Durations ---
- #define AID_DEPLOY_DURATION 50 // Pause duration after finding survivor
- // #define BACKUP_DURATION 8 // Optional
- 
- // --- TUNABLE SENSOR THRESHOLDS ---
- #define OBSTACLE_DISTANCE_THRESHOLD 0.3 // Avoid if DistanceSensor value is LESS than this (meters)
- #define TILT_THRESHOLD 3.5
- #define SURVIVOR_DETECTION_RANGE 0.4 // Must recognize survivor AND be closer than this (meters)
- 
- // --- Names & Communication ---
- #define SURVIVOR_OBJECT_NAME "SurvivorObstacle" // *** The 'name' field of survivor objects in Webots ***
- #define EMITTER_NAME "status_emitter"        // *** 'name' of the Emitter device on the BoeBot ***
- #define EMITTER_CHANNEL 1                    // Channel for communication (must match Supervisor Receiver)
- #define SURVIVOR_MESSAGE "SURVIVOR_FOUND"    // Message sent when survivor found
- 
- // --- Robot States ---
- typedef enum {
-   SEARCHING,
-   AVOIDING_OBSTACLE,
-   DEPLOYING_AID,
-   ROBOT_TILTED
-   // BACKING_UP // Optional
- } RobotState;
- 
- // --- Global state variables ---
- static int aid_deploy_counter = 0;
- // static int backup_counter = 0; // Optional
- 
- // Function to check if a node is a survivor based on its name
- bool is_survivor(WbNodeRef node) {
-   if (!node) return false;
-   const char *node_name = wb_supervisor_node_get_name(node); // Use supervisor function to get name field value
-   if (node_name && strcmp(node_name, SURVIVOR_OBJECT_NAME) == 0) {
-     return true;
-   }
-   // Optional: Also check model name if needed
-   // const char *model_name = wb_supervisor_node_get_model_name(node);
-   // if (model_name && strcmp(model_name, "SurvivorProtoName") == 0) return true;
-   return false;
- }
- 
- 
- int main() {
-   wb_robot_init();
- 
-   // --- Get Device Handles ---
-   WbDeviceTag left_motor = wb_robot_get_device("left wheel motor");
-   WbDeviceTag right_motor = wb_robot_get_device("right wheel motor");
-   // Use multiple sensors for better avoidance
-   WbDeviceTag ds_front = wb_robot_get_device("ds_front");
-   WbDeviceTag ds_left = wb_robot_get_device("ds_left");   // NEEDED for smarter turning
-   WbDeviceTag ds_right = wb_robot_get_device("ds_right"); // NEEDED for smarter turning
-   WbDeviceTag accelerometer = wb_robot_get_device("accelerometer");
-   WbDeviceTag emitter = wb_robot_get_device(EMITTER_NAME); // Get the emitter
-   WbDeviceTag left_led = wb_robot_get_device("left_led");
-   WbDeviceTag right_led = wb_robot_get_device("right_led");
-   // WbDeviceTag left_whisker = wb_robot_get_device("left_whisker"); // Optional
-   // WbDeviceTag right_whisker = wb_robot_get_device("right_whisker"); // Optional
- 
-   // --- Enable Devices & Setup ---
-   if (!left_motor || !right_motor) { /* ... Error handling ... */ return 1; }
-   wb_motor_set_position(left_motor, INFINITY);
-   wb_motor_set_position(right_motor, INFINITY);
-   wb_motor_set_velocity(left_motor, 0.0);
-   wb_motor_set_velocity(right_motor, 0.0);
- 
-   WbDeviceTag distance_sensors[] = {ds_front, ds_left, ds_right};
-   for (int i = 0; i < 3; ++i) {
-       if (distance_sensors[i]) {
-           wb_distance_sensor_enable(distance_sensors[i], TIME_STEP);
-           // Enable recognition on distance sensors
-           wb_distance_sensor_recognition_enable(distance_sensors[i], TIME_STEP);
-       } else {
-           printf("Warning: Distance sensor %d not found!\n", i);
-       }
-   }
- 
-   if (accelerometer) wb_accelerometer_enable(accelerometer, TIME_STEP); else printf("Warning: Accelerometer not found.\n");
-   if (!emitter) printf("ERROR: Emitter '%s' not found! Cannot send survivor signal.\n", EMITTER_NAME);
-   else wb_emitter_set_channel(emitter, EMITTER_CHANNEL); // Set communication channel
- 
- 
-   printf("BoeBot Survivor Emitter Controller Initialized.\n");
-   RobotState current_state = SEARCHING;
- 
-   // --- Main Control Loop ---
-   while (wb_robot_step(TIME_STEP) != -1) {
-     double left_speed = 0.0;
-     double right_speed = 0.0;
- 
-     // --- 1. Read Sensor Values & Check for Survivors ---
-     double ds_values[3] = {999.0, 999.0, 999.0}; // Front, Left, Right
-     bool survivor_detected_this_step = false;
- 
-     for (int i = 0; i < 3; ++i) {
-         if (distance_sensors[i]) {
-             ds_values[i] = wb_distance_sensor_get_value(distance_sensors[i]);
-             // Check recognized objects from this sensor
-             int num_obj = wb_distance_sensor_recognition_get_number_of_objects(distance_sensors[i]);
-             const WbRecognizedObject *objects = wb_distance_sensor_recognition_get_objects(distance_sensors[i]);
-             for (int j = 0; j < num_obj; ++j) {
-                 WbNodeRef recognized_node = objects[j].node;
-                 // Use supervisor function to get name (requires supervisor=TRUE in Robot node)
-                 // OR check model name if supervisor access isn't desired/possible from robot controller
-                 if (is_survivor(recognized_node)) {
-                      // Check if it's close enough based on the sensor reading
-                     if (ds_values[i] < SURVIVOR_DETECTION_RANGE) {
-                          survivor_detected_this_step = true;
-                          printf("--- SURVIVOR DETECTED by sensor %d ---\n", i);
-                          break; // Found one, no need to check others
-                     }
-                 }
-             }
-         }
-         if (survivor_detected_this_step) break;
-     }
- 
-     bool tilted = false;
-     if (accelerometer) {
-       const double *a = wb_accelerometer_get_values(accelerometer);
-       if (fabs(a[0]) > TILT_THRESHOLD || fabs(a[1]) > TILT_THRESHOLD) tilted = true;
-     }
- 
-     // --- 2. Determine Robot State ---
-     RobotState next_state = current_state;
-     bool actively_deploying_aid = false;
- 
-     if (aid_deploy_counter > 0) { // Timer logic
-       aid_deploy_counter--;
-       if (aid_deploy_counter == 0) printf(" Aid Deployment Finished.\n");
-       else { next_state = DEPLOYING_AID; actively_deploying_aid = true; }
-     }
- 
-     if (!actively_deploying_aid) { // Event triggers (only if not deploying aid)
-       if (tilted) { // Priority 1: Tilt
-         if (current_state != ROBOT_TILTED) printf("STATE CHANGE: Robot Tilted! Halting.\n");
-         next_state = ROBOT_TILTED;
-       }
-       else if (survivor_detected_this_step) { // Priority 2: Survivor found
-         if (current_state != DEPLOYING_AID) {
-           printf("STATE CHANGE: Survivor Detected! Deploying Aid & Emitting Signal.\n");
-           aid_deploy_counter = AID_DEPLOY_DURATION; // Start timer
-           next_state = DEPLOYING_AID;
-           // Send signal via emitter
-           if (emitter) {
-             wb_emitter_send(emitter, SURVIVOR_MESSAGE, strlen(SURVIVOR_MESSAGE) + 1);
-             printf(" Emitter: Sent '%s'\n", SURVIVOR_MESSAGE);
-           } else { printf(" Emitter: Error - cannot send signal.\n"); }
-         }
-       }
-       // Priority 3: Obstacle detection (using front sensor primarily)
-       else if (ds_values[0] < OBSTACLE_DISTANCE_THRESHOLD) {
-         if (current_state != AVOIDING_OBSTACLE) printf("STATE CHANGE: Obstacle Detected (Front DS). Avoiding.\n");
-         next_state = AVOIDING_OBSTACLE;
-       }
-       // Priority 4: Default - Clear path
-       else {
-         if (current_state != SEARCHING) printf("STATE CHANGE: Clear. Resuming Search.\n");
-         next_state = SEARCHING;
-       }
-     }
-     current_state = next_state;
- 
-     // --- 3. Execute Actions Based on State ---
-     if(left_led) wb_led_set(left_led, 0); // Reset LEDs
-     if(right_led) wb_led_set(right_led, 0);
- 
-     switch (current_state) {
-       case ROBOT_TILTED:
-         left_speed = 0.0; right_speed = 0.0;
-         if(left_led) wb_led_set(left_led, 1); if(right_led) wb_led_set(right_led, 1); // Solid error LEDs
-         break;
-       case DEPLOYING_AID:
-         left_speed = 0.0; right_speed = 0.0;
-         if (aid_deploy_counter % 4 < 2) { // Blink both LEDs
-              if(left_led) wb_led_set(left_led, 1); if(right_led) wb_led_set(right_led, 1);
-         }
-         break;
-       case AVOIDING_OBSTACLE:
-         // Smarter Turn: Turn away from the side with less space
-         if (ds_values[1] < ds_values[2]) { // Left sensor closer or equal -> Turn Right
-              left_speed = TURN_SPEED;
-              right_speed = -TURN_SPEED;
-              printf(" Avoiding: Turning Right (Left closer: %.2f < Right: %.2f)\n", ds_values[1], ds_values[2]);
-         } else { // Right sensor closer -> Turn Left
-              left_speed = -TURN_SPEED;
-              right_speed = TURN_SPEED;
-               printf(" Avoiding: Turning Left (Right closer: %.2f < Left: %.2f)\n", ds_values[2], ds_values[1]);
-         }
-         break;
-       case SEARCHING:
-       default:
-         left_speed = FORWARD_SPEED; right_speed = FORWARD_SPEED;
-         break;
-     }
- 
-     // --- 4. Set Motor Velocities ---
-     wb_motor_set_velocity(left_motor, left_speed);
-     wb_motor_set_velocity(right_motor, right_speed);
- 
-     // --- 5. Periodic Debug Output ---
-     static int debug_print_counter = 0;
-     if (debug_print_counter++ % 8 == 0) {
-          printf("S:%d Aid:%d | F:%.2f L:%.2f R:%.2f | Tilt:%d Surv:%d | Spd L:%.1f R:%.1f\n",
-                current_state, aid_deploy_counter, ds_values[0], ds_values[1], ds_values[2],
-                tilted, survivor_detected_this_step, left_speed, right_speed);
-     }
-   }
-   wb_robot_cleanup();
-   return 0;
+/*
+ * Description: BoeBot controller - autonomous navigation, obstacle avoidance,
+ *              detects specific obstacles as "survivors" via recognition,
+ *              emits a signal on survivor detection, stops on tilt.
+ *              Implements slightly smarter turning.
+ *
+ *              Webots entry point only: the control logic lives in
+ *              rescue_controller.c and reaches the devices through the
+ *              Webots backend in rescue_hal_webots.c. The robot's
+ *              controllerArgs select what runs:
+ *
+ *                --record=<file>   log every step for replay (rescue_trace.h)
+ *                --arena=<xmin>,<ymin>,<xmax>,<ymax>
+ *                                  center the map on the arena (rescue_map.h)
+ *                --profile         per-phase latency histograms, at shutdown
+ *                                  and on SIGUSR1 (rescue_profile.h)
+ *                --anytime         planner answers at once (rescue_plan.h)
+ *                --spin            turn on the spot (rescue_vfh.h)
+ *                --fixed           no dynamic window (rescue_dwa.h)
+ *                --ungoverned      FORWARD_SPEED (rescue_speed.h)
+ *                --no-escape       no stuck detector (rescue_stuck.h)
+ *                --no-debounce     single readings (rescue_trigger.h)
+ *                --no-mission      search only (rescue_mission.h)
+ *                --single-rate     every task every TIME_STEP
+ *                                  (rescue_schedule.h)
+ *                --full-recognition  no decimation (rescue_recognition.h)
+ *                --raw-tilt        single accelerometer samples
+ *                                  (rescue_tilt.h)
+ *
+ *              headless/README.md describes each of these and how they were
+ *              measured.
+ */
+
+ #include <webots/robot.h>
+
+ #include <math.h>
+ #include <signal.h>
+ #include <stdio.h>
+ #include <string.h>
+
+ #include "rescue_controller.h"
+ #include "rescue_hal_webots.h"
+ #include "rescue_log.h"
+ 
+ #define RECORD_ARG "--record="
+ #define ARENA_ARG "--arena="
+ #define PROFILE_ARG "--profile"
+ #define ANYTIME_ARG "--anytime"
+ #define SPIN_ARG "--spin"
+ #define FIXED_ARG "--fixed"
+ #define UNGOVERNED_ARG "--ungoverned"
+ #define NO_ESCAPE_ARG "--no-escape"
+ #define NO_DEBOUNCE_ARG "--no-debounce"
+ #define NO_MISSION_ARG "--no-mission"
+ #define SINGLE_RATE_ARG "--single-rate"
+ #define FULL_RECOGNITION_ARG "--full-recognition"
+ #define RAW_TILT_ARG "--raw-tilt"
+ 
+ static RescueProfile profile;
+ static RescueMap map;
+ static RescueExplorer explore;
+ static RescuePlanner planner;
+ static RescueVfh vfh;
+ static RescueDwa dwa;
+ static RescueSpeed governor;
+ static RescueStuck stuck;
+ static RescueTriggers triggers;
+ static RescueMission mission;
+ static RescueSchedule schedule;
+ static RescueRecognitionRate recognition;
+ static RescueTilt tilt;
+ 
+ #ifdef SIGUSR1
+ static void request_profile_dump(int sig) {
+   (void)sig;
+   profile.dump_requested = 1;
+ }
+ #endif
+ 
+ int main(int argc, char **argv) {
+   wb_robot_init();
+ 
+   // --- Multi-Rate Tasks ---
+   rescue_tasks_init(&schedule);
+   bool multi_rate = true;
+   for (int i = 1; i < argc; ++i)
+     if (strcmp(argv[i], SINGLE_RATE_ARG) == 0) multi_rate = false;
+   int basic_step = (int)wb_robot_get_basic_time_step();
+   if (multi_rate && (basic_step <= 0 || schedule.tick_ms % basic_step != 0)) {
+     printf("Warning: basicTimeStep %d ms does not divide the %d ms tick, running every task each %d ms.\n", basic_step,
+            schedule.tick_ms, TIME_STEP);
+     multi_rate = false;
+   }
+
+   // --- Get Device Handles, Enable Devices & Setup ---
+   RescueWebots devices;
+   RescueHal hal;
+   if (!rescue_hal_webots_init(&devices, &hal, TIME_STEP, multi_rate ? &schedule : NULL)) { wb_robot_cleanup(); return 1; }
+ 
+   printf("BoeBot Survivor Emitter Controller Initialized.\n");
+   RescueController controller;
+   rescue_controller_init(&controller);
+   if (rescue_map_init(&map, RESCUE_MAP_MAX_TILES)) controller.map = &map;
+   else printf("Warning: Cannot allocate the occupancy grid, not mapping.\n");
+   double arena[4], map_center[2];
+   bool centered = false;
+   for (int i = 1; i < argc && controller.map; ++i) {
+     if (strncmp(argv[i], ARENA_ARG, strlen(ARENA_ARG)) != 0) continue;
+     if (!devices.self) { // The map is then in the odometry frame, which starts wherever the robot does
+       printf("Warning: No supervisor pose, centering the map on the start pose.\n");
+       break;
+     }
+     if (sscanf(argv[i] + strlen(ARENA_ARG), "%lf,%lf,%lf,%lf", &arena[0], &arena[1], &arena[2], &arena[3]) != 4) {
+       printf("Warning: Cannot read '%s', centering the map on the start pose.\n", argv[i]);
+       break;
+     }
+     map_center[0] = 0.5 * (arena[0] + arena[2]);
+     map_center[1] = 0.5 * (arena[1] + arena[3]);
+     rescue_map_center(&map, map_center[0], map_center[1]);
+     centered = true;
+     printf("Map centered on the arena at (%.2f, %.2f).\n", map_center[0], map_center[1]);
+     break;
+   }
+   if (controller.map && rescue_explore_init(&explore, &map)) controller.explore = &explore;
+   else printf("Warning: Frontier exploration unavailable, searching straight ahead.\n");
+   if (controller.explore && rescue_plan_init(&planner, RESCUE_EXPLORE_CELLS, RESCUE_EXPLORE_CELLS, RESCUE_PLAN_MAX_NODES,
+                                              PLAN_SLICE_MS))
+     explore.planner = &planner;
+   for (int i = 1; i < argc && explore.planner; ++i) {
+     if (strcmp(argv[i], ANYTIME_ARG) != 0) continue;
+     rescue_plan_set_anytime(&planner, PLAN_EPSILON);
+     printf("Anytime path planning, first paths within %.1fx of the shortest.\n", PLAN_EPSILON);
+     break;
+   }
+   rescue_vfh_init(&vfh);
+   controller.vfh = &vfh;
+   controller.dwa = &dwa;
+   rescue_speed_init(&governor, RESCUE_SPEED_TOP);
+   controller.speed = &governor;
+   rescue_stuck_init(&stuck);
+   controller.stuck = &stuck;
+   rescue_triggers_init(&triggers);
+   controller.triggers = &triggers;
+   rescue_mission_init(&mission, MISSION_RETURN_AFTER, MISSION_SLICE_MS, true);
+   controller.mission = &mission;
+   controller.schedule = multi_rate ? &schedule : NULL;
+   rescue_recognition_rate_init(&recognition, controller.schedule ? RECOGNIZE_PERIOD : TIME_STEP,
+                                RECOGNIZE_RELAXED_PERIOD, SURVIVOR_DETECTION_RANGE, RESCUE_RECOG_HOLD_STEPS);
+   controller.recognition = &recognition;
+   rescue_tilt_init(&tilt, TILT_THRESHOLD);
+   controller.tilt = &tilt;
+   for (int i = 1; i < argc; ++i) {
+     if (strcmp(argv[i], SPIN_ARG) == 0) { controller.vfh = NULL; controller.dwa = NULL; }
+     if (strcmp(argv[i], FIXED_ARG) == 0) controller.dwa = NULL;
+     if (strcmp(argv[i], UNGOVERNED_ARG) == 0) controller.speed = NULL;
+     if (strcmp(argv[i], NO_ESCAPE_ARG) == 0) controller.stuck = NULL;
+     if (strcmp(argv[i], NO_DEBOUNCE_ARG) == 0) controller.triggers = NULL;
+     if (strcmp(argv[i], NO_MISSION_ARG) == 0) controller.mission = NULL;
+     if (strcmp(argv[i], FULL_RECOGNITION_ARG) == 0) controller.recognition = NULL;
+     if (strcmp(argv[i], RAW_TILT_ARG) == 0) controller.tilt = NULL;
+   }
+   rescue_dwa_init(&dwa, controller.speed ? RESCUE_SPEED_TOP : FORWARD_SPEED);
+   if (controller.vfh) printf("Steering around obstacles with a polar histogram (%s kernel).\n", rescue_vfh_simd_name());
+   if (controller.dwa)
+     printf("Wheel speeds from a dynamic window of %d arcs (%s kernel).\n", RESCUE_DWA_SAMPLES, rescue_dwa_simd_name());
+   if (controller.speed) printf("Top speed %.2f rad/s, governed by time to collision.\n", governor.top_speed);
+   if (controller.schedule)
+     printf("Ticking every %d ms: reflex %d ms, control %d ms, recognition %d ms, exploration %d ms.\n", schedule.tick_ms,
+            REFLEX_PERIOD, TIME_STEP, RECOGNIZE_PERIOD, PLAN_PERIOD);
+   int tick = controller.schedule ? schedule.tick_ms : TIME_STEP;
+ 
+   // --- Optional Flight Recorder & Latency Profile ---
+   RescueTraceWriter trace;
+   for (int i = 1; i < argc; ++i) {
+     if (strcmp(argv[i], PROFILE_ARG) == 0 && !controller.profile) {
+       rescue_profile_init(&profile, tick);
+       controller.profile = &profile;
+ #ifdef SIGUSR1
+       signal(SIGUSR1, request_profile_dump);
+ #endif
+       printf("Profiling control step latency.\n");
+     }
+     if (strncmp(argv[i], RECORD_ARG, strlen(RECORD_ARG)) != 0 || controller.trace) continue;
+     const char *path = argv[i] + strlen(RECORD_ARG);
+     uint32_t config = (controller.explore ? RESCUE_TRACE_CONFIG_EXPLORE : 0) | (explore.planner ? RESCUE_TRACE_CONFIG_PLAN : 0) |
+                       (explore.planner && planner.anytime ? RESCUE_TRACE_CONFIG_ANYTIME : 0) |
+                       (controller.vfh ? RESCUE_TRACE_CONFIG_VFH : 0) | (controller.dwa ? RESCUE_TRACE_CONFIG_DWA : 0) |
+                       (controller.speed ? RESCUE_TRACE_CONFIG_SPEED : 0) |
+                       (controller.stuck ? RESCUE_TRACE_CONFIG_STUCK : 0) |
+                       (controller.triggers ? RESCUE_TRACE_CONFIG_TRIGGERS : 0) |
+                       (controller.mission ? RESCUE_TRACE_CONFIG_MISSION : 0) |
+                       (controller.schedule ? RESCUE_TRACE_CONFIG_SCHEDULE : 0) |
+                       (controller.recognition ? RESCUE_TRACE_CONFIG_RECOGNITION : 0) |
+                       (controller.tilt ? RESCUE_TRACE_CONFIG_TILT : 0);
+     if ((controller.vfh || controller.dwa || controller.speed) && devices.num_ranges)
+       printf("Warning: The %d range sensors are not recorded, a replay avoids with the ds only.\n", devices.num_ranges);
+     if (rescue_trace_open(&trace, path, tick, config, centered ? map_center : NULL)) {
+       controller.trace = &trace;
+       if (explore.planner) rescue_plan_set_slice(&planner, PLAN_SLICE_MS, false); // No clock: replays the same
+       rescue_bt_set_slice(&mission.tree, MISSION_SLICE_MS, false);
+       printf("Recording sensor trace to '%s'.\n", path);
+     } else {
+       printf("Warning: Cannot open trace file '%s', not recording.\n", path);
+     }
+   }
+ 
+   // --- Main Control Loop ---
+   rescue_log_start(stdout);
+   rescue_run(&hal, &controller);
+   rescue_log_stop();
+   if (rescue_log_dropped()) printf("Log: %lu messages dropped (console too slow).\n", rescue_log_dropped());
+ 
+   if (controller.trace) {
+     rescue_trace_close(controller.trace);
+     printf("Trace: %ld steps recorded%s.\n", trace.records, trace.failed ? " (write error, trace is incomplete)" : "");
+   }
+   if (controller.profile) {
+     rescue_profile_dump(controller.profile, stdout);
+     rescue_state_stats_dump(&controller.states, TIME_STEP, stdout);
+   }
+   if (controller.explore) {
+     printf("Exploration: %lu cells searched, %d frontier cells left, %lu goals reached, %lu abandoned, %lu selections.\n",
+            explore.cells_searched, explore.frontier_cells, explore.goals_reached, explore.goals_abandoned, explore.plans);
+     if (explore.planner) {
+       printf("Planner: %lu repairs (%lu goals), %.1f expansions each, slowest %.2f ms of %.1f ms, %lu cut short.\n",
+              planner.steps, planner.searches, planner.steps ? (double)planner.expansions / planner.steps : 0.0,
+              planner.max_step_ns / 1e6, PLAN_SLICE_MS, planner.budget_stops + planner.deadline_stops);
+       if (planner.anytime) printf("Anytime: %lu paths found, %lu restarts after map changes.\n", planner.solutions,
+                                   planner.restarts);
+       rescue_plan_free(&planner);
+     }
+     rescue_explore_free(&explore);
+   }
+   if (controller.vfh)
+     printf("Avoidance: %lu steps boxed in, %lu turning on the spot, %lu reversals.\n", vfh.blocked_steps, vfh.turn_steps,
+            vfh.reversals);
+   if (controller.dwa)
+     printf("Dynamic window: %lu windows, %.0f rollouts/ms, %lu steps braking.\n", dwa.updates,
+            rescue_dwa_rollouts_per_ms(&dwa), dwa.stops);
+   if (controller.speed)
+     printf("Speed governor: %lu of %lu steps slowed, %.2f of top speed on average, shortest time to collision %.2f s.\n",
+            governor.slowed, governor.updates, governor.updates ? governor.scale_sum / governor.updates : 1.0,
+            governor.min_ttc);
+   if (controller.stuck)
+     printf("Stuck: %lu rescues (%lu not moving, %lu oscillating), %lu along a wall, %.1f s escaping.\n", stuck.escapes,
+            stuck.stalls, stuck.oscillations, stuck.wall_follows, stuck.escape_steps * TIME_STEP / 1000.0);
+   if (controller.triggers)
+     printf("Triggers: %lu obstacle, %lu tilt and %lu survivor changes suppressed.\n",
+            rescue_trigger_suppressed(&triggers.obstacle), rescue_trigger_suppressed(&triggers.tilt),
+            rescue_trigger_suppressed(&triggers.survivor));
+   if (controller.mission)
+     printf("Mission: %lu approaches (%lu served, %lu given up), %lu returns, %.1f s docked; ticks: %.1f leaf calls, "
+            "slowest %.1f us, %lu cut short, %lu preemptions.\n", mission.approaches, mission.approaches_served,
+            mission.approaches_abandoned, mission.returns, mission.docked_steps * TIME_STEP / 1000.0,
+            mission.tree.ticks ? (double)mission.tree.leaf_calls / mission.tree.ticks : 0.0,
+            mission.tree.max_tick_ns / 1e3, mission.tree.yields, mission.tree.preemptions);
+   if (controller.schedule) {
+     rescue_schedule_dump(&schedule, stdout);
+     printf("Reflex: %lu turns started between control steps.\n", controller.reflexes);
+   }
+   if (controller.recognition)
+     printf("Recognition: %lu runs, %lu of %lu opportunities saved (%.0f%%, %lu put off for a fresh sample), %lu "
+            "escalations, %.1f s at full rate.\n", recognition.calls, recognition.saved, recognition.steps,
+            recognition.steps ? 100.0 * recognition.saved / recognition.steps : 0.0, recognition.deferred,
+            recognition.escalations, recognition.escalated_steps * recognition.period_ms / 1000.0);
+   if (controller.tilt) {
+     double roll, pitch;
+     rescue_tilt_angles(&tilt, &roll, &pitch);
+     printf("Tilt: %lu updates %s, %lu gated as motion, %lu slowed (mean scale %.2f), max %.2f m/s^2; now roll %.1f, "
+            "pitch %.1f deg.\n", tilt.updates, tilt.gyro ? "with the gyro" : "without a gyro", tilt.gated, tilt.slowed,
+            tilt.updates ? tilt.scale_sum / tilt.updates : 1.0, tilt.max_tilt, roll * 180.0 / M_PI, pitch * 180.0 / M_PI);
+   }
+   if (controller.map) {
+     printf("Map: %d/%d tiles (%.1f MB), %lu cells updated, %lu dropped.\n", map.used_tiles, map.max_tiles,
+            rescue_map_memory(&map) / 1048576.0, map.cells_updated, map.cells_dropped);
+     rescue_map_free(&map);
+   }
+   wb_robot_cleanup();
+   return 0;
  }
\ No newline at end of file
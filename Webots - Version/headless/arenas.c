@@ -0,0 +1,107 @@
+/*
+ * Description: Arena layouts for the headless simulator.
+ */
+
+#include "arenas.h"
+
+#include <math.h>
+#include <stdio.h>
+
+void arena_simple(Sim2D *sim) {
+  // Outer walls
+  sim_add_wall(sim, 0.0, 0.0, 4.0, 0.0);
+  sim_add_wall(sim, 4.0, 0.0, 4.0, 4.0);
+  sim_add_wall(sim, 4.0, 4.0, 0.0, 4.0);
+  sim_add_wall(sim, 0.0, 4.0, 0.0, 0.0);
+  // Furniture / debris
+  sim_add_box(sim, 1.5, 1.2, 0.2, 0.3);
+  sim_add_box(sim, 2.8, 2.6, 0.3, 0.2);
+  sim_add_box(sim, 1.0, 3.0, 0.25, 0.25);
+  // Survivors
+  sim_add_survivor(sim, 3.5, 0.6, 0.08);
+  sim_add_survivor(sim, 0.5, 3.5, 0.08);
+  sim_add_survivor(sim, 2.2, 2.0, 0.08);
+  // Mild rubble, about 10 degrees of pitch (below TILT_THRESHOLD)
+  sim_add_tilt_zone(sim, 2.5, 0.3, 3.0, 1.0, 0.0, 10.0 * M_PI / 180.0);
+
+  sim_set_pose(sim, 0.4, 0.4, 0.0);
+}
+
+void arena_rooms(Sim2D *sim) {
+  const double length = 8.0, depth = 4.0, room = 2.0, door = 0.6;
+  const double corridor[2] = {1.5, 2.5};
+  sim_add_wall(sim, 0.0, 0.0, length, 0.0);
+  sim_add_wall(sim, length, 0.0, length, depth);
+  sim_add_wall(sim, length, depth, 0.0, depth);
+  sim_add_wall(sim, 0.0, depth, 0.0, 0.0);
+  for (int side = 0; side < 2; ++side) {
+    double y = corridor[side];
+    for (double x = 0.0; x < length; x += room) { // Corridor wall with a door in the middle of each room
+      sim_add_wall(sim, x, y, x + 0.5 * (room - door), y);
+      sim_add_wall(sim, x + 0.5 * (room + door), y, x + room, y);
+    }
+    for (double x = room; x < length; x += room) // Dividers between rooms
+      sim_add_wall(sim, x, side ? corridor[1] : 0.0, x, side ? depth : corridor[0]);
+  }
+  // Survivors away from the doors
+  sim_add_survivor(sim, 0.4, 0.4, 0.08);
+  sim_add_survivor(sim, 3.6, 3.5, 0.08);
+  sim_add_survivor(sim, 4.5, 0.3, 0.08);
+  sim_add_survivor(sim, 7.6, 3.6, 0.08);
+  sim_add_survivor(sim, 6.3, 0.9, 0.08);
+  sim_add_box(sim, 5.4, 3.2, 0.3, 0.2);
+  sim_add_box(sim, 2.6, 0.5, 0.25, 0.25);
+
+  sim_set_pose(sim, 0.4, 2.0, 0.0);
+}
+
+void arena_passages(Sim2D *sim) {
+  const double length = 6.0, depth = 3.0, bay = 1.0, gap = 0.5;
+  sim_add_wall(sim, 0.0, 0.0, length, 0.0);
+  sim_add_wall(sim, length, 0.0, length, depth);
+  sim_add_wall(sim, length, depth, 0.0, depth);
+  sim_add_wall(sim, 0.0, depth, 0.0, 0.0);
+  int k = 0;
+  for (double x = bay; x < length; x += bay, ++k) { // Gap at the north end, then the south end
+    if (k % 2 == 0) sim_add_wall(sim, x, 0.0, x, depth - gap);
+    else sim_add_wall(sim, x, gap, x, depth);
+  }
+  sim_add_survivor(sim, 1.6, 0.3, 0.08);
+  sim_add_survivor(sim, 3.6, 0.3, 0.08);
+  sim_add_survivor(sim, 5.6, 0.3, 0.08);
+
+  sim_set_pose(sim, 0.5, 0.5, M_PI / 2.0);
+}
+
+static double arena_random(unsigned int *seed) { // LCG, deterministic per seed
+  *seed = *seed * 1103515245u + 12345u;
+  return (double)((*seed >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+void arena_rubble(Sim2D *sim, double size, int num_rubble, int num_survivors, unsigned int seed) {
+  sim_add_wall(sim, 0.0, 0.0, size, 0.0);
+  sim_add_wall(sim, size, 0.0, size, size);
+  sim_add_wall(sim, size, size, 0.0, size);
+  sim_add_wall(sim, 0.0, size, 0.0, 0.0);
+  double cx = 0.5 * size, cy = 0.5 * size;
+  for (int i = 0; i < num_rubble; ++i) {
+    double x = arena_random(&seed) * size, y = arena_random(&seed) * size;
+    if (fabs(x - cx) < 0.5 && fabs(y - cy) < 0.5) continue; // Keep the start clear
+    double len = 0.1 + 0.5 * arena_random(&seed), a = arena_random(&seed) * 2.0 * M_PI;
+    sim_add_wall(sim, x, y, x + len * cos(a), y + len * sin(a));
+  }
+  for (int i = 0; i < num_survivors; ++i)
+    sim_add_survivor(sim, 0.5 + arena_random(&seed) * (size - 1.0), 0.5 + arena_random(&seed) * (size - 1.0), 0.08);
+  sim_set_pose(sim, cx, cy, 0.0);
+}
+
+bool arena_suite(Sim2D *sim, int index, int rubble_seeds, char *name, size_t size) {
+  if (index == 0) { arena_simple(sim); snprintf(name, size, "simple 4x4"); return true; }
+  if (index == 1) { arena_rooms(sim); snprintf(name, size, "rooms 8x4"); return true; }
+  if (index == 2) { arena_passages(sim); snprintf(name, size, "passages 6x3"); return true; }
+  int seed = index - 3 + 1;
+  if (seed > rubble_seeds) return false;
+  arena_rubble(sim, 6.0, 60, 4, (unsigned int)seed);
+  snprintf(name, size, "rubble 6x6 #%d", seed);
+  return true;
+}
@@ -0,0 +1,44 @@
+/*
+ * Description: Arena layouts for the headless simulator.
+ */
+
+#ifndef ARENAS_H
+#define ARENAS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "sim2d.h"
+
+#define ARENA_SUITE_RUBBLE_SEEDS 4 // Rubble fields in the benches' suite by default
+
+// 4 m x 4 m room with a few boxes, three survivors and a mild rubble patch.
+// The robot starts near the south-west corner facing east.
+void arena_simple(Sim2D *sim);
+
+// Disaster site: size x size meters of outer walls with num_rubble randomly
+// placed rubble segments (0.1 - 0.6 m long) and num_survivors survivors.
+// Deterministic for a given seed. The robot starts at the center.
+void arena_rubble(Sim2D *sim, double size, int num_rubble, int num_survivors, unsigned int seed);
+
+// Office floor: 8 m x 4 m with an east-west corridor (y 1.5 - 2.5 m) and
+// four 2 m x 1.5 m rooms on each side, each with a 0.6 m door onto the
+// corridor, and survivors in five of the rooms. The robot starts at the west
+// end of the corridor facing east; a robot that does not explore tends to
+// run up and down the corridor.
+void arena_rooms(Sim2D *sim);
+
+// Narrow passages: 6 m x 3 m split into six 1 m bays by partitions with a
+// 0.5 m gap at alternate ends, so the way through zigzags, and a survivor
+// in every other bay. The robot starts in the south-west corner facing
+// north; in the gaps the walls are close on both sides, and steering away
+// from one makes it flip between avoiding and searching.
+void arena_passages(Sim2D *sim);
+
+// The suite the benches run: arena index 0 is arena_simple, 1 arena_rooms,
+// 2 arena_passages, then 6 m rubble fields (60 pieces, 4 survivors) with
+// seeds 1 .. rubble_seeds. Builds it into sim and writes its name; returns
+// false past the last one.
+bool arena_suite(Sim2D *sim, int index, int rubble_seeds, char *name, size_t size);
+
+#endif // ARENAS_H
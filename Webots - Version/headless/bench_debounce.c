@@ -0,0 +1,209 @@
+/*
+ * Description: Debounced trigger benchmark (rescue_trigger.h). The
+ *              controller explores the arena suite for a fixed time as it
+ *              is shipped (stack.h), and turning on the spot instead of
+ *              steering with histogram and dynamic window, each with clean
+ *              sensors and with noisy ones (BENCH_DS_NOISE on the ds,
+ *              BENCH_ACCEL_NOISE on the accelerometer, recognition that
+ *              misses a survivor or sees one that is not there), on a
+ *              single threshold per reading and with the debounced
+ *              triggers. Reports state transitions ("STATE CHANGE" lines)
+ *              per minute, aid deployments that credited no new survivor,
+ *              time stopped as tilted, survivors found, collisions and the
+ *              transitions of each trigger suppressed.
+ *
+ * Usage: bench_debounce [sim_seconds] [rubble_seeds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_STEERING 2
+#define BENCH_DS_NOISE 0.02        // Standard deviation of a ds reading (meters)
+#define BENCH_ACCEL_NOISE 1.0      // ... of an accelerometer axis (m/s^2)
+#define BENCH_MISS 0.1             // Chance that recognition misses a survivor in view
+#define BENCH_GHOST 0.01           // Chance per step that a ds within SURVIVOR_EXIT_RANGE sees a survivor not there
+#define BENCH_GHOST_ID 100000      // Identities of those, one per sighting
+
+static const char *steering_names[BENCH_STEERING] = {"default", "spin"};
+
+// --- Noisy Sensors ---
+
+typedef struct {
+  RescueHal inner;
+  Sim2D *sim;
+  const RescueController *controller;
+  bool noisy;
+  unsigned int seed;
+  int ghosts;
+  RobotState last_state;
+  long transitions;
+  long false_aid;
+  long tilted_steps;
+} Watch;
+
+static double uniform(Watch *w) {
+  w->seed = w->seed * 1103515245u + 12345u;
+  return ((w->seed >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+static double gaussian(Watch *w) { // Box-Muller
+  double u = uniform(w), v = uniform(w);
+  return sqrt(-2.0 * log(u + 1e-12)) * cos(2.0 * M_PI * v);
+}
+
+static void watch_sense(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->inner.sense(w->inner.ctx, in);
+  if (!w->noisy) return;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) in->ds[i] = fmax(0.0, in->ds[i] + BENCH_DS_NOISE * gaussian(w));
+  if (in->has_accel)
+    for (int k = 0; k < 2; ++k) in->accel[k] += BENCH_ACCEL_NOISE * gaussian(w);
+}
+
+static void watch_recognize(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->inner.recognize(w->inner.ctx, in);
+  if (!w->noisy) return;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    if (in->survivor_seen[i] && uniform(w) < BENCH_MISS) {
+      in->survivor_seen[i] = false;
+      in->survivor_id[i] = -1;
+    } else if (!in->survivor_seen[i] && in->ds[i] < SURVIVOR_EXIT_RANGE && uniform(w) < BENCH_GHOST) {
+      in->survivor_seen[i] = true;
+      in->survivor_id[i] = BENCH_GHOST_ID + w->ghosts++;
+    }
+  }
+}
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  RobotState state = w->controller->current_state;
+  w->transitions += state != w->last_state;
+  w->last_state = state;
+  w->tilted_steps += state == ROBOT_TILTED;
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static bool watch_emit(void *ctx, const void *d, int n) {
+  Watch *w = ctx;
+  int before = sim_survivors_signaled(w->sim);
+  bool ok = w->inner.emit(w->inner.ctx, d, n);
+  if (n > 0 && strncmp(d, SURVIVOR_MESSAGE, (size_t)n) == 0) w->false_aid += sim_survivors_signaled(w->sim) == before;
+  return ok;
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+
+// --- Arena Runs ---
+
+typedef struct {
+  double transitions;     // Per minute
+  long false_aid;
+  double tilted;          // Seconds
+  int found, total;
+  long collisions;
+  unsigned long suppressed[3]; // Obstacle, tilt, survivor
+} BenchResult;
+
+static int rubble_seeds = ARENA_SUITE_RUBBLE_SEEDS;
+
+static BenchResult run(int scenario, int steering, bool noisy, bool debounce, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, rubble_seeds, name, sizeof(name));
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (steering == 1) config &= ~(RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA);
+  if (!debounce) config &= ~RESCUE_TRACE_CONFIG_TRIGGERS;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  const RescueTriggers *triggers = &stack.triggers;
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  watch.controller = &stack.controller;
+  watch.noisy = noisy;
+  watch.seed = 1u + (unsigned int)scenario;
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.transitions = watch.transitions / (sim.time / 60.0), .false_aid = watch.false_aid,
+                   .tilted = watch.tilted_steps * stack.tick_ms / 1000.0, .found = sim_survivors_signaled(&sim),
+                   .total = sim.num_survivors, .collisions = sim.collisions,
+                   .suppressed = {rescue_trigger_suppressed(&triggers->obstacle),
+                                  rescue_trigger_suppressed(&triggers->tilt),
+                                  rescue_trigger_suppressed(&triggers->survivor)}};
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  if (argc > 2) rubble_seeds = atoi(argv[2]);
+  printf("exploring for %.0f s; noise: ds %.2f m, accel %.1f m/s^2, %.0f%% missed, %.0f%% ghosts\n", limit,
+         BENCH_DS_NOISE, BENCH_ACCEL_NOISE, BENCH_MISS * 100.0, BENCH_GHOST * 100.0);
+  printf("triggers (on/off threshold, samples of m to turn on/off): obstacle %.2f/%.2f m %d/%d of %d, "
+         "tilt %.1f/%.1f %d/%d of %d, survivor %.2f/%.2f m %d/%d of %d\n",
+         OBSTACLE_DISTANCE_THRESHOLD, OBSTACLE_EXIT_DISTANCE, OBSTACLE_ENTER_N, OBSTACLE_CONFIRM_N, OBSTACLE_CONFIRM_M,
+         TILT_THRESHOLD, TILT_EXIT_THRESHOLD, TILT_ENTER_N, TILT_CONFIRM_N, TILT_CONFIRM_M, SURVIVOR_DETECTION_RANGE,
+         SURVIVOR_EXIT_RANGE, SURVIVOR_ENTER_N, SURVIVOR_CONFIRM_N, SURVIVOR_CONFIRM_M);
+  printf("%-15s %-8s %-6s %-9s %12s %9s %8s %6s %10s %s\n", "arena", "steer", "noise", "triggers", "transitions",
+         "false aid", "tilted", "found", "collisions", "suppressed obstacle/tilt/survivor");
+  double transitions[BENCH_STEERING][2][2] = {{{0.0}}}, tilted[BENCH_STEERING][2][2] = {{{0.0}}};
+  long false_aid[BENCH_STEERING][2][2] = {{{0}}}, collisions[BENCH_STEERING][2][2] = {{{0}}};
+  int found[BENCH_STEERING][2][2] = {{{0}}}, total = 0, arenas = 0;
+  unsigned long suppressed[BENCH_STEERING][2] = {{0}};
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, rubble_seeds, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    arenas++;
+    for (int steering = 0; steering < BENCH_STEERING; ++steering)
+      for (int noisy = 0; noisy < 2; ++noisy)
+        for (int debounce = 0; debounce < 2; ++debounce) {
+          BenchResult r = run(scenario, steering, noisy, debounce, limit);
+          printf("%-15s %-8s %-6s %-9s %7.1f/min %9ld %7.1fs %3d/%-2d %10ld", steering || noisy || debounce ? "" : name,
+                 noisy || debounce ? "" : steering_names[steering], debounce ? "" : noisy ? "noisy" : "clean",
+                 debounce ? "debounced" : "single", r.transitions, r.false_aid, r.tilted, r.found, r.total,
+                 r.collisions);
+          if (debounce) printf(" %lu/%lu/%lu", r.suppressed[0], r.suppressed[1], r.suppressed[2]);
+          printf("\n");
+          transitions[steering][noisy][debounce] += r.transitions;
+          false_aid[steering][noisy][debounce] += r.false_aid;
+          tilted[steering][noisy][debounce] += r.tilted;
+          found[steering][noisy][debounce] += r.found;
+          collisions[steering][noisy][debounce] += r.collisions;
+          if (debounce) suppressed[steering][noisy] += r.suppressed[0] + r.suppressed[1] + r.suppressed[2];
+          if (!steering && !noisy && !debounce) total += r.total;
+        }
+  }
+  for (int steering = 0; steering < BENCH_STEERING; ++steering)
+    for (int noisy = 0; noisy < 2; ++noisy)
+      for (int debounce = 0; debounce < 2; ++debounce) {
+        printf("%-8s %-5s %-9s %5.1f transitions/min, %ld false aid, %.0f s tilted, survivors %d/%d, %ld collisions",
+               steering_names[steering], noisy ? "noisy" : "clean", debounce ? "debounced" : "single",
+               transitions[steering][noisy][debounce] / arenas, false_aid[steering][noisy][debounce],
+               tilted[steering][noisy][debounce], found[steering][noisy][debounce], total,
+               collisions[steering][noisy][debounce]);
+        if (debounce) printf(", %lu suppressed", suppressed[steering][noisy]);
+        printf("\n");
+      }
+  return 0;
+}
@@ -0,0 +1,198 @@
+/*
+ * Description: Dynamic window benchmark (rescue_dwa.h). First the rollout
+ *              kernels: costmaps built from random scans, windows around
+ *              random wheel speeds, rolled out by the scalar and the vector
+ *              kernel, which must score every rollout the same; reports
+ *              rollouts per millisecond. Then the controller explores the
+ *              arena suite as it is shipped (stack.h) but for the steering:
+ *              turning on the spot away from obstacles, steering with the
+ *              polar histogram, with the dynamic window alone and with the
+ *              dynamic window driving the histogram's direction, on the
+ *              three ds and on a fan of 16 range sensors. Reports survivors
+ *              found, distance, collisions and the average speed while
+ *              driving (searching or avoiding, not deploying aid).
+ *
+ * Usage: bench_dwa [sim_seconds] [windows]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_MODES 6
+#define BENCH_DISTINCT_MAPS 32     // Costmaps the kernel windows are drawn on
+#define BENCH_SCANS 24             // Random scans sensed into each costmap
+
+typedef enum { BENCH_SPIN, BENCH_VFH, BENCH_DWA, BENCH_VFH_DWA, BENCH_VFH_16, BENCH_VFH_DWA_16 } BenchMode;
+static const char *mode_names[BENCH_MODES] = {"spin", "vfh", "dwa", "vfh+dwa", "vfh 16", "vfh+dwa 16"};
+
+static double uniform(double lo, double hi) { return lo + (hi - lo) * rand() / (double)RAND_MAX; }
+
+// --- Kernels ---
+
+// Fills d's costmap with random scans taken around the origin.
+static void random_costmap(RescueDwa *d) {
+  double range[RESCUE_MAX_RANGES], angle[RESCUE_MAX_RANGES];
+  for (int s = 0; s < BENCH_SCANS; ++s) {
+    double pose[3] = {uniform(-0.2, 0.2), uniform(-0.2, 0.2), uniform(-M_PI, M_PI)};
+    for (int i = 0; i < RESCUE_MAX_RANGES; ++i) {
+      range[i] = uniform(0.1, 1.0);
+      angle[i] = -M_PI / 2.0 + M_PI * i / (RESCUE_MAX_RANGES - 1);
+    }
+    rescue_dwa_sense(d, pose, range, angle, RESCUE_MAX_RANGES);
+  }
+}
+
+// Rolls out count windows with the scalar and the vector kernel; false if
+// any score or clearance differs.
+static bool bench_kernels(long count) {
+  static RescueDwa maps[BENCH_DISTINCT_MAPS];
+  for (int m = 0; m < BENCH_DISTINCT_MAPS; ++m) {
+    rescue_dwa_init(&maps[m], FORWARD_SPEED);
+    random_costmap(&maps[m]);
+  }
+  static RescueDwa scalar, simd;
+  bool same = true;
+  for (long c = 0; c < count; ++c) {
+    const RescueDwa *map = &maps[c % BENCH_DISTINCT_MAPS];
+    double pose[3] = {uniform(-0.1, 0.1), uniform(-0.1, 0.1), uniform(-M_PI, M_PI)};
+    double wheels[2] = {uniform(-TURN_SPEED, FORWARD_SPEED), uniform(-TURN_SPEED, FORWARD_SPEED)};
+    double target = uniform(-M_PI, M_PI), left[2], right[2];
+    for (int k = 0; k < 2; ++k) {
+      RescueDwa *d = k ? &simd : &scalar;
+      // Keep each kernel's statistics across the copies
+      unsigned long rollouts = d->rollouts;
+      uint64_t ns = d->rollout_ns;
+      *d = *map;
+      d->simd = k && map->simd;
+      d->rollouts = rollouts;
+      d->rollout_ns = ns;
+      rescue_dwa_plan(d, pose, target, 1.0, wheels, TIME_STEP / 1000.0, &left[k], &right[k]);
+    }
+    same = same && memcmp(scalar.score, simd.score, sizeof(scalar.score)) == 0 &&
+           memcmp(scalar.min_clearance, simd.min_clearance, sizeof(scalar.min_clearance)) == 0 &&
+           left[0] == left[1] && right[0] == right[1];
+  }
+  printf("  %ld windows of %d rollouts x %d substeps  scalar %9.1f /ms  %s %9.1f /ms  speedup %5.2fx  %s\n", count,
+         RESCUE_DWA_SAMPLES, RESCUE_DWA_STEPS, rescue_dwa_rollouts_per_ms(&scalar), simd.simd ? "simd" : "(no simd)",
+         rescue_dwa_rollouts_per_ms(&simd), rescue_dwa_rollouts_per_ms(&simd) / rescue_dwa_rollouts_per_ms(&scalar),
+         same ? "agree" : "DIFFER");
+  return same;
+}
+
+// --- Arena Runs ---
+
+typedef struct {
+  RescueHal inner;
+  const RescueController *controller;
+  long driving_steps;     // SEARCHING or AVOIDING_OBSTACLE
+} Watch;
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  RobotState state = w->controller->current_state;
+  w->driving_steps += state == SEARCHING || state == AVOIDING_OBSTACLE;
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static void watch_sense(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.sense(w->inner.ctx, in); }
+static void watch_recognize(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.recognize(w->inner.ctx, in); }
+static bool watch_emit(void *ctx, const void *d, int n) { Watch *w = ctx; return w->inner.emit(w->inner.ctx, d, n); }
+
+typedef struct {
+  double all;             // Sim time the last survivor was signaled, -1 if not
+  int found, total;
+  double distance;
+  double driving;         // Seconds driving
+  long collisions;
+  double rollouts_per_ms;
+  unsigned long stops;
+} BenchResult;
+
+static BenchResult run(int scenario, BenchMode mode, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  sim.stop_when_all_signaled = true;
+  if (mode >= BENCH_VFH_16) sim_set_range_sensors(&sim, RESCUE_MAX_RANGES);
+  uint32_t config = SIM_STACK_DEFAULT & ~(RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA);
+  if (mode != BENCH_SPIN && mode != BENCH_DWA) config |= RESCUE_TRACE_CONFIG_VFH;
+  if (mode == BENCH_DWA || mode == BENCH_VFH_DWA || mode == BENCH_VFH_DWA_16) config |= RESCUE_TRACE_CONFIG_DWA;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  const RescueController *controller = &stack.controller;
+
+  Watch watch = {.controller = controller};
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.all = sim.all_signaled_time, .found = sim_survivors_signaled(&sim), .total = sim.num_survivors,
+                   .distance = sim.distance_travelled, .collisions = sim.collisions,
+                   .driving = watch.driving_steps * stack.tick_ms / 1000.0};
+  if (controller->dwa) {
+    r.rollouts_per_ms = rescue_dwa_rollouts_per_ms(&stack.dwa);
+    r.stops = stack.dwa.stops;
+  }
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  long count = argc > 2 ? atol(argv[2]) : 2000;
+
+  printf("rollout kernels: %dx%d window, %.1f s horizon, %dx%d costmap | kernel: %s\n", RESCUE_DWA_V_SAMPLES,
+         RESCUE_DWA_W_SAMPLES, RESCUE_DWA_STEPS * RESCUE_DWA_STEP_TIME, RESCUE_DWA_CELLS, RESCUE_DWA_CELLS,
+         rescue_dwa_simd_name());
+  srand(17);
+  bool agree = bench_kernels(count);
+
+  printf("\nexploring, time limit %.0f s; '-': not within the limit\n", limit);
+  printf("%-15s %-10s %9s %6s %9s %10s %9s %10s\n", "arena", "steer", "all", "found", "distance", "collisions",
+         "speed", "rollouts");
+  int found[BENCH_MODES] = {0}, completed[BENCH_MODES] = {0}, total = 0;
+  long collisions[BENCH_MODES] = {0};
+  double distance[BENCH_MODES] = {0.0}, driving[BENCH_MODES] = {0.0};
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    for (int mode = 0; mode < BENCH_MODES; ++mode) {
+      BenchResult r = run(scenario, (BenchMode)mode, limit);
+      printf("%-15s %-10s ", mode ? "" : name, mode_names[mode]);
+      if (r.all < 0.0) printf("%9s", "-");
+      else printf("%8.1fs", r.all);
+      printf(" %3d/%-2d %8.1fm %10ld %7.3fm/s", r.found, r.total, r.distance, r.collisions,
+             r.driving > 0.0 ? r.distance / r.driving : 0.0);
+      if (r.rollouts_per_ms > 0.0) printf(" %8.0f/ms", r.rollouts_per_ms);
+      printf("\n");
+      found[mode] += r.found;
+      completed[mode] += r.all >= 0.0;
+      collisions[mode] += r.collisions;
+      distance[mode] += r.distance;
+      driving[mode] += r.driving;
+      if (!mode) total += r.total;
+    }
+  }
+  for (int mode = 0; mode < BENCH_MODES; ++mode)
+    printf("%-10s survivors %d/%d, all of them in %d arenas, %ld collisions, %.3f m/s driving\n", mode_names[mode],
+           found[mode], total, completed[mode], collisions[mode], driving[mode] > 0.0 ? distance[mode] / driving[mode] : 0.0);
+  printf("rollout kernels %s\n", agree ? "agree" : "DIFFER");
+  return agree ? 0 : 1;
+}
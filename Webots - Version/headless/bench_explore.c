@@ -0,0 +1,130 @@
+/*
+ * Description: Exploration benchmark. Runs the controller on the arena
+ *              suite, searching straight ahead (turning only away from
+ *              obstacles) and with frontier exploration (rescue_explore.h),
+ *              following first the breadth-first path chosen with the goal,
+ *              then the path the planner repairs every step
+ *              (rescue_plan.h), then the planner's anytime mode and last
+ *              the planned path steered around obstacles by the polar
+ *              histogram (rescue_vfh.h). It reports how long it takes to
+ *              find the first and all survivors, how many are found within
+ *              the time limit, the distance driven and collisions.
+ *
+ * Usage: bench_explore [sim_seconds]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_MODES 5
+
+typedef enum { BENCH_STRAIGHT, BENCH_EXPLORE, BENCH_PLANNED, BENCH_ANYTIME, BENCH_VFH } BenchMode;
+static const char *mode_names[BENCH_MODES] = {"straight", "explore", "planned", "anytime", "vfh"};
+// Each mode on its own, without the rest of the shipped stack (stack.h); without exploration no map at all
+static const uint32_t mode_configs[BENCH_MODES] = {
+    0,
+    RESCUE_TRACE_CONFIG_EXPLORE,
+    RESCUE_TRACE_CONFIG_EXPLORE | RESCUE_TRACE_CONFIG_PLAN,
+    RESCUE_TRACE_CONFIG_EXPLORE | RESCUE_TRACE_CONFIG_PLAN | RESCUE_TRACE_CONFIG_ANYTIME,
+    RESCUE_TRACE_CONFIG_EXPLORE | RESCUE_TRACE_CONFIG_PLAN | RESCUE_TRACE_CONFIG_VFH,
+};
+
+typedef struct {
+  double first, all;     // Sim time of the first / last survivor signaled, -1 if not
+  int found, total;
+  double distance;
+  long collisions;
+  double wall_time;
+} BenchResult;
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static BenchResult run(int scenario, BenchMode mode, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  sim.stop_when_all_signaled = true;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, mode_configs[mode], &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  RescueHal hal;
+  sim_hal_init(&sim, &hal, sim_stack_ticks(&stack, limit));
+
+  double t0 = now_seconds();
+  rescue_run(&hal, &stack.controller);
+  BenchResult r = {.first = -1.0, .all = sim.all_signaled_time, .total = sim.num_survivors,
+                   .distance = sim.distance_travelled, .collisions = sim.collisions};
+  r.wall_time = now_seconds() - t0;
+  for (int i = 0; i < sim.num_survivors; ++i) {
+    if (!sim.survivors[i].signaled) continue;
+    r.found++;
+    if (r.first < 0.0 || sim.survivors[i].signal_time < r.first) r.first = sim.survivors[i].signal_time;
+  }
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+static void print_time(double t) {
+  if (t < 0.0) printf("%9s", "-");
+  else printf("%8.1fs", t);
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 600.0;
+  printf("time limit: %.0f s of sim time; '-': not within the limit\n", limit);
+  printf("%-15s %-9s %9s %9s %6s %9s %10s %8s\n", "arena", "search", "first", "all", "found", "distance",
+         "collisions", "wall");
+
+  int completed[BENCH_MODES] = {0}, found[BENCH_MODES] = {0}, total = 0;
+  double total_all[BENCH_MODES] = {0.0}; // Arenas every mode completed
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    BenchResult r[BENCH_MODES];
+    bool all_completed = true;
+    for (int mode = 0; mode < BENCH_MODES; ++mode) {
+      r[mode] = run(scenario, (BenchMode)mode, limit);
+      printf("%-15s %-9s ", mode ? "" : name, mode_names[mode]);
+      print_time(r[mode].first);
+      printf(" ");
+      print_time(r[mode].all);
+      printf(" %3d/%-2d %8.1fm %10ld %7.2fs\n", r[mode].found, r[mode].total, r[mode].distance,
+             r[mode].collisions, r[mode].wall_time);
+      completed[mode] += r[mode].all >= 0.0;
+      found[mode] += r[mode].found;
+      all_completed = all_completed && r[mode].all >= 0.0;
+    }
+    total += r[0].total;
+    if (all_completed)
+      for (int mode = 0; mode < BENCH_MODES; ++mode) total_all[mode] += r[mode].all;
+  }
+  printf("survivors found:");
+  for (int mode = 0; mode < BENCH_MODES; ++mode) printf(" %s %d/%d,", mode_names[mode], found[mode], total);
+  printf(" | all of them:");
+  for (int mode = 0; mode < BENCH_MODES; ++mode) printf(" %s %d,", mode_names[mode], completed[mode]);
+  printf(" arenas");
+  if (total_all[0] > 0.0) {
+    printf(" | where all did:");
+    for (int mode = 0; mode < BENCH_MODES; ++mode) printf(" %s %.1f s,", mode_names[mode], total_all[mode]);
+  }
+  printf("\n");
+  return 0;
+}
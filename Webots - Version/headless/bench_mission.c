@@ -0,0 +1,153 @@
+/*
+ * Description: Mission behavior tree benchmark (rescue_mission.h). The
+ *              controller explores the arena suite for a fixed time as it
+ *              is shipped (stack.h): searching only, with the mission tree
+ *              (approaching survivors glimpsed from afar), with the tree
+ *              returning to base BENCH_RETURN_SHARE of the way through the
+ *              run, and the same on a tight budget of BENCH_STARVED_CALLS
+ *              leaf calls. Reports survivors found, the time to the last
+ *              of them, approaches (served / given up), how far from the
+ *              starting point the robot ended and how long it stood docked,
+ *              and the tree's leaf calls per tick, slowest tick and ticks
+ *              cut short by the budget.
+ *
+ * Usage: bench_mission [sim_seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_MODES 4
+#define BENCH_RETURN_SHARE 0.6    // Return to base after this share of the run
+#define BENCH_STARVED_CALLS 3     // Leaf calls per tick of the tight tree (it needs up to 4)
+
+static const char *mode_names[BENCH_MODES] = {"search only", "mission", "+ return", "+ return, 3 calls"};
+
+// --- Time to the Last Survivor ---
+
+typedef struct {
+  RescueHal inner;
+  const Sim2D *sim;
+  int signaled;
+  double last_found;
+} Watch;
+
+static bool watch_emit(void *ctx, const void *d, int n) {
+  Watch *w = ctx;
+  bool ok = w->inner.emit(w->inner.ctx, d, n);
+  int signaled = sim_survivors_signaled(w->sim);
+  if (signaled > w->signaled) {
+    w->signaled = signaled;
+    w->last_found = w->sim->time;
+  }
+  return ok;
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static void watch_sense(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.sense(w->inner.ctx, in); }
+static void watch_recognize(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.recognize(w->inner.ctx, in); }
+static void watch_actuate(void *ctx, const RescueOutputs *out) { Watch *w = ctx; w->inner.actuate(w->inner.ctx, out); }
+
+// --- Arena Runs ---
+
+typedef struct {
+  int found, total;
+  double last_found;      // Seconds, 0 if none found
+  unsigned long approaches, served, abandoned;
+  double from_base;       // Meters at the end
+  double docked;          // Seconds
+  double calls_per_tick;
+  int max_calls;
+  double max_tick_us;
+  unsigned long yields;
+} BenchResult;
+
+static BenchResult run(int scenario, int mode, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  double base[2] = {sim.x, sim.y};
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (!mode) config &= ~RESCUE_TRACE_CONFIG_MISSION;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  RescueMission *mission = &stack.mission; // Set up again for the bench's return time and budget
+  rescue_mission_init(mission, mode >= 2 ? BENCH_RETURN_SHARE * limit : 0.0, MISSION_SLICE_MS, false);
+  if (mode == 3) mission->tree.max_calls = BENCH_STARVED_CALLS;
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  const RescueBt *bt = &mission->tree;
+  BenchResult r = {.found = sim_survivors_signaled(&sim), .total = sim.num_survivors, .last_found = watch.last_found,
+                   .approaches = mission->approaches, .served = mission->approaches_served,
+                   .abandoned = mission->approaches_abandoned, .from_base = hypot(sim.x - base[0], sim.y - base[1]),
+                   .docked = mission->docked_steps * TIME_STEP / 1000.0,
+                   .calls_per_tick = bt->ticks ? (double)bt->leaf_calls / bt->ticks : 0.0,
+                   .max_calls = bt->max_tick_calls, .max_tick_us = bt->max_tick_ns / 1e3, .yields = bt->yields};
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  printf("exploring for %.0f s; return to base after %.0f s; tight tree: %d leaf calls per tick\n", limit,
+         BENCH_RETURN_SHARE * limit, BENCH_STARVED_CALLS);
+  printf("%-15s %-17s %6s %8s %16s %9s %8s %16s %10s %7s\n", "arena", "mode", "found", "last", "approaches",
+         "from base", "docked", "calls/tick (max)", "max tick", "yields");
+  int found[BENCH_MODES] = {0}, total = 0, arenas = 0;
+  double from_base[BENCH_MODES] = {0.0}, docked[BENCH_MODES] = {0.0}, max_tick[BENCH_MODES] = {0.0};
+  unsigned long approaches[BENCH_MODES] = {0}, served[BENCH_MODES] = {0}, yields[BENCH_MODES] = {0};
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    arenas++;
+    for (int mode = 0; mode < BENCH_MODES; ++mode) {
+      BenchResult r = run(scenario, mode, limit);
+      printf("%-15s %-17s %3d/%-2d %7.1fs", mode ? "" : name, mode_names[mode], r.found, r.total, r.last_found);
+      if (mode)
+        printf(" %6lu (%lu / %lu) %8.2fm %7.1fs %11.2f (%d) %8.1fus %7lu", r.approaches, r.served, r.abandoned,
+               r.from_base, r.docked, r.calls_per_tick, r.max_calls, r.max_tick_us, r.yields);
+      else
+        printf(" %16s %8.2fm", "", r.from_base);
+      printf("\n");
+      found[mode] += r.found;
+      from_base[mode] += r.from_base;
+      docked[mode] += r.docked;
+      approaches[mode] += r.approaches;
+      served[mode] += r.served;
+      yields[mode] += r.yields;
+      if (r.max_tick_us > max_tick[mode]) max_tick[mode] = r.max_tick_us;
+      if (!mode) total += r.total;
+    }
+  }
+  for (int mode = 0; mode < BENCH_MODES; ++mode) {
+    printf("%-17s survivors %d/%d, %.2f m from base on average", mode_names[mode], found[mode], total,
+           from_base[mode] / arenas);
+    if (mode)
+      printf(", %lu approaches (%lu served), %.0f s docked, slowest tick %.1f us, %lu yields", approaches[mode],
+             served[mode], docked[mode], max_tick[mode], yields[mode]);
+    printf("\n");
+  }
+  return 0;
+}
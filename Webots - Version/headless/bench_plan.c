@@ -0,0 +1,285 @@
+/*
+ * Description: Path planner benchmark. A robot crosses a grid strewn with
+ *              obstacles it only discovers within sensor reach, moving one
+ *              cell per step along the planned path. Every step the newly
+ *              seen cells go into the planner and the path is repaired
+ *              incrementally (D* Lite, rescue_plan.h); the same step is
+ *              also planned from scratch for comparison, and checked
+ *              against a Dijkstra search over the known costs. A third run
+ *              repairs within a time slice per step, as the controller
+ *              does, and reports the slowest step against the slice.
+ *
+ *              Anytime mode (ARA*) is then compared with D* Lite on the
+ *              whole grid known up front, within the same slice: how many
+ *              steps until each has a path, and how the anytime path's
+ *              cost and bound come down to the optimum. Last, the anytime
+ *              planner crosses the grid discovering it, as above.
+ *
+ * Usage: bench_plan [size] [obstacles] [slice_ms] [epsilon]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../rescue_plan.h"
+
+#define BENCH_SENSOR_RADIUS 6     // Cells seen around the robot each step (1 m at 16 cm)
+#define BENCH_MAX_STEPS 100000
+
+typedef struct {
+  int size;
+  uint8_t *truth;               // Real cost of every cell
+  int start, goal;
+} BenchWorld;
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned int bench_random(unsigned int *seed) {
+  *seed = *seed * 1103515245u + 12345u;
+  return (*seed >> 8) & 0xFFFFFF;
+}
+
+// Rectangular obstacles (wall pieces) with a cost-4 band around them, as the
+// explorer inflates obstacles; the corners are kept clear.
+static void build_world(BenchWorld *w, int size, int obstacles, unsigned int seed) {
+  w->size = size;
+  w->truth = malloc((size_t)size * size);
+  memset(w->truth, 1, (size_t)size * size);
+  for (int i = 0; i < obstacles; ++i) {
+    int x = bench_random(&seed) % size, y = bench_random(&seed) % size;
+    int len = 2 + bench_random(&seed) % (size / 8 + 1);
+    bool vertical = bench_random(&seed) & 1;
+    for (int k = 0; k < len; ++k) {
+      int cx = vertical ? x : x + k, cy = vertical ? y + k : y;
+      if (cx >= size || cy >= size || (cx < 8 && cy < 8) || (cx >= size - 8 && cy >= size - 8)) continue;
+      for (int dy = -1; dy <= 1; ++dy)
+        for (int dx = -1; dx <= 1; ++dx) {
+          int nx = cx + dx, ny = cy + dy;
+          if (nx >= 0 && ny >= 0 && nx < size && ny < size && w->truth[ny * size + nx])
+            w->truth[ny * size + nx] = 4;
+        }
+    }
+    for (int k = 0; k < len; ++k) {
+      int cx = vertical ? x : x + k, cy = vertical ? y + k : y;
+      if (cx >= size || cy >= size || (cx < 8 && cy < 8) || (cx >= size - 8 && cy >= size - 8)) continue;
+      w->truth[cy * size + cx] = RESCUE_PLAN_BLOCKED;
+    }
+  }
+  w->start = 2 * size + 2;
+  w->goal = (size - 3) * size + size - 3;
+}
+
+// Copies the true cost of the cells around the robot into the planner(s).
+static void sense(const BenchWorld *w, RescuePlanner **planners, int count, int robot) {
+  int rx = robot % w->size, ry = robot / w->size;
+  for (int y = ry - BENCH_SENSOR_RADIUS; y <= ry + BENCH_SENSOR_RADIUS; ++y)
+    for (int x = rx - BENCH_SENSOR_RADIUS; x <= rx + BENCH_SENSOR_RADIUS; ++x) {
+      if (x < 0 || y < 0 || x >= w->size || y >= w->size) continue;
+      int c = y * w->size + x;
+      for (int k = 0; k < count; ++k) rescue_plan_set_cost(planners[k], c, w->truth[c]);
+    }
+}
+
+// Cost to the goal over the planner's known costs: label-correcting search
+// from the goal with a FIFO ring, each cell queued at most once at a time.
+static uint32_t reference_cost(const RescuePlanner *p, int from, int goal, uint32_t *dist, int *queue, bool *queued) {
+  int n = p->width * p->height;
+  for (int i = 0; i < n; ++i) dist[i] = RESCUE_PLAN_INFINITY;
+  memset(queued, 0, (size_t)n * sizeof(*queued));
+  int head = 0, tail = 0;
+  dist[goal] = 0;
+  queue[tail++] = goal;
+  queued[goal] = true;
+  while (head != tail) {
+    int u = queue[head];
+    head = (head + 1) % n;
+    queued[u] = false;
+    if (p->cost[u] == RESCUE_PLAN_BLOCKED) continue;
+    int x = u % p->width, y = u / p->width;
+    int nb[4] = {x > 0 ? u - 1 : -1, x < p->width - 1 ? u + 1 : -1, y > 0 ? u - p->width : -1,
+                 y < p->height - 1 ? u + p->width : -1};
+    for (int k = 0; k < 4; ++k) {
+      int v = nb[k];
+      if (v < 0) continue;
+      uint32_t d = dist[u] + p->cost[u]; // Stepping from v into u costs u's cost
+      if (d < dist[v]) {
+        dist[v] = d;
+        if (!queued[v]) {
+          queued[v] = true;
+          queue[tail] = v;
+          tail = (tail + 1) % n;
+        }
+      }
+    }
+  }
+  return dist[from];
+}
+
+int main(int argc, char **argv) {
+  int size = argc > 1 ? atoi(argv[1]) : 256;
+  int obstacles = argc > 2 ? atoi(argv[2]) : size * size / 200;
+  double slice_ms = argc > 3 ? atof(argv[3]) : 4.0;
+  double epsilon = argc > 4 ? atof(argv[4]) : 3.0;
+  if (size < 32) size = 32;
+
+  BenchWorld world;
+  build_world(&world, size, obstacles, 11);
+  RescuePlanner incremental, scratch, sliced;
+  int nodes = size * size > RESCUE_PLAN_MAX_NODES ? size * size : RESCUE_PLAN_MAX_NODES; // A from-scratch search may reach every cell
+  if (!rescue_plan_init(&incremental, size, size, nodes, 1e6) || !rescue_plan_init(&scratch, size, size, nodes, 1e6) ||
+      !rescue_plan_init(&sliced, size, size, nodes, slice_ms)) {
+    fprintf(stderr, "cannot allocate the planners\n");
+    return 1;
+  }
+  rescue_plan_set_slice(&incremental, 1e6, false); // Unlimited: every step completes
+  rescue_plan_set_slice(&scratch, 1e6, false);
+  uint32_t *dist = malloc((size_t)size * size * sizeof(*dist));
+  int *queue = malloc((size_t)size * size * sizeof(*queue));
+  bool *queued = malloc((size_t)size * size * sizeof(*queued));
+  printf("grid: %d x %d cells, %d obstacles, sensor radius %d cells | slice %.2f ms = %d expansions\n", size, size,
+         obstacles, BENCH_SENSOR_RADIUS, slice_ms, sliced.max_expansions);
+
+  // --- Incremental vs from scratch, checked against Dijkstra ---
+  int robot = world.start, steps = 0, mismatches = 0;
+  double t_incremental = 0.0, t_scratch = 0.0;
+  unsigned long scratch_expansions = 0;
+  RescuePlanner *both[2] = {&incremental, &scratch};
+  rescue_plan_set_goal(&incremental, world.goal);
+  while (robot != world.goal && steps < BENCH_MAX_STEPS) {
+    sense(&world, both, 2, robot);
+    double t0 = now_seconds();
+    RescuePlanStatus status = rescue_plan_step(&incremental, robot);
+    t_incremental += now_seconds() - t0;
+
+    t0 = now_seconds();
+    rescue_plan_set_goal(&scratch, -1);
+    rescue_plan_set_goal(&scratch, world.goal);
+    unsigned long before = scratch.expansions;
+    rescue_plan_step(&scratch, robot);
+    t_scratch += now_seconds() - t0;
+    scratch_expansions += scratch.expansions - before;
+
+    if (steps % 16 == 0 || status != RESCUE_PLAN_FOUND) {
+      uint32_t want = reference_cost(&incremental, robot, world.goal, dist, queue, queued);
+      uint32_t got = rescue_plan_cost_to_goal(&incremental, robot);
+      if (want != got || rescue_plan_cost_to_goal(&scratch, robot) != want) {
+        if (mismatches++ < 5) printf("  step %d: cost to goal %u, scratch %u, Dijkstra %u\n", steps, got,
+                                     rescue_plan_cost_to_goal(&scratch, robot), want);
+      }
+    }
+    if (status != RESCUE_PLAN_FOUND) break;
+    robot = rescue_plan_next(&incremental, robot);
+    steps++;
+  }
+  bool reached = robot == world.goal;
+  static const char *status_names[] = {"idle", "found", "partial", "no path", "out of nodes"};
+  printf("  %-12s %s (%s) in %d steps, %.1f expansions/step (max %d), %.1f us/step\n", "incremental",
+         reached ? "reached the goal" : "did NOT reach the goal", status_names[incremental.status], steps,
+         (double)incremental.expansions / (steps + 1), incremental.max_step_expansions, t_incremental / (steps + 1) * 1e6);
+  printf("  %-12s %.1f expansions/step (max %d), %.1f us/step  -> incremental is %.1fx faster\n", "from scratch",
+         (double)scratch_expansions / (steps + 1), scratch.max_step_expansions, t_scratch / (steps + 1) * 1e6,
+         t_scratch / t_incremental);
+  printf("  costs checked against Dijkstra: %s\n", mismatches ? "MISMATCH" : "all equal");
+
+  // --- Within the slice, as in the controller ---
+  RescuePlanner *one[1] = {&sliced};
+  rescue_plan_set_goal(&sliced, world.goal);
+  robot = world.start;
+  int sliced_steps = 0, waited = 0;
+  while (robot != world.goal && sliced_steps < BENCH_MAX_STEPS) {
+    sense(&world, one, 1, robot);
+    RescuePlanStatus status = rescue_plan_step(&sliced, robot);
+    sliced_steps++;
+    if (status == RESCUE_PLAN_PARTIAL) { waited++; continue; } // Not repaired yet: wait a step
+    if (status != RESCUE_PLAN_FOUND) break;
+    robot = rescue_plan_next(&sliced, robot);
+  }
+  printf("  %-12s %s in %d steps (%d waiting for the repair) | slowest step %.3f ms of %.2f ms | "
+         "stops: %lu budget, %lu deadline\n", "sliced", robot == world.goal ? "reached the goal" : "did NOT reach the goal",
+         sliced_steps, waited, sliced.max_step_ns / 1e6, slice_ms, sliced.budget_stops, sliced.deadline_stops);
+  printf("  nodes: %d of %d used | memory %.1f MB per planner\n", incremental.used, incremental.max_nodes,
+         rescue_plan_memory(&incremental) / 1048576.0);
+
+  // --- Anytime vs D* Lite, whole grid known, robot waiting at the start ---
+  RescuePlanner anytime;
+  if (!rescue_plan_init(&anytime, size, size, nodes, slice_ms)) {
+    fprintf(stderr, "cannot allocate the planners\n");
+    return 1;
+  }
+  rescue_plan_set_slice(&anytime, slice_ms, false); // Expansion budget only: the same on any host
+  rescue_plan_set_anytime(&anytime, epsilon);
+  rescue_plan_set_goal(&scratch, -1);
+  rescue_plan_set_slice(&scratch, slice_ms, false);
+  for (int c = 0; c < size * size; ++c) {
+    rescue_plan_set_cost(&anytime, c, world.truth[c]);
+    rescue_plan_set_cost(&scratch, c, world.truth[c]);
+  }
+  rescue_plan_set_goal(&anytime, world.goal);
+  rescue_plan_set_goal(&scratch, world.goal);
+  uint32_t optimal = reference_cost(&anytime, world.start, world.goal, dist, queue, queued);
+  printf("anytime, epsilon %.1f, whole grid known, optimal cost %u:\n", epsilon, optimal);
+  int dstar_first = -1, violations = 0;
+  double last_bound = 0.0;
+  for (int step = 0; step < BENCH_MAX_STEPS && (dstar_first < 0 || last_bound != 1.0); ++step) {
+    if (dstar_first < 0 && rescue_plan_step(&scratch, world.start) == RESCUE_PLAN_FOUND) {
+      dstar_first = step;
+      printf("  step %4d: D* Lite path, cost %u\n", step, rescue_plan_cost_to_goal(&scratch, world.start));
+    }
+    if (last_bound == 1.0) continue;
+    RescuePlanStatus status = rescue_plan_step(&anytime, world.start);
+    if (status == RESCUE_PLAN_NO_PATH) break;
+    double bound = rescue_plan_bound(&anytime);
+    if (status != RESCUE_PLAN_FOUND || bound == last_bound) continue;
+    uint32_t cost = rescue_plan_cost_to_goal(&anytime, world.start);
+    violations += cost > bound * optimal + 0.5;
+    printf("  step %4d: anytime path, cost %u (%.3fx optimal) within %.2fx, %lu expansions so far\n", step, cost,
+           (double)cost / optimal, bound, anytime.expansions);
+    last_bound = bound;
+  }
+  if (last_bound == 1.0 && rescue_plan_cost_to_goal(&anytime, world.start) != optimal) violations++;
+  printf("  bounds %s\n", violations ? "VIOLATED" : "held, final path optimal");
+
+  // --- Anytime, discovering the grid ---
+  RescuePlanner discovering;
+  if (!rescue_plan_init(&discovering, size, size, nodes, slice_ms)) {
+    fprintf(stderr, "cannot allocate the planners\n");
+    return 1;
+  }
+  rescue_plan_set_slice(&discovering, slice_ms, false);
+  rescue_plan_set_anytime(&discovering, epsilon);
+  RescuePlanner *any[1] = {&discovering};
+  rescue_plan_set_goal(&discovering, world.goal);
+  robot = world.start;
+  int anytime_steps = 0, anytime_waited = 0;
+  double bound_sum = 0.0;
+  while (robot != world.goal && anytime_steps < BENCH_MAX_STEPS) {
+    sense(&world, any, 1, robot);
+    RescuePlanStatus status = rescue_plan_step(&discovering, robot);
+    anytime_steps++;
+    if (status == RESCUE_PLAN_PARTIAL) { anytime_waited++; continue; }
+    if (status != RESCUE_PLAN_FOUND) break;
+    bound_sum += rescue_plan_bound(&discovering);
+    robot = rescue_plan_next(&discovering, robot);
+  }
+  printf("  %-12s %s in %d steps (%d waiting for a path) | mean bound %.2f | restarts %lu, %.1f expansions/step\n",
+         "discovering", robot == world.goal ? "reached the goal" : "did NOT reach the goal", anytime_steps,
+         anytime_waited, bound_sum / (anytime_steps - anytime_waited > 0 ? anytime_steps - anytime_waited : 1),
+         discovering.restarts, (double)discovering.expansions / anytime_steps);
+  rescue_plan_free(&anytime);
+  rescue_plan_free(&discovering);
+
+  rescue_plan_free(&incremental);
+  rescue_plan_free(&scratch);
+  rescue_plan_free(&sliced);
+  free(world.truth);
+  free(dist);
+  free(queue);
+  free(queued);
+  return mismatches || violations || (!reached && incremental.status != RESCUE_PLAN_NO_PATH) ? 1 : 0; // Walled off goals are fine if Dijkstra agrees
+}
@@ -0,0 +1,113 @@
+/*
+ * Description: Per-step cost of the survivor recognition loop, with and
+ *              without the node classification cache (rescue_recognition.h).
+ *              Stand-in nodes carry a name and a model; the uncached path
+ *              fetches both through a non-inlined accessor (like the
+ *              supervisor API) and matches them against the pattern table
+ *              for every recognized object, as is_survivor() used to.
+ *
+ * Usage: bench_recognition [steps] [objects_per_sensor] [patterns]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../rescue_hal.h"
+#include "../rescue_recognition.h"
+
+#define NUM_NODES 400
+#define NUM_SURVIVOR_NODES 12
+#define MAX_OBJECTS 32
+
+typedef struct {
+  const char *name;
+  const char *model;
+} FakeNode;
+
+static const char *const clutter_names[] = {"wall", "rubble", "box", "floor", "WoodenBox", "RectangleArena"};
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Out of line, like a wb_supervisor_node_get_* call
+__attribute__((noinline)) static const char *node_name(const FakeNode *n) { return n->name; }
+__attribute__((noinline)) static const char *node_model(const FakeNode *n) { return n->model; }
+
+typedef struct {
+  const RescueSurvivorPattern *patterns;
+  int num_patterns;
+} Classifier;
+
+static int classify(void *ctx, const void *node) {
+  const Classifier *c = ctx;
+  return rescue_recognition_match(c->patterns, c->num_patterns, node_name(node), node_model(node));
+}
+
+int main(int argc, char **argv) {
+  long steps = argc > 1 ? atol(argv[1]) : 2000000;
+  int per_sensor = argc > 2 ? atoi(argv[2]) : 6;
+  int num_patterns = argc > 3 ? atoi(argv[3]) : 4;
+  if (per_sensor > MAX_OBJECTS) per_sensor = MAX_OBJECTS;
+  if (num_patterns < 1) num_patterns = 1;
+  if (num_patterns > 8) num_patterns = 8;
+
+  // --- World: clutter plus a few survivors of two classes ---
+  static FakeNode nodes[NUM_NODES];
+  for (int i = 0; i < NUM_NODES; ++i) {
+    nodes[i].name = clutter_names[i % 6];
+    nodes[i].model = "Solid";
+  }
+  for (int i = 0; i < NUM_SURVIVOR_NODES; ++i) {
+    nodes[i * (NUM_NODES / NUM_SURVIVOR_NODES)].name = i % 2 ? "SurvivorObstacle" : "casualty_3";
+    nodes[i * (NUM_NODES / NUM_SURVIVOR_NODES)].model = i % 2 ? "Solid" : "Casualty";
+  }
+  const RescueSurvivorPattern patterns[8] = {
+    {"Debris", NULL, 3}, {NULL, "Mannequin", 4}, {"Victim*", NULL, 5}, {NULL, "Pedestrian", 6},
+    {"Injured*", NULL, 7}, {NULL, "Human", 8}, {"SurvivorObstacle", NULL, 1}, {NULL, "Casualty", 2},
+  };
+  Classifier classifier = {patterns + 8 - num_patterns, num_patterns}; // Survivor rows always included
+
+  // --- Recognition scripts: each sensor sees a drifting window of nodes ---
+  const FakeNode *seen[RESCUE_NUM_DS][MAX_OBJECTS];
+
+  RescueRecognitionCache cache;
+  rescue_recognition_cache_init(&cache);
+  long hits[2] = {0, 0};
+  double elapsed[2];
+  for (int mode = 0; mode < 2; ++mode) { // 0 = uncached, 1 = cached; same script
+    unsigned int lcg = 12345;
+    long window = 0;
+    double t0 = now_seconds();
+    for (long s = 0; s < steps; ++s) {
+      if ((s & 63) == 0) { // The view changes slowly
+        for (int i = 0; i < RESCUE_NUM_DS; ++i)
+          for (int j = 0; j < per_sensor; ++j) {
+            lcg = lcg * 1664525u + 1013904223u;
+            seen[i][j] = &nodes[(window + (lcg >> 16) % 40) % NUM_NODES];
+          }
+        window++;
+      }
+      for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+        for (int j = 0; j < per_sensor; ++j) {
+          int cls = mode == 0 ? classify(&classifier, seen[i][j])
+                              : rescue_recognition_lookup(&cache, seen[i][j], classify, &classifier);
+          if (cls != RESCUE_RECOG_NOT_SURVIVOR) { hits[mode]++; break; }
+        }
+      }
+    }
+    elapsed[mode] = now_seconds() - t0;
+  }
+
+  printf("recognition: %ld steps, %d sensors x %d objects, %d patterns, %d nodes\n", steps, RESCUE_NUM_DS,
+         per_sensor, num_patterns, NUM_NODES);
+  printf("uncached: %8.1f ns/step  (%ld survivor hits)\n", elapsed[0] / steps * 1e9, hits[0]);
+  printf("cached:   %8.1f ns/step  (%ld survivor hits)  speedup %.1fx\n", elapsed[1] / steps * 1e9, hits[1],
+         elapsed[0] / elapsed[1]);
+  printf("cache: %lu lookups, %lu classifier calls (%.4f%%), %d nodes cached, %lu resets\n", cache.lookups,
+         cache.misses, 100.0 * cache.misses / (cache.lookups ? cache.lookups : 1), cache.used, cache.resets);
+  return hits[0] != hits[1];
+}
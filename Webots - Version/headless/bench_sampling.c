@@ -0,0 +1,260 @@
+/*
+ * Description: Recognition sampling benchmark (rescue_recognition.h). The
+ *              controller explores the arena suite for a fixed time as it
+ *              is shipped (stack.h), with recognition on every run of the
+ *              schedule's recognition task (RECOGNIZE_PERIOD), every
+ *              RECOGNIZE_RELAXED_PERIOD, and decimated to
+ *              RECOGNIZE_RELAXED_PERIOD (and half that) while nothing is
+ *              within SURVIVOR_DETECTION_RANGE. Reports the recognitions
+ *              run and the task's runs saved, the share of time at full
+ *              rate, survivors found and the signals that found none (a
+ *              recognition held from earlier paired with a close wall).
+ *
+ *              The detection delay compares the rates on one trajectory:
+ *              the run at the schedule's rate logs every recognition task
+ *              run (readings and what recognition saw), and each rate then
+ *              picks its recognitions from that log. The delay runs from a
+ *              survivor first coming within SURVIVOR_DETECTION_RANGE of a ds
+ *              to the first recognition that reports it there; "missed"
+ *              counts survivors the schedule's rate reported and the rate
+ *              never did.
+ *
+ * Usage: bench_sampling [sim_seconds]
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_MODES 4
+#define BENCH_MAX_SURVIVORS 16
+
+static const char *mode_names[BENCH_MODES] = {"schedule", "fixed 512 ms", "decimated", "decimated 256"};
+
+// The rate of a mode, false for the schedule's own.
+static bool mode_rate(int mode, RescueRecognitionRate *rate) {
+  if (mode == 1) rescue_recognition_rate_init(rate, RECOGNIZE_PERIOD, RECOGNIZE_RELAXED_PERIOD, 0.0, 0);
+  if (mode == 2)
+    rescue_recognition_rate_init(rate, RECOGNIZE_PERIOD, RECOGNIZE_RELAXED_PERIOD, SURVIVOR_DETECTION_RANGE,
+                                 RESCUE_RECOG_HOLD_STEPS);
+  if (mode == 3)
+    rescue_recognition_rate_init(rate, RECOGNIZE_PERIOD, RECOGNIZE_RELAXED_PERIOD / 2, SURVIVOR_DETECTION_RANGE,
+                                 RESCUE_RECOG_HOLD_STEPS);
+  return mode != 0;
+}
+
+// --- Recognition Log ---
+
+typedef struct {
+  double time;
+  double ds[RESCUE_NUM_DS];
+  bool present[RESCUE_NUM_DS];
+  bool in_view;           // Recognition saw any survivor
+  uint32_t close;         // Survivors it saw within SURVIVOR_DETECTION_RANGE, bit s for survivor s
+} Opportunity;
+
+typedef struct {
+  RescueHal inner;
+  const Sim2D *sim;
+  double in_range[BENCH_MAX_SURVIVORS]; // Time first within SURVIVOR_DETECTION_RANGE of a ds, -1 if not yet
+  Opportunity *log;       // NULL: not logging
+  int logged, cap;
+  unsigned long recognitions;
+  int signals, unmatched; // Survivor signals, those that credited no new survivor
+} Watch;
+
+static void watch_sense(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->inner.sense(w->inner.ctx, in);
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    int s = w->sim->ds_survivor[i];
+    if (s >= 0 && s < BENCH_MAX_SURVIVORS && in->ds[i] < SURVIVOR_DETECTION_RANGE && w->in_range[s] < 0.0)
+      w->in_range[s] = in->time;
+  }
+}
+
+static void watch_recognize(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->recognitions++;
+  w->inner.recognize(w->inner.ctx, in);
+  if (!w->log) return;
+  if (w->logged == w->cap) {
+    w->cap = w->cap ? 2 * w->cap : 4096;
+    w->log = realloc(w->log, (size_t)w->cap * sizeof(*w->log));
+    if (!w->log) { fprintf(stderr, "cannot grow the recognition log\n"); exit(1); }
+  }
+  Opportunity *o = &w->log[w->logged++];
+  o->time = in->time;
+  o->in_view = false;
+  o->close = 0;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    o->ds[i] = in->ds[i];
+    o->present[i] = in->ds_present[i];
+    o->in_view |= in->survivor_seen[i];
+    int s = w->sim->ds_survivor[i];
+    if (in->survivor_seen[i] && s >= 0 && s < BENCH_MAX_SURVIVORS && in->ds[i] < SURVIVOR_DETECTION_RANGE)
+      o->close |= 1u << s;
+  }
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static void watch_actuate(void *ctx, const RescueOutputs *out) { Watch *w = ctx; w->inner.actuate(w->inner.ctx, out); }
+static bool watch_emit(void *ctx, const void *d, int n) {
+  Watch *w = ctx;
+  int before = sim_survivors_signaled(w->sim);
+  bool ok = w->inner.emit(w->inner.ctx, d, n);
+  if (n > 0 && strncmp(d, SURVIVOR_MESSAGE, (size_t)n) == 0) {
+    w->signals++;
+    w->unmatched += sim_survivors_signaled(w->sim) == before;
+  }
+  return ok;
+}
+
+// --- Detection Delay on the Logged Trajectory ---
+
+typedef struct {
+  double sum, max;        // Seconds
+  int count, missed;
+} Delay;
+
+// When each survivor is first reported close, picking recognitions from the
+// log with mode's rate; -1 if never.
+static void detect(const Opportunity *log, int count, int mode, double *when) {
+  RescueRecognitionRate rate;
+  bool decimated = mode_rate(mode, &rate), in_view = false;
+  for (int s = 0; s < BENCH_MAX_SURVIVORS; ++s) when[s] = -1.0;
+  for (int k = 0; k < count; ++k) {
+    const Opportunity *o = &log[k];
+    if (decimated && !rescue_recognition_rate_next(&rate, o->ds, o->present, RESCUE_NUM_DS, in_view)) continue;
+    in_view = o->in_view;
+    for (int s = 0; s < BENCH_MAX_SURVIVORS; ++s)
+      if (((o->close >> s) & 1u) && when[s] < 0.0) when[s] = o->time;
+  }
+}
+
+static void delays(const Opportunity *log, int count, const double *in_range, Delay *out) {
+  double base[BENCH_MAX_SURVIVORS], when[BENCH_MAX_SURVIVORS];
+  detect(log, count, 0, base);
+  for (int mode = 0; mode < BENCH_MODES; ++mode) {
+    detect(log, count, mode, when);
+    for (int s = 0; s < BENCH_MAX_SURVIVORS; ++s) {
+      if (base[s] < 0.0 || in_range[s] < 0.0) continue;
+      if (when[s] < 0.0) { out[mode].missed++; continue; }
+      double delay = when[s] - in_range[s];
+      out[mode].sum += delay;
+      out[mode].count++;
+      if (delay > out[mode].max) out[mode].max = delay;
+    }
+  }
+}
+
+// --- Arena Runs ---
+
+typedef struct {
+  unsigned long recognitions, opportunities;
+  double full_rate;       // Share of opportunities escalated
+  int found, total;
+  int unmatched;
+} BenchResult;
+
+// Runs mode; the schedule's own rate also fills delay[] for every mode.
+static BenchResult run(int scenario, int mode, double limit, Delay *delay) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (!mode) config &= ~RESCUE_TRACE_CONFIG_RECOGNITION;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  RescueRecognitionRate *rate = &stack.recognition;
+  mode_rate(mode, rate);
+  const RescueSchedule *schedule = &stack.schedule;
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  for (int i = 0; i < BENCH_MAX_SURVIVORS; ++i) watch.in_range[i] = -1.0;
+  if (mode == 0) {
+    watch.cap = 4096;
+    watch.log = malloc((size_t)watch.cap * sizeof(*watch.log));
+    if (!watch.log) { fprintf(stderr, "cannot allocate the recognition log\n"); exit(1); }
+  }
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.recognitions = watch.recognitions,
+                   .opportunities = mode ? rate->steps : schedule->tasks[RESCUE_TASK_RECOGNIZE].runs,
+                   .full_rate = mode && rate->steps ? (double)rate->escalated_steps / rate->steps : 0.0,
+                   .found = sim_survivors_signaled(&sim), .total = sim.num_survivors, .unmatched = watch.unmatched};
+  if (mode == 0) {
+    delays(watch.log, watch.logged, watch.in_range, delay);
+    free(watch.log);
+  }
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  printf("exploring for %.0f s; recognition task every %d ms, decimated to every %d ms until a reading is within "
+         "%.1f m, then every run until %d runs after\n", limit, RECOGNIZE_PERIOD, RECOGNIZE_RELAXED_PERIOD,
+         SURVIVOR_DETECTION_RANGE, RESCUE_RECOG_HOLD_STEPS);
+  printf("%-15s %-14s %8s %7s %10s %6s %10s %18s %7s\n", "arena", "recognition", "runs", "saved", "full rate",
+         "found", "unmatched", "delay s (max)", "missed");
+  unsigned long runs[BENCH_MODES] = {0}, opportunities[BENCH_MODES] = {0};
+  double full_rate[BENCH_MODES] = {0.0};
+  int found[BENCH_MODES] = {0}, unmatched[BENCH_MODES] = {0}, total = 0, arenas = 0;
+  Delay delay_total[BENCH_MODES];
+  memset(delay_total, 0, sizeof(delay_total));
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    arenas++;
+    Delay delay[BENCH_MODES];
+    memset(delay, 0, sizeof(delay));
+    BenchResult r[BENCH_MODES];
+    for (int mode = 0; mode < BENCH_MODES; ++mode) r[mode] = run(scenario, mode, limit, delay);
+    for (int mode = 0; mode < BENCH_MODES; ++mode) {
+      printf("%-15s %-14s %8lu %6.0f%% %9.0f%% %3d/%-2d %10d %8.2f (%5.2f) %7d\n", mode ? "" : name,
+             mode_names[mode], r[mode].recognitions,
+             r[mode].opportunities ? 100.0 * (1.0 - (double)r[mode].recognitions / r[mode].opportunities) : 0.0,
+             100.0 * r[mode].full_rate, r[mode].found, r[mode].total, r[mode].unmatched,
+             delay[mode].count ? delay[mode].sum / delay[mode].count : 0.0, delay[mode].max, delay[mode].missed);
+      runs[mode] += r[mode].recognitions;
+      opportunities[mode] += r[mode].opportunities;
+      full_rate[mode] += r[mode].full_rate;
+      found[mode] += r[mode].found;
+      unmatched[mode] += r[mode].unmatched;
+      delay_total[mode].sum += delay[mode].sum;
+      delay_total[mode].count += delay[mode].count;
+      delay_total[mode].missed += delay[mode].missed;
+      if (delay[mode].max > delay_total[mode].max) delay_total[mode].max = delay[mode].max;
+      if (!mode) total += r[mode].total;
+    }
+  }
+  for (int mode = 0; mode < BENCH_MODES; ++mode)
+    printf("%-14s %lu recognitions (%.0f%% of the task's runs saved), %.0f%% at full rate, survivors %d/%d, "
+           "%d unmatched signals, detection delay %.2f s (max %.2f, %d missed)\n", mode_names[mode], runs[mode],
+           opportunities[mode] ? 100.0 * (1.0 - (double)runs[mode] / opportunities[mode]) : 0.0,
+           100.0 * full_rate[mode] / arenas, found[mode], total, unmatched[mode],
+           delay_total[mode].count ? delay_total[mode].sum / delay_total[mode].count : 0.0, delay_total[mode].max,
+           delay_total[mode].missed);
+  return 0;
+}
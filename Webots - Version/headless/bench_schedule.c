@@ -0,0 +1,184 @@
+/*
+ * Description: Multi-rate schedule benchmark (rescue_schedule.h). The
+ *              controller explores the arena suite for a fixed time as it
+ *              is shipped (stack.h), and turning on the spot instead of
+ *              steering with histogram and dynamic window; each with every
+ *              task every TIME_STEP and with the multi-rate tasks. Reports the
+ *              controller's CPU time per simulated second (the whole step
+ *              without the simulator's sensing), the obstacle reaction time
+ *              (from the front reading crossing OBSTACLE_DISTANCE_THRESHOLD,
+ *              interpolated between samples, while the robot searches
+ *              forward, to the step that stops searching forward), survivors,
+ *              collisions, and the control steps, recognitions and
+ *              exploration updates run.
+ *
+ * Usage: bench_schedule [sim_seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_STEERING 2
+#define BENCH_RATES 2
+
+static const char *steering_names[BENCH_STEERING] = {"default", "spin"};
+static const char *rate_names[BENCH_RATES] = {"single rate", "multi-rate"};
+
+// --- Obstacle Reaction Time ---
+
+typedef struct {
+  RescueHal inner;
+  const Sim2D *sim;
+  const RescueController *controller;
+  double last_front, last_time;
+  bool forward;           // Searching forward as of the last actuation
+  double crossed;         // Time the front crossed the threshold, -1 if not waiting for a reaction
+  int reactions;
+  double reaction_sum, reaction_max;
+  int recognitions;
+} Watch;
+
+static void watch_sense(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->inner.sense(w->inner.ctx, in);
+  double front = in->ds[RESCUE_DS_FRONT];
+  if (front >= OBSTACLE_DISTANCE_THRESHOLD) {
+    w->crossed = -1.0; // Clear again (or steered past) before a reaction: not counted
+  } else if (w->crossed < 0.0 && w->forward && w->last_front >= OBSTACLE_DISTANCE_THRESHOLD) {
+    double f = (w->last_front - OBSTACLE_DISTANCE_THRESHOLD) / (w->last_front - front);
+    w->crossed = w->last_time + f * (in->time - w->last_time);
+  }
+  w->last_front = front;
+  w->last_time = in->time;
+}
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  w->forward = w->controller->current_state == SEARCHING && out->left_speed + out->right_speed > 0.0;
+  if (w->crossed >= 0.0 && !w->forward) {
+    double reaction = w->sim->time - w->crossed;
+    w->reactions++;
+    w->reaction_sum += reaction;
+    if (reaction > w->reaction_max) w->reaction_max = reaction;
+    w->crossed = -1.0;
+  }
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static void watch_recognize(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->recognitions++;
+  w->inner.recognize(w->inner.ctx, in);
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static bool watch_emit(void *ctx, const void *d, int n) { Watch *w = ctx; return w->inner.emit(w->inner.ctx, d, n); }
+
+// --- Arena Runs ---
+
+typedef struct {
+  double cpu_us;          // Controller time per simulated second
+  double reaction_mean, reaction_max; // ms
+  int reactions;
+  int found, total;
+  long collisions;
+  unsigned long controls, recognitions, plans;
+} BenchResult;
+
+static BenchResult run(int scenario, int steering, int rate, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (steering == 1) config &= ~(RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA);
+  if (!rate) config &= ~RESCUE_TRACE_CONFIG_SCHEDULE;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  RescueController *controller = &stack.controller;
+  const RescueSchedule *schedule = &stack.schedule;
+  static RescueProfile profile;
+  rescue_profile_init(&profile, stack.tick_ms);
+  controller->profile = &profile;
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  watch.controller = controller;
+  watch.last_front = RESCUE_DS_MISSING;
+  watch.crossed = -1.0;
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, controller);
+
+  const RescueHistogram *phase = profile.phase;
+  double cpu_ns = (double)phase[RESCUE_PHASE_STEP].sum_ns - (double)phase[RESCUE_PHASE_SENSE].sum_ns;
+  BenchResult r = {.cpu_us = sim.time > 0.0 ? cpu_ns / 1e3 / sim.time : 0.0,
+                   .reaction_mean = watch.reactions ? 1e3 * watch.reaction_sum / watch.reactions : 0.0,
+                   .reaction_max = 1e3 * watch.reaction_max, .reactions = watch.reactions,
+                   .found = sim_survivors_signaled(&sim), .total = sim.num_survivors, .collisions = sim.collisions,
+                   .controls = rate ? schedule->tasks[RESCUE_TASK_CONTROL].runs : (unsigned long)sim.steps,
+                   .recognitions = (unsigned long)watch.recognitions,
+                   .plans = rate ? schedule->tasks[RESCUE_TASK_PLAN].runs : (unsigned long)sim.steps};
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  RescueSchedule schedule;
+  rescue_tasks_init(&schedule);
+  printf("exploring for %.0f s; multi-rate: %d ms ticks, reflex %d ms, control %d ms, recognition %d ms, "
+         "exploration %d ms\n", limit, schedule.tick_ms, REFLEX_PERIOD, TIME_STEP, RECOGNIZE_PERIOD, PLAN_PERIOD);
+  printf("%-15s %-8s %-12s %10s %16s %6s %6s %10s %8s %8s %8s\n", "arena", "steering", "rate", "cpu us/s",
+         "reaction ms", "(n)", "found", "collisions", "control", "recog", "explore");
+  double cpu[BENCH_STEERING][BENCH_RATES] = {{0.0}}, reaction[BENCH_STEERING][BENCH_RATES] = {{0.0}};
+  double reaction_max[BENCH_STEERING][BENCH_RATES] = {{0.0}};
+  int reactions[BENCH_STEERING][BENCH_RATES] = {{0}}, found[BENCH_STEERING][BENCH_RATES] = {{0}};
+  long collisions[BENCH_STEERING][BENCH_RATES] = {{0}};
+  int total = 0, arenas = 0;
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    arenas++;
+    for (int steering = 0; steering < BENCH_STEERING; ++steering) {
+      for (int rate = 0; rate < BENCH_RATES; ++rate) {
+        BenchResult r = run(scenario, steering, rate, limit);
+        printf("%-15s %-8s %-12s %10.1f %7.0f (max %3.0f) %6d %3d/%-2d %10ld %8lu %8lu %8lu\n",
+               steering || rate ? "" : name, rate ? "" : steering_names[steering], rate_names[rate], r.cpu_us,
+               r.reaction_mean, r.reaction_max, r.reactions, r.found, r.total, r.collisions, r.controls,
+               r.recognitions, r.plans);
+        cpu[steering][rate] += r.cpu_us;
+        reaction[steering][rate] += r.reaction_mean * r.reactions;
+        reactions[steering][rate] += r.reactions;
+        if (r.reaction_max > reaction_max[steering][rate]) reaction_max[steering][rate] = r.reaction_max;
+        found[steering][rate] += r.found;
+        collisions[steering][rate] += r.collisions;
+        if (!steering && !rate) total += r.total;
+      }
+    }
+  }
+  for (int steering = 0; steering < BENCH_STEERING; ++steering)
+    for (int rate = 0; rate < BENCH_RATES; ++rate)
+      printf("%-8s %-12s %.1f us of CPU per simulated second, obstacle reaction %.0f ms (max %.0f, %d), "
+             "survivors %d/%d, %ld collisions\n", steering_names[steering], rate_names[rate], cpu[steering][rate] / arenas,
+             reactions[steering][rate] ? reaction[steering][rate] / reactions[steering][rate] : 0.0,
+             reaction_max[steering][rate], reactions[steering][rate], found[steering][rate], total,
+             collisions[steering][rate]);
+  return 0;
+}
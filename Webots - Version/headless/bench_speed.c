@@ -0,0 +1,135 @@
+/*
+ * Description: Speed governor benchmark (rescue_speed.h). The controller
+ *              explores the arena suite for a fixed time as it is shipped
+ *              (stack.h), turning on the spot away from obstacles, steering
+ *              with the polar histogram, and with the histogram and the
+ *              dynamic window; each of them at FORWARD_SPEED, at the
+ *              motor's top speed, and at the top speed under the
+ *              time-to-collision governor. Reports the area covered per
+ *              minute (cells of BENCH_CELL meters the robot's center passed
+ *              through), collisions, survivors found, the average speed
+ *              scale and the smallest time to collision seen.
+ *
+ * Usage: bench_speed [sim_seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_STEERING 3
+#define BENCH_SPEEDS 3
+#define BENCH_CELL 0.2            // Coverage cell (meters)
+#define BENCH_CELLS 128           // Coverage grid side, from the origin
+
+static const char *steering_names[BENCH_STEERING] = {"spin", "vfh", "vfh+dwa"};
+static const char *speed_names[BENCH_SPEEDS] = {"5.0", "6.28", "6.28 ttc"};
+
+// --- Coverage ---
+
+typedef struct {
+  RescueHal inner;
+  const Sim2D *sim;
+  unsigned char seen[BENCH_CELLS * BENCH_CELLS];
+  long cells;
+} Watch;
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  int cx = (int)floor(w->sim->x / BENCH_CELL), cy = (int)floor(w->sim->y / BENCH_CELL);
+  if (cx >= 0 && cx < BENCH_CELLS && cy >= 0 && cy < BENCH_CELLS && !w->seen[cy * BENCH_CELLS + cx]) {
+    w->seen[cy * BENCH_CELLS + cx] = 1;
+    w->cells++;
+  }
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static void watch_sense(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.sense(w->inner.ctx, in); }
+static void watch_recognize(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.recognize(w->inner.ctx, in); }
+static bool watch_emit(void *ctx, const void *d, int n) { Watch *w = ctx; return w->inner.emit(w->inner.ctx, d, n); }
+
+// --- Arena Runs ---
+
+typedef struct {
+  double coverage;        // m^2 per minute
+  long collisions;
+  int found, total;
+  double scale;           // Average governor scale, 0 without one
+  double min_ttc;
+} BenchResult;
+
+static BenchResult run(int scenario, int steering, int speed, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (steering == 0) config &= ~(RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA);
+  if (steering == 1) config &= ~RESCUE_TRACE_CONFIG_DWA;
+  if (!speed) config &= ~RESCUE_TRACE_CONFIG_SPEED; // The dynamic window at FORWARD_SPEED as well
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  RescueSpeed *governor = &stack.governor;
+  governor->governed = speed == 2;
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.coverage = watch.cells * BENCH_CELL * BENCH_CELL / (sim.time / 60.0), .collisions = sim.collisions,
+                   .found = sim_survivors_signaled(&sim), .total = sim.num_survivors, .min_ttc = governor->min_ttc};
+  if (speed == 2 && governor->updates) r.scale = governor->scale_sum / governor->updates;
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 180.0;
+  printf("exploring for %.0f s; coverage in %.1f m cells, wheel speeds in rad/s\n", limit, BENCH_CELL);
+  printf("%-15s %-8s %-9s %12s %10s %6s %6s %8s\n", "arena", "steer", "speed", "coverage", "collisions", "found",
+         "scale", "min ttc");
+  double coverage[BENCH_STEERING][BENCH_SPEEDS] = {{0.0}};
+  long collisions[BENCH_STEERING][BENCH_SPEEDS] = {{0}};
+  int found[BENCH_STEERING][BENCH_SPEEDS] = {{0}}, total = 0, arenas = 0;
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    arenas++;
+    for (int steering = 0; steering < BENCH_STEERING; ++steering)
+      for (int speed = 0; speed < BENCH_SPEEDS; ++speed) {
+        BenchResult r = run(scenario, steering, speed, limit);
+        printf("%-15s %-8s %-9s %7.2fm2/min %10ld %3d/%-2d", steering || speed ? "" : name,
+               speed ? "" : steering_names[steering], speed_names[speed], r.coverage, r.collisions, r.found, r.total);
+        if (speed == 2) printf(" %6.2f %7.2fs", r.scale, r.min_ttc);
+        printf("\n");
+        coverage[steering][speed] += r.coverage;
+        collisions[steering][speed] += r.collisions;
+        found[steering][speed] += r.found;
+        if (!steering && !speed) total += r.total;
+      }
+  }
+  for (int steering = 0; steering < BENCH_STEERING; ++steering)
+    for (int speed = 0; speed < BENCH_SPEEDS; ++speed)
+      printf("%-8s %-9s %6.2f m2/min on average, %ld collisions, survivors %d/%d\n", steering_names[steering],
+             speed_names[speed], coverage[steering][speed] / arenas, collisions[steering][speed],
+             found[steering][speed], total);
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Description: Stuck detector benchmark (rescue_stuck.h). The controller
+ *              explores the arena suite, among them the narrow passages of
+ *              arena_passages, for a fixed time as it is shipped
+ *              (stack.h), turning on the spot away from obstacles,
+ *              steering with the polar histogram, and with the histogram
+ *              and the dynamic window; each of them without and with the
+ *              detector. Reports the area covered per minute, survivors
+ *              found, collisions, the time spent stuck (the simulated robot
+ *              moved less than BENCH_STUCK_DISTANCE over the last
+ *              BENCH_STUCK_TIME seconds while meant to drive), state flips
+ *              per minute and the escapes (those that followed the wall in
+ *              brackets).
+ *
+ * Usage: bench_stuck [sim_seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_STEERING 3
+#define BENCH_CELL 0.2            // Coverage cell (meters)
+#define BENCH_CELLS 128           // Coverage grid side, from the origin
+#define BENCH_STUCK_TIME 6.0      // Seconds the robot ...
+#define BENCH_STUCK_RING 512      // Positions kept, enough for BENCH_STUCK_TIME at the shortest tick
+#define BENCH_STUCK_DISTANCE 0.1  // ... moves less than this (meters) while driving: stuck
+
+static const char *steering_names[BENCH_STEERING] = {"spin", "vfh", "vfh+dwa"};
+
+// --- Coverage & Time Stuck ---
+
+typedef struct {
+  RescueHal inner;
+  const Sim2D *sim;
+  const RescueController *controller;
+  unsigned char seen[BENCH_CELLS * BENCH_CELLS];
+  long cells;
+  double x[BENCH_STUCK_RING], y[BENCH_STUCK_RING]; // True positions, a ring
+  int window;             // Ticks in BENCH_STUCK_TIME
+  int head, filled;
+  long stuck_steps;
+  long flips;
+} Watch;
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  int cx = (int)floor(w->sim->x / BENCH_CELL), cy = (int)floor(w->sim->y / BENCH_CELL);
+  if (cx >= 0 && cx < BENCH_CELLS && cy >= 0 && cy < BENCH_CELLS && !w->seen[cy * BENCH_CELLS + cx]) {
+    w->seen[cy * BENCH_CELLS + cx] = 1;
+    w->cells++;
+  }
+  RobotState state = w->controller->current_state;
+  w->flips += w->controller->flipped;
+  if (state == SEARCHING || state == AVOIDING_OBSTACLE) {
+    w->x[w->head] = w->sim->x;
+    w->y[w->head] = w->sim->y;
+    w->head = (w->head + 1) % w->window;
+    if (w->filled < w->window) w->filled++;
+    else w->stuck_steps += hypot(w->sim->x - w->x[w->head], w->sim->y - w->y[w->head]) < BENCH_STUCK_DISTANCE;
+  } else {
+    w->head = w->filled = 0;
+  }
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static void watch_sense(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.sense(w->inner.ctx, in); }
+static void watch_recognize(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.recognize(w->inner.ctx, in); }
+static bool watch_emit(void *ctx, const void *d, int n) { Watch *w = ctx; return w->inner.emit(w->inner.ctx, d, n); }
+
+// --- Arena Runs ---
+
+typedef struct {
+  double coverage;        // m^2 per minute
+  int found, total;
+  long collisions;
+  double stuck;           // Seconds
+  double flips;           // Per minute
+  unsigned long escapes, wall_follows;
+} BenchResult;
+
+static BenchResult run(int scenario, int steering, bool detect, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (steering == 0) config &= ~(RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA);
+  if (steering == 1) config &= ~RESCUE_TRACE_CONFIG_DWA;
+  if (!detect) config &= ~RESCUE_TRACE_CONFIG_STUCK;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  watch.controller = &stack.controller;
+  watch.window = (int)(BENCH_STUCK_TIME * 1000.0 / stack.tick_ms);
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.coverage = watch.cells * BENCH_CELL * BENCH_CELL / (sim.time / 60.0),
+                   .found = sim_survivors_signaled(&sim), .total = sim.num_survivors, .collisions = sim.collisions,
+                   .stuck = watch.stuck_steps * stack.tick_ms / 1000.0, .flips = watch.flips / (sim.time / 60.0),
+                   .escapes = stack.stuck.escapes, .wall_follows = stack.stuck.wall_follows};
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  printf("exploring for %.0f s at %.2f rad/s governed; stuck: moved less than %.2f m in %.1f s\n", limit,
+         RESCUE_SPEED_TOP, BENCH_STUCK_DISTANCE, BENCH_STUCK_TIME);
+  printf("%-15s %-8s %-8s %12s %6s %10s %8s %9s %10s\n", "arena", "steer", "detector", "coverage", "found",
+         "collisions", "stuck", "flips", "escapes");
+  double coverage[BENCH_STEERING][2] = {{0.0}}, stuck[BENCH_STEERING][2] = {{0.0}};
+  long collisions[BENCH_STEERING][2] = {{0}};
+  int found[BENCH_STEERING][2] = {{0}}, total = 0, arenas = 0;
+  unsigned long escapes[BENCH_STEERING][2] = {{0}};
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    arenas++;
+    for (int steering = 0; steering < BENCH_STEERING; ++steering)
+      for (int detect = 0; detect < 2; ++detect) {
+        BenchResult r = run(scenario, steering, detect, limit);
+        printf("%-15s %-8s %-8s %7.2fm2/min %3d/%-2d %10ld %7.1fs %5.1f/min", steering || detect ? "" : name,
+               detect ? "" : steering_names[steering], detect ? "on" : "off", r.coverage, r.found, r.total,
+               r.collisions, r.stuck, r.flips);
+        if (detect) printf(" %5lu (%lu)", r.escapes, r.wall_follows);
+        printf("\n");
+        coverage[steering][detect] += r.coverage;
+        stuck[steering][detect] += r.stuck;
+        collisions[steering][detect] += r.collisions;
+        found[steering][detect] += r.found;
+        escapes[steering][detect] += r.escapes;
+        if (!steering && !detect) total += r.total;
+      }
+  }
+  for (int steering = 0; steering < BENCH_STEERING; ++steering)
+    for (int detect = 0; detect < 2; ++detect)
+      printf("%-8s detector %-3s %5.2f m2/min on average, survivors %d/%d, %ld collisions, %.0f s stuck, %lu escapes\n",
+             steering_names[steering], detect ? "on" : "off", coverage[steering][detect] / arenas,
+             found[steering][detect], total, collisions[steering][detect], stuck[steering][detect],
+             escapes[steering][detect]);
+  return 0;
+}
@@ -0,0 +1,68 @@
+/*
+ * Description: Swarm scaling benchmark. Runs the same swarm on 1..N threads
+ *              of the work-stealing pool and reports robot-steps/s, speedup
+ *              and parallel efficiency, plus coverage and a checksum that
+ *              must not change with the thread count.
+ *
+ * Usage: bench_swarm [robots] [steps] [max_threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "swarm.h"
+#include "workpool.h"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  int robots = argc > 1 ? atoi(argv[1]) : 10000;
+  int steps = argc > 2 ? atoi(argv[2]) : 200;
+  int max_threads = argc > 3 ? atoi(argv[3]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+  if (max_threads < 1) max_threads = 1;
+
+  Sim2D world;
+  sim_init(&world);
+  arena_rubble(&world, 100.0, 5000, 200, 7);
+  raygrid_build(&world.grid, 0.0f);
+
+  printf("swarm: %d robots, %d steps, arena 100 x 100 m with %d segments, %d survivors\n",
+         robots, steps, world.num_walls, world.num_survivors);
+  printf("threads  robot-steps/s   speedup  efficiency  steals  coverage  signaled  collisions  checksum\n");
+
+  double base = 0.0;
+  unsigned long reference = 0;
+  int mismatch = 0;
+  for (int threads = 1; threads <= max_threads; threads = threads < 2 ? threads + 1 : threads * 2) {
+    Swarm swarm;
+    swarm_init(&swarm, &world, robots, 42, threads);
+    WorkPool *pool = workpool_create(threads);
+
+    double t0 = now_seconds();
+    for (int k = 0; k < steps; ++k) swarm_step(&swarm, pool, TIME_STEP / 1000.0);
+    double elapsed = now_seconds() - t0;
+
+    double rate = (double)robots * steps / elapsed;
+    if (threads == 1) base = rate;
+    unsigned long sum = swarm_checksum(&swarm);
+    if (threads == 1) reference = sum; else mismatch |= sum != reference;
+    printf("%7d  %13.3e  %8.2f  %9.0f%%  %6ld  %7.1f%%  %8d  %10ld  %016lx\n",
+           threads, rate, rate / base, 100.0 * rate / base / threads, workpool_steals(pool),
+           100.0 * swarm_coverage(&swarm), swarm_survivors_signaled(&swarm), swarm_collisions(&swarm), sum);
+
+    workpool_destroy(pool);
+    swarm_free(&swarm);
+  }
+  if (mismatch) printf("ERROR: results depend on the thread count\n");
+  sim_free(&world);
+  return mismatch;
+}
@@ -0,0 +1,208 @@
+/*
+ * Description: Tilt estimator benchmark (rescue_tilt.h). The controller
+ *              explores the arena suite for a fixed time as it is shipped
+ *              (stack.h), the simple arena with a graded hill whose
+ *              top is past TILT_THRESHOLD, with a clean accelerometer and a
+ *              noisy one (BENCH_ACCEL_NOISE on every axis, and BENCH_BUMP
+ *              spikes while moving); each on single samples, with the
+ *              debounced trigger, with the estimator and with the estimator
+ *              and a gyro. Reports tilt halts on ground below the threshold
+ *              and the time spent halted on it, the time driven on ground
+ *              past it, the mean speed when driving onto it, the estimator's
+ *              mean speed scale, and survivors found.
+ *
+ * Usage: bench_tilt [sim_seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_MODES 4
+#define BENCH_ACCEL_NOISE 1.0      // Standard deviation of an accelerometer axis (m/s^2)
+#define BENCH_BUMP 0.02            // Chance per sample while moving of a bump ...
+#define BENCH_BUMP_ACCEL 5.0       // ... of this standard deviation (m/s^2) on every axis
+#define BENCH_GYRO_NOISE 0.05      // Standard deviation of a gyro axis (rad/s)
+
+static const char *mode_names[BENCH_MODES] = {"raw", "debounced", "estimator", "estimator+gyro"};
+
+// --- Noisy Sensors & True Tilt ---
+
+typedef struct {
+  RescueHal inner;
+  Sim2D *sim;
+  const RescueController *controller;
+  bool noisy;
+  unsigned int seed;
+  RobotState last_state;
+  double last_time;
+  bool steep;             // The ground under the robot is past TILT_THRESHOLD
+  long false_halts;
+  double false_halted;    // Seconds halted as tilted on ground below the threshold
+  double steep_driven;    // Seconds driven on ground past it
+  int climbs;             // Drives onto such ground ...
+  double climb_speed;     // ... and the sum of the speeds (m/s) at those
+} Watch;
+
+static double uniform(Watch *w) {
+  w->seed = w->seed * 1103515245u + 12345u;
+  return ((w->seed >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+static double gaussian(Watch *w) { // Box-Muller
+  double u = uniform(w), v = uniform(w);
+  return sqrt(-2.0 * log(u + 1e-12)) * cos(2.0 * M_PI * v);
+}
+
+static bool ground_steep(const Sim2D *sim) {
+  double roll, pitch;
+  sim_ground_tilt(sim, &roll, &pitch);
+  return SIM_GRAVITY * fmax(fabs(sin(roll)), fabs(sin(pitch))) > TILT_THRESHOLD;
+}
+
+static void watch_sense(void *ctx, RescueInputs *in) {
+  Watch *w = ctx;
+  w->inner.sense(w->inner.ctx, in);
+  if (!w->noisy) return;
+  bool bump = fabs(w->sim->speed) > 0.01 && uniform(w) < BENCH_BUMP;
+  if (in->has_accel)
+    for (int k = 0; k < 3; ++k) in->accel[k] += BENCH_ACCEL_NOISE * gaussian(w) + (bump ? BENCH_BUMP_ACCEL * gaussian(w) : 0.0);
+  if (in->has_gyro)
+    for (int k = 0; k < 3; ++k) in->gyro[k] += BENCH_GYRO_NOISE * gaussian(w);
+}
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  RobotState state = w->controller->current_state;
+  bool steep = ground_steep(w->sim);
+  double dt = w->sim->time - w->last_time;
+  if (state == ROBOT_TILTED && !steep) {
+    w->false_halts += w->last_state != ROBOT_TILTED;
+    w->false_halted += dt;
+  }
+  if (state != ROBOT_TILTED && steep) w->steep_driven += dt;
+  if (steep && !w->steep) {
+    w->climbs++;
+    w->climb_speed += fabs(w->sim->speed);
+  }
+  w->steep = steep;
+  w->last_state = state;
+  w->last_time = w->sim->time;
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static void watch_recognize(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.recognize(w->inner.ctx, in); }
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static bool watch_emit(void *ctx, const void *d, int n) { Watch *w = ctx; return w->inner.emit(w->inner.ctx, d, n); }
+
+// --- Arena Runs ---
+
+typedef struct {
+  long false_halts;
+  double false_halted, steep_driven; // Seconds
+  int climbs;
+  double climb_speed;     // Mean, m/s
+  double scale;           // Mean speed scale of the estimator
+  int found, total;
+} BenchResult;
+
+// The arena suite, with a hill in the simple arena
+static bool build_arena(Sim2D *sim, int scenario, char *name, size_t size) {
+  if (!arena_suite(sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, size)) return false;
+  if (scenario == 0) {
+    // A hill steepening toward its top, steepest first (the first zone containing the robot wins)
+    const double pitch[4] = {24.0, 16.0, 10.0, 5.0}, half[4] = {0.15, 0.25, 0.35, 0.45};
+    for (int k = 0; k < 4; ++k)
+      sim_add_tilt_zone(sim, 3.4 - half[k], 1.9 - half[k], 3.4 + half[k], 1.9 + half[k], 0.0, pitch[k] * M_PI / 180.0);
+    snprintf(name, size, "simple 4x4 hill");
+  }
+  return true;
+}
+
+static BenchResult run(int scenario, int mode, bool noisy, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  build_arena(&sim, scenario, name, sizeof(name));
+  sim.has_gyro = mode == 3;
+  uint32_t config = SIM_STACK_DEFAULT;
+  if (!mode) config &= ~RESCUE_TRACE_CONFIG_TRIGGERS;
+  if (mode < 2) config &= ~RESCUE_TRACE_CONFIG_TILT;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) {
+    fprintf(stderr, "cannot allocate the map\n");
+    exit(1);
+  }
+  const RescueController *controller = &stack.controller;
+  const RescueTilt *tilt = &stack.tilt;
+
+  static Watch watch;
+  memset(&watch, 0, sizeof(watch));
+  watch.sim = &sim;
+  watch.controller = controller;
+  watch.noisy = noisy;
+  watch.seed = 12345u + (unsigned int)scenario;
+  watch.last_state = controller->current_state;
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.false_halts = watch.false_halts, .false_halted = watch.false_halted,
+                   .steep_driven = watch.steep_driven, .climbs = watch.climbs,
+                   .climb_speed = watch.climbs ? watch.climb_speed / watch.climbs : 0.0,
+                   .scale = controller->tilt && tilt->updates ? tilt->scale_sum / tilt->updates : 1.0,
+                   .found = sim_survivors_signaled(&sim), .total = sim.num_survivors};
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  printf("exploring for %.0f s; threshold %.1f m/s^2; noise: accel %.1f m/s^2, %.0f%% bumps of %.1f m/s^2 while "
+         "moving, gyro %.2f rad/s\n", limit, TILT_THRESHOLD, BENCH_ACCEL_NOISE, 100.0 * BENCH_BUMP, BENCH_BUMP_ACCEL,
+         BENCH_GYRO_NOISE);
+  printf("%-16s %-6s %-15s %12s %10s %10s %14s %6s %6s\n", "arena", "accel", "tilt", "false halts", "halted s",
+         "steep s", "climb m/s (n)", "scale", "found");
+  long false_halts[2][BENCH_MODES] = {{0}};
+  double false_halted[2][BENCH_MODES] = {{0.0}}, steep_driven[2][BENCH_MODES] = {{0.0}};
+  double climb_speed[2][BENCH_MODES] = {{0.0}};
+  int climbs[2][BENCH_MODES] = {{0}}, found[2][BENCH_MODES] = {{0}}, total = 0;
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = build_arena(&probe, scenario, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    for (int noisy = 0; noisy < 2; ++noisy) {
+      for (int mode = 0; mode < BENCH_MODES; ++mode) {
+        BenchResult r = run(scenario, mode, noisy, limit);
+        printf("%-16s %-6s %-15s %12ld %10.1f %10.1f %8.3f (%3d) %6.3f %3d/%-2d\n", noisy || mode ? "" : name,
+               mode ? "" : noisy ? "noisy" : "clean", mode_names[mode], r.false_halts, r.false_halted,
+               r.steep_driven, r.climb_speed, r.climbs, r.scale, r.found, r.total);
+        false_halts[noisy][mode] += r.false_halts;
+        false_halted[noisy][mode] += r.false_halted;
+        steep_driven[noisy][mode] += r.steep_driven;
+        climb_speed[noisy][mode] += r.climb_speed * r.climbs;
+        climbs[noisy][mode] += r.climbs;
+        found[noisy][mode] += r.found;
+        if (!noisy && !mode) total += r.total;
+      }
+    }
+  }
+  for (int noisy = 0; noisy < 2; ++noisy)
+    for (int mode = 0; mode < BENCH_MODES; ++mode)
+      printf("%-6s %-15s %ld false halts (%.1f s halted), %.1f s driven past the threshold, climbing at %.3f m/s "
+             "(%d), survivors %d/%d\n", noisy ? "noisy" : "clean", mode_names[mode], false_halts[noisy][mode],
+             false_halted[noisy][mode], steep_driven[noisy][mode],
+             climbs[noisy][mode] ? climb_speed[noisy][mode] / climbs[noisy][mode] : 0.0, climbs[noisy][mode],
+             found[noisy][mode], total);
+  return 0;
+}
@@ -0,0 +1,203 @@
+/*
+ * Description: Polar-histogram avoidance benchmark (rescue_vfh.h). First
+ *              the histogram kernels: random obstacle points, as many as a
+ *              layout of 3 to 16 sensors leaves in the point memory, go
+ *              through the scalar and the vector kernel, which must build
+ *              the same histograms; reports histograms per millisecond.
+ *              Then the controller searches the arena suite straight ahead
+ *              (no map) turning on the spot away from obstacles, and with
+ *              the histogram on the three ds and on a fan of 8 and 16
+ *              range sensors. Reports survivors found, time, distance,
+ *              collisions, the share of steps spent avoiding and how often
+ *              a turn on the spot went the other way from the one just
+ *              before (oscillation).
+ *
+ * Usage: bench_vfh [sim_seconds] [histograms]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+#define BENCH_MODES 4
+#define BENCH_DISTINCT_SCANS 256  // Pre-generated point sets, replayed in a loop
+#define BENCH_FLIP_WINDOW 16      // Steps within which a turn the other way counts as a flip
+
+static const char *mode_names[BENCH_MODES] = {"spin", "vfh 3", "vfh 8", "vfh 16"};
+static const int mode_sensors[BENCH_MODES] = {0, 3, 8, 16}; // 3: the ds themselves
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// --- Kernels ---
+
+// Histograms per ms with the scalar and vector kernels on sets of n points;
+// false if they differ.
+static bool bench_kernels(int n, long count) {
+  static RescueVfh scans[BENCH_DISTINCT_SCANS];
+  for (int s = 0; s < BENCH_DISTINCT_SCANS; ++s) {
+    rescue_vfh_init(&scans[s]);
+    scans[s].num_points = n;
+    for (int i = 0; i < n; ++i) {
+      double d = 0.08 + (RESCUE_VFH_RANGE - 0.08) * rand() / (double)RAND_MAX;
+      scans[s].bearing[i] = (float)(2.0 * M_PI * rand() / ((double)RAND_MAX + 1.0));
+      scans[s].spread[i] = (float)(d > RESCUE_VFH_CLEARANCE ? asin(RESCUE_VFH_CLEARANCE / d) : M_PI / 2.0);
+      scans[s].weight[i] = (float)(RESCUE_VFH_RANGE - d);
+    }
+  }
+  RescueVfh scalar, simd;
+  rescue_vfh_init(&scalar);
+  rescue_vfh_init(&simd);
+  scalar.simd = false;
+  double elapsed[2];
+  bool same = true;
+  for (int k = 0; k < 2; ++k) {
+    RescueVfh *v = k ? &simd : &scalar;
+    double t0 = now_seconds();
+    for (long c = 0; c < count; ++c) {
+      const RescueVfh *s = &scans[c % BENCH_DISTINCT_SCANS];
+      v->num_points = n; // The binary histogram carries over, as it does step to step
+      memcpy(v->bearing, s->bearing, sizeof(float) * (size_t)n);
+      memcpy(v->spread, s->spread, sizeof(float) * (size_t)n);
+      memcpy(v->weight, s->weight, sizeof(float) * (size_t)n);
+      rescue_vfh_histogram(v);
+    }
+    elapsed[k] = now_seconds() - t0;
+  }
+  // Both ran the same sequence: compare the last state, then step through
+  // every scan again comparing as they go
+  for (int s = 0; s <= BENCH_DISTINCT_SCANS && same; ++s) {
+    same = memcmp(scalar.polar, simd.polar, sizeof(scalar.polar)) == 0 &&
+           memcmp(scalar.binary, simd.binary, sizeof(scalar.binary)) == 0 &&
+           scalar.edges[0] == simd.edges[0] && scalar.edges[1] == simd.edges[1];
+    if (s == BENCH_DISTINCT_SCANS) break;
+    for (int k = 0; k < 2; ++k) {
+      RescueVfh *v = k ? &simd : &scalar;
+      memcpy(v->bearing, scans[s].bearing, sizeof(float) * (size_t)n);
+      memcpy(v->spread, scans[s].spread, sizeof(float) * (size_t)n);
+      memcpy(v->weight, scans[s].weight, sizeof(float) * (size_t)n);
+      rescue_vfh_histogram(v);
+    }
+  }
+  printf("  %4d points  scalar %8.1f /ms  %s %8.1f /ms  speedup %5.2fx  %s\n", n, count / elapsed[0] / 1e3,
+         simd.simd ? "simd" : "(no simd)", count / elapsed[1] / 1e3, elapsed[0] / elapsed[1], same ? "agree" : "DIFFER");
+  return same;
+}
+
+// --- Arena Runs ---
+
+typedef struct {
+  RescueHal inner;
+  const RescueController *controller;
+  long avoid_steps;
+  int last_turn;          // Direction of the last turn on the spot, 0 none yet
+  long last_turn_step;
+  long steps;
+  long flips;
+} Watch;
+
+static void watch_actuate(void *ctx, const RescueOutputs *out) {
+  Watch *w = ctx;
+  w->steps++;
+  w->avoid_steps += w->controller->current_state == AVOIDING_OBSTACLE;
+  if (out->left_speed != 0.0 && out->left_speed == -out->right_speed) {
+    int turn = out->left_speed < 0.0 ? 1 : -1; // Left wheel back: turning left
+    w->flips += w->last_turn && turn != w->last_turn && w->steps - w->last_turn_step <= BENCH_FLIP_WINDOW;
+    w->last_turn = turn;
+    w->last_turn_step = w->steps;
+  }
+  w->inner.actuate(w->inner.ctx, out);
+}
+
+static int watch_step(void *ctx, int ms) { Watch *w = ctx; return w->inner.step(w->inner.ctx, ms); }
+static void watch_sense(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.sense(w->inner.ctx, in); }
+static void watch_recognize(void *ctx, RescueInputs *in) { Watch *w = ctx; w->inner.recognize(w->inner.ctx, in); }
+static bool watch_emit(void *ctx, const void *d, int n) { Watch *w = ctx; return w->inner.emit(w->inner.ctx, d, n); }
+
+typedef struct {
+  double all;             // Sim time the last survivor was signaled, -1 if not
+  int found, total;
+  double distance;
+  long collisions;
+  double avoiding;        // Share of the steps in AVOIDING_OBSTACLE
+  long flips;
+} BenchResult;
+
+static BenchResult run(int scenario, int mode, double limit) {
+  Sim2D sim;
+  char name[32];
+  sim_init(&sim);
+  arena_suite(&sim, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+  sim.stop_when_all_signaled = true;
+  if (mode_sensors[mode] > RESCUE_NUM_DS) sim_set_range_sensors(&sim, mode_sensors[mode]);
+  static SimStack stack; // The histogram on its own, without the rest of the shipped stack
+  if (!sim_stack_init(&stack, mode_sensors[mode] ? RESCUE_TRACE_CONFIG_VFH : 0, NULL)) {
+    fprintf(stderr, "cannot set up the controller\n");
+    exit(1);
+  }
+
+  Watch watch = {.controller = &stack.controller};
+  sim_hal_init(&sim, &watch.inner, sim_stack_ticks(&stack, limit));
+  RescueHal hal = {&watch, watch_step, watch_sense, watch_recognize, watch_actuate, watch_emit, NULL};
+  rescue_run(&hal, &stack.controller);
+
+  BenchResult r = {.all = sim.all_signaled_time, .found = sim_survivors_signaled(&sim), .total = sim.num_survivors,
+                   .distance = sim.distance_travelled, .collisions = sim.collisions, .flips = watch.flips};
+  r.avoiding = watch.steps ? (double)watch.avoid_steps / watch.steps : 0.0;
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return r;
+}
+
+int main(int argc, char **argv) {
+  double limit = argc > 1 ? atof(argv[1]) : 300.0;
+  long count = argc > 2 ? atol(argv[2]) : 200000;
+
+  printf("histogram kernels: %d sectors | kernel: %s\n", RESCUE_VFH_SECTORS, rescue_vfh_simd_name());
+  srand(11);
+  bool agree = true;
+  const int points[] = {3, 3 * RESCUE_VFH_MEMORY, 8 * RESCUE_VFH_MEMORY, RESCUE_VFH_MAX_POINTS};
+  for (int i = 0; i < 4; ++i) agree = bench_kernels(points[i], count) && agree;
+
+  printf("\nsearching straight ahead, time limit %.0f s; '-': not within the limit\n", limit);
+  printf("%-15s %-7s %9s %6s %9s %10s %9s %6s\n", "arena", "avoid", "all", "found", "distance", "collisions",
+         "avoiding", "flips");
+  int found[BENCH_MODES] = {0}, completed[BENCH_MODES] = {0}, total = 0;
+  long collisions[BENCH_MODES] = {0}, flips[BENCH_MODES] = {0};
+  char name[32];
+  Sim2D probe;
+  for (int scenario = 0;; ++scenario) {
+    sim_init(&probe);
+    bool more = arena_suite(&probe, scenario, ARENA_SUITE_RUBBLE_SEEDS, name, sizeof(name));
+    sim_free(&probe);
+    if (!more) break;
+    for (int mode = 0; mode < BENCH_MODES; ++mode) {
+      BenchResult r = run(scenario, mode, limit);
+      printf("%-15s %-7s ", mode ? "" : name, mode_names[mode]);
+      if (r.all < 0.0) printf("%9s", "-");
+      else printf("%8.1fs", r.all);
+      printf(" %3d/%-2d %8.1fm %10ld %8.1f%% %6ld\n", r.found, r.total, r.distance, r.collisions, 100.0 * r.avoiding,
+             r.flips);
+      found[mode] += r.found;
+      completed[mode] += r.all >= 0.0;
+      collisions[mode] += r.collisions;
+      flips[mode] += r.flips;
+      if (!mode) total += r.total;
+    }
+  }
+  for (int mode = 0; mode < BENCH_MODES; ++mode)
+    printf("%-7s survivors %d/%d, all of them in %d arenas, %ld collisions, %ld flips\n", mode_names[mode],
+           found[mode], total, completed[mode], collisions[mode], flips[mode]);
+  printf("histogram kernels %s\n", agree ? "agree" : "DIFFER");
+  return agree ? 0 : 1;
+}
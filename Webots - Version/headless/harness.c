@@ -0,0 +1,52 @@
+/*
+ * Description: Headless throughput harness - runs the rescue controller
+ *              against the stand-in backend and reports control steps/s.
+ *
+ * Usage: harness [steps] [--profile]
+ *        --profile also prints the per-phase latency histograms and the
+ *                  time spent in each state
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../rescue_controller.h"
+#include "stub_hal.h"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  long steps = argc > 1 ? atol(argv[1]) : 10000000;
+
+  StubHal stub;
+  RescueHal hal;
+  stub_hal_init(&stub, &hal, steps);
+
+  RescueController controller;
+  rescue_controller_init(&controller);
+  controller.verbose = false;
+
+  RescueProfile profile;
+  if (argc > 2 && strcmp(argv[2], "--profile") == 0) {
+    rescue_profile_init(&profile, TIME_STEP);
+    controller.profile = &profile;
+  }
+
+  double t0 = now_seconds();
+  long done = rescue_run(&hal, &controller);
+  double elapsed = now_seconds() - t0;
+
+  printf("steps: %ld  elapsed: %.3f s  throughput: %.2f M steps/s  emits: %ld  final state: %d\n",
+         done, elapsed, done / elapsed / 1e6, stub.emits, controller.current_state);
+  if (controller.profile) {
+    rescue_profile_dump(&profile, stdout);
+    rescue_state_stats_dump(&controller.states, TIME_STEP, stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,487 @@
+/*
+ * Description: Distance-sensor ray-casting engine for large arenas.
+ *              Uniform grid + DDA traversal + vectorized segment tests.
+ */
+
+#include "raycast.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RAYGRID_KERNEL "avx"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RAYGRID_KERNEL "sse2"
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RAYGRID_KERNEL "neon"
+#else
+#define RAYGRID_KERNEL "scalar"
+#endif
+
+// Batches are cast in grid-cell order only when that pays for the sort: many
+// rays and a grid that no longer fits in cache.
+#define RAYGRID_BATCH_SORT_MIN 256
+#define RAYGRID_BATCH_SORT_BYTES (4u << 20)
+
+const char *raygrid_simd_name(void) { return RAYGRID_KERNEL; }
+
+// --- Setup ---
+
+void raygrid_init(RayGrid *g) {
+  memset(g, 0, sizeof(*g));
+  g->simd = strcmp(RAYGRID_KERNEL, "scalar") != 0;
+}
+
+static void raygrid_free_grid(RayGrid *g) {
+  free(g->seg_start); free(g->gx0); free(g->gy0); free(g->gex); free(g->gey); free(g->gtag);
+  free(g->disc_start); free(g->disc_index);
+  g->seg_start = g->disc_start = g->disc_index = g->gtag = NULL;
+  g->gx0 = g->gy0 = g->gex = g->gey = NULL;
+  g->built = false;
+}
+
+void raygrid_free(RayGrid *g) {
+  raygrid_free_grid(g);
+  free(g->sx0); free(g->sy0); free(g->sx1); free(g->sy1); free(g->stag);
+  free(g->dcx); free(g->dcy); free(g->dr); free(g->dtag);
+  bool simd = g->simd;
+  memset(g, 0, sizeof(*g));
+  g->simd = simd;
+}
+
+void raygrid_clear(RayGrid *g) {
+  g->num_segs = 0;
+  g->num_discs = 0;
+  g->built = false;
+}
+
+void raygrid_add_segment(RayGrid *g, float x0, float y0, float x1, float y1, int tag) {
+  if (g->num_segs == g->cap_segs) {
+    g->cap_segs = g->cap_segs ? g->cap_segs * 2 : 64;
+    size_t n = (size_t)g->cap_segs;
+    g->sx0 = realloc(g->sx0, n * sizeof(float)); g->sy0 = realloc(g->sy0, n * sizeof(float));
+    g->sx1 = realloc(g->sx1, n * sizeof(float)); g->sy1 = realloc(g->sy1, n * sizeof(float));
+    g->stag = realloc(g->stag, n * sizeof(int));
+  }
+  int i = g->num_segs++;
+  g->sx0[i] = x0; g->sy0[i] = y0; g->sx1[i] = x1; g->sy1[i] = y1; g->stag[i] = tag;
+  g->built = false;
+}
+
+void raygrid_add_disc(RayGrid *g, float cx, float cy, float r, int tag) {
+  if (g->num_discs == g->cap_discs) {
+    g->cap_discs = g->cap_discs ? g->cap_discs * 2 : 16;
+    size_t n = (size_t)g->cap_discs;
+    g->dcx = realloc(g->dcx, n * sizeof(float)); g->dcy = realloc(g->dcy, n * sizeof(float));
+    g->dr = realloc(g->dr, n * sizeof(float)); g->dtag = realloc(g->dtag, n * sizeof(int));
+  }
+  int i = g->num_discs++;
+  g->dcx[i] = cx; g->dcy[i] = cy; g->dr[i] = r; g->dtag[i] = tag;
+  g->built = false;
+}
+
+// --- Build ---
+
+static int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+static int cell_coord(float v, float min, float inv_cell, int n) {
+  return clampi((int)floorf((v - min) * inv_cell), 0, n - 1);
+}
+
+// Does the segment touch the axis-aligned box? (bbox already overlaps)
+static bool segment_touches_box(float x0, float y0, float x1, float y1,
+                                float bx0, float by0, float bx1, float by1) {
+  float nx = y1 - y0, ny = x0 - x1; // Line normal
+  float c = nx * x0 + ny * y0;
+  float d0 = nx * bx0 + ny * by0 - c, d1 = nx * bx1 + ny * by0 - c;
+  float d2 = nx * bx0 + ny * by1 - c, d3 = nx * bx1 + ny * by1 - c;
+  bool pos = d0 >= 0 || d1 >= 0 || d2 >= 0 || d3 >= 0;
+  bool neg = d0 <= 0 || d1 <= 0 || d2 <= 0 || d3 <= 0;
+  return pos && neg;
+}
+
+// Counts (pass 0) or copies the segment into (pass 1) every cell it touches.
+static void segment_cells(const RayGrid *g, int s, int *counts, int *cursor, int pass) {
+  float x0 = g->sx0[s], y0 = g->sy0[s], x1 = g->sx1[s], y1 = g->sy1[s];
+  int cx0 = cell_coord(fminf(x0, x1), g->min_x, g->inv_cell, g->nx);
+  int cx1 = cell_coord(fmaxf(x0, x1), g->min_x, g->inv_cell, g->nx);
+  int cy0 = cell_coord(fminf(y0, y1), g->min_y, g->inv_cell, g->ny);
+  int cy1 = cell_coord(fmaxf(y0, y1), g->min_y, g->inv_cell, g->ny);
+  for (int cy = cy0; cy <= cy1; ++cy) {
+    for (int cx = cx0; cx <= cx1; ++cx) {
+      float bx0 = g->min_x + cx * g->cell, by0 = g->min_y + cy * g->cell;
+      if (!segment_touches_box(x0, y0, x1, y1, bx0, by0, bx0 + g->cell, by0 + g->cell)) continue;
+      int c = cy * g->nx + cx;
+      if (pass == 0) {
+        counts[c]++;
+      } else {
+        int k = cursor[c]++;
+        g->gx0[k] = x0; g->gy0[k] = y0; g->gex[k] = x1 - x0; g->gey[k] = y1 - y0; g->gtag[k] = g->stag[s];
+      }
+    }
+  }
+}
+
+void raygrid_build(RayGrid *g, float cell_size) {
+  raygrid_free_grid(g);
+
+  // Bounds of everything
+  float minx = INFINITY, miny = INFINITY, maxx = -INFINITY, maxy = -INFINITY;
+  double total_len = 0.0;
+  for (int i = 0; i < g->num_segs; ++i) {
+    minx = fminf(minx, fminf(g->sx0[i], g->sx1[i])); maxx = fmaxf(maxx, fmaxf(g->sx0[i], g->sx1[i]));
+    miny = fminf(miny, fminf(g->sy0[i], g->sy1[i])); maxy = fmaxf(maxy, fmaxf(g->sy0[i], g->sy1[i]));
+    total_len += hypotf(g->sx1[i] - g->sx0[i], g->sy1[i] - g->sy0[i]);
+  }
+  for (int i = 0; i < g->num_discs; ++i) {
+    minx = fminf(minx, g->dcx[i] - g->dr[i]); maxx = fmaxf(maxx, g->dcx[i] + g->dr[i]);
+    miny = fminf(miny, g->dcy[i] - g->dr[i]); maxy = fmaxf(maxy, g->dcy[i] + g->dr[i]);
+  }
+  if (g->num_segs + g->num_discs == 0) { minx = miny = 0.0f; maxx = maxy = 1.0f; }
+  g->min_x = minx - 1e-3f; g->min_y = miny - 1e-3f;
+  g->max_x = maxx + 1e-3f; g->max_y = maxy + 1e-3f;
+
+  if (cell_size <= 0.0f) { // About 4 segments per cell, never finer than the mean segment
+    float area = (g->max_x - g->min_x) * (g->max_y - g->min_y);
+    int prims = g->num_segs + g->num_discs;
+    cell_size = sqrtf(area * 4.0f / (float)(prims > 0 ? prims : 1));
+    float mean_len = g->num_segs ? (float)(total_len / g->num_segs) : cell_size;
+    if (cell_size < mean_len) cell_size = mean_len;
+  }
+  g->cell = cell_size;
+  g->inv_cell = 1.0f / cell_size;
+  g->nx = (int)ceilf((g->max_x - g->min_x) * g->inv_cell); if (g->nx < 1) g->nx = 1;
+  g->ny = (int)ceilf((g->max_y - g->min_y) * g->inv_cell); if (g->ny < 1) g->ny = 1;
+  int cells = g->nx * g->ny;
+
+  // Segments: count, pad each cell to a lane multiple, fill
+  int *counts = calloc((size_t)cells, sizeof(int));
+  for (int s = 0; s < g->num_segs; ++s) segment_cells(g, s, counts, NULL, 0);
+  g->seg_start = malloc(((size_t)cells + 1) * sizeof(int));
+  int total = 0;
+  for (int c = 0; c < cells; ++c) {
+    g->seg_start[c] = total;
+    total += (counts[c] + RAYGRID_LANES - 1) / RAYGRID_LANES * RAYGRID_LANES;
+  }
+  g->seg_start[cells] = total;
+  g->bytes = (size_t)total * (4 * sizeof(float) + sizeof(int)) + (size_t)cells * 2 * sizeof(int);
+  size_t block = (size_t)(total > 0 ? total : 1);
+  g->gx0 = calloc(block, sizeof(float)); g->gy0 = calloc(block, sizeof(float));
+  g->gex = calloc(block, sizeof(float)); g->gey = calloc(block, sizeof(float)); // Zero direction never hits
+  g->gtag = malloc(block * sizeof(int));
+  for (int k = 0; k < total; ++k) g->gtag[k] = RAYGRID_NO_TAG;
+  int *cursor = malloc(((size_t)cells + 1) * sizeof(int));
+  memcpy(cursor, g->seg_start, (size_t)cells * sizeof(int));
+  for (int s = 0; s < g->num_segs; ++s) segment_cells(g, s, counts, cursor, 1);
+
+  // Discs: bounding-box cells
+  memset(counts, 0, (size_t)cells * sizeof(int));
+  for (int pass = 0; pass < 2; ++pass) {
+    if (pass == 1) {
+      g->disc_start = malloc(((size_t)cells + 1) * sizeof(int));
+      int n = 0;
+      for (int c = 0; c < cells; ++c) { g->disc_start[c] = n; n += counts[c]; }
+      g->disc_start[cells] = n;
+      g->disc_index = malloc((size_t)(n > 0 ? n : 1) * sizeof(int));
+      memcpy(cursor, g->disc_start, (size_t)cells * sizeof(int));
+    }
+    for (int d = 0; d < g->num_discs; ++d) {
+      int cx0 = cell_coord(g->dcx[d] - g->dr[d], g->min_x, g->inv_cell, g->nx);
+      int cx1 = cell_coord(g->dcx[d] + g->dr[d], g->min_x, g->inv_cell, g->nx);
+      int cy0 = cell_coord(g->dcy[d] - g->dr[d], g->min_y, g->inv_cell, g->ny);
+      int cy1 = cell_coord(g->dcy[d] + g->dr[d], g->min_y, g->inv_cell, g->ny);
+      for (int cy = cy0; cy <= cy1; ++cy)
+        for (int cx = cx0; cx <= cx1; ++cx) {
+          int c = cy * g->nx + cx;
+          if (pass == 0) counts[c]++; else g->disc_index[cursor[c]++] = d;
+        }
+    }
+  }
+  free(cursor);
+  free(counts);
+  g->built = true;
+}
+
+// --- Cell Kernels ---
+// Each returns the nearest segment hit in [begin, end) closer than best, or
+// -1; best is updated in place.
+
+static int cell_segments_scalar(const RayGrid *g, int begin, int end,
+                                float ox, float oy, float dx, float dy, float *best) {
+  int hit = -1;
+  float b = *best;
+  for (int k = begin; k < end; ++k) {
+    float ex = g->gex[k], ey = g->gey[k];
+    float denom = dx * ey - dy * ex;
+    if (denom == 0.0f) continue; // Parallel or padding
+    float wx = g->gx0[k] - ox, wy = g->gy0[k] - oy;
+    float inv = 1.0f / denom;
+    float t = (wx * ey - wy * ex) * inv;
+    float u = (wx * dy - wy * dx) * inv;
+    if (t >= 0.0f && u >= 0.0f && u <= 1.0f && t < b) { b = t; hit = k; }
+  }
+  *best = b;
+  return hit;
+}
+
+#if defined(__AVX__)
+static int cell_segments_simd(const RayGrid *g, int begin, int end,
+                              float ox, float oy, float dx, float dy, float *best) {
+  const __m256 vox = _mm256_set1_ps(ox), voy = _mm256_set1_ps(oy);
+  const __m256 vdx = _mm256_set1_ps(dx), vdy = _mm256_set1_ps(dy);
+  const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+  const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+  __m256 vbest = _mm256_set1_ps(*best);
+  __m256 vidx = _mm256_set1_ps(-1.0f);
+  for (int k = begin; k < end; k += 8) {
+    __m256 ex = _mm256_loadu_ps(g->gex + k), ey = _mm256_loadu_ps(g->gey + k);
+    __m256 wx = _mm256_sub_ps(_mm256_loadu_ps(g->gx0 + k), vox);
+    __m256 wy = _mm256_sub_ps(_mm256_loadu_ps(g->gy0 + k), voy);
+    __m256 inv = _mm256_div_ps(one, _mm256_sub_ps(_mm256_mul_ps(vdx, ey), _mm256_mul_ps(vdy, ex)));
+    __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(wx, ey), _mm256_mul_ps(wy, ex)), inv);
+    __m256 u = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(wx, vdy), _mm256_mul_ps(wy, vdx)), inv);
+    // Ordered compares: NaN/inf from parallel or padding lanes fail
+    __m256 m = _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_GE_OQ), _mm256_cmp_ps(t, vbest, _CMP_LT_OQ));
+    m = _mm256_and_ps(m, _mm256_and_ps(_mm256_cmp_ps(u, zero, _CMP_GE_OQ), _mm256_cmp_ps(u, one, _CMP_LE_OQ)));
+    vbest = _mm256_blendv_ps(vbest, t, m);
+    vidx = _mm256_blendv_ps(vidx, _mm256_add_ps(lane, _mm256_set1_ps((float)k)), m);
+  }
+  float tb[8], ib[8];
+  _mm256_storeu_ps(tb, vbest);
+  _mm256_storeu_ps(ib, vidx);
+  int hit = -1;
+  for (int l = 0; l < 8; ++l)
+    if (ib[l] >= 0.0f && tb[l] < *best) { *best = tb[l]; hit = (int)ib[l]; }
+  return hit;
+}
+#elif defined(__SSE2__)
+static inline __m128 sse_blend(__m128 a, __m128 b, __m128 m) {
+  return _mm_or_ps(_mm_andnot_ps(m, a), _mm_and_ps(m, b));
+}
+
+static int cell_segments_simd(const RayGrid *g, int begin, int end,
+                              float ox, float oy, float dx, float dy, float *best) {
+  const __m128 vox = _mm_set1_ps(ox), voy = _mm_set1_ps(oy);
+  const __m128 vdx = _mm_set1_ps(dx), vdy = _mm_set1_ps(dy);
+  const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+  const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+  __m128 vbest = _mm_set1_ps(*best);
+  __m128 vidx = _mm_set1_ps(-1.0f);
+  for (int k = begin; k < end; k += 4) {
+    __m128 ex = _mm_loadu_ps(g->gex + k), ey = _mm_loadu_ps(g->gey + k);
+    __m128 wx = _mm_sub_ps(_mm_loadu_ps(g->gx0 + k), vox);
+    __m128 wy = _mm_sub_ps(_mm_loadu_ps(g->gy0 + k), voy);
+    __m128 inv = _mm_div_ps(one, _mm_sub_ps(_mm_mul_ps(vdx, ey), _mm_mul_ps(vdy, ex)));
+    __m128 t = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(wx, ey), _mm_mul_ps(wy, ex)), inv);
+    __m128 u = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(wx, vdy), _mm_mul_ps(wy, vdx)), inv);
+    // Ordered compares: NaN/inf from parallel or padding lanes fail
+    __m128 m = _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmplt_ps(t, vbest));
+    m = _mm_and_ps(m, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one)));
+    vbest = sse_blend(vbest, t, m);
+    vidx = sse_blend(vidx, _mm_add_ps(lane, _mm_set1_ps((float)k)), m);
+  }
+  float tb[4], ib[4];
+  _mm_storeu_ps(tb, vbest);
+  _mm_storeu_ps(ib, vidx);
+  int hit = -1;
+  for (int l = 0; l < 4; ++l)
+    if (ib[l] >= 0.0f && tb[l] < *best) { *best = tb[l]; hit = (int)ib[l]; }
+  return hit;
+}
+#elif defined(__ARM_NEON)
+static int cell_segments_simd(const RayGrid *g, int begin, int end,
+                              float ox, float oy, float dx, float dy, float *best) {
+  const float32x4_t vox = vdupq_n_f32(ox), voy = vdupq_n_f32(oy);
+  const float32x4_t vdx = vdupq_n_f32(dx), vdy = vdupq_n_f32(dy);
+  const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f);
+  const float lane_init[4] = {0, 1, 2, 3};
+  const float32x4_t lane = vld1q_f32(lane_init);
+  float32x4_t vbest = vdupq_n_f32(*best);
+  float32x4_t vidx = vdupq_n_f32(-1.0f);
+  for (int k = begin; k < end; k += 4) {
+    float32x4_t ex = vld1q_f32(g->gex + k), ey = vld1q_f32(g->gey + k);
+    float32x4_t wx = vsubq_f32(vld1q_f32(g->gx0 + k), vox);
+    float32x4_t wy = vsubq_f32(vld1q_f32(g->gy0 + k), voy);
+    float32x4_t denom = vsubq_f32(vmulq_f32(vdx, ey), vmulq_f32(vdy, ex));
+    float32x4_t t = vdivq_f32(vsubq_f32(vmulq_f32(wx, ey), vmulq_f32(wy, ex)), denom);
+    float32x4_t u = vdivq_f32(vsubq_f32(vmulq_f32(wx, vdy), vmulq_f32(wy, vdx)), denom);
+    uint32x4_t m = vandq_u32(vcgeq_f32(t, zero), vcltq_f32(t, vbest));
+    m = vandq_u32(m, vandq_u32(vcgeq_f32(u, zero), vcleq_f32(u, one)));
+    vbest = vbslq_f32(m, t, vbest);
+    vidx = vbslq_f32(m, vaddq_f32(lane, vdupq_n_f32((float)k)), vidx);
+  }
+  float tb[4], ib[4];
+  vst1q_f32(tb, vbest);
+  vst1q_f32(ib, vidx);
+  int hit = -1;
+  for (int l = 0; l < 4; ++l)
+    if (ib[l] >= 0.0f && tb[l] < *best) { *best = tb[l]; hit = (int)ib[l]; }
+  return hit;
+}
+#else
+#define cell_segments_simd cell_segments_scalar
+#endif
+
+static float ray_disc(float ox, float oy, float dx, float dy, float cx, float cy, float r) {
+  float fx = ox - cx, fy = oy - cy;
+  float b = fx * dx + fy * dy;
+  float c = fx * fx + fy * fy - r * r;
+  float disc = b * b - c;
+  if (disc < 0.0f) return INFINITY;
+  float t = -b - sqrtf(disc);
+  if (t < 0.0f) t = -b + sqrtf(disc); // Origin inside the disc
+  return t < 0.0f ? INFINITY : t;
+}
+
+// --- Traversal ---
+
+float raygrid_cast(const RayGrid *g, float ox, float oy, float dx, float dy, float max_range,
+                   int *tag, RayStats *stats) {
+  float best = max_range;
+  int best_tag = RAYGRID_NO_TAG;
+  long cells_visited = 0, segment_tests = 0;
+
+  // Clip the ray to the grid bounds (slab test)
+  float t0 = 0.0f, t1 = max_range;
+  if (dx != 0.0f) {
+    float ta = (g->min_x - ox) / dx, tb = (g->max_x - ox) / dx;
+    t0 = fmaxf(t0, fminf(ta, tb)); t1 = fminf(t1, fmaxf(ta, tb));
+  } else if (ox < g->min_x || ox > g->max_x) t1 = -1.0f;
+  if (dy != 0.0f) {
+    float ta = (g->min_y - oy) / dy, tb = (g->max_y - oy) / dy;
+    t0 = fmaxf(t0, fminf(ta, tb)); t1 = fminf(t1, fmaxf(ta, tb));
+  } else if (oy < g->min_y || oy > g->max_y) t1 = -1.0f;
+  if (t0 > t1 || !g->built) {
+    if (stats) stats->rays++;
+    if (tag) *tag = best_tag;
+    return best;
+  }
+
+  int ix = cell_coord(ox + dx * t0, g->min_x, g->inv_cell, g->nx);
+  int iy = cell_coord(oy + dy * t0, g->min_y, g->inv_cell, g->ny);
+  int step_x = dx > 0.0f ? 1 : -1, step_y = dy > 0.0f ? 1 : -1;
+  float t_max_x = dx != 0.0f ? (g->min_x + (ix + (dx > 0.0f)) * g->cell - ox) / dx : INFINITY;
+  float t_max_y = dy != 0.0f ? (g->min_y + (iy + (dy > 0.0f)) * g->cell - oy) / dy : INFINITY;
+  float t_delta_x = dx != 0.0f ? g->cell / fabsf(dx) : INFINITY;
+  float t_delta_y = dy != 0.0f ? g->cell / fabsf(dy) : INFINITY;
+
+  for (;;) {
+    int c = iy * g->nx + ix;
+    cells_visited++;
+    int begin = g->seg_start[c], end = g->seg_start[c + 1];
+    if (begin < end) {
+      segment_tests += end - begin;
+      int k = g->simd ? cell_segments_simd(g, begin, end, ox, oy, dx, dy, &best)
+                      : cell_segments_scalar(g, begin, end, ox, oy, dx, dy, &best);
+      if (k >= 0) best_tag = g->gtag[k];
+    }
+    for (int j = g->disc_start[c]; j < g->disc_start[c + 1]; ++j) {
+      int d = g->disc_index[j];
+      float t = ray_disc(ox, oy, dx, dy, g->dcx[d], g->dcy[d], g->dr[d]);
+      if (t < best) { best = t; best_tag = g->dtag[d]; }
+    }
+
+    // A hit inside this cell cannot be beaten by a later cell
+    float cell_exit = fminf(t_max_x, t_max_y);
+    if (best <= cell_exit || cell_exit > t1) break;
+    if (t_max_x < t_max_y) {
+      ix += step_x; if (ix < 0 || ix >= g->nx) break;
+      t_max_x += t_delta_x;
+    } else {
+      iy += step_y; if (iy < 0 || iy >= g->ny) break;
+      t_max_y += t_delta_y;
+    }
+  }
+  if (stats) {
+    stats->rays++;
+    stats->cells_visited += cells_visited;
+    stats->segment_tests += segment_tests;
+  }
+  if (tag) *tag = best_tag;
+  return best;
+}
+
+void raygrid_cast_batch(const RayGrid *g, const RayBatch *batch, RayStats *stats) {
+  int n = batch->count;
+  if (!batch->scratch || n < RAYGRID_BATCH_SORT_MIN || g->bytes < RAYGRID_BATCH_SORT_BYTES) {
+    for (int i = 0; i < n; ++i)
+      batch->t[i] = raygrid_cast(g, batch->ox[i], batch->oy[i], batch->dx[i], batch->dy[i],
+                                 batch->max_range[i], &batch->tag[i], stats);
+    return;
+  }
+
+  // Counting sort by origin cell so neighbouring rays reuse hot cell data
+  int *keys = batch->scratch, *order = batch->scratch + n;
+  int cells = g->nx * g->ny;
+  int *bucket = calloc((size_t)cells + 1, sizeof(int));
+  for (int i = 0; i < n; ++i) {
+    int cx = cell_coord(batch->ox[i], g->min_x, g->inv_cell, g->nx);
+    int cy = cell_coord(batch->oy[i], g->min_y, g->inv_cell, g->ny);
+    keys[i] = cy * g->nx + cx;
+    bucket[keys[i] + 1]++;
+  }
+  for (int c = 0; c < cells; ++c) bucket[c + 1] += bucket[c];
+  for (int i = 0; i < n; ++i) order[bucket[keys[i]]++] = i;
+  free(bucket);
+
+  for (int j = 0; j < n; ++j) {
+    int i = order[j];
+    batch->t[i] = raygrid_cast(g, batch->ox[i], batch->oy[i], batch->dx[i], batch->dy[i],
+                               batch->max_range[i], &batch->tag[i], stats);
+  }
+}
+
+float raygrid_cast_brute(const RayGrid *g, float ox, float oy, float dx, float dy, float max_range, int *tag) {
+  float best = max_range;
+  int best_tag = RAYGRID_NO_TAG;
+  for (int i = 0; i < g->num_segs; ++i) {
+    float ex = g->sx1[i] - g->sx0[i], ey = g->sy1[i] - g->sy0[i];
+    float denom = dx * ey - dy * ex;
+    if (denom == 0.0f) continue;
+    float wx = g->sx0[i] - ox, wy = g->sy0[i] - oy;
+    float inv = 1.0f / denom;
+    float t = (wx * ey - wy * ex) * inv;
+    float u = (wx * dy - wy * dx) * inv;
+    if (t >= 0.0f && u >= 0.0f && u <= 1.0f && t < best) { best = t; best_tag = g->stag[i]; }
+  }
+  for (int d = 0; d < g->num_discs; ++d) {
+    float t = ray_disc(ox, oy, dx, dy, g->dcx[d], g->dcy[d], g->dr[d]);
+    if (t < best) { best = t; best_tag = g->dtag[d]; }
+  }
+  if (tag) *tag = best_tag;
+  return best;
+}
+
+// --- Overlap Queries ---
+
+bool raygrid_disc_overlaps(const RayGrid *g, float x, float y, float r) {
+  if (!g->built) return false;
+  if (x + r < g->min_x || x - r > g->max_x || y + r < g->min_y || y - r > g->max_y) return false;
+  int cx0 = cell_coord(x - r, g->min_x, g->inv_cell, g->nx), cx1 = cell_coord(x + r, g->min_x, g->inv_cell, g->nx);
+  int cy0 = cell_coord(y - r, g->min_y, g->inv_cell, g->ny), cy1 = cell_coord(y + r, g->min_y, g->inv_cell, g->ny);
+  float r2 = r * r;
+  for (int cy = cy0; cy <= cy1; ++cy) {
+    for (int cx = cx0; cx <= cx1; ++cx) {
+      int c = cy * g->nx + cx;
+      for (int k = g->seg_start[c]; k < g->seg_start[c + 1]; ++k) {
+        float ex = g->gex[k], ey = g->gey[k];
+        float len2 = ex * ex + ey * ey;
+        if (len2 == 0.0f) continue; // Padding
+        float t = ((x - g->gx0[k]) * ex + (y - g->gy0[k]) * ey) / len2;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        float qx = g->gx0[k] + t * ex - x, qy = g->gy0[k] + t * ey - y;
+        if (qx * qx + qy * qy < r2) return true;
+      }
+      for (int j = g->disc_start[c]; j < g->disc_start[c + 1]; ++j) {
+        int d = g->disc_index[j];
+        float ddx = x - g->dcx[d], ddy = y - g->dcy[d], rr = r + g->dr[d];
+        if (ddx * ddx + ddy * ddy < rr * rr) return true;
+      }
+    }
+  }
+  return false;
+}
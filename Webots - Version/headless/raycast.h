@@ -0,0 +1,80 @@
+/*
+ * Description: Distance-sensor ray-casting engine for large arenas.
+ *              Segments and discs are binned into a uniform grid; a ray
+ *              walks the grid cells it crosses (Amanatides-Woo DDA) and
+ *              tests each cell's segments 8 (AVX) or 4 (SSE2/NEON) at a
+ *              time, stopping at the first cell that contains a hit.
+ *              Batched casts take every sensor ray of every robot in one
+ *              call and, on grids larger than the cache, process them in
+ *              grid-cell order.
+ */
+
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define RAYGRID_LANES 8     // Per-cell segment blocks are padded to this many
+#define RAYGRID_NO_TAG -1   // Tag reported for walls and for "nothing hit"
+
+typedef struct {
+  // --- Primitives (insertion order) ---
+  float *sx0, *sy0, *sx1, *sy1; int *stag; int num_segs, cap_segs;
+  float *dcx, *dcy, *dr; int *dtag; int num_discs, cap_discs;
+
+  // --- Grid ---
+  float min_x, min_y, max_x, max_y;
+  float cell, inv_cell;
+  int nx, ny;
+  int *seg_start;            // nx*ny + 1 offsets into the cell-ordered segment block
+  float *gx0, *gy0, *gex, *gey; int *gtag; // Cell-ordered SoA copies, padded per cell
+  int *disc_start;           // nx*ny + 1 offsets into disc_index
+  int *disc_index;
+  size_t bytes;              // Footprint of the binned data
+  bool built;
+  bool simd;                 // Use the vector kernel (default when compiled in)
+
+} RayGrid;
+
+// Casts never modify the grid, so any number of threads can cast at once;
+// each passes its own statistics block (or NULL).
+typedef struct {
+  long rays, cells_visited, segment_tests;
+} RayStats;
+
+// Rays as structure-of-arrays; directions must be unit length.
+typedef struct {
+  int count;
+  const float *ox, *oy, *dx, *dy;
+  const float *max_range;
+  float *t;                  // Out: hit distance, max_range if nothing
+  int *tag;                  // Out: tag of the primitive hit, RAYGRID_NO_TAG otherwise
+  int *scratch;              // 2 * count ints for cell-order sorting, NULL = cast in given order
+} RayBatch;
+
+void raygrid_init(RayGrid *g);
+void raygrid_free(RayGrid *g);
+void raygrid_clear(RayGrid *g);   // Drops all primitives, keeps allocations
+
+void raygrid_add_segment(RayGrid *g, float x0, float y0, float x1, float y1, int tag);
+void raygrid_add_disc(RayGrid *g, float cx, float cy, float r, int tag);
+
+// Bins the primitives. cell_size <= 0 picks one from the primitive density.
+void raygrid_build(RayGrid *g, float cell_size);
+
+// The grid must be built. stats may be NULL.
+float raygrid_cast(const RayGrid *g, float ox, float oy, float dx, float dy, float max_range,
+                   int *tag, RayStats *stats);
+void raygrid_cast_batch(const RayGrid *g, const RayBatch *batch, RayStats *stats);
+
+// Reference: tests every primitive, no grid.
+float raygrid_cast_brute(const RayGrid *g, float ox, float oy, float dx, float dy, float max_range, int *tag);
+
+// True if the disc overlaps any segment or disc (collision queries).
+bool raygrid_disc_overlaps(const RayGrid *g, float x, float y, float r);
+
+// Name of the compiled-in vector kernel ("avx", "sse2", "neon" or "scalar").
+const char *raygrid_simd_name(void);
+
+#endif // RAYCAST_H
@@ -0,0 +1,155 @@
+/*
+ * Description: Replays a flight-recorder trace (rescue_trace.h) through the
+ *              rescue controller without Webots. The trace is memory-mapped
+ *              and every record is fed to rescue_controller_step(); the
+ *              commands it produces are packed the same way the recorder
+ *              packed them and compared byte for byte. The first divergent
+ *              step is reported, so a regression can be bisected offline
+ *              against one recorded run.
+ *
+ * Usage: replay <trace> [repeat] [--dump] [--bare]
+ *        --dump prints one line per step (inputs, state, speeds in %a)
+ *        --bare feeds the records to the reactive state machine alone
+ *               (sim_run --bare), whatever the trace was recorded with;
+ *               the commands are only compared if it was recorded bare
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../rescue_controller.h"
+#include "../rescue_trace.h"
+#include "stack.h"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void print_record(const char *label, const RescueTraceRecord *r) {
+  printf("  %-9s state %u  speeds %a %a  leds %u  flags 0x%03x\n",
+         label, r->state, r->left_speed, r->right_speed, r->led, r->flags);
+}
+
+typedef struct {
+  long mismatches;
+  long first_mismatch;      // Step index, -1 if none
+  long transitions;
+} ReplayResult;
+
+static ReplayResult replay(const RescueTraceRecord *records, long count, const RescueTraceHeader *h, bool dump,
+                           bool bare) {
+  ReplayResult res = {0, -1, 0};
+  bool compare = !bare || !(h->config & ~RESCUE_TRACE_CONFIG_MAP_CENTER);
+  static SimStack stack; // Decisions depend on the map: rebuild it as recorded
+  if (!sim_stack_init(&stack, bare ? 0 : h->config, h->config & RESCUE_TRACE_CONFIG_MAP_CENTER ? h->map_center : NULL)) {
+    fprintf(stderr, "cannot allocate the map, explorer and planner\n");
+    exit(2);
+  }
+  RescueController *controller = &stack.controller;
+
+  RescueInputs in;
+  RescueOutputs out;
+  RescueTraceRecord got;
+  for (long k = 0; k < count; ++k) {
+    const RescueTraceRecord *rec = &records[k];
+    RobotState before = controller->current_state;
+    rescue_trace_inputs(rec, &in);
+    rescue_controller_step(controller, &in, &out);
+    rescue_trace_pack(&got, &in, &out, controller->current_state);
+    res.transitions += controller->current_state != before;
+
+    if (compare && memcmp(&got, rec, sizeof(got)) != 0) {
+      if (res.mismatches++ == 0) {
+        res.first_mismatch = k;
+        printf("MISMATCH at step %ld (t = %.3f s)\n", k, rec->time);
+        print_record("recorded", rec);
+        print_record("replayed", &got);
+      }
+    }
+    if (dump) {
+      printf("%ld %.3f F:%a L:%a R:%a flags:0x%03x -> S:%u %a %a\n", k, rec->time,
+             rec->ds[0], rec->ds[1], rec->ds[2], got.flags, got.state, got.left_speed, got.right_speed);
+    }
+  }
+  sim_stack_free(&stack);
+  return res;
+}
+
+int main(int argc, char **argv) {
+  const char *path = NULL;
+  int repeat = 1;
+  bool dump = false, bare = false;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--dump") == 0) dump = true;
+    else if (strcmp(argv[i], "--bare") == 0) bare = true;
+    else if (!path) path = argv[i];
+    else repeat = atoi(argv[i]);
+  }
+  if (!path) {
+    fprintf(stderr, "usage: %s <trace> [repeat] [--dump] [--bare]\n", argv[0]);
+    return 2;
+  }
+  if (repeat < 1) repeat = 1;
+
+  // --- Map the Trace ---
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) { perror(path); return 2; }
+  if ((size_t)st.st_size < sizeof(RescueTraceHeader)) { fprintf(stderr, "%s: too short for a trace\n", path); return 2; }
+  void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) { perror("mmap"); return 2; }
+  madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+  const RescueTraceHeader *h = map;
+  if (!rescue_trace_check_header(h)) {
+    fprintf(stderr, "%s: not a version %d trace with %zu-byte records\n", path, RESCUE_TRACE_VERSION,
+            sizeof(RescueTraceRecord));
+    return 2;
+  }
+  const RescueTraceRecord *records = (const RescueTraceRecord *)(h + 1);
+  size_t payload = (size_t)st.st_size - sizeof(*h);
+  long count = (long)(payload / sizeof(RescueTraceRecord));
+  if (payload % sizeof(RescueTraceRecord))
+    printf("note: ignoring a partial last record (%zu bytes)\n", payload % sizeof(RescueTraceRecord));
+
+  // --- Replay ---
+  ReplayResult res = {0, -1, 0};
+  double t0 = now_seconds();
+  for (int pass = 0; pass < repeat; ++pass) res = replay(records, count, h, dump && pass == 0, bare);
+  double elapsed = now_seconds() - t0;
+
+  double steps = (double)count * repeat;
+  printf("trace: %s  steps: %ld  time step: %u ms  sim time: %.1f s%s%s%s%s%s%s%s%s%s%s\n", path, count, h->time_step,
+         count ? records[count - 1].time : 0.0,
+         h->config & RESCUE_TRACE_CONFIG_ANYTIME ? "  (exploring, anytime planned paths)"
+         : h->config & RESCUE_TRACE_CONFIG_PLAN ? "  (exploring, planned paths)"
+         : h->config & RESCUE_TRACE_CONFIG_EXPLORE ? "  (exploring)" : "",
+         h->config & RESCUE_TRACE_CONFIG_VFH ? "  (polar histogram avoidance)" : "",
+         h->config & RESCUE_TRACE_CONFIG_DWA ? "  (dynamic window)" : "",
+         h->config & RESCUE_TRACE_CONFIG_SPEED ? "  (governed speed)" : "",
+         h->config & RESCUE_TRACE_CONFIG_STUCK ? "  (escapes)" : "",
+         h->config & RESCUE_TRACE_CONFIG_TRIGGERS ? "  (debounced)" : "",
+         h->config & RESCUE_TRACE_CONFIG_MISSION ? "  (mission)" : "",
+         h->config & RESCUE_TRACE_CONFIG_SCHEDULE ? "  (multi-rate)" : "",
+         h->config & RESCUE_TRACE_CONFIG_RECOGNITION ? "  (decimated recognition)" : "",
+         h->config & RESCUE_TRACE_CONFIG_TILT ? "  (tilt estimator)" : "");
+  printf("replay: %.3f s for %d pass(es)  %.2f M steps/s  %.0f MB/s\n", elapsed, repeat,
+         steps / elapsed * 1e-6, steps * sizeof(RescueTraceRecord) / elapsed * 1e-6);
+  printf("state transitions: %ld  mismatched steps: %ld", res.transitions, res.mismatches);
+  if (res.mismatches) printf("  (first at step %ld)", res.first_mismatch);
+  if (bare && (h->config & ~RESCUE_TRACE_CONFIG_MAP_CENTER))
+    printf("\nbare controller: commands not compared, the trace was recorded with more\n");
+  else printf("\n%s\n", res.mismatches ? "DIVERGED from the recorded run" : "bit-identical to the recorded run");
+
+  munmap(map, (size_t)st.st_size);
+  return res.mismatches ? 1 : 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * Description: Headless 2D kinematic simulator standing in for Webots.
+ *              Differential-drive kinematics integrated along exact arcs,
+ *              ray-cast distance sensors, a disk collision model and a
+ *              recorded emitter. No rendering, no rigid-body physics.
+ */
+
+#include "sim2d.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_controller.h"
+
+#define SIM_SIGNAL_RANGE (SURVIVOR_DETECTION_RANGE + SIM_DS_OFFSET + 0.1) // Survivor credited to an emit
+
+// --- Growable Arrays ---
+static void *sim_grow(void *ptr, int count, int *cap, size_t elem) {
+  if (count < *cap) return ptr;
+  *cap = *cap ? *cap * 2 : 16;
+  return realloc(ptr, (size_t)*cap * elem);
+}
+
+void sim_init(Sim2D *sim) {
+  memset(sim, 0, sizeof(*sim));
+  raygrid_init(&sim->grid);
+  sim->all_signaled_time = -1.0;
+  sim->ds_angle[RESCUE_DS_FRONT] = 0.0;
+  sim->ds_angle[RESCUE_DS_LEFT] = M_PI / 4.0;
+  sim->ds_angle[RESCUE_DS_RIGHT] = -M_PI / 4.0;
+}
+
+void sim_set_range_sensors(Sim2D *sim, int count) {
+  if (count > RESCUE_MAX_RANGES) count = RESCUE_MAX_RANGES;
+  sim->num_ranges = count >= 2 ? count : 0;
+  for (int i = 0; i < sim->num_ranges; ++i) sim->range_angle[i] = -M_PI / 2.0 + M_PI * i / (count - 1);
+}
+
+void sim_free(Sim2D *sim) {
+  free(sim->walls);
+  free(sim->survivors);
+  free(sim->tilt_zones);
+  raygrid_free(&sim->grid);
+  sim->walls = NULL; sim->survivors = NULL; sim->tilt_zones = NULL;
+  sim->num_walls = sim->num_survivors = sim->num_tilt_zones = 0;
+  sim->cap_walls = sim->cap_survivors = sim->cap_tilt_zones = 0;
+}
+
+void sim_add_wall(Sim2D *sim, double x0, double y0, double x1, double y1) {
+  sim->walls = sim_grow(sim->walls, sim->num_walls, &sim->cap_walls, sizeof(SimSegment));
+  sim->walls[sim->num_walls++] = (SimSegment){x0, y0, x1, y1};
+  raygrid_add_segment(&sim->grid, (float)x0, (float)y0, (float)x1, (float)y1, RAYGRID_NO_TAG);
+}
+
+void sim_add_box(Sim2D *sim, double cx, double cy, double half_w, double half_h) {
+  double x0 = cx - half_w, x1 = cx + half_w, y0 = cy - half_h, y1 = cy + half_h;
+  sim_add_wall(sim, x0, y0, x1, y0);
+  sim_add_wall(sim, x1, y0, x1, y1);
+  sim_add_wall(sim, x1, y1, x0, y1);
+  sim_add_wall(sim, x0, y1, x0, y0);
+}
+
+int sim_add_survivor(Sim2D *sim, double x, double y, double radius) {
+  sim->survivors = sim_grow(sim->survivors, sim->num_survivors, &sim->cap_survivors, sizeof(SimSurvivor));
+  int id = sim->num_survivors++;
+  sim->survivors[id] = (SimSurvivor){x, y, radius, id, false, -1.0};
+  raygrid_add_disc(&sim->grid, (float)x, (float)y, (float)radius, id);
+  return id;
+}
+
+void sim_add_tilt_zone(Sim2D *sim, double xmin, double ymin, double xmax, double ymax, double roll, double pitch) {
+  sim->tilt_zones = sim_grow(sim->tilt_zones, sim->num_tilt_zones, &sim->cap_tilt_zones, sizeof(SimTiltZone));
+  sim->tilt_zones[sim->num_tilt_zones++] = (SimTiltZone){xmin, ymin, xmax, ymax, roll, pitch};
+}
+
+void sim_set_pose(Sim2D *sim, double x, double y, double theta) {
+  sim->x = x; sim->y = y; sim->theta = theta;
+  sim_ground_tilt(sim, &sim->roll, &sim->pitch);
+  sim->roll_rate = sim->pitch_rate = 0.0;
+}
+
+// --- Geometry ---
+
+double sim_cast_ray(Sim2D *sim, double ox, double oy, double dx, double dy, double max_range, int *survivor_hit) {
+  if (!sim->grid.built) raygrid_build(&sim->grid, 0.0f);
+  return raygrid_cast(&sim->grid, (float)ox, (float)oy, (float)dx, (float)dy, (float)max_range,
+                      survivor_hit, &sim->ray_stats);
+}
+
+static bool sim_collides(Sim2D *sim, double x, double y) {
+  if (!sim->grid.built) raygrid_build(&sim->grid, 0.0f);
+  return raygrid_disc_overlaps(&sim->grid, (float)x, (float)y, (float)SIM_BODY_RADIUS);
+}
+
+// --- Kinematics ---
+
+static double clamp_wheel(double w) {
+  if (w > SIM_MAX_WHEEL_SPEED) return SIM_MAX_WHEEL_SPEED;
+  if (w < -SIM_MAX_WHEEL_SPEED) return -SIM_MAX_WHEEL_SPEED;
+  return w;
+}
+
+void sim_advance(Sim2D *sim, double dt) {
+  sim->wheel_angle[0] += clamp_wheel(sim->left_cmd) * dt;
+  sim->wheel_angle[1] += clamp_wheel(sim->right_cmd) * dt;
+  double vl = clamp_wheel(sim->left_cmd) * SIM_WHEEL_RADIUS;
+  double vr = clamp_wheel(sim->right_cmd) * SIM_WHEEL_RADIUS;
+  double v = 0.5 * (vl + vr);
+  double w = (vr - vl) / SIM_AXLE_LENGTH;
+
+  double nx, ny, nth = sim->theta + w * dt;
+  if (fabs(w) < 1e-9) { // Straight line
+    nx = sim->x + v * dt * cos(sim->theta);
+    ny = sim->y + v * dt * sin(sim->theta);
+  } else {              // Exact arc
+    double r = v / w;
+    nx = sim->x + r * (sin(nth) - sin(sim->theta));
+    ny = sim->y - r * (cos(nth) - cos(sim->theta));
+  }
+
+  bool contact = sim_collides(sim, nx, ny);
+  if (contact) { // Blocked: the wheels slip, only the heading changes
+    if (!sim->in_contact) sim->collisions++;
+    v = 0.0;
+  } else {
+    sim->distance_travelled += fabs(v) * dt;
+    sim->x = nx; sim->y = ny;
+  }
+  sim->in_contact = contact;
+  sim->theta = atan2(sin(nth), cos(nth));
+  sim->accel_forward = dt > 0.0 ? (v - sim->speed) / dt : 0.0;
+  sim->speed = v;
+  sim->time += dt;
+
+  // The body rotates onto the ground's tilt rather than jumping at a zone's edge
+  double roll, pitch, turn = SIM_TILT_RATE * dt;
+  sim_ground_tilt(sim, &roll, &pitch);
+  double droll = fmax(-turn, fmin(turn, roll - sim->roll)), dpitch = fmax(-turn, fmin(turn, pitch - sim->pitch));
+  sim->roll += droll;
+  sim->pitch += dpitch;
+  sim->roll_rate = dt > 0.0 ? droll / dt : 0.0;
+  sim->pitch_rate = dt > 0.0 ? dpitch / dt : 0.0;
+}
+
+void sim_ground_tilt(const Sim2D *sim, double *roll, double *pitch) {
+  *roll = *pitch = 0.0;
+  for (int i = 0; i < sim->num_tilt_zones; ++i) {
+    const SimTiltZone *z = &sim->tilt_zones[i];
+    if (sim->x >= z->xmin && sim->x <= z->xmax && sim->y >= z->ymin && sim->y <= z->ymax) {
+      *roll = z->roll;
+      *pitch = z->pitch;
+      return;
+    }
+  }
+}
+
+int sim_survivors_signaled(const Sim2D *sim) {
+  int n = 0;
+  for (int i = 0; i < sim->num_survivors; ++i) n += sim->survivors[i].signaled;
+  return n;
+}
+
+bool sim_bounds(const Sim2D *sim, double *xmin, double *ymin, double *xmax, double *ymax) {
+  if (sim->num_walls == 0) return false;
+  *xmin = *ymin = INFINITY;
+  *xmax = *ymax = -INFINITY;
+  for (int i = 0; i < sim->num_walls; ++i) {
+    const SimSegment *w = &sim->walls[i];
+    *xmin = fmin(*xmin, fmin(w->x0, w->x1));
+    *ymin = fmin(*ymin, fmin(w->y0, w->y1));
+    *xmax = fmax(*xmax, fmax(w->x0, w->x1));
+    *ymax = fmax(*ymax, fmax(w->y0, w->y1));
+  }
+  return true;
+}
+
+// --- Backend Operations ---
+
+static int sim_hal_step(void *ctx, int duration_ms) {
+  Sim2D *sim = ctx;
+  if (sim->steps >= sim->max_steps) return -1;
+  if (sim->stop_when_all_signaled && sim->all_signaled_time >= 0.0) return -1;
+  sim_advance(sim, duration_ms / 1000.0);
+  sim->steps++;
+  return 0;
+}
+
+static void sim_hal_sense(void *ctx, RescueInputs *in) {
+  Sim2D *sim = ctx;
+  in->time = sim->time;
+  in->has_pose = true; // Ground truth, like a supervisor reading its own node
+  in->pose[0] = sim->x;
+  in->pose[1] = sim->y;
+  in->pose[2] = sim->theta;
+  in->has_wheels = true;
+  in->wheel[0] = sim->wheel_angle[0];
+  in->wheel[1] = sim->wheel_angle[1];
+
+  double c = cos(sim->theta), s = sin(sim->theta);
+  double ox = sim->x + SIM_DS_OFFSET * c, oy = sim->y + SIM_DS_OFFSET * s;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    double a = sim->theta + sim->ds_angle[i];
+    in->ds[i] = sim_cast_ray(sim, ox, oy, cos(a), sin(a), SIM_DS_MAX_RANGE, &sim->ds_survivor[i]);
+    in->ds_present[i] = true;
+  }
+  in->num_ranges = sim->num_ranges;
+  for (int i = 0; i < sim->num_ranges; ++i) {
+    double a = sim->theta + sim->range_angle[i];
+    int hit;
+    in->range[i] = sim_cast_ray(sim, ox, oy, cos(a), sin(a), SIM_DS_MAX_RANGE, &hit);
+    in->range_angle[i] = sim->range_angle[i];
+  }
+
+  // Gravity seen through the tilt of the body plus the longitudinal acceleration
+  in->has_accel = true;
+  in->accel[0] = sim->accel_forward + SIM_GRAVITY * sin(sim->pitch);
+  in->accel[1] = SIM_GRAVITY * sin(sim->roll);
+  in->accel[2] = SIM_GRAVITY * cos(sim->pitch) * cos(sim->roll);
+  // The zones tilt the body the same whatever its heading, so only the
+  // changes of roll and pitch turn gravity; the yaw rate is left out
+  in->has_gyro = sim->has_gyro;
+  in->gyro[0] = sim->roll_rate;
+  in->gyro[1] = -sim->pitch_rate;
+  in->gyro[2] = 0.0;
+}
+
+static void sim_hal_recognize(void *ctx, RescueInputs *in) {
+  Sim2D *sim = ctx;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    in->survivor_seen[i] = sim->ds_survivor[i] >= 0;
+    in->survivor_id[i] = in->survivor_seen[i] ? sim->survivors[sim->ds_survivor[i]].id : -1;
+  }
+}
+
+static void sim_hal_actuate(void *ctx, const RescueOutputs *out) {
+  Sim2D *sim = ctx;
+  sim->left_cmd = out->left_speed;
+  sim->right_cmd = out->right_speed;
+  for (int i = 0; i < RESCUE_NUM_LEDS; ++i) sim->led[i] = out->led[i];
+}
+
+static bool sim_hal_emit(void *ctx, const void *data, int size) {
+  Sim2D *sim = ctx;
+  RescueTelemetry t;
+  if (rescue_telemetry_decode(data, size, &t)) { // Compare with the ground truth, like supervisor_monitor.py
+    sim->num_telemetry++;
+    sim->odom_error = hypot(t.x - sim->x, t.y - sim->y);
+    if (sim->odom_error > sim->odom_error_max) sim->odom_error_max = sim->odom_error;
+    return true;
+  }
+
+  SimMessage *m = &sim->messages[sim->num_messages++ % SIM_MAX_MESSAGES];
+  m->time = sim->time;
+  m->size = size < (int)sizeof(m->data) ? size : (int)sizeof(m->data);
+  memcpy(m->data, data, (size_t)m->size);
+
+  // Credit the closest survivor in signaling range, like the supervisor would
+  if (size > 0 && strncmp(data, SURVIVOR_MESSAGE, (size_t)size) == 0) {
+    int best = -1;
+    double best_d2 = SIM_SIGNAL_RANGE * SIM_SIGNAL_RANGE;
+    for (int i = 0; i < sim->num_survivors; ++i) {
+      const SimSurvivor *s = &sim->survivors[i];
+      double dx = s->x - sim->x, dy = s->y - sim->y;
+      double d2 = dx * dx + dy * dy - s->radius * s->radius;
+      if (d2 < best_d2) { best_d2 = d2; best = i; }
+    }
+    if (best >= 0 && !sim->survivors[best].signaled) {
+      sim->survivors[best].signaled = true;
+      sim->survivors[best].signal_time = sim->time;
+      if (sim_survivors_signaled(sim) == sim->num_survivors) sim->all_signaled_time = sim->time;
+    }
+  }
+  return true;
+}
+
+void sim_hal_init(Sim2D *sim, RescueHal *hal, long max_steps) {
+  sim->steps = 0;
+  sim->max_steps = max_steps;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) sim->ds_survivor[i] = -1;
+
+  hal->ctx = sim;
+  hal->step = sim_hal_step;
+  hal->sense = sim_hal_sense;
+  hal->recognize = sim_hal_recognize;
+  hal->actuate = sim_hal_actuate;
+  hal->emit = sim_hal_emit;
+  hal->sample_recognition = NULL; // Recognition is computed when asked for
+}
@@ -0,0 +1,124 @@
+/*
+ * Description: Headless 2D kinematic simulator standing in for Webots.
+ *              Models the BoeBot's two wheel motors (differential drive),
+ *              the ray-cast distance sensors ds_front/ds_left/ds_right with
+ *              recognition, the accelerometer (and optionally a gyro) and
+ *              the status_emitter, and
+ *              hosts the rescue controller through the RescueHal interface.
+ */
+
+#ifndef SIM2D_H
+#define SIM2D_H
+
+#include <stdbool.h>
+
+#include "../rescue_hal.h"
+#include "raycast.h"
+
+// --- BoeBot Geometry & Limits ---
+#define SIM_WHEEL_RADIUS 0.0335   // meters
+#define SIM_AXLE_LENGTH 0.104     // meters between the wheels
+#define SIM_BODY_RADIUS 0.06      // collision disk (meters)
+#define SIM_MAX_WHEEL_SPEED 6.28  // rad/s, motor maxVelocity
+#define SIM_DS_MAX_RANGE 1.0      // meters, reading when nothing is in range
+#define SIM_DS_OFFSET 0.05        // sensors sit this far ahead of the axle
+#define SIM_GRAVITY 9.81
+#define SIM_TILT_RATE 3.0         // rad/s the body rotates at settling onto a tilt zone
+
+#define SIM_MAX_MESSAGES 16       // Emitter packets kept for the "supervisor"
+
+// --- Arena ---
+typedef struct { double x0, y0, x1, y1; } SimSegment;
+
+typedef struct {
+  double x, y, radius;
+  int id;
+  bool signaled;          // The robot sent SURVIVOR_FOUND while next to it
+  double signal_time;     // Sim time of the first such signal
+} SimSurvivor;
+
+typedef struct {          // Rubble/ramp area that tilts the robot
+  double xmin, ymin, xmax, ymax;
+  double roll, pitch;     // radians
+} SimTiltZone;
+
+typedef struct {
+  double time;
+  int size;
+  char data[32];
+} SimMessage;
+
+typedef struct {
+  // --- World ---
+  SimSegment *walls; int num_walls, cap_walls;
+  SimSurvivor *survivors; int num_survivors, cap_survivors;
+  SimTiltZone *tilt_zones; int num_tilt_zones, cap_tilt_zones;
+  RayGrid grid;                       // Walls + survivor discs, rebuilt after changes
+  RayStats ray_stats;
+
+  // --- Robot ---
+  double x, y, theta;                 // Pose (theta = heading, radians)
+  double left_cmd, right_cmd;         // Motor velocity commands (rad/s)
+  double wheel_angle[2];              // Wheel position sensors (rad); they keep turning when blocked
+  double speed;                       // Forward speed last step (m/s)
+  double accel_forward;               // Longitudinal acceleration last step (m/s^2)
+  bool has_gyro;                      // Report rotation rates too (the BoeBot has no gyro)
+  double roll, pitch;                 // Body tilt (rad), following the ground's at up to SIM_TILT_RATE
+  double roll_rate, pitch_rate;       // Their change last step (rad/s), for the gyro
+  double ds_angle[RESCUE_NUM_DS];     // Sensor mounting angles relative to heading
+  int ds_survivor[RESCUE_NUM_DS];     // Survivor hit by each ray last sense, -1 if none
+  int num_ranges;                     // Range sensor layout for the avoidance (rescue_vfh.h), 0: the three ds
+  double range_angle[RESCUE_MAX_RANGES];
+  int led[RESCUE_NUM_LEDS];
+
+  // --- Bookkeeping ---
+  double time;                        // seconds
+  long steps, max_steps;
+  bool stop_when_all_signaled;        // step() also ends the run once every survivor is signaled
+  double all_signaled_time;           // Sim time the last survivor was signaled, -1 until then
+  long collisions;                    // Contact events (free -> touching)
+  bool in_contact;
+  double distance_travelled;
+  SimMessage messages[SIM_MAX_MESSAGES]; // Emitter ring buffer (telemetry excluded)
+  long num_messages;
+  long num_telemetry;                 // Odometry packets received
+  double odom_error, odom_error_max;  // Last and worst odometry position error (meters)
+} Sim2D;
+
+void sim_init(Sim2D *sim);
+void sim_free(Sim2D *sim);
+
+void sim_add_wall(Sim2D *sim, double x0, double y0, double x1, double y1);
+void sim_add_box(Sim2D *sim, double cx, double cy, double half_w, double half_h);
+int sim_add_survivor(Sim2D *sim, double x, double y, double radius);
+void sim_add_tilt_zone(Sim2D *sim, double xmin, double ymin, double xmax, double ymax, double roll, double pitch);
+void sim_set_pose(Sim2D *sim, double x, double y, double theta);
+
+// Gives the robot count range sensors (2 .. RESCUE_MAX_RANGES) spread evenly
+// from -90 to +90 degrees, reported in RescueInputs' range array; the three
+// ds stay for the state and recognition. 0 goes back to the ds only.
+void sim_set_range_sensors(Sim2D *sim, int count);
+
+// Casts one ray through the arena grid; returns the hit distance (max_range
+// if nothing) and the index of the survivor hit, or -1 for a wall / nothing.
+double sim_cast_ray(Sim2D *sim, double ox, double oy, double dx, double dy, double max_range, int *survivor_hit);
+
+// Roll and pitch (rad) of the ground under the robot: the first tilt zone
+// containing it, level if none.
+void sim_ground_tilt(const Sim2D *sim, double *roll, double *pitch);
+
+// Integrates the robot over dt seconds with the current motor commands.
+void sim_advance(Sim2D *sim, double dt);
+
+// Number of survivors that have been signaled so far.
+int sim_survivors_signaled(const Sim2D *sim);
+
+// Bounding box of the walls (the arena); false if there are none.
+bool sim_bounds(const Sim2D *sim, double *xmin, double *ymin, double *xmax, double *ymax);
+
+// Hosts the controller: fills hal with the simulator backend. step() returns
+// -1 after max_steps control steps (or once every survivor is signaled when
+// stop_when_all_signaled is set).
+void sim_hal_init(Sim2D *sim, RescueHal *hal, long max_steps);
+
+#endif // SIM2D_H
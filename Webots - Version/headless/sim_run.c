@@ -0,0 +1,193 @@
+/*
+ * Description: Runs the rescue controller inside the headless 2D simulator
+ *              and reports simulation speed and mission statistics.
+ *
+ * Usage: sim_run [steps] [trace] [--anytime] [--spin] [--fixed] [--ungoverned]
+ *               [--no-escape] [--no-debounce] [--no-mission] [--single-rate]
+ *               [--full-recognition] [--raw-tilt] [--bare]
+ *        steps: control steps (TIME_STEP each), however many ticks they take
+ *        trace: also record the run for headless/replay.c
+ *        --bare: the reactive state machine alone, every TIME_STEP: no
+ *                map, exploration, planner, avoidance, triggers, mission,
+ *                schedule, decimation or tilt estimator (the other options
+ *                then change nothing)
+ *        --anytime: plan paths in anytime mode (rescue_plan.h)
+ *        --spin: turn on the spot away from obstacles instead of steering
+ *                with the polar histogram (rescue_vfh.h)
+ *        --fixed: drive at FORWARD_SPEED and TURN_SPEED instead of the
+ *                 dynamic window (rescue_dwa.h)
+ *        --ungoverned: stay at FORWARD_SPEED instead of the top speed under
+ *                      the time-to-collision governor (rescue_speed.h)
+ *        --no-escape: no stuck detector (rescue_stuck.h)
+ *        --no-debounce: change state on single readings instead of the
+ *                       debounced triggers (rescue_trigger.h)
+ *        --no-mission: search only, no mission behavior tree
+ *                      (rescue_mission.h)
+ *        --single-rate: every task every TIME_STEP instead of the
+ *                       multi-rate schedule (rescue_schedule.h)
+ *        --full-recognition: recognize at the rate of the schedule, not
+ *                            decimated while nothing is close
+ *                            (rescue_recognition.h)
+ *        --raw-tilt: stop on a single accelerometer sample past
+ *                    TILT_THRESHOLD, no tilt estimator (rescue_tilt.h)
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../rescue_controller.h"
+#include "arenas.h"
+#include "sim2d.h"
+#include "stack.h"
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  const char *args[2] = {NULL, NULL};
+  bool anytime = false, spin = false, fixed = false, ungoverned = false, no_escape = false, no_debounce = false;
+  bool no_mission = false, single_rate = false, full_recognition = false, raw_tilt = false, bare = false;
+  for (int i = 1, n = 0; i < argc; ++i) {
+    if (strcmp(argv[i], "--anytime") == 0) anytime = true;
+    else if (strcmp(argv[i], "--spin") == 0) spin = true;
+    else if (strcmp(argv[i], "--fixed") == 0) fixed = true;
+    else if (strcmp(argv[i], "--ungoverned") == 0) ungoverned = true;
+    else if (strcmp(argv[i], "--no-escape") == 0) no_escape = true;
+    else if (strcmp(argv[i], "--no-debounce") == 0) no_debounce = true;
+    else if (strcmp(argv[i], "--no-mission") == 0) no_mission = true;
+    else if (strcmp(argv[i], "--single-rate") == 0) single_rate = true;
+    else if (strcmp(argv[i], "--full-recognition") == 0) full_recognition = true;
+    else if (strcmp(argv[i], "--raw-tilt") == 0) raw_tilt = true;
+    else if (strcmp(argv[i], "--bare") == 0) bare = true;
+    else if (n < 2) args[n++] = argv[i];
+  }
+  long steps = args[0] ? atol(args[0]) : 1000000;
+
+  Sim2D sim;
+  sim_init(&sim);
+  arena_simple(&sim);
+
+  uint32_t config = SIM_STACK_DEFAULT | (anytime ? RESCUE_TRACE_CONFIG_ANYTIME : 0);
+  if (spin) config &= ~(RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA);
+  if (fixed) config &= ~RESCUE_TRACE_CONFIG_DWA;
+  if (ungoverned) config &= ~RESCUE_TRACE_CONFIG_SPEED;
+  if (no_escape) config &= ~RESCUE_TRACE_CONFIG_STUCK;
+  if (no_debounce) config &= ~RESCUE_TRACE_CONFIG_TRIGGERS;
+  if (no_mission) config &= ~RESCUE_TRACE_CONFIG_MISSION;
+  if (single_rate) config &= ~RESCUE_TRACE_CONFIG_SCHEDULE;
+  if (full_recognition) config &= ~RESCUE_TRACE_CONFIG_RECOGNITION;
+  if (raw_tilt) config &= ~RESCUE_TRACE_CONFIG_TILT;
+  if (bare) config = 0;
+  static SimStack stack;
+  if (!sim_stack_init_arena(&stack, config, &sim)) { fprintf(stderr, "cannot allocate the map\n"); return 1; }
+  RescueController *controller = &stack.controller;
+  int tick = stack.tick_ms;
+  RescueHal hal;
+  sim_hal_init(&sim, &hal, steps * (TIME_STEP / tick));
+
+  RescueTraceWriter trace;
+  if (args[1]) {
+    if (!rescue_trace_open(&trace, args[1], tick, stack.config, stack.centered ? stack.map_center : NULL)) {
+      perror(args[1]);
+      return 1;
+    }
+    controller->trace = &trace;
+  } else {
+    rescue_plan_set_slice(&stack.planner, PLAN_SLICE_MS, true); // Nothing to replay: the deadline as on the robot
+  }
+
+  double t0 = now_seconds();
+  long done = rescue_run(&hal, controller);
+  double elapsed = now_seconds() - t0;
+
+  const RescueMap *map = &stack.map;
+  const RescueExplorer *explore = &stack.explore;
+  const RescuePlanner *planner = &stack.planner;
+  const RescueVfh *vfh = &stack.vfh;
+  const RescueDwa *dwa = &stack.dwa;
+  const RescueSpeed *governor = &stack.governor;
+  const RescueStuck *stuck = &stack.stuck;
+  const RescueTriggers *triggers = &stack.triggers;
+  const RescueMission *mission = &stack.mission;
+  const RescueSchedule *schedule = &stack.schedule;
+  const RescueRecognitionRate *recognition = &stack.recognition;
+  const RescueTilt *tilt = &stack.tilt;
+
+  printf("steps: %ld of %d ms  sim time: %.1f s  wall time: %.3f s  speed: %.0f steps/s (%.0fx real time)\n",
+         done, tick, sim.time, elapsed, done / elapsed, sim.time / elapsed);
+  printf("distance: %.1f m  collisions: %ld  emits: %ld  survivors signaled: %d/%d  final pose: (%.2f, %.2f, %.2f)\n",
+         sim.distance_travelled, sim.collisions, sim.num_messages,
+         sim_survivors_signaled(&sim), sim.num_survivors, sim.x, sim.y, sim.theta);
+  const RescueOdometry *odom = &controller->odom;
+  printf("odometry: (%.2f, %.2f, %.2f)  sigma x/y/theta: %.3f m %.3f m %.3f rad  error: %.3f m (max %.3f m, %ld packets)\n",
+         odom->pose[0], odom->pose[1], odom->pose[2], sqrt(odom->cov[0][0]), sqrt(odom->cov[1][1]),
+         sqrt(odom->cov[2][2]), sim.odom_error, sim.odom_error_max, sim.num_telemetry);
+  if (controller->map)
+    printf("map: %d/%d tiles (%.1f MB)  rays: %lu  cells updated: %lu  dropped: %lu\n", map->used_tiles, map->max_tiles,
+           rescue_map_memory(map) / 1048576.0, map->rays, map->cells_updated, map->cells_dropped);
+  if (controller->explore)
+    printf("explore: %lu cells searched  %d frontier cells  goals reached: %lu  abandoned: %lu  selections: %lu  "
+           "cells examined: %lu (%.1f/step)\n", explore->cells_searched, explore->frontier_cells, explore->goals_reached,
+           explore->goals_abandoned, explore->plans, explore->cells_examined,
+           done ? (double)explore->cells_examined / done : 0.0);
+  if (stack.config & RESCUE_TRACE_CONFIG_PLAN)
+    printf("plan: %lu repairs  %lu goals  %.1f expansions/repair (max %d)  slowest %.3f ms of %.1f ms  "
+           "cut short: %lu budget, %lu deadline  paths taken: %lu\n", planner->steps, planner->searches,
+           planner->steps ? (double)planner->expansions / planner->steps : 0.0, planner->max_step_expansions,
+           planner->max_step_ns / 1e6, PLAN_SLICE_MS, planner->budget_stops, planner->deadline_stops, explore->path_traces);
+  if (stack.config & RESCUE_TRACE_CONFIG_ANYTIME)
+    printf("anytime: %lu paths found  %lu restarts after map changes  bound now %.2f\n", planner->solutions,
+           planner->restarts, controller->plan_bound);
+  if (controller->vfh)
+    printf("avoid: %s kernel  %lu updates  boxed in: %lu  turning on the spot: %lu steps  reversals: %lu\n",
+           vfh->simd ? rescue_vfh_simd_name() : "scalar", vfh->updates, vfh->blocked_steps, vfh->turn_steps, vfh->reversals);
+  if (controller->dwa)
+    printf("dwa: %s kernel  %lu windows  %.0f rollouts/ms  braking: %lu steps\n", dwa->simd ? rescue_dwa_simd_name() : "scalar",
+           dwa->updates, rescue_dwa_rollouts_per_ms(dwa), dwa->stops);
+  if (controller->speed)
+    printf("speed: top %.2f rad/s  slowed: %lu of %lu steps  average scale: %.2f  shortest ttc: %.2f s\n",
+           governor->top_speed, governor->slowed, governor->updates,
+           governor->updates ? governor->scale_sum / governor->updates : 1.0, governor->min_ttc);
+  if (controller->stuck)
+    printf("stuck: %lu escapes  not moving: %lu  oscillating: %lu  along a wall: %lu  escaping: %.1f s\n", stuck->escapes,
+           stuck->stalls, stuck->oscillations, stuck->wall_follows, stuck->escape_steps * TIME_STEP / 1000.0);
+  if (controller->triggers)
+    printf("triggers: suppressed obstacle: %lu of %lu  tilt: %lu of %lu  survivor: %lu of %lu\n",
+           rescue_trigger_suppressed(&triggers->obstacle), triggers->obstacle.raw_changes,
+           rescue_trigger_suppressed(&triggers->tilt), triggers->tilt.raw_changes,
+           rescue_trigger_suppressed(&triggers->survivor), triggers->survivor.raw_changes);
+  if (controller->mission)
+    printf("mission: approaches: %lu (served %lu, given up %lu)  returns: %lu  docked: %.1f s  "
+           "leaf calls/tick: %.2f (max %d)  cut short: %lu  preemptions: %lu\n", mission->approaches,
+           mission->approaches_served, mission->approaches_abandoned, mission->returns,
+           mission->docked_steps * TIME_STEP / 1000.0,
+           mission->tree.ticks ? (double)mission->tree.leaf_calls / mission->tree.ticks : 0.0,
+           mission->tree.max_tick_calls, mission->tree.yields, mission->tree.preemptions);
+  rescue_state_stats_dump(&controller->states, TIME_STEP, stdout);
+  if (controller->schedule) {
+    rescue_schedule_dump(schedule, stdout);
+    printf("reflex: %lu turns started between control steps\n", controller->reflexes);
+  }
+  if (controller->recognition)
+    printf("recognition: %lu runs  saved: %lu of %lu opportunities (%.0f%%)  escalations: %lu  at full rate: %.1f s\n",
+           recognition->calls, recognition->saved, recognition->steps,
+           recognition->steps ? 100.0 * recognition->saved / recognition->steps : 0.0, recognition->escalations,
+           recognition->escalated_steps * recognition->period_ms / 1000.0);
+  if (controller->tilt)
+    printf("tilt: %lu updates%s  gated: %lu  slowed: %lu (mean scale %.2f)  max: %.2f m/s^2\n", tilt->updates,
+           tilt->gyro ? " (gyro)" : "", tilt->gated, tilt->slowed, tilt->updates ? tilt->scale_sum / tilt->updates : 1.0,
+           tilt->max_tilt);
+  if (controller->trace) {
+    rescue_trace_close(&trace);
+    printf("trace: %ld steps written to %s%s\n", trace.records, args[1], trace.failed ? " (write error)" : "");
+  }
+  sim_stack_free(&stack);
+  sim_free(&sim);
+  return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Description: The controller as the Webots controller runs it, for the
+ *              headless tools (see stack.h).
+ */
+
+#include "stack.h"
+
+#include <string.h>
+
+bool sim_stack_init(SimStack *s, uint32_t config, const double *map_center) {
+  memset(s, 0, sizeof(*s));
+  RescueController *c = &s->controller;
+  rescue_controller_init(c);
+  c->verbose = false;
+  s->config = config & ~RESCUE_TRACE_CONFIG_MAP_CENTER;
+
+  // --- Map, Explorer & Planner ---
+  if (config & RESCUE_TRACE_CONFIG_EXPLORE) {
+    if (!rescue_map_init(&s->map, RESCUE_MAP_MAX_TILES)) return false;
+    if (!rescue_explore_init(&s->explore, &s->map)) { rescue_map_free(&s->map); return false; }
+    if (map_center) {
+      s->centered = true;
+      s->map_center[0] = map_center[0];
+      s->map_center[1] = map_center[1];
+      rescue_map_center(&s->map, map_center[0], map_center[1]);
+    }
+    c->map = &s->map;
+    c->explore = &s->explore;
+  } else {
+    s->config &= ~(RESCUE_TRACE_CONFIG_PLAN | RESCUE_TRACE_CONFIG_ANYTIME); // Nothing to plan for
+  }
+  if (c->explore && (config & RESCUE_TRACE_CONFIG_PLAN)) {
+    if (!rescue_plan_init(&s->planner, RESCUE_EXPLORE_CELLS, RESCUE_EXPLORE_CELLS, RESCUE_PLAN_MAX_NODES, PLAN_SLICE_MS)) {
+      rescue_explore_free(&s->explore);
+      rescue_map_free(&s->map);
+      return false;
+    }
+    rescue_plan_set_slice(&s->planner, PLAN_SLICE_MS, false); // Same runs on any host
+    if (config & RESCUE_TRACE_CONFIG_ANYTIME) rescue_plan_set_anytime(&s->planner, PLAN_EPSILON);
+    s->explore.planner = &s->planner;
+  }
+
+  // --- Steering & Speed ---
+  rescue_vfh_init(&s->vfh);
+  if (config & RESCUE_TRACE_CONFIG_VFH) c->vfh = &s->vfh;
+  rescue_dwa_init(&s->dwa, config & RESCUE_TRACE_CONFIG_SPEED ? RESCUE_SPEED_TOP : FORWARD_SPEED);
+  if (config & RESCUE_TRACE_CONFIG_DWA) c->dwa = &s->dwa;
+  rescue_speed_init(&s->governor, RESCUE_SPEED_TOP);
+  if (config & RESCUE_TRACE_CONFIG_SPEED) c->speed = &s->governor;
+  rescue_stuck_init(&s->stuck);
+  if (config & RESCUE_TRACE_CONFIG_STUCK) c->stuck = &s->stuck;
+
+  // --- Decisions ---
+  rescue_triggers_init(&s->triggers);
+  if (config & RESCUE_TRACE_CONFIG_TRIGGERS) c->triggers = &s->triggers;
+  rescue_mission_init(&s->mission, MISSION_RETURN_AFTER, MISSION_SLICE_MS, false);
+  if (config & RESCUE_TRACE_CONFIG_MISSION) c->mission = &s->mission;
+  rescue_tilt_init(&s->tilt, TILT_THRESHOLD);
+  if (config & RESCUE_TRACE_CONFIG_TILT) c->tilt = &s->tilt;
+
+  // --- Rates ---
+  rescue_tasks_init(&s->schedule);
+  if (config & RESCUE_TRACE_CONFIG_SCHEDULE) c->schedule = &s->schedule;
+  s->tick_ms = c->schedule ? s->schedule.tick_ms : TIME_STEP;
+  rescue_recognition_rate_init(&s->recognition, c->schedule ? RECOGNIZE_PERIOD : TIME_STEP, RECOGNIZE_RELAXED_PERIOD,
+                               SURVIVOR_DETECTION_RANGE, RESCUE_RECOG_HOLD_STEPS);
+  if (config & RESCUE_TRACE_CONFIG_RECOGNITION) c->recognition = &s->recognition;
+  return true;
+}
+
+bool sim_stack_init_arena(SimStack *s, uint32_t config, const Sim2D *sim) {
+  double x0, y0, x1, y1;
+  if (!sim_bounds(sim, &x0, &y0, &x1, &y1)) return sim_stack_init(s, config, NULL);
+  const double center[2] = {0.5 * (x0 + x1), 0.5 * (y0 + y1)};
+  return sim_stack_init(s, config, center);
+}
+
+void sim_stack_free(SimStack *s) {
+  // By what was set up: a tool may have detached parts since
+  if (s->config & RESCUE_TRACE_CONFIG_PLAN) rescue_plan_free(&s->planner);
+  if (s->config & RESCUE_TRACE_CONFIG_EXPLORE) {
+    rescue_explore_free(&s->explore);
+    rescue_map_free(&s->map);
+  }
+  s->config = 0;
+  s->controller.map = NULL;
+  s->controller.explore = NULL;
+}
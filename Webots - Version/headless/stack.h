@@ -0,0 +1,71 @@
+/*
+ * Description: The controller set up the way the Webots controller runs it
+ *              (boebot_rescue.c), for the headless tools: occupancy grid,
+ *              frontier explorer and path planner, polar histogram, dynamic
+ *              window, speed governor, stuck detector, debounced triggers,
+ *              mission tree, multi-rate schedule, decimated recognition and
+ *              tilt estimator. Which parts are attached is given as
+ *              RESCUE_TRACE_CONFIG_* bits, the same ones a trace header
+ *              records, so sim_run, replay and every bench set the
+ *              controller up from one place and a bench only names what it
+ *              compares.
+ *
+ *              Planner and mission tree run on their budgets without a
+ *              clock, so a run is the same on any host. A SimStack is big
+ *              (keep it static) and must not move once set up: the
+ *              controller points into it.
+ */
+
+#ifndef STACK_H
+#define STACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "../rescue_controller.h"
+#include "../rescue_trace.h"
+#include "sim2d.h"
+
+// What the Webots controller runs without options
+#define SIM_STACK_DEFAULT                                                                                    \
+  (RESCUE_TRACE_CONFIG_EXPLORE | RESCUE_TRACE_CONFIG_PLAN | RESCUE_TRACE_CONFIG_VFH | RESCUE_TRACE_CONFIG_DWA | \
+   RESCUE_TRACE_CONFIG_SPEED | RESCUE_TRACE_CONFIG_STUCK | RESCUE_TRACE_CONFIG_TRIGGERS |                     \
+   RESCUE_TRACE_CONFIG_MISSION | RESCUE_TRACE_CONFIG_SCHEDULE | RESCUE_TRACE_CONFIG_RECOGNITION |             \
+   RESCUE_TRACE_CONFIG_TILT)
+
+typedef struct {
+  RescueController controller;
+  uint32_t config;                   // RESCUE_TRACE_CONFIG_* bits set up
+  int tick_ms;                       // Period rescue_run steps the backend at
+  bool centered;                     // The map is centered on map_center, not the first pose
+  double map_center[2];
+  RescueMap map;                     // With RESCUE_TRACE_CONFIG_EXPLORE
+  RescueExplorer explore;
+  RescuePlanner planner;             // With RESCUE_TRACE_CONFIG_PLAN as well
+  RescueVfh vfh;
+  RescueDwa dwa;
+  RescueSpeed governor;
+  RescueStuck stuck;
+  RescueTriggers triggers;
+  RescueMission mission;
+  RescueSchedule schedule;
+  RescueRecognitionRate recognition;
+  RescueTilt tilt;
+} SimStack;
+
+// Sets up s->controller with the parts config asks for. map_center: where
+// to center the map, NULL for the first pose. Returns false if the map,
+// explorer or planner cannot be allocated.
+bool sim_stack_init(SimStack *s, uint32_t config, const double *map_center);
+
+// The same with the map centered on the arena (the bounding box of its walls).
+bool sim_stack_init_arena(SimStack *s, uint32_t config, const Sim2D *sim);
+
+void sim_stack_free(SimStack *s);
+
+// Steps of tick_ms that simulate the given time.
+static inline long sim_stack_ticks(const SimStack *s, double seconds) {
+  return (long)(seconds * 1000.0 / s->tick_ms);
+}
+
+#endif // STACK_H
@@ -0,0 +1,93 @@
+/*
+ * Description: In-process stand-in backend for the rescue controller.
+ *              The world is a wall ahead that gets closer while the robot
+ *              drives forward and moves away again after it turns.
+ */
+
+#include "stub_hal.h"
+
+#include <stddef.h>
+
+#include "../rescue_controller.h"
+
+#define STUB_WHEEL_RADIUS 0.0335 // meters, BoeBot wheel
+
+static double stub_random(StubHal *s) { // LCG, deterministic per seed
+  s->seed = s->seed * 1103515245u + 12345u;
+  return (double)((s->seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+static int stub_step(void *ctx, int duration_ms) {
+  StubHal *s = ctx;
+  if (s->steps >= s->max_steps) return -1;
+  s->steps++;
+  s->time += duration_ms / 1000.0;
+
+  // Apply the last command to the scripted world
+  double l = s->last.left_speed, r = s->last.right_speed;
+  if (l > 0.0 && r > 0.0) {
+    s->front -= 0.5 * (l + r) * STUB_WHEEL_RADIUS * duration_ms / 1000.0;
+    if (s->front < 0.05) s->front = 0.05;
+  } else if (l != r) { // Turning in place opens up a new view
+    s->front = 0.2 + 1.8 * stub_random(s);
+    s->left = 0.1 + 0.9 * stub_random(s);
+    s->right = 0.1 + 0.9 * stub_random(s);
+  }
+  return 0;
+}
+
+static void stub_sense(void *ctx, RescueInputs *in) {
+  StubHal *s = ctx;
+  in->time = s->time;
+  in->ds[RESCUE_DS_FRONT] = s->front;
+  in->ds[RESCUE_DS_LEFT] = s->left;
+  in->ds[RESCUE_DS_RIGHT] = s->right;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) in->ds_present[i] = true;
+  in->has_accel = true;
+  in->accel[0] = s->accel[0]; in->accel[1] = s->accel[1]; in->accel[2] = s->accel[2];
+}
+
+static void stub_recognize(void *ctx, RescueInputs *in) {
+  StubHal *s = ctx;
+  if (s->survivor_every > 0 && s->steps % s->survivor_every == 0) {
+    in->survivor_seen[RESCUE_DS_FRONT] = true;
+    s->front = 0.25;
+  }
+}
+
+static void stub_actuate(void *ctx, const RescueOutputs *out) {
+  StubHal *s = ctx;
+  s->last = *out;
+}
+
+static bool stub_emit(void *ctx, const void *data, int size) {
+  StubHal *s = ctx;
+  RescueTelemetry t;
+  if (rescue_telemetry_decode(data, size, &t)) s->telemetry++;
+  else s->emits++;
+  return true;
+}
+
+void stub_hal_init(StubHal *s, RescueHal *hal, long max_steps) {
+  s->max_steps = max_steps;
+  s->steps = 0;
+  s->time = 0.0;
+  s->front = 1.0; s->left = 0.5; s->right = 0.5;
+  s->accel[0] = 0.0; s->accel[1] = 0.0; s->accel[2] = 9.81;
+  s->survivor_every = 997;
+  s->seed = 1;
+  s->last.left_speed = s->last.right_speed = 0.0;
+  s->last.led[0] = s->last.led[1] = 0;
+  s->last.message = NULL;
+  s->last.message_size = 0;
+  s->emits = 0;
+  s->telemetry = 0;
+
+  hal->ctx = s;
+  hal->step = stub_step;
+  hal->sense = stub_sense;
+  hal->recognize = stub_recognize;
+  hal->actuate = stub_actuate;
+  hal->emit = stub_emit;
+  hal->sample_recognition = NULL;
+}
@@ -0,0 +1,29 @@
+/*
+ * Description: In-process stand-in backend for the rescue controller.
+ *              Replaces Webots with a tiny scripted world so the control
+ *              logic can be stepped millions of times per second.
+ */
+
+#ifndef STUB_HAL_H
+#define STUB_HAL_H
+
+#include "../rescue_hal.h"
+
+typedef struct {
+  long max_steps;          // step() returns -1 after this many steps
+  long steps;
+  double time;
+  // --- Scripted World ---
+  double front, left, right; // Distances the sensors will report (meters)
+  double accel[3];
+  long survivor_every;     // A survivor appears in front every N steps, 0 = never
+  unsigned int seed;
+  // --- Observed Commands ---
+  RescueOutputs last;
+  long emits;
+  long telemetry;          // Odometry packets (not counted in emits)
+} StubHal;
+
+void stub_hal_init(StubHal *s, RescueHal *hal, long max_steps);
+
+#endif // STUB_HAL_H
@@ -0,0 +1,321 @@
+/*
+ * Description: Structure-of-arrays swarm of BoeBots running the rescue
+ *              policy. Each work chunk runs four passes over its robots:
+ *              sensing (ray casts, branchy), the policy (branch-free, one
+ *              lane per robot), kinematics (branch-free, heading kept as a
+ *              unit vector so no trig calls) and collisions/coverage.
+ *              Robots only read the previous positions of other robots,
+ *              so results do not depend on the thread count.
+ */
+
+#include "swarm.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../rescue_policy.h"
+
+// --- Setup ---
+
+static float swarm_random(unsigned int *seed) { // LCG, deterministic per seed
+  *seed = *seed * 1103515245u + 12345u;
+  return (float)((*seed >> 8) & 0xFFFFFF) / 16777216.0f;
+}
+
+void swarm_init(Swarm *s, const Sim2D *world, int n, unsigned int seed, int num_workers) {
+  memset(s, 0, sizeof(*s));
+  s->world = world;
+  SwarmRobots *r = &s->r;
+  r->n = n;
+  size_t fn = (size_t)(n > 0 ? n : 1);
+  r->x = calloc(fn, sizeof(float)); r->y = calloc(fn, sizeof(float));
+  r->hc = calloc(fn, sizeof(float)); r->hs = calloc(fn, sizeof(float));
+  r->next_x = calloc(fn, sizeof(float)); r->next_y = calloc(fn, sizeof(float));
+  r->wl = calloc(fn, sizeof(float)); r->wr = calloc(fn, sizeof(float));
+  r->state = calloc(fn, sizeof(int)); r->aid_deploy_counter = calloc(fn, sizeof(int));
+  r->led = calloc(fn, sizeof(int));
+  for (int k = 0; k < RESCUE_NUM_DS; ++k) {
+    r->ds[k] = calloc(fn, sizeof(float));
+    r->ds_tag[k] = calloc(fn, sizeof(int));
+  }
+  r->collisions = calloc(fn, sizeof(int)); r->in_contact = calloc(fn, 1);
+  r->signals = calloc(fn, sizeof(int));
+
+  const RayGrid *g = &world->grid;
+  s->bin_size = (float)(SIM_DS_OFFSET + SIM_DS_MAX_RANGE + SIM_BODY_RADIUS); // A ray never leaves the 3x3 bins
+  s->bin_min_x = g->min_x; s->bin_min_y = g->min_y;
+  s->bnx = (int)ceilf((g->max_x - g->min_x) / s->bin_size); if (s->bnx < 1) s->bnx = 1;
+  s->bny = (int)ceilf((g->max_y - g->min_y) / s->bin_size); if (s->bny < 1) s->bny = 1;
+  s->bin_start = calloc((size_t)s->bnx * s->bny + 1, sizeof(int));
+  s->bin_items = calloc(fn, sizeof(int));
+
+  s->cnx = (int)ceilf((g->max_x - g->min_x) / SWARM_COVERAGE_CELL);
+  s->cny = (int)ceilf((g->max_y - g->min_y) / SWARM_COVERAGE_CELL);
+  s->coverage = calloc((size_t)s->cnx * s->cny, 1);
+  s->survivor_signaled = calloc((size_t)(world->num_survivors > 0 ? world->num_survivors : 1), 1);
+  s->num_workers = num_workers;
+  s->worker_stats = calloc((size_t)num_workers, sizeof(RayStats));
+
+  // Random collision-free poses, robots at least two body widths apart
+  float clearance = (float)SIM_BODY_RADIUS * 1.5f, apart = (float)SIM_BODY_RADIUS * 4.0f;
+  for (int i = 0; i < n; ++i) {
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+      float x = g->min_x + swarm_random(&seed) * (g->max_x - g->min_x);
+      float y = g->min_y + swarm_random(&seed) * (g->max_y - g->min_y);
+      if (raygrid_disc_overlaps(g, x, y, clearance)) continue;
+      bool crowded = false;
+      for (int j = 0; j < i && !crowded; ++j)
+        crowded = (r->x[j] - x) * (r->x[j] - x) + (r->y[j] - y) * (r->y[j] - y) < apart * apart;
+      if (crowded) continue;
+      r->x[i] = x; r->y[i] = y;
+      break;
+    }
+    float a = swarm_random(&seed) * 2.0f * (float)M_PI;
+    r->hc[i] = cosf(a); r->hs[i] = sinf(a);
+    r->state[i] = SEARCHING;
+  }
+}
+
+void swarm_free(Swarm *s) {
+  SwarmRobots *r = &s->r;
+  free(r->x); free(r->y); free(r->hc); free(r->hs); free(r->next_x); free(r->next_y);
+  free(r->wl); free(r->wr); free(r->state); free(r->aid_deploy_counter); free(r->led);
+  for (int k = 0; k < RESCUE_NUM_DS; ++k) { free(r->ds[k]); free(r->ds_tag[k]); }
+  free(r->collisions); free(r->in_contact); free(r->signals);
+  free(s->bin_start); free(s->bin_items);
+  free((void *)s->coverage); free((void *)s->survivor_signaled);
+  free(s->worker_stats);
+  memset(s, 0, sizeof(*s));
+}
+
+// --- Robot Bins ---
+
+static int bin_of(const Swarm *s, float x, float y, int *bx, int *by) {
+  int cx = (int)floorf((x - s->bin_min_x) / s->bin_size);
+  int cy = (int)floorf((y - s->bin_min_y) / s->bin_size);
+  cx = cx < 0 ? 0 : (cx >= s->bnx ? s->bnx - 1 : cx);
+  cy = cy < 0 ? 0 : (cy >= s->bny ? s->bny - 1 : cy);
+  if (bx) { *bx = cx; *by = cy; }
+  return cy * s->bnx + cx;
+}
+
+static void swarm_bin_robots(Swarm *s) { // Counting sort by bin
+  int bins = s->bnx * s->bny;
+  memset(s->bin_start, 0, ((size_t)bins + 1) * sizeof(int));
+  for (int i = 0; i < s->r.n; ++i) s->bin_start[bin_of(s, s->r.x[i], s->r.y[i], NULL, NULL) + 1]++;
+  for (int b = 0; b < bins; ++b) s->bin_start[b + 1] += s->bin_start[b];
+  int *cursor = s->bin_start; // Reuse: shift back afterwards
+  for (int i = 0; i < s->r.n; ++i) s->bin_items[cursor[bin_of(s, s->r.x[i], s->r.y[i], NULL, NULL)]++] = i;
+  for (int b = bins; b > 0; --b) s->bin_start[b] = s->bin_start[b - 1];
+  s->bin_start[0] = 0;
+}
+
+// Nearest other robot hit by the ray if closer than best.
+static float robots_ray(const Swarm *s, int self, float ox, float oy, float dx, float dy, float best, int *tag) {
+  const SwarmRobots *r = &s->r;
+  const float rr = (float)(SIM_BODY_RADIUS * SIM_BODY_RADIUS);
+  int bx, by;
+  bin_of(s, r->x[self], r->y[self], &bx, &by);
+  for (int cy = by - 1; cy <= by + 1; ++cy) {
+    if (cy < 0 || cy >= s->bny) continue;
+    for (int cx = bx - 1; cx <= bx + 1; ++cx) {
+      if (cx < 0 || cx >= s->bnx) continue;
+      int b = cy * s->bnx + cx;
+      for (int k = s->bin_start[b]; k < s->bin_start[b + 1]; ++k) {
+        int j = s->bin_items[k];
+        if (j == self) continue;
+        float fx = ox - r->x[j], fy = oy - r->y[j];
+        float bb = fx * dx + fy * dy;
+        float disc = bb * bb - (fx * fx + fy * fy - rr);
+        if (disc < 0.0f) continue;
+        float t = -bb - sqrtf(disc);
+        if (t >= 0.0f && t < best) { best = t; *tag = RAYGRID_NO_TAG; }
+      }
+    }
+  }
+  return best;
+}
+
+// Would moving to (x, y) bring us closer into another robot?
+static bool robots_block(const Swarm *s, int self, float x, float y) {
+  const SwarmRobots *r = &s->r;
+  const float min_d2 = (float)(4.0 * SIM_BODY_RADIUS * SIM_BODY_RADIUS);
+  int bx, by;
+  bin_of(s, x, y, &bx, &by);
+  for (int cy = by - 1; cy <= by + 1; ++cy) {
+    if (cy < 0 || cy >= s->bny) continue;
+    for (int cx = bx - 1; cx <= bx + 1; ++cx) {
+      if (cx < 0 || cx >= s->bnx) continue;
+      int b = cy * s->bnx + cx;
+      for (int k = s->bin_start[b]; k < s->bin_start[b + 1]; ++k) {
+        int j = s->bin_items[k];
+        if (j == self) continue;
+        float nx = x - r->x[j], ny = y - r->y[j];
+        float d2 = nx * nx + ny * ny;
+        if (d2 >= min_d2) continue;
+        float ox = r->x[self] - r->x[j], oy = r->y[self] - r->y[j];
+        if (d2 < ox * ox + oy * oy) return true; // Overlapping robots may still separate
+      }
+    }
+  }
+  return false;
+}
+
+// --- Step ---
+
+// Midpoint rule with the heading rotated by a polynomial, so the loop has
+// no calls and vectorizes.
+static void swarm_kinematics(int n, float dt, const float *restrict x, const float *restrict y,
+                             const float *restrict wls, const float *restrict wrs,
+                             float *restrict hc, float *restrict hs,
+                             float *restrict next_x, float *restrict next_y) {
+  const float radius = (float)SIM_WHEEL_RADIUS, inv_axle = 1.0f / (float)SIM_AXLE_LENGTH;
+  const float max_w = (float)SIM_MAX_WHEEL_SPEED;
+  for (int i = 0; i < n; ++i) {
+    float wl = wls[i] > max_w ? max_w : wls[i] < -max_w ? -max_w : wls[i];
+    float wr = wrs[i] > max_w ? max_w : wrs[i] < -max_w ? -max_w : wrs[i];
+    float v = 0.5f * (wl + wr) * radius;
+    float h = 0.5f * (wr - wl) * radius * inv_axle * dt; // Half of this step's rotation
+    float h2 = h * h;
+    float ch = 1.0f - h2 * (0.5f - h2 * (1.0f / 24.0f));
+    float sh = h * (1.0f - h2 * ((1.0f / 6.0f) - h2 * (1.0f / 120.0f)));
+    float mc = hc[i] * ch - hs[i] * sh, ms = hs[i] * ch + hc[i] * sh;
+    next_x[i] = x[i] + v * dt * mc;
+    next_y[i] = y[i] + v * dt * ms;
+    float nc = mc * ch - ms * sh, ns = ms * ch + mc * sh;
+    float k = 1.5f - 0.5f * (nc * nc + ns * ns); // Keep it unit length
+    hc[i] = nc * k;
+    hs[i] = ns * k;
+  }
+}
+
+typedef struct {
+  Swarm *s;
+  float dt;
+} SwarmStepCtx;
+
+static void swarm_chunk(void *ctx, int begin, int end, int worker) {
+  SwarmStepCtx *step = ctx;
+  Swarm *s = step->s;
+  SwarmRobots *r = &s->r;
+  const Sim2D *w = s->world;
+  const float dt = step->dt;
+  int survivor[SWARM_GRAIN], tilted[SWARM_GRAIN];
+  unsigned events[SWARM_GRAIN];
+  int n = end - begin;
+
+  // --- 1. Sensing ---
+  float mount_c[RESCUE_NUM_DS], mount_s[RESCUE_NUM_DS];
+  for (int k = 0; k < RESCUE_NUM_DS; ++k) { mount_c[k] = cosf((float)w->ds_angle[k]); mount_s[k] = sinf((float)w->ds_angle[k]); }
+  for (int l = 0; l < n; ++l) {
+    int i = begin + l;
+    float ox = r->x[i] + (float)SIM_DS_OFFSET * r->hc[i], oy = r->y[i] + (float)SIM_DS_OFFSET * r->hs[i];
+    for (int k = 0; k < RESCUE_NUM_DS; ++k) {
+      float dx = r->hc[i] * mount_c[k] - r->hs[i] * mount_s[k];
+      float dy = r->hs[i] * mount_c[k] + r->hc[i] * mount_s[k];
+      int tag;
+      float t = raygrid_cast(&w->grid, ox, oy, dx, dy, (float)SIM_DS_MAX_RANGE, &tag, &s->worker_stats[worker]);
+      r->ds[k][i] = robots_ray(s, i, ox, oy, dx, dy, t, &tag);
+      r->ds_tag[k][i] = tag;
+    }
+    double a[3] = {0.0, 0.0, SIM_GRAVITY};
+    for (int z = 0; z < w->num_tilt_zones; ++z) {
+      const SimTiltZone *tz = &w->tilt_zones[z];
+      if (r->x[i] >= tz->xmin && r->x[i] <= tz->xmax && r->y[i] >= tz->ymin && r->y[i] <= tz->ymax) {
+        a[0] = SIM_GRAVITY * sin(tz->pitch); a[1] = SIM_GRAVITY * sin(tz->roll);
+        break;
+      }
+    }
+    tilted[l] = rescue_policy_tilted(a);
+  }
+
+  // --- 2. Policy, one lane per robot ---
+  for (int l = 0; l < n; ++l) {
+    int i = begin + l;
+    int seen = 0;
+    for (int k = 0; k < RESCUE_NUM_DS; ++k)
+      seen |= (r->ds_tag[k][i] >= 0) & (r->ds[k][i] < (float)SURVIVOR_DETECTION_RANGE);
+    survivor[l] = seen;
+    double left, right, avoid_left, avoid_right;
+    rescue_policy_avoid_turn(r->ds[RESCUE_DS_LEFT][i], r->ds[RESCUE_DS_RIGHT][i], &avoid_left, &avoid_right);
+    events[l] = rescue_policy_step(&r->state[i], &r->aid_deploy_counter[i],
+                                   r->ds[RESCUE_DS_FRONT][i] < OBSTACLE_DISTANCE_THRESHOLD, survivor[l], tilted[l],
+                                   FORWARD_SPEED, FORWARD_SPEED, avoid_left, avoid_right, &left, &right, &r->led[i]);
+    r->wl[i] = (float)left;
+    r->wr[i] = (float)right;
+  }
+
+  // --- 3. Kinematics ---
+  swarm_kinematics(n, dt, r->x + begin, r->y + begin, r->wl + begin, r->wr + begin,
+                   r->hc + begin, r->hs + begin, r->next_x + begin, r->next_y + begin);
+
+  // --- 4. Collisions, coverage, signals ---
+  const float body = (float)SIM_BODY_RADIUS;
+  for (int l = 0; l < n; ++l) {
+    int i = begin + l;
+    bool contact = raygrid_disc_overlaps(&w->grid, r->next_x[i], r->next_y[i], body) ||
+                   robots_block(s, i, r->next_x[i], r->next_y[i]);
+    if (contact) {
+      r->collisions[i] += !r->in_contact[i];
+      r->next_x[i] = r->x[i]; r->next_y[i] = r->y[i];
+    }
+    r->in_contact[i] = contact;
+
+    int cx = (int)((r->next_x[i] - w->grid.min_x) * (float)(1.0 / SWARM_COVERAGE_CELL));
+    int cy = (int)((r->next_y[i] - w->grid.min_y) * (float)(1.0 / SWARM_COVERAGE_CELL));
+    if (cx >= 0 && cx < s->cnx && cy >= 0 && cy < s->cny)
+      atomic_store_explicit(&s->coverage[cy * s->cnx + cx], 1, memory_order_relaxed);
+
+    if (events[l] & RESCUE_EV_SIGNAL) {
+      r->signals[i]++;
+      for (int k = 0; k < RESCUE_NUM_DS; ++k) // Credit the survivor that triggered it
+        if (r->ds_tag[k][i] >= 0 && r->ds[k][i] < (float)SURVIVOR_DETECTION_RANGE) {
+          atomic_store_explicit(&s->survivor_signaled[r->ds_tag[k][i]], 1, memory_order_relaxed);
+          break;
+        }
+    }
+  }
+}
+
+void swarm_step(Swarm *s, WorkPool *pool, double dt) {
+  swarm_bin_robots(s);
+  SwarmStepCtx ctx = {s, (float)dt};
+  workpool_parallel_for(pool, s->r.n, SWARM_GRAIN, swarm_chunk, &ctx);
+  float *t = s->r.x; s->r.x = s->r.next_x; s->r.next_x = t;
+  t = s->r.y; s->r.y = s->r.next_y; s->r.next_y = t;
+  s->steps++;
+}
+
+// --- Results ---
+
+double swarm_coverage(const Swarm *s) {
+  long visited = 0, cells = (long)s->cnx * s->cny;
+  for (long c = 0; c < cells; ++c) visited += atomic_load_explicit(&s->coverage[c], memory_order_relaxed);
+  return cells ? (double)visited / cells : 0.0;
+}
+
+int swarm_survivors_signaled(const Swarm *s) {
+  int n = 0;
+  for (int i = 0; i < s->world->num_survivors; ++i) n += atomic_load(&s->survivor_signaled[i]);
+  return n;
+}
+
+long swarm_collisions(const Swarm *s) {
+  long n = 0;
+  for (int i = 0; i < s->r.n; ++i) n += s->r.collisions[i];
+  return n;
+}
+
+unsigned long swarm_checksum(const Swarm *s) { // FNV-1a
+  unsigned long h = 1469598103934665603ul;
+  const SwarmRobots *r = &s->r;
+  for (int i = 0; i < r->n; ++i) {
+    uint32_t words[5];
+    memcpy(&words[0], &r->x[i], 4); memcpy(&words[1], &r->y[i], 4);
+    memcpy(&words[2], &r->hc[i], 4); memcpy(&words[3], &r->hs[i], 4);
+    words[4] = (uint32_t)r->state[i];
+    for (int k = 0; k < 5; ++k) { h ^= words[k]; h *= 1099511628211ul; }
+  }
+  return h;
+}
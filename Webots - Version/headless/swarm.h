@@ -0,0 +1,70 @@
+/*
+ * Description: Structure-of-arrays swarm of BoeBots running the rescue
+ *              policy (rescue_policy.h) in one headless process. Robots
+ *              share the static arena of a Sim2D, see each other through
+ *              their distance sensors and collide with each other. The step
+ *              loop runs on a work-stealing pool and gives the same result
+ *              for any thread count.
+ */
+
+#ifndef SWARM_H
+#define SWARM_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "raycast.h"
+#include "sim2d.h"
+#include "workpool.h"
+
+#define SWARM_GRAIN 256          // Robots per work chunk
+#define SWARM_COVERAGE_CELL 0.25 // meters
+
+// --- Robot State, one array per field ---
+typedef struct {
+  int n;
+  float *x, *y;                  // Position (meters)
+  float *hc, *hs;                // Heading as a unit vector (cos, sin)
+  float *next_x, *next_y;        // Positions written during a step
+  float *wl, *wr;                // Wheel speed commands (rad/s)
+  int *state;                    // RobotState
+  int *aid_deploy_counter;
+  int *led;
+  float *ds[RESCUE_NUM_DS];      // Last distance readings
+  int *ds_tag[RESCUE_NUM_DS];    // Survivor hit by each sensor, -1 if none
+  int *collisions;
+  uint8_t *in_contact;
+  int *signals;                  // SURVIVOR_FOUND messages sent
+} SwarmRobots;
+
+typedef struct {
+  const Sim2D *world;            // Walls, survivors, tilt zones; grid must be built
+  SwarmRobots r;
+  long steps;
+
+  // --- Robot Bins (robot-robot sensing and collisions) ---
+  float bin_size, bin_min_x, bin_min_y;
+  int bnx, bny;
+  int *bin_start, *bin_items;
+
+  // --- Coverage & Results ---
+  int cnx, cny;
+  _Atomic unsigned char *coverage;          // Cells any robot has driven over
+  _Atomic unsigned char *survivor_signaled; // Per world survivor
+  RayStats *worker_stats;                   // One per worker
+  int num_workers;
+} Swarm;
+
+// Places n robots at random collision-free poses inside the world bounds.
+void swarm_init(Swarm *s, const Sim2D *world, int n, unsigned int seed, int num_workers);
+void swarm_free(Swarm *s);
+
+// Advances every robot by one control step of dt seconds.
+void swarm_step(Swarm *s, WorkPool *pool, double dt);
+
+double swarm_coverage(const Swarm *s);     // Fraction of coverage cells visited
+int swarm_survivors_signaled(const Swarm *s);
+long swarm_collisions(const Swarm *s);
+unsigned long swarm_checksum(const Swarm *s); // Hash of poses and states
+
+#endif // SWARM_H
@@ -0,0 +1,168 @@
+/*
+ * Description: Work-stealing parallel-for for the headless tools.
+ */
+
+#include "workpool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define WORKPOOL_MAX_THREADS 256
+
+// A share of chunk indices [lo, hi) packed as hi << 32 | lo
+typedef struct {
+  _Atomic uint64_t range;
+  char pad[64 - sizeof(uint64_t)]; // One cache line per worker
+} WorkShare;
+
+struct WorkPool {
+  int num_threads;
+  pthread_t threads[WORKPOOL_MAX_THREADS];
+  WorkShare shares[WORKPOOL_MAX_THREADS];
+
+  // --- Current Job (published under lock) ---
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  unsigned long generation;
+  bool shutdown;
+  WorkFn fn;
+  void *ctx;
+  int count, grain;
+
+  _Atomic int remaining;        // Chunks not finished yet
+  _Atomic int busy;             // Workers inside the current job
+  _Atomic long steals;
+};
+
+static uint64_t pack(uint32_t lo, uint32_t hi) { return (uint64_t)hi << 32 | lo; }
+static uint32_t range_lo(uint64_t r) { return (uint32_t)r; }
+static uint32_t range_hi(uint64_t r) { return (uint32_t)(r >> 32); }
+
+static void run_chunk(WorkPool *p, uint32_t chunk, int worker) {
+  int begin = (int)chunk * p->grain;
+  int end = begin + p->grain < p->count ? begin + p->grain : p->count;
+  p->fn(p->ctx, begin, end, worker);
+  atomic_fetch_sub_explicit(&p->remaining, 1, memory_order_acq_rel);
+}
+
+// Pops chunks from the front of our own share until it is empty.
+static void drain_own(WorkPool *p, int w) {
+  WorkShare *s = &p->shares[w];
+  uint64_t r = atomic_load_explicit(&s->range, memory_order_acquire);
+  while (range_lo(r) < range_hi(r)) {
+    if (!atomic_compare_exchange_weak_explicit(&s->range, &r, pack(range_lo(r) + 1, range_hi(r)),
+                                               memory_order_acq_rel, memory_order_acquire))
+      continue; // r now holds the fresh value
+    run_chunk(p, range_lo(r), w);
+    r = atomic_load_explicit(&s->range, memory_order_acquire);
+  }
+}
+
+// Takes the back half of a victim's share into our own. Returns false if
+// every share looked empty.
+static bool steal(WorkPool *p, int w) {
+  for (int k = 1; k < p->num_threads; ++k) {
+    WorkShare *v = &p->shares[(w + k) % p->num_threads];
+    uint64_t r = atomic_load_explicit(&v->range, memory_order_acquire);
+    uint32_t lo = range_lo(r), hi = range_hi(r);
+    if (lo >= hi) continue;
+    uint32_t mid = hi - (hi - lo + 1) / 2;
+    if (atomic_compare_exchange_strong_explicit(&v->range, &r, pack(lo, mid),
+                                                memory_order_acq_rel, memory_order_acquire)) {
+      atomic_fetch_add_explicit(&p->steals, (long)(hi - mid), memory_order_relaxed);
+      atomic_store_explicit(&p->shares[w].range, pack(mid, hi), memory_order_release);
+      return true;
+    }
+    return true; // Lost a race: work still exists, retry
+  }
+  return false;
+}
+
+static void work(WorkPool *p, int w) {
+  while (atomic_load_explicit(&p->remaining, memory_order_acquire) > 0) {
+    drain_own(p, w);
+    if (!steal(p, w)) sched_yield(); // Last chunks are running elsewhere
+  }
+}
+
+static void *worker_main(void *arg) {
+  WorkPool *p = ((void **)arg)[0];
+  int w = (int)(intptr_t)((void **)arg)[1];
+  free(arg);
+  unsigned long seen = 0;
+  for (;;) {
+    pthread_mutex_lock(&p->lock);
+    while (p->generation == seen && !p->shutdown) pthread_cond_wait(&p->wake, &p->lock);
+    if (p->shutdown) { pthread_mutex_unlock(&p->lock); return NULL; }
+    seen = p->generation;
+    atomic_fetch_add_explicit(&p->busy, 1, memory_order_acq_rel);
+    pthread_mutex_unlock(&p->lock);
+
+    work(p, w);
+    atomic_fetch_sub_explicit(&p->busy, 1, memory_order_acq_rel);
+  }
+}
+
+WorkPool *workpool_create(int num_threads) {
+  if (num_threads < 1) num_threads = 1;
+  if (num_threads > WORKPOOL_MAX_THREADS) num_threads = WORKPOOL_MAX_THREADS;
+  WorkPool *p = calloc(1, sizeof(*p));
+  p->num_threads = num_threads;
+  pthread_mutex_init(&p->lock, NULL);
+  pthread_cond_init(&p->wake, NULL);
+  for (int w = 1; w < num_threads; ++w) {
+    void **arg = malloc(2 * sizeof(void *));
+    arg[0] = p;
+    arg[1] = (void *)(intptr_t)w;
+    pthread_create(&p->threads[w], NULL, worker_main, arg);
+  }
+  return p;
+}
+
+void workpool_destroy(WorkPool *p) {
+  if (!p) return;
+  pthread_mutex_lock(&p->lock);
+  p->shutdown = true;
+  pthread_cond_broadcast(&p->wake);
+  pthread_mutex_unlock(&p->lock);
+  for (int w = 1; w < p->num_threads; ++w) pthread_join(p->threads[w], NULL);
+  pthread_cond_destroy(&p->wake);
+  pthread_mutex_destroy(&p->lock);
+  free(p);
+}
+
+int workpool_size(const WorkPool *p) { return p->num_threads; }
+
+long workpool_steals(const WorkPool *p) { return atomic_load(&((WorkPool *)p)->steals); }
+
+void workpool_parallel_for(WorkPool *p, int count, int grain, WorkFn fn, void *ctx) {
+  if (count <= 0) return;
+  if (grain < 1) grain = 1;
+  if (p->num_threads == 1) {
+    for (int begin = 0; begin < count; begin += grain) fn(ctx, begin, begin + grain < count ? begin + grain : count, 0);
+    return;
+  }
+
+  uint32_t chunks = (uint32_t)((count + grain - 1) / grain);
+  pthread_mutex_lock(&p->lock);
+  p->fn = fn;
+  p->ctx = ctx;
+  p->count = count;
+  p->grain = grain;
+  for (int w = 0; w < p->num_threads; ++w) {
+    uint32_t lo = (uint32_t)((uint64_t)chunks * w / p->num_threads);
+    uint32_t hi = (uint32_t)((uint64_t)chunks * (w + 1) / p->num_threads);
+    atomic_store_explicit(&p->shares[w].range, pack(lo, hi), memory_order_release); // Publishes fn/ctx to thieves
+  }
+  atomic_store_explicit(&p->remaining, (int)chunks, memory_order_release);
+  p->generation++;
+  pthread_cond_broadcast(&p->wake);
+  pthread_mutex_unlock(&p->lock);
+
+  work(p, 0); // The caller is worker 0
+  while (atomic_load_explicit(&p->busy, memory_order_acquire) > 0) sched_yield();
+}
@@ -0,0 +1,30 @@
+/*
+ * Description: Work-stealing parallel-for for the headless tools.
+ *              A range of items is cut into chunks; every worker starts
+ *              with an equal share of chunks and pops them from the front,
+ *              and a worker that runs dry steals the back half of another
+ *              worker's share. Shares are single 64-bit atomics, so pops
+ *              and steals are one compare-and-swap each.
+ */
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+// Processes items [begin, end) on behalf of worker 'worker' (0 = caller).
+typedef void (*WorkFn)(void *ctx, int begin, int end, int worker);
+
+typedef struct WorkPool WorkPool;
+
+// num_threads includes the calling thread; 1 runs everything inline.
+WorkPool *workpool_create(int num_threads);
+void workpool_destroy(WorkPool *pool);
+int workpool_size(const WorkPool *pool);
+
+// Runs fn over [0, count) in chunks of 'grain' items and returns when all
+// chunks are done. Not reentrant.
+void workpool_parallel_for(WorkPool *pool, int count, int grain, WorkFn fn, void *ctx);
+
+// Chunks taken from another worker's share since creation.
+long workpool_steals(const WorkPool *pool);
+
+#endif // WORKPOOL_H
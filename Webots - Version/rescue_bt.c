@@ -0,0 +1,177 @@
+/*
+ * Description: Behavior-tree runtime (see rescue_bt.h).
+ */
+
+#include "rescue_bt.h"
+#include "rescue_profile.h"
+
+#include <string.h>
+
+void rescue_bt_init(RescueBt *bt, void *ctx, int max_calls, double slice_ms, bool use_clock) {
+  memset(bt, 0, sizeof(*bt));
+  bt->root = RESCUE_BT_NONE;
+  bt->active = RESCUE_BT_NONE;
+  bt->ctx = ctx;
+  bt->max_calls = max_calls > 0 ? max_calls : 1;
+  rescue_bt_set_slice(bt, slice_ms, use_clock);
+}
+
+void rescue_bt_set_slice(RescueBt *bt, double slice_ms, bool use_clock) {
+  bt->slice_ns = use_clock ? (uint64_t)(slice_ms * 1e6) : 0;
+}
+
+// --- Building ---
+
+static int add_node(RescueBt *bt, RescueBtKind kind, RescueBtLeaf fn, int arg, const char *name) {
+  if (bt->count == RESCUE_BT_MAX_NODES) {
+    bt->overflow = true;
+    return RESCUE_BT_NONE;
+  }
+  int i = bt->count++;
+  RescueBtNode *n = &bt->nodes[i];
+  n->kind = kind;
+  n->fn = fn;
+  n->arg = arg;
+  n->first = n->last = n->next = n->cursor = RESCUE_BT_NONE;
+  n->running = false;
+  n->name = name;
+  if (bt->root == RESCUE_BT_NONE) bt->root = i;
+  return i;
+}
+
+int rescue_bt_composite(RescueBt *bt, RescueBtKind kind, const char *name) {
+  return add_node(bt, kind, NULL, 0, name);
+}
+
+int rescue_bt_leaf(RescueBt *bt, RescueBtKind kind, RescueBtLeaf fn, int arg, const char *name) {
+  if (!fn) {
+    bt->overflow = true;
+    return RESCUE_BT_NONE;
+  }
+  return add_node(bt, kind, fn, arg, name);
+}
+
+int rescue_bt_add(RescueBt *bt, int parent, int child) {
+  bool valid = parent >= 0 && parent < bt->count && child >= 0 && child < bt->count && parent != child;
+  if (!valid || bt->nodes[parent].fn || child == bt->root) {
+    bt->overflow = true;
+    return RESCUE_BT_NONE;
+  }
+  RescueBtNode *p = &bt->nodes[parent];
+  if (p->last == RESCUE_BT_NONE) p->first = child;
+  else bt->nodes[p->last].next = child;
+  p->last = child;
+  return child;
+}
+
+// --- Ticking ---
+
+static void halt(RescueBt *bt, int i) {
+  RescueBtNode *n = &bt->nodes[i];
+  if (!n->running) return; // Nothing below a node that is not running is either
+  n->running = false;
+  if (bt->active == i) bt->active = RESCUE_BT_NONE;
+  for (int c = n->first; c != RESCUE_BT_NONE; c = bt->nodes[c].next) halt(bt, c);
+}
+
+// Calls a leaf, or returns RUNNING with yielded set if the budget is spent.
+static RescueBtStatus call(RescueBt *bt, int i) {
+  if (bt->calls >= bt->max_calls || (bt->slice_ns && rescue_profile_now() - bt->t0 >= bt->slice_ns)) {
+    bt->yielded = true;
+    return RESCUE_BT_RUNNING;
+  }
+  RescueBtNode *n = &bt->nodes[i];
+  bt->calls++;
+  RescueBtStatus s = n->fn(bt->ctx, n->arg, n->running);
+  if (n->kind == RESCUE_BT_CONDITION && s == RESCUE_BT_RUNNING) s = RESCUE_BT_FAILURE;
+  n->running = s == RESCUE_BT_RUNNING;
+  if (n->running) bt->active = i;
+  else if (bt->active == i) bt->active = RESCUE_BT_NONE;
+  return s;
+}
+
+// Whether the conditions guarding child i hold: i itself if a condition, the
+// conditions a sequence starts with otherwise (FAILURE if there are none).
+static RescueBtStatus guard(RescueBt *bt, int i) {
+  const RescueBtNode *n = &bt->nodes[i];
+  if (n->kind == RESCUE_BT_CONDITION) return call(bt, i);
+  if (n->kind != RESCUE_BT_SEQUENCE) return RESCUE_BT_FAILURE;
+  bool any = false;
+  for (int c = n->first; c != RESCUE_BT_NONE && bt->nodes[c].kind == RESCUE_BT_CONDITION; c = bt->nodes[c].next) {
+    RescueBtStatus s = call(bt, c);
+    if (s != RESCUE_BT_SUCCESS) return s;
+    any = true;
+  }
+  return any ? RESCUE_BT_SUCCESS : RESCUE_BT_FAILURE;
+}
+
+// guarded: guard() just held for node i, so its guarding conditions are not
+// called again in this tick.
+static RescueBtStatus tick_node(RescueBt *bt, int i, bool guarded) {
+  RescueBtNode *n = &bt->nodes[i];
+  if (n->fn) return guarded ? RESCUE_BT_SUCCESS : call(bt, i);
+  bool sequence = n->kind == RESCUE_BT_SEQUENCE;
+  RescueBtStatus done = sequence ? RESCUE_BT_FAILURE : RESCUE_BT_SUCCESS; // Ends the composite early
+  int start = n->first;
+  if (guarded)
+    while (start != RESCUE_BT_NONE && bt->nodes[start].kind == RESCUE_BT_CONDITION) start = bt->nodes[start].next;
+  bool child_guarded = false;
+  if (n->running) { // Resume: only the guards ahead of the running child are checked again
+    start = n->cursor;
+    for (int c = n->first; c != n->cursor; c = bt->nodes[c].next) {
+      if (sequence && bt->nodes[c].kind != RESCUE_BT_CONDITION) continue;
+      RescueBtStatus s = sequence ? call(bt, c) : guard(bt, c);
+      if (bt->yielded) return RESCUE_BT_RUNNING;
+      if (sequence && s == RESCUE_BT_FAILURE) {
+        halt(bt, i);
+        return RESCUE_BT_FAILURE;
+      }
+      if (!sequence && s == RESCUE_BT_SUCCESS) { // A higher-priority child applies again
+        halt(bt, n->cursor);
+        bt->preemptions++;
+        start = c;
+        child_guarded = true;
+        break;
+      }
+    }
+  }
+  for (int c = start; c != RESCUE_BT_NONE; c = bt->nodes[c].next) {
+    RescueBtStatus s = tick_node(bt, c, child_guarded);
+    child_guarded = false;
+    if (s == RESCUE_BT_RUNNING) {
+      n->cursor = c;
+      n->running = true;
+      return RESCUE_BT_RUNNING;
+    }
+    if (s == done) {
+      n->running = false;
+      return done;
+    }
+  }
+  n->running = false;
+  return sequence ? RESCUE_BT_SUCCESS : RESCUE_BT_FAILURE;
+}
+
+RescueBtStatus rescue_bt_tick(RescueBt *bt) {
+  if (bt->root == RESCUE_BT_NONE) return RESCUE_BT_FAILURE;
+  bt->t0 = rescue_profile_now();
+  bt->calls = 0;
+  bt->yielded = false;
+  bt->ticks++;
+  RescueBtStatus s = tick_node(bt, bt->root, false);
+  uint64_t elapsed = rescue_profile_now() - bt->t0;
+  bt->leaf_calls += (unsigned long)bt->calls;
+  if (bt->calls > bt->max_tick_calls) bt->max_tick_calls = bt->calls;
+  if (elapsed > bt->max_tick_ns) bt->max_tick_ns = elapsed;
+  bt->yields += bt->yielded;
+  return s;
+}
+
+void rescue_bt_reset(RescueBt *bt) {
+  if (bt->root != RESCUE_BT_NONE) halt(bt, bt->root);
+  bt->active = RESCUE_BT_NONE;
+}
+
+const char *rescue_bt_active(const RescueBt *bt) {
+  return bt->active == RESCUE_BT_NONE || !bt->nodes[bt->active].name ? "" : bt->nodes[bt->active].name;
+}
@@ -0,0 +1,111 @@
+/*
+ * Description: Behavior-tree runtime. Missions with more steps than the
+ *              reactive state machine (rescue_states.h) can hold - search,
+ *              approach a survivor, return to base - are composed from
+ *              sequences, selectors, conditions and actions instead of
+ *              new RobotState values for every combination.
+ *
+ *              Nodes come from a fixed arena inside the tree, linked as
+ *              first child / next sibling by index: no allocation, and a
+ *              tree is built once at start.
+ *
+ *              Ticks are incremental. A composite that returned RUNNING
+ *              remembers the child it was in and the next tick resumes
+ *              there, so the whole tree is not evaluated again. Only the
+ *              conditions guarding the running branch are checked again: a
+ *              sequence checks the conditions before its running child, and
+ *              a selector checks the leading conditions of the children
+ *              ahead of its running one and switches to the first whose
+ *              conditions now hold (a preemption), carrying on past the
+ *              conditions it just checked. Actions are told whether
+ *              they resume a RUNNING call or start afresh.
+ *
+ *              Each tick has a budget of leaf calls and, optionally, of
+ *              time. When it runs out the tick stops where it is and returns
+ *              RUNNING; the next tick carries on from there. A tick never
+ *              takes more than its slice of the control step, whatever the
+ *              tree. Leaf calls count whether or not the clock is used, so
+ *              without it runs replay exactly.
+ */
+
+#ifndef RESCUE_BT_H
+#define RESCUE_BT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RESCUE_BT_MAX_NODES 32                // Arena size
+#define RESCUE_BT_NONE (-1)                   // No node
+
+typedef enum { RESCUE_BT_SUCCESS, RESCUE_BT_FAILURE, RESCUE_BT_RUNNING } RescueBtStatus;
+
+typedef enum {
+  RESCUE_BT_SEQUENCE,                         // Children in order until one does not succeed
+  RESCUE_BT_SELECTOR,                         // Children in order until one does not fail
+  RESCUE_BT_CONDITION,                        // Leaf that only checks: SUCCESS or FAILURE, never RUNNING
+  RESCUE_BT_ACTION                            // Leaf that acts, may return RUNNING
+} RescueBtKind;
+
+// A leaf: ctx is the tree's, arg the leaf's own, resume tells an action
+// that it returned RUNNING on the last tick and was not preempted since.
+typedef RescueBtStatus (*RescueBtLeaf)(void *ctx, int arg, bool resume);
+
+typedef struct {
+  RescueBtKind kind;
+  RescueBtLeaf fn;                            // Leaves only
+  int arg;
+  int first, last, next;                      // First and last child, next sibling
+  int cursor;                                 // Composites: the running child
+  bool running;                               // Returned RUNNING and was not halted since
+  const char *name;
+} RescueBtNode;
+
+typedef struct {
+  RescueBtNode nodes[RESCUE_BT_MAX_NODES];
+  int count;
+  int root;
+  bool overflow;                              // A node did not fit or a link was invalid
+  void *ctx;                                  // Passed to every leaf
+  // --- Budget per tick ---
+  int max_calls;                              // Leaf calls
+  uint64_t slice_ns;                          // 0: no clock, the call budget only
+  int calls;                                  // This tick so far
+  uint64_t t0;
+  bool yielded;                               // This tick ran out of budget
+  int active;                                 // Leaf that last returned RUNNING, RESCUE_BT_NONE if none
+  // Statistics
+  unsigned long ticks;
+  unsigned long leaf_calls;
+  int max_tick_calls;
+  uint64_t max_tick_ns;
+  unsigned long yields;                       // Ticks cut short by the budget
+  unsigned long preemptions;                  // Running branches given up for a higher-priority one
+} RescueBt;
+
+// Empty tree; every leaf gets ctx. At most max_calls leaf calls per tick and,
+// if use_clock, slice_ms of time.
+void rescue_bt_init(RescueBt *bt, void *ctx, int max_calls, double slice_ms, bool use_clock);
+
+// Changes the time budget, e.g. to turn the clock off for a recorded run.
+void rescue_bt_set_slice(RescueBt *bt, double slice_ms, bool use_clock);
+
+// Adds a node to the arena and returns its index, RESCUE_BT_NONE (and
+// overflow set) if the arena is full. The first node added is the root.
+int rescue_bt_composite(RescueBt *bt, RescueBtKind kind, const char *name);
+int rescue_bt_leaf(RescueBt *bt, RescueBtKind kind, RescueBtLeaf fn, int arg, const char *name);
+
+// Appends child to parent's children; returns child (RESCUE_BT_NONE with
+// overflow set if either index is invalid) so calls can nest.
+int rescue_bt_add(RescueBt *bt, int parent, int child);
+
+// Ticks the tree from the running branch. RUNNING also when the budget ran
+// out (yielded is then set).
+RescueBtStatus rescue_bt_tick(RescueBt *bt);
+
+// Halts every running branch: the next tick starts from the root.
+void rescue_bt_reset(RescueBt *bt);
+
+// Name of the leaf that last returned RUNNING, "" if none.
+const char *rescue_bt_active(const RescueBt *bt);
+
+#endif // RESCUE_BT_H
@@ -0,0 +1,475 @@
+/*
+ * Description: Rescue controller core - autonomous navigation, obstacle
+ *              avoidance, survivor detection, emits a signal on survivor
+ *              detection, stops on tilt. Implements slightly smarter turning.
+ *              No Webots calls in here; devices go through RescueHal.
+ */
+
+#include "rescue_controller.h"
+#include "rescue_log.h"
+#include "rescue_policy.h"
+
+#include <math.h>
+#include <string.h>
+
+void rescue_controller_init(RescueController *c) {
+  c->current_state = SEARCHING;
+  rescue_state_stats_init(&c->states, SEARCHING);
+  c->aid_deploy_counter = 0;
+  c->debug_print_counter = 0;
+  rescue_survivors_init(&c->survivors);
+  rescue_odometry_init(&c->odom);
+  c->telemetry_counter = 0;
+  c->map = NULL;
+  c->explore = NULL;
+  c->goal_turn = 0;
+  c->goal_hold = 0;
+  c->vfh = NULL;
+  c->dwa = NULL;
+  c->speed = NULL;
+  c->stuck = NULL;
+  c->triggers = NULL;
+  c->mission = NULL;
+  c->schedule = NULL;
+  c->obstacle = false;
+  c->led = 0;
+  c->reflexes = 0;
+  c->recognition = NULL;
+  c->tilt = NULL;
+  c->verbose = true;
+  c->trace = NULL;
+  c->profile = NULL;
+  c->tilted = false;
+  c->survivor_detected = false;
+  c->flipped = false;
+  c->plan_bound = 0.0;
+}
+
+void rescue_triggers_init(RescueTriggers *t) {
+  RescueTriggerConfig obstacle = {OBSTACLE_DISTANCE_THRESHOLD, OBSTACLE_EXIT_DISTANCE, true, OBSTACLE_ENTER_N,
+                                  OBSTACLE_CONFIRM_N, OBSTACLE_CONFIRM_M};
+  RescueTriggerConfig tilt = {TILT_THRESHOLD, TILT_EXIT_THRESHOLD, false, TILT_ENTER_N, TILT_CONFIRM_N, TILT_CONFIRM_M};
+  RescueTriggerConfig survivor = {SURVIVOR_DETECTION_RANGE, SURVIVOR_EXIT_RANGE, true, SURVIVOR_ENTER_N,
+                                  SURVIVOR_CONFIRM_N, SURVIVOR_CONFIRM_M};
+  rescue_trigger_init(&t->obstacle, &obstacle);
+  rescue_trigger_init(&t->tilt, &tilt);
+  rescue_trigger_init(&t->survivor, &survivor);
+  rescue_trigger_init(&t->reflex, &obstacle);
+}
+
+void rescue_tasks_init(RescueSchedule *s) {
+  rescue_schedule_init(s);
+  rescue_schedule_add(s, "reflex", REFLEX_PERIOD, 0, RESCUE_DEVICE_DS);
+  rescue_schedule_add(s, "control", TIME_STEP, 0,
+                      RESCUE_DEVICE_DS | RESCUE_DEVICE_RANGES | RESCUE_DEVICE_ACCEL | RESCUE_DEVICE_WHEELS);
+  rescue_schedule_add(s, "recognize", RECOGNIZE_PERIOD, 0, RESCUE_DEVICE_RECOGNITION);
+  rescue_schedule_add(s, "plan", PLAN_PERIOD, PLAN_OFFSET, 0); // Reads the map
+}
+
+// Wheel speeds that take the robot toward waypoint (on the way to the
+// exploration goal or the mission's target). Near an
+// obstacle the goal is put aside: the policy turns away when the front is
+// blocked, an obstacle almost touching a side sensor (which the front one
+// misses) is turned away from here, and afterwards the robot drives straight
+// for GOAL_AVOID_HOLD steps so it leaves the spot instead of swinging back
+// into it. A turn on the spot toward the goal keeps its direction until the
+// goal is ahead.
+static void steer_to_goal(RescueController *c, const double *pose, const double *waypoint, const double *ds,
+                          double *left_speed, double *right_speed) {
+  bool scraping = ds[1] < GOAL_SIDE_CLEARANCE || ds[2] < GOAL_SIDE_CLEARANCE;
+  if (scraping || ds[0] < OBSTACLE_DISTANCE_THRESHOLD) {
+    c->goal_hold = GOAL_AVOID_HOLD;
+    c->goal_turn = 0;
+    *left_speed = scraping ? (ds[1] < ds[2] ? TURN_SPEED : -TURN_SPEED) : FORWARD_SPEED;
+    *right_speed = scraping ? -*left_speed : FORWARD_SPEED;
+    return;
+  }
+  if (c->goal_hold > 0) {
+    c->goal_hold--;
+    *left_speed = *right_speed = FORWARD_SPEED;
+    return;
+  }
+  double error = atan2(waypoint[1] - pose[1], waypoint[0] - pose[0]) - pose[2];
+  error = atan2(sin(error), cos(error));
+  if (fabs(error) > GOAL_TURN_IN_PLACE) {
+    if (!c->goal_turn) c->goal_turn = error > 0.0 ? 1 : -1; // Goal on the left: turn left
+    *left_speed = -c->goal_turn * TURN_SPEED;
+    *right_speed = -*left_speed;
+  } else {
+    c->goal_turn = 0;
+    *left_speed = FORWARD_SPEED - GOAL_STEER_GAIN * error;
+    *right_speed = FORWARD_SPEED + GOAL_STEER_GAIN * error;
+  }
+}
+
+// Every range reading: the backend's array if it has more than the three
+// ds, else those. Returns how many.
+static int range_readings(const RescueInputs *in, double *range, double *angle) {
+  int count = 0;
+  if (in->num_ranges > 0) {
+    count = in->num_ranges;
+    memcpy(range, in->range, sizeof(double) * (size_t)count);
+    memcpy(angle, in->range_angle, sizeof(double) * (size_t)count);
+  } else {
+    for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+      if (!in->ds_present[i]) continue;
+      range[count] = in->ds[i];
+      angle[count++] = rescue_ds_angle(i);
+    }
+  }
+  return count;
+}
+
+// Wheel speeds from the polar histogram (rescue_vfh.h) over every range
+// sensor, toward target (the exploration waypoint, or straight ahead).
+static void steer_vfh(RescueController *c, const double *pose, const double *range, const double *angle, int count,
+                      double target, double *left_speed, double *right_speed) {
+  RescueVfh *v = c->vfh;
+  rescue_vfh_update(v, pose, range, angle, count, target);
+  if (v->turn) {
+    *left_speed = -v->turn * TURN_SPEED;
+    *right_speed = -*left_speed;
+  } else {
+    *left_speed = FORWARD_SPEED * v->speed - GOAL_STEER_GAIN * v->direction;
+    *right_speed = FORWARD_SPEED * v->speed + GOAL_STEER_GAIN * v->direction;
+  }
+}
+
+// Wheel speeds of the escape in progress (rescue_stuck.h).
+static void escape_command(const RescueStuck *s, double *left_speed, double *right_speed) {
+  if (s->phase == RESCUE_STUCK_BACKUP) {
+    *left_speed = *right_speed = -BACKUP_SPEED;
+  } else if (s->turn) {
+    *left_speed = -s->turn * TURN_SPEED;
+    *right_speed = -*left_speed;
+  } else {
+    *left_speed = FORWARD_SPEED - GOAL_STEER_GAIN * s->steer;
+    *right_speed = FORWARD_SPEED + GOAL_STEER_GAIN * s->steer;
+  }
+}
+
+// The reflex's front obstacle: its own trigger, sampled every reflex tick,
+// else a single threshold.
+static bool reflex_obstacle(RescueController *c, double front) {
+  return c->triggers ? rescue_trigger_update(&c->triggers->reflex, front) : front < OBSTACLE_DISTANCE_THRESHOLD;
+}
+
+// Seconds since the last control step, on a tick between two.
+static double since_control(const RescueSchedule *s) {
+  const RescueTask *control = &s->tasks[RESCUE_TASK_CONTROL];
+  return (s->tick - 1 - control->phase) % control->every * s->tick_ms / 1000.0;
+}
+
+// A tick between control steps: the last commands, unless the robot is
+// searching forward into an obstacle the reflex just confirmed; it then
+// starts the turn away the state machine would, a control step early.
+static void reflex_step(RescueController *c, const RescueInputs *in, RescueOutputs *out) {
+  double left_speed = c->odom.last_command[0], right_speed = c->odom.last_command[1];
+  if (c->obstacle && c->current_state == SEARCHING && left_speed + right_speed > 0.0) {
+    rescue_policy_avoid_turn(in->ds[RESCUE_DS_LEFT], in->ds[RESCUE_DS_RIGHT], &left_speed, &right_speed);
+    // The forward command drove until now; odometry integrates it up to here
+    // so the next control step integrates the turn over its share only
+    rescue_odometry_update(&c->odom, in, since_control(c->schedule));
+    rescue_odometry_command(&c->odom, left_speed, right_speed);
+    c->reflexes++;
+  }
+  out->left_speed = left_speed;
+  out->right_speed = right_speed;
+  out->led[0] = out->led[1] = c->led;
+}
+
+void rescue_controller_step(RescueController *c, const RescueInputs *in, RescueOutputs *out) {
+  const double *ds_values = in->ds; // Front, Left, Right
+  double left_speed = 0.0;
+  double right_speed = 0.0;
+
+  RescueProfile *profile = c->profile;
+  uint64_t t = profile ? rescue_profile_now() : 0;
+
+  out->message = NULL;
+  out->message_size = 0;
+  out->telemetry = NULL;
+  out->telemetry_size = 0;
+
+  // --- Multi-Rate Tasks: the reflex every tick, the rest on control steps ---
+  RescueSchedule *schedule = c->schedule;
+  if (schedule) {
+    rescue_schedule_next(schedule);
+    if (rescue_schedule_due(schedule, RESCUE_TASK_REFLEX)) c->obstacle = reflex_obstacle(c, in->ds[RESCUE_DS_FRONT]);
+    if (!rescue_schedule_due(schedule, RESCUE_TASK_CONTROL)) {
+      reflex_step(c, in, out);
+      return;
+    }
+  }
+
+  // --- 0. Odometry, Map & Exploration ---
+  rescue_odometry_update(&c->odom, in, TIME_STEP / 1000.0);
+  const double *map_pose = in->has_pose ? in->pose : c->odom.pose;
+  if (c->map) rescue_map_update(c->map, map_pose, in);
+  // Survivor positions need a pose: the backend's, else encoder odometry
+  // (dead-reckoned commands drift too fast to tell survivors apart)
+  const double *pose = in->has_pose ? in->pose : c->odom.source == RESCUE_ODOM_ENCODERS ? c->odom.pose : NULL;
+  if (profile) rescue_profile_lap(profile, RESCUE_PHASE_MAP, &t);
+  RescueExplorer *explore = c->map ? c->explore : NULL;
+  bool had_goal = explore && explore->has_goal;
+  double previous_bound = c->plan_bound;
+  int previous_goal = explore ? explore->goal_cell : -1;
+  double search_left = FORWARD_SPEED, search_right = FORWARD_SPEED;
+  if (explore && (!schedule || rescue_schedule_due(schedule, RESCUE_TASK_PLAN))) {
+    if (schedule) { // One update stands for the control steps until the next
+      int steps = schedule->tasks[RESCUE_TASK_PLAN].period_ms / schedule->tasks[RESCUE_TASK_CONTROL].period_ms;
+      explore->steps_per_update = steps > 1 ? steps : 1;
+    }
+    rescue_explore_update(explore, map_pose);
+    c->plan_bound = explore->has_goal ? explore->path_bound : 0.0;
+  }
+  RescueMission *mission = c->mission;
+  const char *previous_task = mission ? rescue_bt_active(&mission->tree) : NULL;
+  if (mission) rescue_mission_update(mission, in, map_pose, pose, &c->survivors, explore);
+  const double *waypoint = explore && explore->has_goal ? explore->waypoint : NULL;
+  if (mission && mission->mode == RESCUE_MISSION_GOTO) waypoint = mission->target;
+  bool hold = mission && mission->mode == RESCUE_MISSION_HOLD;
+  if (waypoint && !c->vfh && !c->dwa) steer_to_goal(c, map_pose, waypoint, ds_values, &search_left, &search_right);
+  if (profile) rescue_profile_lap(profile, RESCUE_PHASE_EXPLORE, &t);
+  double avoid_left, avoid_right;
+  double range[RESCUE_MAX_RANGES], angle[RESCUE_MAX_RANGES];
+  int count = c->vfh || c->dwa || c->speed ? range_readings(in, range, angle) : 0;
+  if (c->speed) rescue_speed_update(c->speed, range, count, TIME_STEP / 1000.0);
+  if (c->vfh || c->dwa) { // One command whether or not the front is blocked
+    double target = waypoint ? atan2(waypoint[1] - map_pose[1], waypoint[0] - map_pose[0]) - map_pose[2] : 0.0;
+    if (c->vfh) {
+      steer_vfh(c, map_pose, range, angle, count, target, &search_left, &search_right);
+      target = c->vfh->direction;
+    } else if (!waypoint && ds_values[RESCUE_DS_FRONT] < OBSTACLE_DISTANCE_THRESHOLD) {
+      // Straight ahead is blocked: head for the side with more space
+      target = ds_values[RESCUE_DS_LEFT] < ds_values[RESCUE_DS_RIGHT] ? -M_PI / 2.0 : M_PI / 2.0;
+    }
+    if (c->dwa) { // The dynamic window drives toward the direction chosen, as fast as the governor allows
+      double max_speed = (c->vfh && c->vfh->turn ? 0.0 : 1.0) * (c->speed ? c->speed->scale : 1.0);
+      rescue_dwa_sense(c->dwa, map_pose, range, angle, count);
+      rescue_dwa_plan(c->dwa, map_pose, target, max_speed, c->odom.last_command, TIME_STEP / 1000.0, &search_left,
+                      &search_right);
+    }
+    avoid_left = search_left;
+    avoid_right = search_right;
+  } else {
+    rescue_policy_avoid_turn(ds_values[RESCUE_DS_LEFT], ds_values[RESCUE_DS_RIGHT], &avoid_left, &avoid_right);
+  }
+  if (c->speed && !c->dwa) { // The dynamic window was already sized to the governor's top speed
+    rescue_speed_apply(c->speed, FORWARD_SPEED, &search_left, &search_right);
+    rescue_speed_apply(c->speed, FORWARD_SPEED, &avoid_left, &avoid_right);
+  }
+  if (c->tilt) { // Slower as the slope steepens, before it is too steep
+    if (in->has_accel) rescue_tilt_update(c->tilt, in->accel, in->has_gyro ? in->gyro : NULL, TIME_STEP);
+    rescue_tilt_apply(c->tilt, &search_left, &search_right);
+    rescue_tilt_apply(c->tilt, &avoid_left, &avoid_right);
+  }
+  if (hold) search_left = search_right = avoid_left = avoid_right = 0.0; // Docked
+  unsigned long escapes = c->stuck ? c->stuck->escapes : 0;
+  bool driving = rescue_state_drives(c->current_state) && !hold;
+  if (c->stuck && rescue_stuck_update(c->stuck, map_pose, c->flipped, driving, ds_values)) {
+    // Either state drives the escape; stopping for a survivor or a tilt still wins
+    escape_command(c->stuck, &search_left, &search_right);
+    avoid_left = search_left;
+    avoid_right = search_right;
+  }
+  if (profile) rescue_profile_lap(profile, RESCUE_PHASE_AVOID, &t);
+
+  // --- 1. Check for Survivors ---
+  bool survivor_detected_this_step = false;
+  int survivor_sensor = -1;
+  bool survivor_has_pos = false;
+  double survivor_x = 0.0, survivor_y = 0.0;
+  RescueTriggers *triggers = c->triggers;
+  double survivor_range = triggers ? SURVIVOR_EXIT_RANGE : SURVIVOR_DETECTION_RANGE; // The trigger decides within
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    // Must recognize a survivor AND be close enough based on the sensor reading
+    if (in->survivor_seen[i] && ds_values[i] < survivor_range) {
+      survivor_has_pos = rescue_survivor_estimate(pose, ds_values[i], i, &survivor_x, &survivor_y);
+      if (rescue_survivors_served(&c->survivors, in->survivor_id[i], survivor_has_pos, survivor_x, survivor_y)) {
+        c->survivors.repeat_sightings++;
+        continue; // Already helped: only an obstacle now
+      }
+      survivor_detected_this_step = true;
+      survivor_sensor = i;
+      break; // Found one, no need to check others
+    }
+  }
+  bool tilted, obstacle;
+  if (triggers) { // Confirmed over several steps; a survivor must also be in view this step to be registered
+    bool confirmed = rescue_trigger_update(&triggers->survivor,
+                                           survivor_sensor >= 0 ? ds_values[survivor_sensor] : INFINITY);
+    survivor_detected_this_step = confirmed && survivor_sensor >= 0;
+    if (!survivor_detected_this_step) survivor_sensor = -1;
+    double tilt = c->tilt ? c->tilt->halt : in->has_accel ? fmax(fabs(in->accel[0]), fabs(in->accel[1])) : 0.0;
+    tilted = rescue_trigger_update(&triggers->tilt, tilt);
+    // The reflex confirms an obstacle sooner; the clear readings that end
+    // the avoidance still come at the control rate, as long as before
+    if (schedule && c->obstacle) rescue_trigger_set(&triggers->obstacle, true);
+    obstacle = rescue_trigger_update(&triggers->obstacle, ds_values[RESCUE_DS_FRONT]);
+  } else {
+    tilted = c->tilt ? c->tilt->halt > TILT_THRESHOLD : in->has_accel && rescue_policy_tilted(in->accel);
+    obstacle = ds_values[RESCUE_DS_FRONT] < OBSTACLE_DISTANCE_THRESHOLD || (schedule && c->obstacle);
+  }
+  if (profile) rescue_profile_lap(profile, RESCUE_PHASE_SURVIVOR, &t);
+
+  // --- 2. Determine Robot State & 3. Actions (rescue_policy.h) ---
+  RobotState previous_state = c->current_state;
+  int state = previous_state, led = 0;
+  unsigned events = rescue_policy_step(&state, &c->aid_deploy_counter, obstacle, survivor_detected_this_step, tilted,
+                                       search_left, search_right, avoid_left, avoid_right, &left_speed, &right_speed,
+                                       &led);
+  RobotState current_state = (RobotState)state;
+  c->current_state = current_state;
+  rescue_state_stats_count(&c->states, previous_state, current_state);
+  c->flipped = (previous_state == SEARCHING && current_state == AVOIDING_OBSTACLE) ||
+               (previous_state == AVOIDING_OBSTACLE && current_state == SEARCHING);
+  out->led[0] = led; // Both LEDs: solid when tilted, blinking while deploying aid
+  out->led[1] = led;
+  c->led = led;
+
+  if (events & RESCUE_EV_SIGNAL) {
+    // Signal goes out through the backend's emitter after this step
+    out->message = SURVIVOR_MESSAGE;
+    out->message_size = (int)strlen(SURVIVOR_MESSAGE) + 1;
+    rescue_survivors_add(&c->survivors, in->survivor_id[survivor_sensor], survivor_has_pos, survivor_x, survivor_y);
+  }
+
+  // --- 4. Motor Velocities ---
+  out->left_speed = left_speed;
+  out->right_speed = right_speed;
+  rescue_odometry_command(&c->odom, left_speed, right_speed);
+
+  if (c->telemetry_counter++ % RESCUE_TELEMETRY_PERIOD == 0) {
+    rescue_telemetry_pack(&c->telemetry, &c->odom, in->time, (uint32_t)(c->telemetry_counter / RESCUE_TELEMETRY_PERIOD));
+    out->telemetry = &c->telemetry;
+    out->telemetry_size = (int)sizeof(c->telemetry);
+  }
+
+  c->tilted = tilted;
+  c->survivor_detected = survivor_detected_this_step;
+  if (profile) rescue_profile_lap(profile, RESCUE_PHASE_DECIDE, &t);
+
+  // --- 5. Debug Output ---
+  if (c->verbose) {
+    if (survivor_sensor >= 0) RESCUE_LOG_INFO("--- SURVIVOR DETECTED by sensor %d ---\n", survivor_sensor);
+    if (events & RESCUE_EV_AID_FINISHED) RESCUE_LOG_INFO(" Aid Deployment Finished.\n");
+    if (current_state != previous_state) RESCUE_LOG_INFO("STATE CHANGE: %s\n", rescue_state_message(current_state));
+    if (explore && (explore->has_goal != had_goal || (explore->has_goal && explore->goal_cell != previous_goal))) {
+      if (explore->has_goal)
+        RESCUE_LOG_DEBUG(" Exploring: goal (%.2f, %.2f), %d frontier cells\n", explore->goal[0], explore->goal[1],
+                         explore->frontier_cells);
+      else if (explore->complete) RESCUE_LOG_INFO(" Exploration complete: no frontier left.\n");
+    }
+    if (mission && rescue_bt_active(&mission->tree) != previous_task && *rescue_bt_active(&mission->tree))
+      RESCUE_LOG_INFO(" Mission: %s.\n", rescue_bt_active(&mission->tree));
+    if (c->stuck && c->stuck->escapes != escapes)
+      RESCUE_LOG_INFO(" Stuck: %s, escape %lu: backing up, then %s.\n",
+                      c->stuck->flips >= RESCUE_STUCK_FLIPS ? "oscillating" : "not moving", c->stuck->escapes,
+                      c->stuck->follow ? "following the wall" : "a random turn");
+    if (c->plan_bound != previous_bound && c->plan_bound > 0.0)
+      RESCUE_LOG_DEBUG(" Planning: path within %.2fx of the shortest\n", c->plan_bound);
+    if (current_state == AVOIDING_OBSTACLE && c->vfh) {
+      RESCUE_LOG_DEBUG(" Avoiding: heading %+.0f deg%s (F:%.2f L:%.2f R:%.2f)\n", c->vfh->direction * 57.29577951308232,
+                       c->vfh->blocked ? ", boxed in" : "", ds_values[0], ds_values[1], ds_values[2]);
+    } else if (current_state == AVOIDING_OBSTACLE && c->dwa) {
+      RESCUE_LOG_DEBUG(" Avoiding: %.2f m/s turning %+.0f deg/s%s (F:%.2f L:%.2f R:%.2f)\n", c->dwa->v_cmd,
+                       c->dwa->w_cmd * 57.29577951308232, c->dwa->stopping ? ", braking" : "", ds_values[0],
+                       ds_values[1], ds_values[2]);
+    } else if (current_state == AVOIDING_OBSTACLE) {
+      if (left_speed > 0.0) RESCUE_LOG_DEBUG(" Avoiding: Turning Right (Left closer: %.2f < Right: %.2f)\n", ds_values[1], ds_values[2]);
+      else RESCUE_LOG_DEBUG(" Avoiding: Turning Left (Right closer: %.2f < Left: %.2f)\n", ds_values[2], ds_values[1]);
+    }
+  }
+
+  // Periodic debug line
+  if (c->debug_print_counter++ % 8 == 0 && c->verbose) {
+    RESCUE_LOG_DEBUG("S:%d Aid:%d | F:%.2f L:%.2f R:%.2f | Tilt:%d Surv:%d | Spd L:%.1f R:%.1f\n",
+           current_state, c->aid_deploy_counter, ds_values[0], ds_values[1], ds_values[2],
+           tilted, survivor_detected_this_step, left_speed, right_speed);
+  }
+  if (profile) rescue_profile_lap(profile, RESCUE_PHASE_DEBUG, &t);
+}
+
+long rescue_run(const RescueHal *hal, RescueController *c) {
+  RescueInputs in;
+  RescueOutputs out;
+  long steps = 0;
+  RescueProfile *profile = c->profile;
+  uint64_t t = profile ? rescue_profile_now() : 0, step_start = t;
+  RescueSchedule *schedule = c->schedule;
+  int tick = schedule ? schedule->tick_ms : TIME_STEP;
+  bool seen[RESCUE_NUM_DS] = {false};
+  int seen_id[RESCUE_NUM_DS];
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) seen_id[i] = -1;
+  // Recognition opportunities: the recognition task's runs, else every step
+  int opportunity = schedule ? schedule->tasks[RESCUE_TASK_RECOGNIZE].period_ms : TIME_STEP;
+  int sampled = opportunity; // Recognition sampling period the backend was last given
+
+  // --- Main Control Loop ---
+  while (hal->step(hal->ctx, tick) != -1) {
+    if (profile) { rescue_profile_lap(profile, RESCUE_PHASE_WAIT, &t); step_start = t; }
+
+    // --- 1. Read Sensor Values & Recognized Objects ---
+    rescue_inputs_reset(&in);
+    hal->sense(hal->ctx, &in);
+    if (profile) rescue_profile_lap(profile, RESCUE_PHASE_SENSE, &t);
+    bool recognize = !schedule || rescue_schedule_due_next(schedule, RESCUE_TASK_RECOGNIZE);
+    if (c->recognition && recognize) {
+      RescueRecognitionRate *rate = c->recognition;
+      bool in_view = false;
+      for (int i = 0; i < RESCUE_NUM_DS; ++i) in_view |= seen[i];
+      recognize = rescue_recognition_rate_next(rate, in.ds, in.ds_present, RESCUE_NUM_DS, in_view);
+      int period = rate->escalated ? opportunity : rate->relaxed_every * opportunity;
+      if (period != sampled && hal->sample_recognition) {
+        hal->sample_recognition(hal->ctx, period);
+        // The backend's last result is as old as the longer period: the next one is fresh
+        if (period < sampled && recognize) {
+          rescue_recognition_rate_defer(rate);
+          recognize = false;
+        }
+      }
+      sampled = period;
+      if (!recognize && schedule) rescue_schedule_skip_next(schedule, RESCUE_TASK_RECOGNIZE);
+    }
+    if (recognize) {
+      hal->recognize(hal->ctx, &in);
+      memcpy(seen, in.survivor_seen, sizeof(seen));
+      memcpy(seen_id, in.survivor_id, sizeof(seen_id));
+    } else { // The last recognition holds until the next (and is what a trace records)
+      memcpy(in.survivor_seen, seen, sizeof(seen));
+      memcpy(in.survivor_id, seen_id, sizeof(seen_id));
+    }
+    if (profile) rescue_profile_lap(profile, RESCUE_PHASE_RECOGNIZE, &t);
+
+    // --- 2./3. Decide ---
+    rescue_controller_step(c, &in, &out);
+
+    if (c->trace) rescue_trace_append(c->trace, &in, &out, c->current_state);
+
+    // --- 4. Set Motor Velocities, LEDs & Send Signal ---
+    if (profile) t = rescue_profile_now();
+    hal->actuate(hal->ctx, &out);
+    if (out.message) {
+      if (hal->emit(hal->ctx, out.message, out.message_size)) {
+        if (c->verbose) RESCUE_LOG_INFO(" Emitter: Sent '%s'\n", (const char *)out.message);
+      } else if (c->verbose) { RESCUE_LOG_WARN(" Emitter: Error - cannot send signal.\n"); }
+    }
+    if (out.telemetry) hal->emit(hal->ctx, out.telemetry, out.telemetry_size); // Best effort, no console noise
+    steps++;
+
+    if (profile) {
+      rescue_profile_lap(profile, RESCUE_PHASE_ACTUATE, &t);
+      uint64_t total = t - step_start;
+      rescue_histogram_record(&profile->phase[RESCUE_PHASE_STEP], total);
+      profile->over_budget += total > profile->budget_ns;
+      if (profile->dump_requested) {
+        profile->dump_requested = 0;
+        rescue_profile_dump(profile, stdout);
+        rescue_state_stats_dump(&c->states, TIME_STEP, stdout);
+      }
+      t = rescue_profile_now(); // Exclude the dump from the next wait
+    }
+  }
+  return steps;
+}
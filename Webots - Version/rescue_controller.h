@@ -0,0 +1,152 @@
+/*
+ * Description: Rescue controller core - the sensing/decision/actuation logic
+ *              of the BoeBot, independent of Webots. Feed it one
+ *              RescueInputs per control step and apply the RescueOutputs.
+ */
+
+#ifndef RESCUE_CONTROLLER_H
+#define RESCUE_CONTROLLER_H
+
+#include "rescue_dwa.h"
+#include "rescue_explore.h"
+#include "rescue_hal.h"
+#include "rescue_map.h"
+#include "rescue_mission.h"
+#include "rescue_odometry.h"
+#include "rescue_profile.h"
+#include "rescue_recognition.h"
+#include "rescue_schedule.h"
+#include "rescue_speed.h"
+#include "rescue_states.h"
+#include "rescue_stuck.h"
+#include "rescue_survivors.h"
+#include "rescue_tilt.h"
+#include "rescue_trace.h"
+#include "rescue_trigger.h"
+#include "rescue_vfh.h"
+
+// --- Time Step ---
+#define TIME_STEP 64
+#define PLAN_SLICE_MS 4.0 // Path repair budget per step (rescue_plan.h), a sixteenth of TIME_STEP
+#define PLAN_EPSILON 3.0  // Anytime planning: the first path costs at most this many times the shortest
+#define MISSION_SLICE_MS 0.5      // Behavior tree budget per tick (rescue_mission.h), with the clock
+#define MISSION_RETURN_AFTER 0.0  // Return to base after this long (s), 0: once exploration is complete
+#define RECOGNIZE_RELAXED_PERIOD 512 // Recognition while nothing is within SURVIVOR_DETECTION_RANGE (rescue_recognition.h)
+
+// --- Multi-Rate Tasks (rescue_schedule.h): periods and offsets (ms); control runs every TIME_STEP ---
+#define REFLEX_PERIOD 16          // Front obstacle check, turning if the robot drives into it
+#define RECOGNIZE_PERIOD 128      // Survivor recognition, held in between
+#define PLAN_PERIOD 256           // Frontier update, goal selection and path repair
+#define PLAN_OFFSET 64            // ... on control steps without recognition
+
+typedef enum {
+  RESCUE_TASK_REFLEX,
+  RESCUE_TASK_CONTROL,      // Odometry, map, mission, avoidance, triggers, state, actuation
+  RESCUE_TASK_RECOGNIZE,
+  RESCUE_TASK_PLAN,
+  RESCUE_NUM_TASKS
+} RescueTaskId;
+
+// --- Movement Speeds ---
+#define FORWARD_SPEED 5.0
+#define TURN_SPEED 4.0
+#define BACKUP_SPEED 3.0 // Escapes back up at this (rescue_stuck.h)
+
+// --- Exploration Steering ---
+#define GOAL_TURN_IN_PLACE 0.6 // Turn on the spot while the goal is more than this off the heading (rad)
+#define GOAL_STEER_GAIN 2.0    // Wheel speed difference per radian of heading error otherwise
+#define GOAL_SIDE_CLEARANCE 0.15 // A side reading below this (m) turns the robot away from it first
+#define GOAL_AVOID_HOLD 16      // Steps driven straight after an obstacle before steering to the goal again
+
+// --- Behavior Durations ---
+#define AID_DEPLOY_DURATION 50 // Pause duration after finding survivor
+// #define BACKUP_DURATION 8 // Optional
+
+// --- TUNABLE SENSOR THRESHOLDS ---
+#define OBSTACLE_DISTANCE_THRESHOLD 0.3 // Avoid if DistanceSensor value is LESS than this (meters)
+#define TILT_THRESHOLD 3.5
+#define SURVIVOR_DETECTION_RANGE 0.4 // Must recognize survivor AND be closer than this (meters)
+
+// --- Debounced Triggers (rescue_trigger.h): exit threshold, samples of m to turn on, to turn off ---
+#define OBSTACLE_EXIT_DISTANCE 0.34     // Front clear again beyond this (meters)
+#define OBSTACLE_ENTER_N 1              // Avoid on the first close reading ...
+#define OBSTACLE_CONFIRM_N 2            // ... clear again on 2 of 3
+#define OBSTACLE_CONFIRM_M 3
+#define TILT_EXIT_THRESHOLD 3.0         // Level again below this
+#define TILT_ENTER_N 3
+#define TILT_CONFIRM_N 3
+#define TILT_CONFIRM_M 4
+#define SURVIVOR_EXIT_RANGE 0.45        // A survivor in view still counts within this (meters)
+#define SURVIVOR_ENTER_N 2              // In range on 2 of 3 sightings ...
+#define SURVIVOR_CONFIRM_N 2            // ... out of it on 2 of 3
+#define SURVIVOR_CONFIRM_M 3
+
+// --- Communication ---
+#define SURVIVOR_MESSAGE "SURVIVOR_FOUND"    // Message sent when survivor found
+
+// --- Robot States --- (RobotState and its transitions: rescue_states.h)
+
+// --- Debounced Triggers ---
+typedef struct {
+  RescueTrigger obstacle;   // Front distance against OBSTACLE_DISTANCE_THRESHOLD
+  RescueTrigger tilt;       // Larger of |accel x|, |accel y| (or of the estimate's) against TILT_THRESHOLD
+  RescueTrigger survivor;   // Distance to a recognized survivor not served yet against SURVIVOR_DETECTION_RANGE
+  RescueTrigger reflex;     // The obstacle trigger again, sampled by the reflex task (multi-rate)
+} RescueTriggers;
+
+// --- Controller State ---
+typedef struct {
+  RobotState current_state;
+  RescueStateStats states;  // Time in each state and transitions, for profiling
+  int aid_deploy_counter;
+  int debug_print_counter;
+  RescueSurvivorRegistry survivors; // Already served; seen again they are just obstacles
+  RescueOdometry odom;      // Dead-reckoned pose, updated every step
+  RescueTelemetry telemetry; // Last odometry packet handed to the emitter
+  int telemetry_counter;
+  RescueMap *map;           // Occupancy grid, NULL when not mapping
+  RescueExplorer *explore;  // Frontier exploration on the map, NULL: search straight ahead
+  int goal_turn;            // Turn on the spot toward the goal in progress: 1 left, -1 right, 0 none
+  int goal_hold;            // Steps left driving straight after turning away from an obstacle
+  RescueVfh *vfh;           // Polar-histogram steering over every range sensor, NULL: turn on the spot
+  RescueDwa *dwa;           // Dynamic window wheel speeds toward the chosen direction, NULL: fixed speeds
+  RescueSpeed *speed;       // Time-to-collision speed governor, NULL: FORWARD_SPEED at most
+  RescueStuck *stuck;       // Stuck and oscillation detector with escapes, NULL: never escapes
+  RescueTriggers *triggers; // Debounced state triggers, NULL: a single threshold on each reading
+  RescueMission *mission;   // Behavior tree choosing where to head, NULL: search only
+  RescueSchedule *schedule; // Multi-rate tasks (rescue_tasks_init), one step per tick; NULL: everything every step
+  bool obstacle;            // Front obstacle as of the last reflex; the state avoids it too
+  int led;                  // LEDs commanded by the last control step
+  unsigned long reflexes;   // Turns started between control steps
+  RescueRecognitionRate *recognition; // Recognition sampling rate among the recognition task's runs, NULL: all of them
+  RescueTilt *tilt;         // Fused tilt estimate slowing the robot as it nears TILT_THRESHOLD, NULL: raw samples
+  bool verbose;            // Console output on state changes and every 8th step
+  RescueTraceWriter *trace; // Flight recorder, NULL when not recording
+  RescueProfile *profile;   // Phase latency histograms, NULL when not profiling
+  // Last step, kept for inspection by harnesses
+  bool tilted;
+  bool survivor_detected;
+  bool flipped;             // Switched between SEARCHING and AVOIDING_OBSTACLE
+  double plan_bound;        // Path followed costs at most this many times the shortest (1: optimal), 0: not planned
+} RescueController;
+
+void rescue_controller_init(RescueController *c);
+
+// Sets up the triggers from the thresholds above.
+void rescue_triggers_init(RescueTriggers *t);
+
+// Sets up the schedule with the RescueTaskId tasks from the periods above.
+void rescue_tasks_init(RescueSchedule *s);
+
+// Runs one control step: decides the next state from the inputs and fills
+// the motor/LED/emitter commands. Pure with respect to the hardware. With a
+// schedule it runs one tick: the tasks due, holding the last commands.
+void rescue_controller_step(RescueController *c, const RescueInputs *in, RescueOutputs *out);
+
+// Drives the controller from a backend until its step() returns -1, one
+// step every TIME_STEP or every tick of the schedule, recognizing on the
+// steps the recognition rate picks and holding the last result in between.
+// Returns the number of steps (ticks) executed.
+long rescue_run(const RescueHal *hal, RescueController *c);
+
+#endif // RESCUE_CONTROLLER_H
@@ -0,0 +1,375 @@
+/*
+ * Description: Dynamic Window Approach local planner (see rescue_dwa.h).
+ */
+
+#include "rescue_dwa.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rescue_odometry.h"
+#include "rescue_profile.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RESCUE_DWA_KERNEL "avx"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RESCUE_DWA_KERNEL "sse2"
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESCUE_DWA_KERNEL "neon"
+#else
+#define RESCUE_DWA_KERNEL "scalar"
+#endif
+
+#define CELLS RESCUE_DWA_CELLS
+#define MASK (RESCUE_DWA_CELLS - 1)
+#define STEP_TIME ((float)RESCUE_DWA_STEP_TIME)
+#define HORIZON ((float)(RESCUE_DWA_STEPS * RESCUE_DWA_STEP_TIME))
+#define INV_RESOLUTION ((float)(1.0 / RESCUE_DWA_RESOLUTION))
+#define CAP ((float)RESCUE_DWA_CLEARANCE_CAP)
+#define INV_CAP ((float)(1.0 / RESCUE_DWA_CLEARANCE_CAP))
+#define PI_F ((float)M_PI)
+#define INV_PI ((float)(1.0 / M_PI))
+#define TWO_ACCEL ((float)(2.0 * RESCUE_DWA_ACCEL))
+#define HEADING_WEIGHT ((float)RESCUE_DWA_HEADING_WEIGHT)
+#define CLEARANCE_WEIGHT ((float)RESCUE_DWA_CLEARANCE_WEIGHT)
+#define SPEED_WEIGHT ((float)RESCUE_DWA_SPEED_WEIGHT)
+
+const char *rescue_dwa_simd_name(void) { return RESCUE_DWA_KERNEL; }
+
+void rescue_dwa_init(RescueDwa *d, double max_wheel_speed) {
+  memset(d, 0, sizeof(*d));
+  d->simd = strcmp(RESCUE_DWA_KERNEL, "scalar") != 0;
+  d->max_wheel = max_wheel_speed;
+  d->max_v = max_wheel_speed * RESCUE_WHEEL_RADIUS;
+  d->max_w = 2.0 * d->max_v / RESCUE_AXLE_LENGTH; // Wheels at full speed in opposite directions
+}
+
+double rescue_dwa_rollouts_per_ms(const RescueDwa *d) {
+  return d->rollout_ns ? d->rollouts / (d->rollout_ns / 1e6) : 0.0;
+}
+
+// --- Rolling Costmap ---
+
+// Forgets world columns from .. from + count - 1, which leave the window.
+static void clear_columns(RescueDwa *d, int from, int count) {
+  for (int i = 0; i < count; ++i) {
+    int column = (from + i) & MASK;
+    for (int row = 0; row < CELLS; ++row) d->stamp[row * CELLS + column] = 0;
+  }
+}
+
+static void clear_rows(RescueDwa *d, int from, int count) {
+  for (int i = 0; i < count; ++i) memset(d->stamp + ((from + i) & MASK) * CELLS, 0, sizeof(uint32_t) * CELLS);
+}
+
+// Moves the window's lower-left corner to world cell (ox, oy); what slides
+// out is cleared so the ring slots come back empty on the other side.
+static void move_window(RescueDwa *d, int ox, int oy) {
+  int dx = ox - d->origin[0], dy = oy - d->origin[1];
+  if (abs(dx) >= CELLS || abs(dy) >= CELLS) {
+    memset(d->stamp, 0, sizeof(d->stamp));
+  } else {
+    if (dx > 0) clear_columns(d, d->origin[0], dx);
+    else if (dx < 0) clear_columns(d, ox + CELLS, -dx);
+    if (dy > 0) clear_rows(d, d->origin[1], dy);
+    else if (dy < 0) clear_rows(d, oy + CELLS, -dy);
+  }
+  d->origin[0] = ox;
+  d->origin[1] = oy;
+}
+
+// Two-pass chamfer distance (3 cm straight, 4.2 cm diagonal) from the cells
+// hit within RESCUE_DWA_MEMORY steps, in window order, capped.
+static void build_clearance(RescueDwa *d) {
+  const float straight = (float)RESCUE_DWA_RESOLUTION, diagonal = (float)(RESCUE_DWA_RESOLUTION * M_SQRT2);
+  float *f = d->clearance;
+  for (int wy = 0; wy < CELLS; ++wy) {
+    const uint32_t *row = d->stamp + ((d->origin[1] + wy) & MASK) * CELLS;
+    for (int wx = 0; wx < CELLS; ++wx) {
+      uint32_t stamp = row[(d->origin[0] + wx) & MASK];
+      f[wy * CELLS + wx] = stamp && d->now - stamp < RESCUE_DWA_MEMORY ? 0.0f : CAP;
+    }
+  }
+  for (int wy = 0; wy < CELLS; ++wy)
+    for (int wx = 0; wx < CELLS; ++wx) {
+      float *c = f + wy * CELLS + wx;
+      if (wx > 0) *c = fminf(*c, c[-1] + straight);
+      if (wy > 0) {
+        *c = fminf(*c, c[-CELLS] + straight);
+        if (wx > 0) *c = fminf(*c, c[-CELLS - 1] + diagonal);
+        if (wx < CELLS - 1) *c = fminf(*c, c[-CELLS + 1] + diagonal);
+      }
+    }
+  for (int wy = CELLS - 1; wy >= 0; --wy)
+    for (int wx = CELLS - 1; wx >= 0; --wx) {
+      float *c = f + wy * CELLS + wx;
+      if (wx < CELLS - 1) *c = fminf(*c, c[1] + straight);
+      if (wy < CELLS - 1) {
+        *c = fminf(*c, c[CELLS] + straight);
+        if (wx < CELLS - 1) *c = fminf(*c, c[CELLS + 1] + diagonal);
+        if (wx > 0) *c = fminf(*c, c[CELLS - 1] + diagonal);
+      }
+    }
+}
+
+void rescue_dwa_sense(RescueDwa *d, const double *pose, const double *range, const double *angle, int count) {
+  int cx = (int)floor(pose[0] / RESCUE_DWA_RESOLUTION), cy = (int)floor(pose[1] / RESCUE_DWA_RESOLUTION);
+  if (d->now) move_window(d, cx - CELLS / 2, cy - CELLS / 2);
+  else d->origin[0] = cx - CELLS / 2, d->origin[1] = cy - CELLS / 2;
+  d->now++;
+
+  double c = cos(pose[2]), s = sin(pose[2]);
+  double ox = pose[0] + RESCUE_DS_MOUNT_OFFSET * c, oy = pose[1] + RESCUE_DS_MOUNT_OFFSET * s;
+  for (int i = 0; i < count; ++i) {
+    if (!(range[i] < RESCUE_DWA_RANGE)) continue; // Nothing in reach (or no reading)
+    double a = pose[2] + angle[i];
+    int hx = (int)floor((ox + range[i] * cos(a)) / RESCUE_DWA_RESOLUTION) - d->origin[0];
+    int hy = (int)floor((oy + range[i] * sin(a)) / RESCUE_DWA_RESOLUTION) - d->origin[1];
+    if (hx < 0 || hx >= CELLS || hy < 0 || hy >= CELLS) continue;
+    d->stamp[((d->origin[1] + hy) & MASK) * CELLS + ((d->origin[0] + hx) & MASK)] = d->now;
+  }
+  build_clearance(d);
+}
+
+// --- Rollout Kernels ---
+// Each lane turns its heading by (step_cos, step_sin) and moves v *
+// RESCUE_DWA_STEP_TIME along it, RESCUE_DWA_STEPS times. The clearance under
+// each substep (CAP outside the window) gives the smallest clearance and the
+// distance driven before the first substep closer than floor; a lane is
+// admissible if it can brake within that distance. Both kernels do the same
+// float operations in the same order.
+
+typedef struct {
+  float x, y;                 // Window cells
+  float cos_h, sin_h;         // Heading
+  float floor;                // A substep with less clearance collides
+  float target;               // rad, relative to the heading
+  float inv_max_v;
+} Start;
+
+static inline float lookup(const float *clearance, float x, float y) {
+  bool in = x >= 0.0f && x < (float)CELLS && y >= 0.0f && y < (float)CELLS;
+  return in ? clearance[(int)y * CELLS + (int)x] : CAP;
+}
+
+static void rollout_scalar(RescueDwa *d, const Start *s) {
+  for (int i = 0; i < RESCUE_DWA_SAMPLES; ++i) {
+    float v = d->v[i], sc = d->step_cos[i], ss = d->step_sin[i];
+    float step = v * STEP_TIME, cells = step * INV_RESOLUTION;
+    float x = s->x, y = s->y, c = s->cos_h, sn = s->sin_h, m = CAP, dist = 0.0f;
+    bool unblocked = true;
+    for (int k = 0; k < RESCUE_DWA_STEPS; ++k) {
+      float turned = c * sc - sn * ss;
+      sn = sn * sc + c * ss;
+      c = turned;
+      x = x + cells * c;
+      y = y + cells * sn;
+      float clearance = lookup(d->clearance, x, y);
+      unblocked = unblocked && clearance >= s->floor;
+      dist = dist + (unblocked ? step : 0.0f);
+      m = fminf(m, clearance);
+    }
+    float err = fminf(fabsf(d->w[i] * HORIZON - s->target), PI_F);
+    float score = HEADING_WEIGHT * (1.0f - err * INV_PI) + CLEARANCE_WEIGHT * (m * INV_CAP) +
+                  SPEED_WEIGHT * (v * s->inv_max_v);
+    d->min_clearance[i] = m;
+    d->score[i] = v * v <= TWO_ACCEL * dist ? score : -1.0f;
+  }
+}
+
+#if defined(__AVX__)
+static void rollout_simd(RescueDwa *d, const Start *s) {
+  const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), sign = _mm256_set1_ps(-0.0f);
+  const __m256 size = _mm256_set1_ps((float)CELLS), last = _mm256_set1_ps((float)(CELLS - 1)), cap = _mm256_set1_ps(CAP);
+  const __m256 limit = _mm256_set1_ps(s->floor);
+  int32_t index[8];
+  float gathered[8];
+  for (int i = 0; i < RESCUE_DWA_SAMPLES; i += 8) {
+    __m256 v = _mm256_loadu_ps(d->v + i), sc = _mm256_loadu_ps(d->step_cos + i), ss = _mm256_loadu_ps(d->step_sin + i);
+    __m256 step = _mm256_mul_ps(v, _mm256_set1_ps(STEP_TIME));
+    __m256 cells = _mm256_mul_ps(step, _mm256_set1_ps(INV_RESOLUTION));
+    __m256 x = _mm256_set1_ps(s->x), y = _mm256_set1_ps(s->y), c = _mm256_set1_ps(s->cos_h);
+    __m256 sn = _mm256_set1_ps(s->sin_h), m = cap, dist = zero, unblocked = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+    for (int k = 0; k < RESCUE_DWA_STEPS; ++k) {
+      __m256 turned = _mm256_sub_ps(_mm256_mul_ps(c, sc), _mm256_mul_ps(sn, ss));
+      sn = _mm256_add_ps(_mm256_mul_ps(sn, sc), _mm256_mul_ps(c, ss));
+      c = turned;
+      x = _mm256_add_ps(x, _mm256_mul_ps(cells, c));
+      y = _mm256_add_ps(y, _mm256_mul_ps(cells, sn));
+      __m256 in = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(x, zero, _CMP_GE_OQ), _mm256_cmp_ps(x, size, _CMP_LT_OQ)),
+                                _mm256_and_ps(_mm256_cmp_ps(y, zero, _CMP_GE_OQ), _mm256_cmp_ps(y, size, _CMP_LT_OQ)));
+      __m256 cx = _mm256_round_ps(_mm256_min_ps(_mm256_max_ps(x, zero), last), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+      __m256 cy = _mm256_round_ps(_mm256_min_ps(_mm256_max_ps(y, zero), last), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+      _mm256_storeu_si256((__m256i *)index, _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(cy, size), cx)));
+      for (int j = 0; j < 8; ++j) gathered[j] = d->clearance[index[j]];
+      __m256 clearance = _mm256_blendv_ps(cap, _mm256_loadu_ps(gathered), in);
+      unblocked = _mm256_and_ps(unblocked, _mm256_cmp_ps(clearance, limit, _CMP_GE_OQ));
+      dist = _mm256_add_ps(dist, _mm256_and_ps(unblocked, step));
+      m = _mm256_min_ps(m, clearance);
+    }
+    __m256 err = _mm256_andnot_ps(sign, _mm256_sub_ps(_mm256_mul_ps(_mm256_loadu_ps(d->w + i), _mm256_set1_ps(HORIZON)),
+                                                      _mm256_set1_ps(s->target)));
+    err = _mm256_min_ps(err, _mm256_set1_ps(PI_F));
+    __m256 score = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(HEADING_WEIGHT), _mm256_sub_ps(one, _mm256_mul_ps(err, _mm256_set1_ps(INV_PI)))),
+                      _mm256_mul_ps(_mm256_set1_ps(CLEARANCE_WEIGHT), _mm256_mul_ps(m, _mm256_set1_ps(INV_CAP)))),
+        _mm256_mul_ps(_mm256_set1_ps(SPEED_WEIGHT), _mm256_mul_ps(v, _mm256_set1_ps(s->inv_max_v))));
+    __m256 admissible = _mm256_cmp_ps(_mm256_mul_ps(v, v), _mm256_mul_ps(_mm256_set1_ps(TWO_ACCEL), dist), _CMP_LE_OQ);
+    _mm256_storeu_ps(d->min_clearance + i, m);
+    _mm256_storeu_ps(d->score + i, _mm256_blendv_ps(_mm256_set1_ps(-1.0f), score, admissible));
+  }
+}
+#elif defined(__SSE2__)
+static void rollout_simd(RescueDwa *d, const Start *s) {
+  const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), sign = _mm_set1_ps(-0.0f);
+  const __m128 size = _mm_set1_ps((float)CELLS), last = _mm_set1_ps((float)(CELLS - 1)), cap = _mm_set1_ps(CAP);
+  const __m128 limit = _mm_set1_ps(s->floor);
+  int32_t index[4];
+  float gathered[4];
+  for (int i = 0; i < RESCUE_DWA_SAMPLES; i += 4) {
+    __m128 v = _mm_loadu_ps(d->v + i), sc = _mm_loadu_ps(d->step_cos + i), ss = _mm_loadu_ps(d->step_sin + i);
+    __m128 step = _mm_mul_ps(v, _mm_set1_ps(STEP_TIME));
+    __m128 cells = _mm_mul_ps(step, _mm_set1_ps(INV_RESOLUTION));
+    __m128 x = _mm_set1_ps(s->x), y = _mm_set1_ps(s->y), c = _mm_set1_ps(s->cos_h);
+    __m128 sn = _mm_set1_ps(s->sin_h), m = cap, dist = zero, unblocked = _mm_cmpeq_ps(zero, zero);
+    for (int k = 0; k < RESCUE_DWA_STEPS; ++k) {
+      __m128 turned = _mm_sub_ps(_mm_mul_ps(c, sc), _mm_mul_ps(sn, ss));
+      sn = _mm_add_ps(_mm_mul_ps(sn, sc), _mm_mul_ps(c, ss));
+      c = turned;
+      x = _mm_add_ps(x, _mm_mul_ps(cells, c));
+      y = _mm_add_ps(y, _mm_mul_ps(cells, sn));
+      __m128 in = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(x, zero), _mm_cmplt_ps(x, size)),
+                             _mm_and_ps(_mm_cmpge_ps(y, zero), _mm_cmplt_ps(y, size)));
+      __m128i cx = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(x, zero), last));
+      __m128i cy = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(y, zero), last));
+      _mm_storeu_si128((__m128i *)index, _mm_add_epi32(_mm_slli_epi32(cy, RESCUE_DWA_CELL_BITS), cx));
+      for (int j = 0; j < 4; ++j) gathered[j] = d->clearance[index[j]];
+      __m128 clearance = _mm_or_ps(_mm_and_ps(in, _mm_loadu_ps(gathered)), _mm_andnot_ps(in, cap));
+      unblocked = _mm_and_ps(unblocked, _mm_cmpge_ps(clearance, limit));
+      dist = _mm_add_ps(dist, _mm_and_ps(unblocked, step));
+      m = _mm_min_ps(m, clearance);
+    }
+    __m128 err = _mm_andnot_ps(sign, _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(d->w + i), _mm_set1_ps(HORIZON)),
+                                                _mm_set1_ps(s->target)));
+    err = _mm_min_ps(err, _mm_set1_ps(PI_F));
+    __m128 score = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(HEADING_WEIGHT), _mm_sub_ps(one, _mm_mul_ps(err, _mm_set1_ps(INV_PI)))),
+                   _mm_mul_ps(_mm_set1_ps(CLEARANCE_WEIGHT), _mm_mul_ps(m, _mm_set1_ps(INV_CAP)))),
+        _mm_mul_ps(_mm_set1_ps(SPEED_WEIGHT), _mm_mul_ps(v, _mm_set1_ps(s->inv_max_v))));
+    __m128 admissible = _mm_cmple_ps(_mm_mul_ps(v, v), _mm_mul_ps(_mm_set1_ps(TWO_ACCEL), dist));
+    _mm_storeu_ps(d->min_clearance + i, m);
+    _mm_storeu_ps(d->score + i, _mm_or_ps(_mm_and_ps(admissible, score), _mm_andnot_ps(admissible, _mm_set1_ps(-1.0f))));
+  }
+}
+#elif defined(__ARM_NEON)
+static void rollout_simd(RescueDwa *d, const Start *s) {
+  const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f), size = vdupq_n_f32((float)CELLS);
+  const float32x4_t last = vdupq_n_f32((float)(CELLS - 1)), cap = vdupq_n_f32(CAP), limit = vdupq_n_f32(s->floor);
+  int32_t index[4];
+  float gathered[4];
+  for (int i = 0; i < RESCUE_DWA_SAMPLES; i += 4) {
+    float32x4_t v = vld1q_f32(d->v + i), sc = vld1q_f32(d->step_cos + i), ss = vld1q_f32(d->step_sin + i);
+    float32x4_t step = vmulq_f32(v, vdupq_n_f32(STEP_TIME));
+    float32x4_t cells = vmulq_f32(step, vdupq_n_f32(INV_RESOLUTION));
+    float32x4_t x = vdupq_n_f32(s->x), y = vdupq_n_f32(s->y), c = vdupq_n_f32(s->cos_h);
+    float32x4_t sn = vdupq_n_f32(s->sin_h), m = cap, dist = zero;
+    uint32x4_t unblocked = vdupq_n_u32(~0u);
+    for (int k = 0; k < RESCUE_DWA_STEPS; ++k) {
+      float32x4_t turned = vsubq_f32(vmulq_f32(c, sc), vmulq_f32(sn, ss));
+      sn = vaddq_f32(vmulq_f32(sn, sc), vmulq_f32(c, ss));
+      c = turned;
+      x = vaddq_f32(x, vmulq_f32(cells, c));
+      y = vaddq_f32(y, vmulq_f32(cells, sn));
+      uint32x4_t in = vandq_u32(vandq_u32(vcgeq_f32(x, zero), vcltq_f32(x, size)),
+                                vandq_u32(vcgeq_f32(y, zero), vcltq_f32(y, size)));
+      int32x4_t cx = vcvtq_s32_f32(vminq_f32(vmaxq_f32(x, zero), last));
+      int32x4_t cy = vcvtq_s32_f32(vminq_f32(vmaxq_f32(y, zero), last));
+      vst1q_s32(index, vaddq_s32(vshlq_n_s32(cy, RESCUE_DWA_CELL_BITS), cx));
+      for (int j = 0; j < 4; ++j) gathered[j] = d->clearance[index[j]];
+      float32x4_t clearance = vbslq_f32(in, vld1q_f32(gathered), cap);
+      unblocked = vandq_u32(unblocked, vcgeq_f32(clearance, limit));
+      dist = vaddq_f32(dist, vbslq_f32(unblocked, step, zero));
+      m = vminq_f32(m, clearance);
+    }
+    float32x4_t err = vabsq_f32(vsubq_f32(vmulq_f32(vld1q_f32(d->w + i), vdupq_n_f32(HORIZON)), vdupq_n_f32(s->target)));
+    err = vminq_f32(err, vdupq_n_f32(PI_F));
+    float32x4_t score = vaddq_f32(
+        vaddq_f32(vmulq_f32(vdupq_n_f32(HEADING_WEIGHT), vsubq_f32(one, vmulq_f32(err, vdupq_n_f32(INV_PI)))),
+                  vmulq_f32(vdupq_n_f32(CLEARANCE_WEIGHT), vmulq_f32(m, vdupq_n_f32(INV_CAP)))),
+        vmulq_f32(vdupq_n_f32(SPEED_WEIGHT), vmulq_f32(v, vdupq_n_f32(s->inv_max_v))));
+    uint32x4_t admissible = vcleq_f32(vmulq_f32(v, v), vmulq_f32(vdupq_n_f32(TWO_ACCEL), dist));
+    vst1q_f32(d->min_clearance + i, m);
+    vst1q_f32(d->score + i, vbslq_f32(admissible, score, vdupq_n_f32(-1.0f)));
+  }
+}
+#else
+#define rollout_simd rollout_scalar
+#endif
+
+void rescue_dwa_rollout(RescueDwa *d, const double *pose, double target) {
+  Start s;
+  s.x = (float)(pose[0] / RESCUE_DWA_RESOLUTION - d->origin[0]);
+  s.y = (float)(pose[1] / RESCUE_DWA_RESOLUTION - d->origin[1]);
+  s.cos_h = (float)cos(pose[2]);
+  s.sin_h = (float)sin(pose[2]);
+  // Already closer than the body (pressed against something): only getting
+  // closer still collides, so the robot can drive away
+  s.floor = fminf((float)RESCUE_DWA_BODY, lookup(d->clearance, s.x, s.y));
+  s.target = (float)target;
+  s.inv_max_v = (float)(1.0 / d->max_v);
+  uint64_t t0 = rescue_profile_now();
+  if (d->simd) rollout_simd(d, &s);
+  else rollout_scalar(d, &s);
+  d->rollout_ns += rescue_profile_now() - t0;
+  d->rollouts += RESCUE_DWA_SAMPLES;
+}
+
+// --- Dynamic Window ---
+
+void rescue_dwa_plan(RescueDwa *d, const double *pose, double target, double max_speed, const double *current_wheels,
+                     double dt, double *left_speed, double *right_speed) {
+  const double half_axle = RESCUE_AXLE_LENGTH / 2.0;
+  // The robot only drives forward: there is no sensor behind it
+  double v0 = RESCUE_WHEEL_RADIUS * (current_wheels[0] + current_wheels[1]) / 2.0;
+  double w0 = RESCUE_WHEEL_RADIUS * (current_wheels[1] - current_wheels[0]) / RESCUE_AXLE_LENGTH;
+  v0 = fmin(fmax(v0, 0.0), d->max_v);
+  w0 = fmin(fmax(w0, -d->max_w), d->max_w);
+  double v_lo = fmax(0.0, v0 - RESCUE_DWA_ACCEL * dt), v_hi = fmin(d->max_v * max_speed, v0 + RESCUE_DWA_ACCEL * dt);
+  v_lo = fmin(v_lo, v_hi);
+  double w_lo = fmax(-d->max_w, w0 - RESCUE_DWA_ANGULAR_ACCEL * dt);
+  double w_hi = fmin(d->max_w, w0 + RESCUE_DWA_ANGULAR_ACCEL * dt);
+  for (int j = 0; j < RESCUE_DWA_W_SAMPLES; ++j) {
+    double w = w_lo + (w_hi - w_lo) * j / (RESCUE_DWA_W_SAMPLES - 1);
+    float step_cos = (float)cos(w * RESCUE_DWA_STEP_TIME), step_sin = (float)sin(w * RESCUE_DWA_STEP_TIME);
+    // Turning takes wheel speed from driving: both wheels stay within the limit
+    double v_max = fmax(0.0, d->max_v - fabs(w) * half_axle);
+    for (int i = 0; i < RESCUE_DWA_V_SAMPLES; ++i) {
+      int lane = i * RESCUE_DWA_W_SAMPLES + j;
+      d->v[lane] = (float)fmin(v_lo + (v_hi - v_lo) * i / (RESCUE_DWA_V_SAMPLES - 1), v_max);
+      d->w[lane] = (float)w;
+      d->step_cos[lane] = step_cos;
+      d->step_sin[lane] = step_sin;
+    }
+  }
+
+  rescue_dwa_rollout(d, pose, atan2(sin(target), cos(target)));
+  int best = 0;
+  for (int i = 1; i < RESCUE_DWA_SAMPLES; ++i)
+    if (d->score[i] > d->score[best]) best = i;
+  d->stopping = d->score[best] < 0.0f;
+  d->updates++;
+  if (d->stopping) { // Too fast to stop short of anything: brake as hard as allowed
+    d->stops++;
+    d->w_cmd = w0;
+    d->v_cmd = fmin(v_lo, fmax(0.0, d->max_v - fabs(w0) * half_axle));
+  } else {
+    d->v_cmd = d->v[best];
+    d->w_cmd = d->w[best];
+  }
+  *left_speed = (d->v_cmd - d->w_cmd * half_axle) / RESCUE_WHEEL_RADIUS;
+  *right_speed = (d->v_cmd + d->w_cmd * half_axle) / RESCUE_WHEEL_RADIUS;
+}
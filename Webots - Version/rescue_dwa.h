@@ -0,0 +1,112 @@
+/*
+ * Description: Dynamic Window Approach local planner (Fox, Burgard and
+ *              Thrun). Instead of switching the wheels between
+ *              FORWARD_SPEED and TURN_SPEED, every step samples forward and
+ *              turn rates (v, w) the BoeBot can reach from its current
+ *              command within one step at RESCUE_DWA_ACCEL and
+ *              RESCUE_DWA_ANGULAR_ACCEL, rolls each pair out as an arc over
+ *              a short horizon and drives the best one.
+ *
+ *              Rollouts are checked against a rolling local costmap: a
+ *              64 x 64 grid of 3 cm cells that follows the robot, indexed
+ *              as a ring so that moving only clears the rows and columns
+ *              that come into view. Range hits mark cells for
+ *              RESCUE_DWA_MEMORY steps, and each step a two-pass chamfer
+ *              transform turns the grid into the distance to the nearest
+ *              hit. A rollout's clearance is the smallest distance along
+ *              it; it is admissible if the robot clears RESCUE_DWA_BODY and
+ *              can still brake to a stop before the obstacle (turning on
+ *              the spot always is, the robot is a disk). The score weighs
+ *              how close the final heading comes to the target direction,
+ *              the clearance and the speed.
+ *
+ *              The rollouts are laid out as structure of arrays, one lane
+ *              per (v, w) pair: the vector kernels advance and score eight
+ *              (AVX) or four (SSE2, NEON) arcs at a time, turning each by
+ *              a precomputed rotation per substep so there is no sine or
+ *              cosine in the loop. Costmap reads are the only per-lane
+ *              loads. The scalar kernel is the reference and both score
+ *              every rollout the same.
+ */
+
+#ifndef RESCUE_DWA_H
+#define RESCUE_DWA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// --- Dynamic Window ---
+#define RESCUE_DWA_ACCEL 0.5               // Forward acceleration and braking (m/s^2)
+#define RESCUE_DWA_ANGULAR_ACCEL 6.0       // rad/s^2
+#define RESCUE_DWA_V_SAMPLES 16            // Forward speeds sampled across the window ...
+#define RESCUE_DWA_W_SAMPLES 32            // ... times turn rates
+#define RESCUE_DWA_SAMPLES (RESCUE_DWA_V_SAMPLES * RESCUE_DWA_W_SAMPLES)
+#define RESCUE_DWA_STEPS 16                // Substeps per rollout ...
+#define RESCUE_DWA_STEP_TIME 0.1           // ... of this long (seconds): a 1.6 s horizon
+#define RESCUE_DWA_BODY 0.075              // Robot radius plus margin (meters)
+
+// --- Local Costmap ---
+#define RESCUE_DWA_CELL_BITS 6
+#define RESCUE_DWA_CELLS (1 << RESCUE_DWA_CELL_BITS) // 64 x 64 ...
+#define RESCUE_DWA_RESOLUTION 0.03         // ... cells of 3 cm: 1.92 m around the robot
+#define RESCUE_DWA_MEMORY 32               // Steps a hit stays in the costmap (2 s)
+#define RESCUE_DWA_RANGE 0.9               // Readings at or beyond this (meters) hit nothing
+#define RESCUE_DWA_CLEARANCE_CAP 0.4       // Clearance counts up to this distance (meters)
+
+// --- Scoring ---
+#define RESCUE_DWA_HEADING_WEIGHT 1.0      // Final heading against the target direction
+#define RESCUE_DWA_CLEARANCE_WEIGHT 0.6
+#define RESCUE_DWA_SPEED_WEIGHT 0.4
+
+typedef struct {
+  // --- Rolling Costmap (odometry frame) ---
+  uint32_t stamp[RESCUE_DWA_CELLS * RESCUE_DWA_CELLS]; // Step of the last hit; ring-indexed by world cell, 0: none
+  int origin[2];                           // World cell of the window's lower-left corner
+  uint32_t now;                            // Steps sensed, from 1
+  float clearance[RESCUE_DWA_CELLS * RESCUE_DWA_CELLS]; // Window rows: distance to the nearest hit (m), capped
+  // --- Rollouts, one lane per (v, w) pair ---
+  float v[RESCUE_DWA_SAMPLES];             // m/s
+  float w[RESCUE_DWA_SAMPLES];             // rad/s, counter-clockwise
+  float step_cos[RESCUE_DWA_SAMPLES];      // Rotation of the heading per substep
+  float step_sin[RESCUE_DWA_SAMPLES];
+  float min_clearance[RESCUE_DWA_SAMPLES]; // Smallest clearance along the arc (m)
+  float score[RESCUE_DWA_SAMPLES];         // -1: not admissible
+  bool simd;                               // Use the vector kernels (default when compiled in)
+  // --- Limits & Command ---
+  double max_v, max_w;                     // From the wheel speed limit given at init
+  double max_wheel;                        // rad/s
+  double v_cmd, w_cmd;                     // Chosen this step
+  bool stopping;                           // No admissible rollout: braking
+  // Statistics
+  unsigned long updates;
+  unsigned long rollouts;
+  uint64_t rollout_ns;                     // Time in the rollout kernel
+  unsigned long stops;                     // Steps with no admissible rollout
+} RescueDwa;
+
+// Empties the costmap; wheel speeds stay within max_wheel_speed (rad/s).
+void rescue_dwa_init(RescueDwa *d, double max_wheel_speed);
+
+// Name of the vector kernels compiled in ("avx", "sse2", "neon" or "scalar").
+const char *rescue_dwa_simd_name(void);
+
+// Moves the costmap window to pose (x, y, heading), marks this step's range
+// hits (as for rescue_vfh_update) and rebuilds the clearance.
+void rescue_dwa_sense(RescueDwa *d, const double *pose, const double *range, const double *angle, int count);
+
+// Samples the window around current_wheels (last step's command, rad/s),
+// rolls every pair out and writes the wheel speeds of the best one. target:
+// direction to head for (rad, relative to the heading); max_speed: fraction
+// of the forward speed allowed (0: turn on the spot); dt: control period
+// (seconds).
+void rescue_dwa_plan(RescueDwa *d, const double *pose, double target, double max_speed, const double *current_wheels,
+                     double dt, double *left_speed, double *right_speed);
+
+// Rolls out and scores the sampled pairs in v/w/step_cos/step_sin from pose;
+// rescue_dwa_plan calls it.
+void rescue_dwa_rollout(RescueDwa *d, const double *pose, double target);
+
+// Rollouts per millisecond of kernel time so far.
+double rescue_dwa_rollouts_per_ms(const RescueDwa *d);
+
+#endif // RESCUE_DWA_H
@@ -0,0 +1,451 @@
+/*
+ * Description: Frontier-based exploration (see rescue_explore.h).
+ */
+
+#include "rescue_explore.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// --- Cell Flags ---
+#define EXPLORE_FRONTIER 1u       // Searched with an open neighbor
+#define EXPLORE_LISTED 2u         // In e->frontier
+#define EXPLORE_DIRTY 4u          // In e->dirty
+#define EXPLORE_ABANDONED 8u      // Goal given up, never selected again
+#define EXPLORE_SEARCHED 16u      // Free and within RESCUE_EXPLORE_VISIT_RANGE of the robot once
+
+#define GRID RESCUE_EXPLORE_CELLS
+#define SEARCH_SIZE (2 * RESCUE_EXPLORE_SEARCH_RADIUS + 1)
+#define MAP_CELLS_PER_CELL (1 << (2 * RESCUE_EXPLORE_CELL_BITS))
+
+bool rescue_explore_init(RescueExplorer *e, RescueMap *map) {
+  memset(e, 0, sizeof(*e));
+  e->map = map;
+  e->cells = calloc((size_t)GRID * GRID, sizeof(*e->cells));
+  e->frontier = malloc(RESCUE_EXPLORE_MAX_FRONTIER * sizeof(*e->frontier));
+  e->dirty = malloc(RESCUE_EXPLORE_MAX_DIRTY * sizeof(*e->dirty));
+  e->search_dist = malloc(SEARCH_SIZE * SEARCH_SIZE * sizeof(*e->search_dist));
+  e->search_queue = malloc(SEARCH_SIZE * SEARCH_SIZE * sizeof(*e->search_queue));
+  e->path = malloc(RESCUE_EXPLORE_MAX_PATH * sizeof(*e->path));
+  if (!e->cells || !e->frontier || !e->dirty || !e->search_dist || !e->search_queue || !e->path ||
+      !rescue_map_track_changes(map, RESCUE_EXPLORE_MAX_CHANGES)) {
+    rescue_explore_free(e);
+    return false;
+  }
+  e->map_dropped = map->changes_dropped;
+  e->seen_min[0] = e->seen_min[1] = GRID;
+  e->seen_max[0] = e->seen_max[1] = -1;
+  e->steps_since_plan = RESCUE_EXPLORE_REPLAN_PERIOD; // Plan on the first update
+  e->steps_per_update = 1;
+  return true;
+}
+
+void rescue_explore_free(RescueExplorer *e) {
+  free(e->cells);
+  free(e->frontier);
+  free(e->dirty);
+  free(e->search_dist);
+  free(e->search_queue);
+  free(e->path);
+  e->cells = NULL;
+  e->frontier = e->dirty = e->search_dist = e->search_queue = e->path = NULL;
+}
+
+unsigned long rescue_explore_memory(const RescueExplorer *e) {
+  return (unsigned long)sizeof(*e) + (unsigned long)GRID * GRID * sizeof(RescueExploreCell) +
+         (RESCUE_EXPLORE_MAX_FRONTIER + RESCUE_EXPLORE_MAX_DIRTY + 2ul * SEARCH_SIZE * SEARCH_SIZE +
+          RESCUE_EXPLORE_MAX_PATH) * sizeof(int32_t);
+}
+
+static RescueMapClass cell_class(const RescueExploreCell *c) {
+  return c->occupied ? RESCUE_MAP_OCCUPIED_CELL : c->free ? RESCUE_MAP_FREE_CELL : RESCUE_MAP_UNKNOWN;
+}
+
+// Not searched yet and not known to be occupied: where a survivor may still be.
+static bool is_open(const RescueExploreCell *c) {
+  return !(c->flags & EXPLORE_SEARCHED) && !c->occupied;
+}
+
+// Off the grid is closed, and so is a cell the map has no tile left for: it would never be seen.
+static bool is_open_at(const RescueExplorer *e, int cx, int cy) {
+  return (unsigned)cx < GRID && (unsigned)cy < GRID && is_open(&e->cells[cy * GRID + cx]) &&
+         rescue_map_storable(e->map, cx << RESCUE_EXPLORE_CELL_BITS, cy << RESCUE_EXPLORE_CELL_BITS);
+}
+
+static bool near_obstacle(const RescueExplorer *e, int cx, int cy) {
+  const int g = RESCUE_EXPLORE_CLEARANCE;
+  for (int y = cy - g; y <= cy + g; ++y)
+    for (int x = cx - g; x <= cx + g; ++x)
+      if ((unsigned)x < GRID && (unsigned)y < GRID && e->cells[y * GRID + x].occupied) return true;
+  return false;
+}
+
+// --- Planner Costs ---
+
+static uint8_t plan_cost(const RescueExplorer *e, int cx, int cy) {
+  if (e->cells[cy * GRID + cx].occupied) return RESCUE_PLAN_BLOCKED;
+  return near_obstacle(e, cx, cy) ? RESCUE_EXPLORE_NEAR_COST : 1;
+}
+
+// A cell turned occupied or free: its cost and its neighbors' clearance changed.
+static void plan_costs_around(RescueExplorer *e, int cx, int cy) {
+  const int g = RESCUE_EXPLORE_CLEARANCE;
+  for (int y = cy - g; y <= cy + g; ++y)
+    for (int x = cx - g; x <= cx + g; ++x)
+      if ((unsigned)x < GRID && (unsigned)y < GRID) rescue_plan_set_cost(e->planner, y * GRID + x, plan_cost(e, x, y));
+}
+
+// --- Incremental Frontier ---
+
+static void mark_dirty(RescueExplorer *e, int cx, int cy) {
+  if ((unsigned)cx >= GRID || (unsigned)cy >= GRID) return;
+  RescueExploreCell *c = &e->cells[cy * GRID + cx];
+  if (c->flags & EXPLORE_DIRTY) return;
+  if (e->num_dirty >= RESCUE_EXPLORE_MAX_DIRTY) { e->rescan = true; return; }
+  c->flags |= EXPLORE_DIRTY;
+  e->dirty[e->num_dirty++] = cy * GRID + cx;
+}
+
+static void grow_seen(RescueExplorer *e, int cx, int cy) {
+  if (cx < e->seen_min[0]) e->seen_min[0] = cx;
+  if (cx > e->seen_max[0]) e->seen_max[0] = cx;
+  if (cy < e->seen_min[1]) e->seen_min[1] = cy;
+  if (cy > e->seen_max[1]) e->seen_max[1] = cy;
+}
+
+// A cell that changed and its four neighbors, whose frontier flags depend on it.
+static void mark_around(RescueExplorer *e, int cx, int cy) {
+  mark_dirty(e, cx, cy);
+  mark_dirty(e, cx - 1, cy);
+  mark_dirty(e, cx + 1, cy);
+  mark_dirty(e, cx, cy - 1);
+  mark_dirty(e, cx, cy + 1);
+}
+
+// Moves one map cell between the counts of its coarse cell. Only a change of
+// the coarse class can change a frontier: that cell's and its neighbors'.
+static void apply_change(RescueExplorer *e, const RescueMapChange *ch) {
+  int cx = ch->cx >> RESCUE_EXPLORE_CELL_BITS, cy = ch->cy >> RESCUE_EXPLORE_CELL_BITS;
+  RescueExploreCell *c = &e->cells[cy * GRID + cx];
+  RescueMapClass before = cell_class(c);
+  RescueMapClass was = rescue_map_class(ch->before), is = rescue_map_class(ch->after);
+  c->free = (uint8_t)(c->free + (is == RESCUE_MAP_FREE_CELL) - (was == RESCUE_MAP_FREE_CELL));
+  c->occupied = (uint8_t)(c->occupied + (is == RESCUE_MAP_OCCUPIED_CELL) - (was == RESCUE_MAP_OCCUPIED_CELL));
+  if (cell_class(c) == before) return;
+  if (before == RESCUE_MAP_UNKNOWN) grow_seen(e, cx, cy);
+  mark_around(e, cx, cy);
+  if (e->planner && (before == RESCUE_MAP_OCCUPIED_CELL) != (c->occupied != 0)) plan_costs_around(e, cx, cy);
+}
+
+// Marks the free cells within RESCUE_EXPLORE_VISIT_RANGE of the robot searched.
+static void visit(RescueExplorer *e, const double *pose) {
+  const RescueMap *m = e->map;
+  const int g = (int)(RESCUE_EXPLORE_VISIT_RANGE / RESCUE_EXPLORE_CELL_SIZE) + 1;
+  double fx = (pose[0] - m->origin_x) / RESCUE_EXPLORE_CELL_SIZE, fy = (pose[1] - m->origin_y) / RESCUE_EXPLORE_CELL_SIZE;
+  int rx = (int)floor(fx), ry = (int)floor(fy);
+  const double r2 = (RESCUE_EXPLORE_VISIT_RANGE / RESCUE_EXPLORE_CELL_SIZE) * (RESCUE_EXPLORE_VISIT_RANGE / RESCUE_EXPLORE_CELL_SIZE);
+  for (int cy = ry - g; cy <= ry + g; ++cy) {
+    for (int cx = rx - g; cx <= rx + g; ++cx) {
+      if ((unsigned)cx >= GRID || (unsigned)cy >= GRID) continue;
+      RescueExploreCell *c = &e->cells[cy * GRID + cx];
+      double dx = cx + 0.5 - fx, dy = cy + 0.5 - fy;
+      if ((c->flags & EXPLORE_SEARCHED) || cell_class(c) != RESCUE_MAP_FREE_CELL || dx * dx + dy * dy > r2) continue;
+      c->flags |= EXPLORE_SEARCHED;
+      e->cells_searched++;
+      mark_around(e, cx, cy);
+    }
+  }
+}
+
+static void examine(RescueExplorer *e, int i) {
+  RescueExploreCell *c = &e->cells[i];
+  int cx = i % GRID, cy = i / GRID;
+  c->flags &= (uint8_t)~EXPLORE_DIRTY;
+  e->cells_examined++;
+  bool frontier = (c->flags & EXPLORE_SEARCHED) && !c->occupied &&
+                  (is_open_at(e, cx - 1, cy) || is_open_at(e, cx + 1, cy) || is_open_at(e, cx, cy - 1) ||
+                   is_open_at(e, cx, cy + 1));
+  if (frontier != ((c->flags & EXPLORE_FRONTIER) != 0)) {
+    c->flags ^= EXPLORE_FRONTIER;
+    e->frontier_cells += frontier ? 1 : -1;
+  }
+  if (frontier && !(c->flags & EXPLORE_LISTED)) {
+    if (e->num_listed < RESCUE_EXPLORE_MAX_FRONTIER) {
+      c->flags |= EXPLORE_LISTED;
+      e->frontier[e->num_listed++] = i;
+    } else {
+      e->rescan = true; // Listed once the list is compacted
+    }
+  }
+}
+
+// Drops the listed cells that are no longer frontiers.
+static void compact(RescueExplorer *e) {
+  int n = 0;
+  for (int k = 0; k < e->num_listed; ++k) {
+    int i = e->frontier[k];
+    if (e->cells[i].flags & EXPLORE_FRONTIER) e->frontier[n++] = i;
+    else e->cells[i].flags &= (uint8_t)~EXPLORE_LISTED;
+  }
+  e->num_listed = n;
+}
+
+// Rebuilds the coarse counts from the map after lost changes.
+static void recount(RescueExplorer *e) {
+  const RescueMap *m = e->map;
+  const int per_tile = RESCUE_MAP_TILE_SIZE >> RESCUE_EXPLORE_CELL_BITS;
+  for (int t = 0; t < RESCUE_MAP_TILES * RESCUE_MAP_TILES; ++t) {
+    if (!m->tile[t]) continue;
+    int tx = t % RESCUE_MAP_TILES, ty = t / RESCUE_MAP_TILES;
+    for (int k = 0; k < per_tile * per_tile; ++k) {
+      int cx = tx * per_tile + k % per_tile, cy = ty * per_tile + k / per_tile;
+      RescueExploreCell *c = &e->cells[cy * GRID + cx];
+      int free_cells = 0, occupied_cells = 0;
+      for (int j = 0; j < MAP_CELLS_PER_CELL; ++j) {
+        int mx = (cx << RESCUE_EXPLORE_CELL_BITS) + (j & ((1 << RESCUE_EXPLORE_CELL_BITS) - 1));
+        int my = (cy << RESCUE_EXPLORE_CELL_BITS) + (j >> RESCUE_EXPLORE_CELL_BITS);
+        RescueMapClass cls = rescue_map_class(*rescue_map_cell(m, mx, my));
+        free_cells += cls == RESCUE_MAP_FREE_CELL;
+        occupied_cells += cls == RESCUE_MAP_OCCUPIED_CELL;
+      }
+      c->free = (uint8_t)free_cells;
+      c->occupied = (uint8_t)occupied_cells;
+      if (cell_class(c) != RESCUE_MAP_UNKNOWN) grow_seen(e, cx, cy);
+    }
+  }
+}
+
+// Examines every seen cell and its neighbors.
+static void rescan(RescueExplorer *e) {
+  e->rescan = false;
+  e->rescans++;
+  if (e->map->changes_dropped != e->map_dropped) {
+    e->map_dropped = e->map->changes_dropped;
+    recount(e);
+  }
+  compact(e);
+  if (e->seen_max[0] < 0) return;
+  int x0 = e->seen_min[0] > 0 ? e->seen_min[0] - 1 : 0, x1 = e->seen_max[0] < GRID - 1 ? e->seen_max[0] + 1 : GRID - 1;
+  int y0 = e->seen_min[1] > 0 ? e->seen_min[1] - 1 : 0, y1 = e->seen_max[1] < GRID - 1 ? e->seen_max[1] + 1 : GRID - 1;
+  for (int cy = y0; cy <= y1; ++cy)
+    for (int cx = x0; cx <= x1; ++cx) {
+      examine(e, cy * GRID + cx);
+      if (e->planner) rescue_plan_set_cost(e->planner, cy * GRID + cx, plan_cost(e, cx, cy)); // Counts rebuilt
+    }
+}
+
+// --- Goal Selection ---
+
+// Breadth-first search (4-connected) from the robot's cell through the cells
+// clear of known obstacles, within the search window. Cells near an obstacle
+// may only be crossed right around the robot, so it can get away from a wall
+// it is next to. Distances in cells, -1 where not reached.
+static void search(RescueExplorer *e, int rx, int ry) {
+  const int r = RESCUE_EXPLORE_SEARCH_RADIUS;
+  memset(e->search_dist, 0xFF, SEARCH_SIZE * SEARCH_SIZE * sizeof(*e->search_dist));
+  if ((unsigned)rx >= GRID || (unsigned)ry >= GRID) return;
+  int head = 0, tail = 0;
+  int start = r * SEARCH_SIZE + r;
+  e->search_dist[start] = 0;
+  e->search_queue[tail++] = start;
+  static const int step_x[4] = {1, -1, 0, 0}, step_y[4] = {0, 0, 1, -1};
+  while (head < tail) {
+    int w = e->search_queue[head++];
+    int wx = w % SEARCH_SIZE, wy = w / SEARCH_SIZE;
+    for (int k = 0; k < 4; ++k) {
+      int nx = wx + step_x[k], ny = wy + step_y[k];
+      if ((unsigned)nx >= SEARCH_SIZE || (unsigned)ny >= SEARCH_SIZE) continue;
+      int n = ny * SEARCH_SIZE + nx;
+      if (e->search_dist[n] >= 0) continue;
+      int cx = rx - r + nx, cy = ry - r + ny;
+      if ((unsigned)cx >= GRID || (unsigned)cy >= GRID || e->cells[cy * GRID + cx].occupied) continue;
+      bool around_robot = abs(nx - r) <= RESCUE_EXPLORE_CLEARANCE + 1 && abs(ny - r) <= RESCUE_EXPLORE_CLEARANCE + 1;
+      if (!around_robot && near_obstacle(e, cx, cy)) continue;
+      e->search_dist[n] = e->search_dist[w] + 1;
+      e->search_queue[tail++] = n;
+    }
+  }
+  e->search_expansions += (unsigned long)tail;
+}
+
+// Open cells within the gain window around (cx, cy).
+static int information_gain(const RescueExplorer *e, int cx, int cy) {
+  const int g = RESCUE_EXPLORE_GAIN_RADIUS;
+  int x0 = cx - g > 0 ? cx - g : 0, x1 = cx + g < GRID - 1 ? cx + g : GRID - 1;
+  int y0 = cy - g > 0 ? cy - g : 0, y1 = cy + g < GRID - 1 ? cy + g : GRID - 1;
+  int gain = 0;
+  for (int y = y0; y <= y1; ++y)
+    for (int x = x0; x <= x1; ++x) gain += is_open_at(e, x, y);
+  return gain;
+}
+
+// Walks the search back from the goal to the robot's cell (rx, ry), always to
+// a neighbor one step closer, and stores the cells. Leaves the path empty if
+// the goal is beyond the search window.
+static void trace_path(RescueExplorer *e, int rx, int ry) {
+  const int r = RESCUE_EXPLORE_SEARCH_RADIUS;
+  static const int step_x[4] = {1, -1, 0, 0}, step_y[4] = {0, 0, 1, -1};
+  e->path_length = 0;
+  int wx = e->goal_cell % GRID - rx + r, wy = e->goal_cell / GRID - ry + r;
+  if ((unsigned)wx >= SEARCH_SIZE || (unsigned)wy >= SEARCH_SIZE) return;
+  for (int d = e->search_dist[wy * SEARCH_SIZE + wx]; d > 0; --d) {
+    if (d <= RESCUE_EXPLORE_MAX_PATH) e->path[e->path_length++] = (ry - r + wy) * GRID + (rx - r + wx);
+    for (int k = 0; k < 4; ++k) {
+      int nx = wx + step_x[k], ny = wy + step_y[k];
+      if ((unsigned)nx < SEARCH_SIZE && (unsigned)ny < SEARCH_SIZE && e->search_dist[ny * SEARCH_SIZE + nx] == d - 1) {
+        wx = nx; wy = ny;
+        break;
+      }
+    }
+  }
+  e->path_next = e->path_length - 1;
+}
+
+static void select_goal(RescueExplorer *e, const double *pose) {
+  const RescueMap *m = e->map;
+  const int r = RESCUE_EXPLORE_SEARCH_RADIUS;
+  int previous = e->has_goal ? e->goal_cell : -1;
+  e->plans++;
+  e->steps_since_plan = 0;
+  e->has_goal = false;
+  e->path_length = 0;
+  compact(e);
+  e->complete = e->frontier_cells == 0;
+  if (e->complete) return;
+
+  int rx = (int)floor((pose[0] - m->origin_x) / RESCUE_EXPLORE_CELL_SIZE);
+  int ry = (int)floor((pose[1] - m->origin_y) / RESCUE_EXPLORE_CELL_SIZE);
+  search(e, rx, ry);
+
+  double best_utility = 0.0;
+  for (int k = 0; k < e->num_listed; ++k) {
+    int i = e->frontier[k];
+    if (e->cells[i].flags & EXPLORE_ABANDONED) continue;
+    int cx = i % GRID, cy = i / GRID;
+    double gx = m->origin_x + (cx + 0.5) * RESCUE_EXPLORE_CELL_SIZE;
+    double gy = m->origin_y + (cy + 0.5) * RESCUE_EXPLORE_CELL_SIZE;
+    double straight = hypot(gx - pose[0], gy - pose[1]);
+    if (straight < RESCUE_EXPLORE_MIN_GOAL_DISTANCE || near_obstacle(e, cx, cy)) continue;
+    int wx = cx - rx + r, wy = cy - ry + r;
+    double cost;
+    if ((unsigned)wx < SEARCH_SIZE && (unsigned)wy < SEARCH_SIZE) {
+      int d = e->search_dist[wy * SEARCH_SIZE + wx];
+      if (d < 0) continue; // Walled off from the robot
+      cost = d * RESCUE_EXPLORE_CELL_SIZE;
+    } else {
+      cost = straight * RESCUE_EXPLORE_DETOUR;
+    }
+    double utility = information_gain(e, cx, cy) * exp(-RESCUE_EXPLORE_LAMBDA * cost);
+    if (utility > best_utility) {
+      best_utility = utility;
+      e->has_goal = true;
+      e->goal_cell = i;
+      e->goal[0] = gx;
+      e->goal[1] = gy;
+    }
+  }
+  if (e->has_goal) trace_path(e, rx, ry);
+  e->path_planned = false;
+  e->path_bound = 0.0;
+  if (e->planner) rescue_plan_set_goal(e->planner, e->has_goal ? e->goal_cell : -1); // The same goal keeps its search
+  if (e->has_goal && e->goal_cell != previous) { // Same goal again: keep counting the steps without progress
+    e->best_distance = hypot(e->goal[0] - pose[0], e->goal[1] - pose[1]);
+    e->stalled_steps = 0;
+  }
+}
+
+// Whether a cell still ahead on the path has been found blocked since it was traced.
+static bool path_blocked(const RescueExplorer *e) {
+  for (int k = e->path_next; k >= 0; --k)
+    if (e->planner->cost[e->path[k]] == RESCUE_PLAN_BLOCKED) return true;
+  return false;
+}
+
+// Repairs the planner's search from the robot's cell, and once it is done
+// takes its path in place of the breadth-first one. The path is kept until a
+// cell on it turns out blocked, a new goal is selected or the anytime search
+// finds one with a tighter bound, so the robot does not swing between two routes of
+// about the same cost as the map flickers.
+// A goal the planner finds walled off is given up.
+static void plan_path(RescueExplorer *e, const double *pose) {
+  const RescueMap *m = e->map;
+  int rx = (int)floor((pose[0] - m->origin_x) / RESCUE_EXPLORE_CELL_SIZE);
+  int ry = (int)floor((pose[1] - m->origin_y) / RESCUE_EXPLORE_CELL_SIZE);
+  if ((unsigned)rx >= GRID || (unsigned)ry >= GRID) return;
+  RescuePlanStatus status = rescue_plan_step(e->planner, ry * GRID + rx);
+  if (status == RESCUE_PLAN_NO_PATH) {
+    e->cells[e->goal_cell].flags |= EXPLORE_ABANDONED;
+    e->goals_abandoned++;
+    e->steps_since_plan = RESCUE_EXPLORE_REPLAN_PERIOD; // Select another goal next step
+    return;
+  }
+  if (status != RESCUE_PLAN_FOUND) return;
+  if (e->path_planned && rescue_plan_bound(e->planner) >= e->path_bound && !path_blocked(e)) return;
+  int n = 0;
+  for (int i = ry * GRID + rx; n < RESCUE_EXPLORE_MAX_PATH && i != e->goal_cell;) {
+    i = rescue_plan_next(e->planner, i);
+    if (i < 0) break;
+    e->path[n++] = i;
+  }
+  for (int k = 0; k < n / 2; ++k) { // Goal end first, as trace_path stores it
+    int32_t t = e->path[k];
+    e->path[k] = e->path[n - 1 - k];
+    e->path[n - 1 - k] = t;
+  }
+  e->path_length = n;
+  e->path_next = n - 1;
+  e->path_planned = true;
+  e->path_bound = rescue_plan_bound(e->planner);
+  e->path_traces++;
+}
+
+void rescue_explore_update(RescueExplorer *e, const double *pose) {
+  RescueMap *m = e->map;
+
+  // --- Frontier: only what changed this step ---
+  for (int k = 0; k < m->num_changes; ++k) apply_change(e, &m->changes[k]);
+  m->num_changes = 0;
+  visit(e, pose);
+  for (int k = 0; k < e->num_dirty; ++k) examine(e, e->dirty[k]);
+  e->num_dirty = 0;
+  if (!e->pool_full && m->used_tiles >= m->max_tiles) e->pool_full = e->rescan = true; // Unassigned tiles closed
+  if (e->rescan || m->changes_dropped != e->map_dropped) rescan(e);
+
+  // --- Goal ---
+  // Step counts advance by the steps an update stands for
+  bool replan = (e->steps_since_plan += e->steps_per_update) >= RESCUE_EXPLORE_REPLAN_PERIOD;
+  if (e->has_goal) {
+    double d = hypot(e->goal[0] - pose[0], e->goal[1] - pose[1]);
+    if (d < RESCUE_EXPLORE_GOAL_REACHED) {
+      e->goals_reached++;
+      replan = true;
+    } else if (!(e->cells[e->goal_cell].flags & EXPLORE_FRONTIER)) {
+      replan = true; // Seen already
+    } else if (d < e->best_distance - RESCUE_EXPLORE_PROGRESS) {
+      e->best_distance = d;
+      e->stalled_steps = 0;
+    } else if ((e->stalled_steps += e->steps_per_update) > RESCUE_EXPLORE_GIVE_UP) {
+      e->cells[e->goal_cell].flags |= EXPLORE_ABANDONED;
+      e->goals_abandoned++;
+      replan = true;
+    }
+  }
+  if (replan) select_goal(e, pose);
+  if (e->has_goal && e->planner) plan_path(e, pose);
+
+  // --- Waypoint: the first path cell past the lookahead, else the goal ---
+  if (!e->has_goal) return;
+  e->waypoint[0] = e->goal[0];
+  e->waypoint[1] = e->goal[1];
+  for (; e->path_next >= 0; --e->path_next) {
+    int i = e->path[e->path_next];
+    double wx = m->origin_x + (i % GRID + 0.5) * RESCUE_EXPLORE_CELL_SIZE;
+    double wy = m->origin_y + (i / GRID + 0.5) * RESCUE_EXPLORE_CELL_SIZE;
+    if (hypot(wx - pose[0], wy - pose[1]) >= RESCUE_EXPLORE_LOOKAHEAD) {
+      e->waypoint[0] = wx;
+      e->waypoint[1] = wy;
+      break;
+    }
+  }
+}
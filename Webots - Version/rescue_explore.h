@@ -0,0 +1,138 @@
+/*
+ * Description: Frontier-based exploration on top of the occupancy grid
+ *              (rescue_map.h). The grid is summarized in coarse cells of
+ *              8x8 map cells (16 cm) that count their free and occupied map
+ *              cells: a coarse cell is occupied if any of its cells is,
+ *              free if some are free and none occupied, unknown otherwise.
+ *              Survivors are only recognized close up, so seeing a cell
+ *              from a distance is not enough: a free cell counts as
+ *              searched once the robot has been within
+ *              RESCUE_EXPLORE_VISIT_RANGE of it. A frontier is a searched
+ *              cell next to an open one, neither searched nor occupied.
+ *              Once the map's tile pool is used up, cells in tiles it
+ *              never assigned are not open either: the map cannot record
+ *              them, so they would stay frontiers for good.
+ *
+ *              Detection is incremental: the map logs the cells whose class
+ *              changed in a step, and only the coarse cells whose own class
+ *              changed or that were just searched, with their four
+ *              neighbors, are examined again. The
+ *              frontier is kept as flags plus a list that is compacted when
+ *              a goal is chosen.
+ *
+ *              A goal is the frontier cell with the highest utility
+ *              gain * exp(-lambda * cost): gain is the number of open
+ *              coarse cells within sensor reach of it, cost the travel
+ *              distance from a breadth-first search over the cells clear
+ *              of known obstacles. The robot follows the search's path to
+ *              the goal, aiming at a waypoint a little way along it. It
+ *              replans when it gets to the goal, when the goal stops being
+ *              a frontier and every RESCUE_EXPLORE_REPLAN_PERIOD steps, and
+ *              gives a goal up for good when it stops getting closer to it.
+ *
+ *              With a planner attached (rescue_plan.h), the path is instead
+ *              repaired every step as obstacles show up: the explorer keeps
+ *              the planner's cell costs in step with the coarse grid
+ *              (occupied cells blocked, cells next to them dearer) and
+ *              takes the planner's path once a repair is finished, keeping
+ *              it until a cell on it turns out blocked or, in anytime mode,
+ *              the planner finds one with a tighter bound. Until then the
+ *              breadth-first path is followed, and a goal the planner finds
+ *              walled off is given up at once.
+ */
+
+#ifndef RESCUE_EXPLORE_H
+#define RESCUE_EXPLORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rescue_map.h"
+#include "rescue_plan.h"
+
+// --- Coarse Grid ---
+#define RESCUE_EXPLORE_CELL_BITS 3          // 8x8 map cells per coarse cell
+#define RESCUE_EXPLORE_CELL_SIZE (RESCUE_MAP_RESOLUTION * (1 << RESCUE_EXPLORE_CELL_BITS)) // 16 cm
+#define RESCUE_EXPLORE_CELLS (RESCUE_MAP_CELLS >> RESCUE_EXPLORE_CELL_BITS) // 632 per side, the whole map
+#define RESCUE_EXPLORE_MAX_FRONTIER 65536   // Listed frontier cells
+#define RESCUE_EXPLORE_MAX_DIRTY 16384      // Coarse cells examined per step
+#define RESCUE_EXPLORE_MAX_CHANGES 8192     // Map change log between two steps
+#define RESCUE_EXPLORE_VISIT_RANGE 0.4      // Searched radius around the robot (meters), SURVIVOR_DETECTION_RANGE
+
+// --- Goal Selection ---
+#define RESCUE_EXPLORE_SEARCH_RADIUS 64     // Travel costs are searched within 64 cells (10 m) of the robot
+#define RESCUE_EXPLORE_DETOUR 1.5           // Beyond that: straight-line distance times this
+#define RESCUE_EXPLORE_GAIN_RADIUS 2        // Gain window: 5x5 coarse cells (0.8 m), about the searched circle
+#define RESCUE_EXPLORE_LAMBDA 0.5           // Utility discount per meter of travel
+#define RESCUE_EXPLORE_MIN_GOAL_DISTANCE 0.3 // Frontiers closer than this (meters) are seen on the way
+#define RESCUE_EXPLORE_CLEARANCE 1          // Goals and paths keep this many cells from occupied ones (the robot avoids walls)
+#define RESCUE_EXPLORE_REPLAN_PERIOD 32     // Control steps between goal selections
+
+// --- Goal Tracking ---
+#define RESCUE_EXPLORE_MAX_PATH 1024        // Path cells kept, from the robot's end
+#define RESCUE_EXPLORE_LOOKAHEAD 0.3        // The waypoint is the first path cell at least this far (meters)
+#define RESCUE_EXPLORE_GOAL_REACHED 0.2     // meters
+#define RESCUE_EXPLORE_PROGRESS 0.1         // A goal must get this much closer (meters) ...
+#define RESCUE_EXPLORE_GIVE_UP 150          // ... within this many steps, or it is abandoned
+#define RESCUE_EXPLORE_NEAR_COST 16         // Planner cost of a cell within RESCUE_EXPLORE_CLEARANCE of an obstacle (free: 1)
+
+typedef struct {
+  uint8_t free, occupied;                   // Map cells of each class, 0..64
+  uint8_t flags;                            // RESCUE_EXPLORE_* bits (rescue_explore.c)
+} RescueExploreCell;
+
+typedef struct {
+  RescueMap *map;
+  RescueExploreCell *cells;                 // RESCUE_EXPLORE_CELLS^2, row-major
+  int32_t *frontier;                        // Listed cells; some may have stopped being frontiers
+  int num_listed;
+  int32_t *dirty;                           // Cells to examine this step
+  int num_dirty;
+  bool rescan;                              // Something overflowed: examine every seen cell
+  bool pool_full;                           // The map's tiles ran out; cells without one are no longer open
+  unsigned long map_dropped;                // Map changes lost before the counts were last rebuilt
+  int seen_min[2], seen_max[2];             // Bounding box of the cells that are not unknown
+  int32_t *search_dist;                     // Breadth-first search window, (2R + 1)^2
+  int32_t *search_queue;
+  int32_t *path;                            // Cells from the goal (0) back to the robot; empty if the goal is beyond the search
+  int path_length, path_next;               // path_next: index of the waypoint, counts down
+  RescuePlanner *planner;                   // Repairs the path to the goal every step, NULL: breadth-first path only
+  int steps_per_update;                     // Control steps one update stands for (updated less often), 1 by default
+  bool path_planned;                        // path is the planner's, else the breadth-first one
+  double path_bound;                        // The planner's path costs at most this many times the best; 0: breadth-first
+  // --- Goal ---
+  bool has_goal;
+  int goal_cell;
+  double goal[2];                           // World position (meters)
+  double waypoint[2];                       // Where to steer: the goal, or a path cell on the way
+  double best_distance;                     // Closest the robot has been to the goal
+  int stalled_steps;                        // Steps since it last got RESCUE_EXPLORE_PROGRESS closer
+  int steps_since_plan;
+  bool complete;                            // Last selection found no frontier at all
+  // Statistics
+  int frontier_cells;
+  unsigned long cells_searched;
+  unsigned long cells_examined;
+  unsigned long rescans;
+  unsigned long plans;
+  unsigned long goals_reached;
+  unsigned long goals_abandoned;
+  unsigned long search_expansions;
+  unsigned long path_traces;                // Planner paths taken over
+} RescueExplorer;
+
+// Allocates the coarse grid and turns on the map's change log. Returns false
+// if memory cannot be allocated. A planner must be attached before the first
+// update, with RESCUE_EXPLORE_CELLS^2 cells.
+bool rescue_explore_init(RescueExplorer *e, RescueMap *map);
+void rescue_explore_free(RescueExplorer *e);
+
+// Takes in this step's map changes and updates the frontier, then checks the
+// goal and selects a new one if needed. pose: x, y, heading of the robot in
+// the map's frame. Call after rescue_map_update().
+void rescue_explore_update(RescueExplorer *e, const double *pose);
+
+// Bytes allocated by the explorer.
+unsigned long rescue_explore_memory(const RescueExplorer *e);
+
+#endif // RESCUE_EXPLORE_H
@@ -0,0 +1,101 @@
+/*
+ * Description: Device interface between the rescue control logic and the
+ *              robot it runs on. The controller core only ever sees a
+ *              RescueInputs snapshot and fills a RescueOutputs command, so
+ *              the same logic runs under Webots (rescue_hal_webots.c) or
+ *              inside a headless harness (headless/stub_hal.c).
+ */
+
+#ifndef RESCUE_HAL_H
+#define RESCUE_HAL_H
+
+#include <stdbool.h>
+
+// --- Sensor Layout ---
+#define RESCUE_NUM_DS 3   // Front, Left, Right
+#define RESCUE_DS_FRONT 0
+#define RESCUE_DS_LEFT 1
+#define RESCUE_DS_RIGHT 2
+#define RESCUE_DS_MISSING 999.0 // Reading reported for a sensor that does not exist
+#define RESCUE_DS_MOUNT_OFFSET 0.05 // Sensor distance ahead of the robot center (meters)
+
+// Sensor bearing relative to the robot heading (rad, counter-clockwise)
+static inline double rescue_ds_angle(int i) {
+  return i == RESCUE_DS_LEFT ? 0.7853981633974483 : i == RESCUE_DS_RIGHT ? -0.7853981633974483 : 0.0;
+}
+
+#define RESCUE_MAX_RANGES 16 // Range sensors of any layout, for the avoidance (rescue_vfh.h)
+
+#define RESCUE_NUM_LEDS 2 // Left, Right
+
+// --- Device Groups --- (what a task reads, for the sampling periods: rescue_schedule.h)
+#define RESCUE_DEVICE_DS (1u << 0)          // The three ds
+#define RESCUE_DEVICE_RANGES (1u << 1)      // The other range sensors
+#define RESCUE_DEVICE_RECOGNITION (1u << 2) // Object recognition on the ds
+#define RESCUE_DEVICE_ACCEL (1u << 3)      // Accelerometer and gyro
+#define RESCUE_DEVICE_WHEELS (1u << 4)      // Wheel position sensors
+
+// --- One Step of Sensor Data ---
+typedef struct {
+  double time;                          // Simulation time in seconds
+  double ds[RESCUE_NUM_DS];             // Distance readings (meters)
+  bool ds_present[RESCUE_NUM_DS];       // false if the device was not found
+  int num_ranges;                       // Range sensors of the whole layout, 0 if it is just the three ds
+  double range[RESCUE_MAX_RANGES];      // Their readings (meters) ...
+  double range_angle[RESCUE_MAX_RANGES]; // ... and bearings, as rescue_ds_angle
+  bool survivor_seen[RESCUE_NUM_DS];    // A survivor is among the objects recognized by sensor i
+  int survivor_id[RESCUE_NUM_DS];       // Identity of that survivor (e.g. Webots node id), -1 if unknown
+  bool has_accel;
+  double accel[3];                      // Accelerometer vector (m/s^2)
+  bool has_gyro;
+  double gyro[3];                       // Rotation rates about the body axes (rad/s)
+  bool has_pose;
+  double pose[3];                       // Robot x, y (meters) and heading (rad) in the world frame
+  bool has_wheels;
+  double wheel[2];                      // Left, right wheel position sensors (rad)
+} RescueInputs;
+
+// --- One Step of Commands ---
+typedef struct {
+  double left_speed;                    // Wheel motor velocities (rad/s)
+  double right_speed;
+  int led[RESCUE_NUM_LEDS];             // 0 = off, 1 = on
+  const void *message;                  // Emitter payload for this step, NULL if none
+  int message_size;
+  const void *telemetry;                // Odometry packet for the supervisor, NULL if none this step
+  int telemetry_size;
+} RescueOutputs;
+
+// --- Backend Operations ---
+// A backend fills in the function pointers and passes its own state as ctx.
+typedef struct RescueHal {
+  void *ctx;
+  int (*step)(void *ctx, int duration_ms);                     // Advance time, -1 when the run is over
+  void (*sense)(void *ctx, RescueInputs *in);                  // Distances, accelerometer, wheels, time
+  void (*recognize)(void *ctx, RescueInputs *in);              // Survivor recognition hits
+  void (*actuate)(void *ctx, const RescueOutputs *out);        // Motors and LEDs
+  bool (*emit)(void *ctx, const void *data, int size);         // false if there is no emitter
+  void (*sample_recognition)(void *ctx, int period_ms);        // Optional: recognition period from now on
+} RescueHal;
+
+// Clears a snapshot to the "no device" defaults used by the controller.
+static inline void rescue_inputs_reset(RescueInputs *in) {
+  in->time = 0.0;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    in->ds[i] = RESCUE_DS_MISSING;
+    in->ds_present[i] = false;
+    in->survivor_seen[i] = false;
+    in->survivor_id[i] = -1;
+  }
+  in->num_ranges = 0;
+  in->has_accel = false;
+  in->accel[0] = in->accel[1] = in->accel[2] = 0.0;
+  in->has_gyro = false;
+  in->gyro[0] = in->gyro[1] = in->gyro[2] = 0.0;
+  in->has_pose = false;
+  in->pose[0] = in->pose[1] = in->pose[2] = 0.0;
+  in->has_wheels = false;
+  in->wheel[0] = in->wheel[1] = 0.0;
+}
+
+#endif // RESCUE_HAL_H
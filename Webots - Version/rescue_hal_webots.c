@@ -0,0 +1,240 @@
+/*
+ * Description: Webots backend for the rescue controller device interface.
+ *              All wb_* calls of the BoeBot rescue controller live here.
+ */
+
+#include "rescue_hal_webots.h"
+
+#include <webots/robot.h>
+#include <webots/motor.h>
+#include <webots/position_sensor.h>
+#include <webots/distance_sensor.h>
+#include <webots/accelerometer.h>
+#include <webots/gyro.h>
+#include <webots/emitter.h>
+#include <webots/supervisor.h> // Supervisor (to get node info)
+#include <webots/led.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// --- Survivor Patterns ---
+// First match wins. Add rows to tag more object classes; the per-step loop
+// only ever sees the cached class (rescue_recognition.h).
+static const RescueSurvivorPattern survivor_patterns[] = {
+  {SURVIVOR_OBJECT_NAME, NULL, 1},
+  // {NULL, "SurvivorProtoName", 2}, // Match by PROTO model name
+};
+#define NUM_SURVIVOR_PATTERNS ((int)(sizeof(survivor_patterns) / sizeof(survivor_patterns[0])))
+
+int survivor_class(WbNodeRef node) {
+  if (!node) return RESCUE_RECOG_NOT_SURVIVOR;
+  // Use supervisor functions to get name/model field values
+  return rescue_recognition_match(survivor_patterns, NUM_SURVIVOR_PATTERNS, wb_supervisor_node_get_name(node),
+                                  wb_supervisor_node_get_model_name(node));
+}
+
+bool is_survivor(WbNodeRef node) {
+  return survivor_class(node) != RESCUE_RECOG_NOT_SURVIVOR;
+}
+
+static int classify_node(void *ctx, const void *node) {
+  (void)ctx;
+  return survivor_class((WbNodeRef)node);
+}
+
+// --- Backend Operations ---
+
+static int webots_step(void *ctx, int duration_ms) {
+  (void)ctx;
+  return wb_robot_step(duration_ms);
+}
+
+// Bearing of each range sensor: the yaw of its node (the ray runs along its
+// x axis) relative to the robot's. Node orientations are valid once the
+// simulation has stepped, so this runs at the first sense.
+static void find_range_angles(RescueWebots *w) {
+  const double *r = wb_supervisor_node_get_orientation(w->self);
+  double heading = atan2(r[3], r[0]);
+  for (int i = 0; i < w->num_ranges; ++i) {
+    WbNodeRef node = wb_supervisor_node_get_from_device(w->ranges[i]);
+    const double *o = node ? wb_supervisor_node_get_orientation(node) : NULL;
+    double a = o ? atan2(o[3], o[0]) - heading : 0.0;
+    w->range_angle[i] = atan2(sin(a), cos(a));
+  }
+  w->range_angles_known = true;
+}
+
+static void webots_sense(void *ctx, RescueInputs *in) {
+  RescueWebots *w = ctx;
+  in->time = wb_robot_get_time();
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    if (w->distance_sensors[i]) {
+      in->ds_present[i] = true;
+      in->ds[i] = wb_distance_sensor_get_value(w->distance_sensors[i]);
+    }
+  }
+  if (w->num_ranges && !w->range_angles_known) find_range_angles(w);
+  in->num_ranges = w->num_ranges;
+  for (int i = 0; i < w->num_ranges; ++i) {
+    in->range[i] = wb_distance_sensor_get_value(w->ranges[i]);
+    in->range_angle[i] = w->range_angle[i];
+  }
+  if (w->accelerometer) {
+    const double *a = wb_accelerometer_get_values(w->accelerometer);
+    in->has_accel = true;
+    in->accel[0] = a[0]; in->accel[1] = a[1]; in->accel[2] = a[2];
+  }
+  if (w->gyro) {
+    const double *g = wb_gyro_get_values(w->gyro);
+    in->has_gyro = true;
+    in->gyro[0] = g[0]; in->gyro[1] = g[1]; in->gyro[2] = g[2];
+  }
+  if (w->wheel_sensors[0] && w->wheel_sensors[1]) {
+    double l = wb_position_sensor_get_value(w->wheel_sensors[0]);
+    double r = wb_position_sensor_get_value(w->wheel_sensors[1]);
+    if (!isnan(l) && !isnan(r)) { // NaN until the first sample
+      in->has_wheels = true;
+      in->wheel[0] = l;
+      in->wheel[1] = r;
+    }
+  }
+  if (w->self) {
+    // World frame is ENU (z up): heading is the yaw of the rotation matrix
+    const double *p = wb_supervisor_node_get_position(w->self);
+    const double *r = wb_supervisor_node_get_orientation(w->self);
+    in->has_pose = true;
+    in->pose[0] = p[0];
+    in->pose[1] = p[1];
+    in->pose[2] = atan2(r[3], r[0]);
+  }
+}
+
+static void webots_recognize(void *ctx, RescueInputs *in) {
+  RescueWebots *w = ctx;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    if (!w->distance_sensors[i]) continue;
+    // Check recognized objects from this sensor
+    int num_obj = wb_distance_sensor_recognition_get_number_of_objects(w->distance_sensors[i]);
+    const WbRecognizedObject *objects = wb_distance_sensor_recognition_get_objects(w->distance_sensors[i]);
+    for (int j = 0; j < num_obj; ++j) {
+      // Classified once per node (requires supervisor=TRUE in Robot node), then cached
+      if (rescue_recognition_lookup(&w->recognition, objects[j].node, classify_node, NULL) != RESCUE_RECOG_NOT_SURVIVOR) {
+        in->survivor_seen[i] = true;
+        in->survivor_id[i] = wb_supervisor_node_get_id(objects[j].node); // Identity for the served-survivor registry
+        break; // Found one, no need to check others
+      }
+    }
+  }
+}
+
+static void webots_actuate(void *ctx, const RescueOutputs *out) {
+  RescueWebots *w = ctx;
+  wb_motor_set_velocity(w->left_motor, out->left_speed);
+  wb_motor_set_velocity(w->right_motor, out->right_speed);
+  for (int i = 0; i < RESCUE_NUM_LEDS; ++i)
+    if (w->leds[i]) wb_led_set(w->leds[i], out->led[i]);
+}
+
+static bool webots_emit(void *ctx, const void *data, int size) {
+  RescueWebots *w = ctx;
+  if (!w->emitter) return false;
+  wb_emitter_send(w->emitter, data, size);
+  return true;
+}
+
+// Webots computes recognition every sampling period whether or not it is
+// read: slowing it down while the controller does not look saves the scan.
+static void webots_sample_recognition(void *ctx, int period_ms) {
+  RescueWebots *w = ctx;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i)
+    if (w->distance_sensors[i]) wb_distance_sensor_recognition_enable(w->distance_sensors[i], period_ms);
+}
+
+// Sampling period of a device group (RESCUE_DEVICE_*).
+static int sampling_period(const RescueSchedule *schedule, unsigned devices, int time_step) {
+  return schedule ? rescue_schedule_device_period(schedule, devices, time_step) : time_step;
+}
+
+bool rescue_hal_webots_init(RescueWebots *w, RescueHal *hal, int time_step, const RescueSchedule *schedule) {
+  // --- Get Device Handles ---
+  w->left_motor = wb_robot_get_device("left wheel motor");
+  w->right_motor = wb_robot_get_device("right wheel motor");
+  w->wheel_sensors[0] = wb_robot_get_device("left wheel sensor");
+  w->wheel_sensors[1] = wb_robot_get_device("right wheel sensor");
+  // Use multiple sensors for better avoidance
+  w->distance_sensors[RESCUE_DS_FRONT] = wb_robot_get_device("ds_front");
+  w->distance_sensors[RESCUE_DS_LEFT] = wb_robot_get_device("ds_left");   // NEEDED for smarter turning
+  w->distance_sensors[RESCUE_DS_RIGHT] = wb_robot_get_device("ds_right"); // NEEDED for smarter turning
+  // Every distance sensor the robot has, found by type, feeds the avoidance
+  w->num_ranges = 0;
+  w->range_angles_known = false;
+  int num_devices = wb_robot_get_number_of_devices();
+  for (int i = 0; i < num_devices && w->num_ranges < RESCUE_MAX_RANGES; ++i) {
+    WbDeviceTag tag = wb_robot_get_device_by_index(i);
+    if (wb_device_get_node_type(tag) == WB_NODE_DISTANCE_SENSOR) w->ranges[w->num_ranges++] = tag;
+  }
+  w->accelerometer = wb_robot_get_device("accelerometer");
+  w->gyro = wb_robot_get_device("gyro");
+  w->emitter = wb_robot_get_device(EMITTER_NAME); // Get the emitter
+  w->leds[0] = wb_robot_get_device("left_led");
+  w->leds[1] = wb_robot_get_device("right_led");
+
+  // --- Enable Devices & Setup ---
+  if (!w->left_motor || !w->right_motor) { printf("ERROR: Wheel motors not found!\n"); return false; }
+  wb_motor_set_position(w->left_motor, INFINITY);
+  wb_motor_set_position(w->right_motor, INFINITY);
+  wb_motor_set_velocity(w->left_motor, 0.0);
+  wb_motor_set_velocity(w->right_motor, 0.0);
+  if (w->wheel_sensors[0] && w->wheel_sensors[1]) {
+    int period = sampling_period(schedule, RESCUE_DEVICE_WHEELS, time_step);
+    wb_position_sensor_enable(w->wheel_sensors[0], period);
+    wb_position_sensor_enable(w->wheel_sensors[1], period);
+  } else {
+    printf("Warning: Wheel sensors not found, odometry falls back to the commanded speeds.\n");
+  }
+
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    if (w->distance_sensors[i]) {
+      wb_distance_sensor_enable(w->distance_sensors[i], sampling_period(schedule, RESCUE_DEVICE_DS, time_step));
+      // Enable recognition on distance sensors
+      wb_distance_sensor_recognition_enable(w->distance_sensors[i],
+                                            sampling_period(schedule, RESCUE_DEVICE_RECOGNITION, time_step));
+    } else {
+      printf("Warning: Distance sensor %d not found!\n", i);
+    }
+  }
+
+  if (w->accelerometer) wb_accelerometer_enable(w->accelerometer, sampling_period(schedule, RESCUE_DEVICE_ACCEL, time_step)); else printf("Warning: Accelerometer not found.\n");
+  if (w->gyro) wb_gyro_enable(w->gyro, sampling_period(schedule, RESCUE_DEVICE_ACCEL, time_step)); // Optional, no warning
+  if (!w->emitter) printf("ERROR: Emitter '%s' not found! Cannot send survivor signal.\n", EMITTER_NAME);
+  else wb_emitter_set_channel(w->emitter, EMITTER_CHANNEL); // Set communication channel
+
+  rescue_recognition_cache_init(&w->recognition);
+  w->self = wb_supervisor_node_get_self();
+
+  // Just the three ds: the controller knows their bearings and reads them as ds
+  if (w->num_ranges <= RESCUE_NUM_DS) w->num_ranges = 0;
+  if (w->num_ranges && !w->self) {
+    printf("Warning: No supervisor access, cannot place the %d range sensors; avoiding with the ds only.\n",
+           w->num_ranges);
+    w->num_ranges = 0;
+  }
+  // The ds among them keep their own period (the reflex may read them faster)
+  for (int i = 0; i < w->num_ranges; ++i) {
+    bool ds = false;
+    for (int k = 0; k < RESCUE_NUM_DS; ++k) ds |= w->ranges[i] == w->distance_sensors[k];
+    if (!ds) wb_distance_sensor_enable(w->ranges[i], sampling_period(schedule, RESCUE_DEVICE_RANGES, time_step));
+  }
+  if (w->num_ranges) printf("Avoidance reads %d range sensors.\n", w->num_ranges);
+
+  hal->ctx = w;
+  hal->step = webots_step;
+  hal->sense = webots_sense;
+  hal->recognize = webots_recognize;
+  hal->actuate = webots_actuate;
+  hal->emit = webots_emit;
+  hal->sample_recognition = webots_sample_recognition;
+  return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * Description: Webots backend for the rescue controller device interface.
+ */
+
+#ifndef RESCUE_HAL_WEBOTS_H
+#define RESCUE_HAL_WEBOTS_H
+
+#include <webots/types.h>
+
+#include "rescue_hal.h"
+#include "rescue_recognition.h"
+#include "rescue_schedule.h"
+
+// --- Names & Communication ---
+#define SURVIVOR_OBJECT_NAME "SurvivorObstacle" // *** The 'name' field of survivor objects in Webots ***
+#define EMITTER_NAME "status_emitter"        // *** 'name' of the Emitter device on the BoeBot ***
+#define EMITTER_CHANNEL 1                    // Channel for communication (must match Supervisor Receiver)
+
+// --- Device Handles ---
+typedef struct {
+  WbDeviceTag left_motor;
+  WbDeviceTag right_motor;
+  WbDeviceTag wheel_sensors[2];                // left/right wheel sensor, optional (odometry)
+  WbDeviceTag distance_sensors[RESCUE_NUM_DS]; // ds_front, ds_left, ds_right
+  WbDeviceTag ranges[RESCUE_MAX_RANGES];       // Every distance sensor, in device order; none if just the ds
+  double range_angle[RESCUE_MAX_RANGES];       // Their bearings, from the node orientations at the first step
+  int num_ranges;
+  bool range_angles_known;
+  WbDeviceTag accelerometer;
+  WbDeviceTag gyro;                            // Optional, for the tilt estimator (rescue_tilt.h)
+  WbDeviceTag emitter;
+  WbDeviceTag leds[RESCUE_NUM_LEDS];           // left_led, right_led
+  RescueRecognitionCache recognition;          // Node -> survivor class
+  WbNodeRef self;                              // Robot node, for its pose
+} RescueWebots;
+
+// Looks up and enables all devices (after wb_robot_init) and fills hal.
+// Each device group is sampled at the shortest period of the schedule's
+// tasks that read it, every time_step without a schedule (NULL). Returns
+// false if the wheel motors are missing.
+bool rescue_hal_webots_init(RescueWebots *w, RescueHal *hal, int time_step, const RescueSchedule *schedule);
+
+// Survivor class of a node from its name/model (uncached), 0 if not a survivor
+int survivor_class(WbNodeRef node);
+
+// Function to check if a node is a survivor based on its name
+bool is_survivor(WbNodeRef node);
+
+#endif // RESCUE_HAL_WEBOTS_H
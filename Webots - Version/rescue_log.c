@@ -0,0 +1,174 @@
+/*
+ * Description: Asynchronous SPSC ring-buffer logger (see rescue_log.h).
+ */
+
+#include "rescue_log.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define LOG_IDLE_SLEEP_NS 1000000L // Writer poll interval when the ring is empty
+#define LOG_LINE_MAX 512
+
+// One queued call: 16-byte header, then the raw argument values.
+typedef struct {
+  const char *fmt;
+  uint32_t types;                     // 2 bits per argument (RescueLogType)
+  uint8_t level;
+  uint8_t nargs;
+  uint8_t reserved[2];
+  uint64_t values[RESCUE_LOG_MAX_ARGS];
+} LogRecord;
+
+typedef struct {
+  _Atomic size_t head;                // Next slot the producer fills
+  char pad0[64 - sizeof(size_t)];
+  _Atomic size_t tail;                // Next slot the writer formats
+  char pad1[64 - sizeof(size_t)];
+  size_t cached_tail;                 // Producer's last view of tail
+  _Atomic unsigned long dropped;
+  LogRecord slots[RESCUE_LOG_RING_SLOTS];
+} LogRing;
+
+static LogRing ring;
+static FILE *log_out;
+static pthread_t log_thread;
+static atomic_bool log_running;
+static atomic_bool log_stopping;
+
+// --- Formatting (writer thread) ---
+
+static bool is_int_conversion(char c) { return strchr("diouxXcp", c) != NULL; }
+static bool is_float_conversion(char c) { return strchr("fFeEgGaA", c) != NULL; }
+
+static int format_arg(char *buf, size_t size, const char *spec, char conv, RescueLogType type, uint64_t raw) {
+  long long i;
+  double d;
+  const char *s;
+  memcpy(&i, &raw, sizeof(i));
+  memcpy(&d, &raw, sizeof(d));
+  memcpy(&s, &raw, sizeof(s));
+  if (conv == 's') return snprintf(buf, size, spec, type == RESCUE_LOG_STRING && s ? s : "(?)");
+  if (is_float_conversion(conv)) return snprintf(buf, size, spec, type == RESCUE_LOG_DOUBLE ? d : (double)i);
+  long long v = type == RESCUE_LOG_DOUBLE ? (long long)d : i;
+  if (conv == 'c') return snprintf(buf, size, spec, (int)v);
+  return snprintf(buf, size, spec, v); // spec carries an "ll" length
+}
+
+// Expands fmt with the recorded arguments, one conversion at a time.
+static void format_record(FILE *out, const LogRecord *r) {
+  char line[LOG_LINE_MAX];
+  size_t n = 0;
+  int arg = 0;
+  for (const char *p = r->fmt; *p && n < sizeof(line) - 1;) {
+    if (*p != '%') { line[n++] = *p++; continue; }
+    if (p[1] == '%') { line[n++] = '%'; p += 2; continue; }
+
+    char spec[32];
+    size_t k = 0;
+    spec[k++] = *p++;
+    while (*p && strchr("-+ #0123456789.", *p) && k < sizeof(spec) - 4) spec[k++] = *p++;
+    while (*p && strchr("hlLqjzt", *p)) p++; // Lengths come from the recorded type
+    char conv = *p ? *p++ : 's';
+    if (is_int_conversion(conv) && conv != 'c') {
+      if (conv == 'p') conv = 'x';
+      spec[k++] = 'l';
+      spec[k++] = 'l';
+    }
+    spec[k++] = conv;
+    spec[k] = '\0';
+
+    int w = arg < r->nargs
+              ? format_arg(line + n, sizeof(line) - n, spec, conv, (RescueLogType)((r->types >> (2 * arg)) & 3u), r->values[arg])
+              : snprintf(line + n, sizeof(line) - n, "(missing)");
+    arg++;
+    if (w > 0) n += (size_t)w < sizeof(line) - n ? (size_t)w : sizeof(line) - n - 1;
+  }
+  fwrite(line, 1, n, out);
+}
+
+static void idle_sleep(void) {
+#ifdef _WIN32
+  Sleep(LOG_IDLE_SLEEP_NS / 1000000L);
+#else
+  struct timespec idle = {0, LOG_IDLE_SLEEP_NS};
+  nanosleep(&idle, NULL);
+#endif
+}
+
+static void *writer_main(void *arg) {
+  (void)arg;
+  for (;;) {
+    size_t tail = atomic_load_explicit(&ring.tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&ring.head, memory_order_acquire);
+    if (tail == head) {
+      if (atomic_load_explicit(&log_stopping, memory_order_acquire) &&
+          atomic_load_explicit(&ring.head, memory_order_acquire) == tail) break;
+      fflush(log_out);
+      idle_sleep();
+      continue;
+    }
+    for (; tail != head; ++tail) format_record(log_out, &ring.slots[tail & (RESCUE_LOG_RING_SLOTS - 1)]);
+    atomic_store_explicit(&ring.tail, tail, memory_order_release);
+  }
+  fflush(log_out);
+  return NULL;
+}
+
+// --- Control ---
+
+void rescue_log_start(FILE *out) {
+  if (atomic_load(&log_running)) return;
+  log_out = out;
+  atomic_store(&log_stopping, false);
+  if (pthread_create(&log_thread, NULL, writer_main, NULL) == 0) atomic_store(&log_running, true);
+}
+
+void rescue_log_stop(void) {
+  if (!atomic_load(&log_running)) return;
+  atomic_store_explicit(&log_stopping, true, memory_order_release);
+  pthread_join(log_thread, NULL);
+  atomic_store(&log_running, false);
+}
+
+unsigned long rescue_log_dropped(void) { return atomic_load_explicit(&ring.dropped, memory_order_relaxed); }
+
+// --- Producer (control thread) ---
+
+void rescue_log_write(int level, const char *fmt, int nargs, const RescueLogArg *args) {
+  LogRecord *r, sync_record;
+  size_t head = atomic_load_explicit(&ring.head, memory_order_relaxed);
+  bool async = atomic_load_explicit(&log_running, memory_order_relaxed);
+  if (async) {
+    if (head - ring.cached_tail >= RESCUE_LOG_RING_SLOTS) {
+      ring.cached_tail = atomic_load_explicit(&ring.tail, memory_order_acquire);
+      if (head - ring.cached_tail >= RESCUE_LOG_RING_SLOTS) {
+        atomic_fetch_add_explicit(&ring.dropped, 1, memory_order_relaxed);
+        return;
+      }
+    }
+    r = &ring.slots[head & (RESCUE_LOG_RING_SLOTS - 1)];
+  } else {
+    r = &sync_record;
+  }
+
+  if (nargs > RESCUE_LOG_MAX_ARGS) nargs = RESCUE_LOG_MAX_ARGS;
+  r->fmt = fmt;
+  r->level = (uint8_t)level;
+  r->nargs = (uint8_t)nargs;
+  r->types = 0;
+  for (int i = 0; i < nargs; ++i) {
+    r->types |= (uint32_t)args[i].type << (2 * i);
+    memcpy(&r->values[i], &args[i].v, sizeof(r->values[i]));
+  }
+
+  if (async) atomic_store_explicit(&ring.head, head + 1, memory_order_release);
+  else format_record(stdout, r);
+}
@@ -0,0 +1,129 @@
+/*
+ * Description: Asynchronous logger for the control loop. A log call does
+ *              not format anything: it copies the format string pointer and
+ *              its arguments (tagged as integer, double or string) into a
+ *              preallocated single-producer/single-consumer ring, and a
+ *              background thread formats and writes the records. The
+ *              control thread never blocks on the console; if the ring is
+ *              full the record is dropped and counted.
+ *
+ *              Levels are chosen at compile time with RESCUE_LOG_LEVEL
+ *              (e.g. -DRESCUE_LOG_LEVEL=RESCUE_LOG_LEVEL_INFO); calls below
+ *              it expand to nothing and their arguments are not evaluated.
+ *
+ *              Rules for call sites: the format must be a string literal,
+ *              %s arguments must outlive the logger (literals or static
+ *              buffers), and at most RESCUE_LOG_MAX_ARGS arguments.
+ */
+
+#ifndef RESCUE_LOG_H
+#define RESCUE_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// --- Levels ---
+#define RESCUE_LOG_LEVEL_DEBUG 0
+#define RESCUE_LOG_LEVEL_INFO 1
+#define RESCUE_LOG_LEVEL_WARN 2
+#define RESCUE_LOG_LEVEL_ERROR 3
+#define RESCUE_LOG_LEVEL_OFF 4
+
+#ifndef RESCUE_LOG_LEVEL
+#define RESCUE_LOG_LEVEL RESCUE_LOG_LEVEL_DEBUG // Same console output as the original controller
+#endif
+
+#define RESCUE_LOG_MAX_ARGS 10
+#ifndef RESCUE_LOG_RING_SLOTS
+#define RESCUE_LOG_RING_SLOTS 1024 // Records; power of two
+#endif
+
+// --- Binary Arguments ---
+typedef enum { RESCUE_LOG_INT, RESCUE_LOG_DOUBLE, RESCUE_LOG_STRING } RescueLogType;
+
+typedef struct {
+  RescueLogType type;
+  union {
+    long long i;
+    double d;
+    const char *s;
+  } v;
+} RescueLogArg;
+
+static inline RescueLogArg rescue_log_arg_int(long long v) { RescueLogArg a = {RESCUE_LOG_INT, {.i = v}}; return a; }
+static inline RescueLogArg rescue_log_arg_double(double v) { RescueLogArg a = {RESCUE_LOG_DOUBLE, {.d = v}}; return a; }
+static inline RescueLogArg rescue_log_arg_string(const char *v) { RescueLogArg a = {RESCUE_LOG_STRING, {.s = v}}; return a; }
+
+#define RESCUE_LOG_ARG(x) _Generic((x),                                   \
+    float: rescue_log_arg_double, double: rescue_log_arg_double,          \
+    char *: rescue_log_arg_string, const char *: rescue_log_arg_string,   \
+    default: rescue_log_arg_int)(x)
+
+// Starts the background writer on 'out'. Until it runs (or after it stops)
+// log calls are formatted and written synchronously.
+void rescue_log_start(FILE *out);
+
+// Writes every queued record, then stops the background writer.
+void rescue_log_stop(void);
+
+// Records dropped because the ring was full.
+unsigned long rescue_log_dropped(void);
+
+// Queues one record. Use the RESCUE_LOG_* macros instead.
+void rescue_log_write(int level, const char *fmt, int nargs, const RescueLogArg *args);
+
+// --- Call Sites ---
+#define RESCUE_LOG_A1(a) RESCUE_LOG_ARG(a)
+#define RESCUE_LOG_A2(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A1(__VA_ARGS__)
+#define RESCUE_LOG_A3(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A2(__VA_ARGS__)
+#define RESCUE_LOG_A4(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A3(__VA_ARGS__)
+#define RESCUE_LOG_A5(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A4(__VA_ARGS__)
+#define RESCUE_LOG_A6(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A5(__VA_ARGS__)
+#define RESCUE_LOG_A7(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A6(__VA_ARGS__)
+#define RESCUE_LOG_A8(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A7(__VA_ARGS__)
+#define RESCUE_LOG_A9(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A8(__VA_ARGS__)
+#define RESCUE_LOG_A10(a, ...) RESCUE_LOG_ARG(a), RESCUE_LOG_A9(__VA_ARGS__)
+
+#define RESCUE_LOG_CALL0(level, fmt) rescue_log_write(level, fmt, 0, NULL)
+#define RESCUE_LOG_CALLN(level, n, fmt, ...) \
+  rescue_log_write(level, fmt, n, (const RescueLogArg[]){RESCUE_LOG_A##n(__VA_ARGS__)})
+#define RESCUE_LOG_CALL1(level, fmt, ...) RESCUE_LOG_CALLN(level, 1, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL2(level, fmt, ...) RESCUE_LOG_CALLN(level, 2, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL3(level, fmt, ...) RESCUE_LOG_CALLN(level, 3, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL4(level, fmt, ...) RESCUE_LOG_CALLN(level, 4, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL5(level, fmt, ...) RESCUE_LOG_CALLN(level, 5, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL6(level, fmt, ...) RESCUE_LOG_CALLN(level, 6, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL7(level, fmt, ...) RESCUE_LOG_CALLN(level, 7, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL8(level, fmt, ...) RESCUE_LOG_CALLN(level, 8, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL9(level, fmt, ...) RESCUE_LOG_CALLN(level, 9, fmt, __VA_ARGS__)
+#define RESCUE_LOG_CALL10(level, fmt, ...) RESCUE_LOG_CALLN(level, 10, fmt, __VA_ARGS__)
+
+#define RESCUE_LOG_PICK(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, NAME, ...) NAME
+#define RESCUE_LOG_EMIT(level, ...)                                                                  \
+  RESCUE_LOG_PICK(__VA_ARGS__, RESCUE_LOG_CALL10, RESCUE_LOG_CALL9, RESCUE_LOG_CALL8, RESCUE_LOG_CALL7, \
+                  RESCUE_LOG_CALL6, RESCUE_LOG_CALL5, RESCUE_LOG_CALL4, RESCUE_LOG_CALL3,             \
+                  RESCUE_LOG_CALL2, RESCUE_LOG_CALL1, RESCUE_LOG_CALL0, )(level, __VA_ARGS__)
+
+#if RESCUE_LOG_LEVEL <= RESCUE_LOG_LEVEL_DEBUG
+#define RESCUE_LOG_DEBUG(...) RESCUE_LOG_EMIT(RESCUE_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define RESCUE_LOG_DEBUG(...) ((void)0)
+#endif
+#if RESCUE_LOG_LEVEL <= RESCUE_LOG_LEVEL_INFO
+#define RESCUE_LOG_INFO(...) RESCUE_LOG_EMIT(RESCUE_LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define RESCUE_LOG_INFO(...) ((void)0)
+#endif
+#if RESCUE_LOG_LEVEL <= RESCUE_LOG_LEVEL_WARN
+#define RESCUE_LOG_WARN(...) RESCUE_LOG_EMIT(RESCUE_LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define RESCUE_LOG_WARN(...) ((void)0)
+#endif
+#if RESCUE_LOG_LEVEL <= RESCUE_LOG_LEVEL_ERROR
+#define RESCUE_LOG_ERROR(...) RESCUE_LOG_EMIT(RESCUE_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define RESCUE_LOG_ERROR(...) ((void)0)
+#endif
+
+#endif // RESCUE_LOG_H
@@ -0,0 +1,594 @@
+/*
+ * Description: Tiled log-odds occupancy grid (see rescue_map.h).
+ */
+
+#include "rescue_map.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RESCUE_MAP_KERNEL "avx2"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RESCUE_MAP_KERNEL "sse2"
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESCUE_MAP_KERNEL "neon"
+#else
+#define RESCUE_MAP_KERNEL "scalar"
+#endif
+
+#define WINDOW_CELLS (RESCUE_MAP_WINDOW_TILES * RESCUE_MAP_WINDOW_TILES * RESCUE_MAP_TILE_CELLS)
+#define TILE_CELL_BITS (2 * RESCUE_MAP_TILE_BITS)
+#define BATCH_SLOTS (RESCUE_MAP_MAX_BEAMS + 8) // Room to pad the last vector of beams
+#define BLOCK_BITS 8                           // Window blocks of 256 cells (a 16x16 Morton square)
+#define BLOCK_CELLS (1 << BLOCK_BITS)
+#define DIRTY_WORDS (WINDOW_CELLS >> BLOCK_BITS >> 6)
+
+const char *rescue_map_simd_name(void) { return RESCUE_MAP_KERNEL; }
+
+bool rescue_map_init(RescueMap *m, int max_tiles) {
+  memset(m, 0, sizeof(*m));
+  if (max_tiles > RESCUE_MAP_TILES * RESCUE_MAP_TILES) max_tiles = RESCUE_MAP_TILES * RESCUE_MAP_TILES;
+  m->pool = calloc((size_t)max_tiles, RESCUE_MAP_TILE_CELLS);
+  m->window = calloc(WINDOW_CELLS + RESCUE_MAP_TILE_CELLS, 1); // + sink
+  if (!m->pool || !m->window) { rescue_map_free(m); return false; }
+  m->max_tiles = max_tiles;
+  m->simd = strcmp(RESCUE_MAP_KERNEL, "scalar") != 0;
+  return true;
+}
+
+void rescue_map_free(RescueMap *m) {
+  free(m->pool);
+  free(m->window);
+  free(m->changes);
+  m->pool = NULL;
+  m->window = NULL;
+  m->changes = NULL;
+  m->max_tiles = m->used_tiles = 0;
+  m->num_changes = m->max_changes = 0;
+}
+
+bool rescue_map_track_changes(RescueMap *m, int capacity) {
+  RescueMapChange *log = realloc(m->changes, (size_t)capacity * sizeof(*log));
+  if (!log) return false;
+  m->changes = log;
+  m->max_changes = capacity;
+  m->num_changes = 0;
+  return true;
+}
+
+unsigned long rescue_map_memory(const RescueMap *m) {
+  return (unsigned long)sizeof(*m) + (unsigned long)m->max_tiles * RESCUE_MAP_TILE_CELLS + WINDOW_CELLS +
+         RESCUE_MAP_TILE_CELLS + (unsigned long)m->max_changes * sizeof(RescueMapChange);
+}
+
+// Inverse of rescue_map_spread: every other bit, packed.
+static inline uint32_t unspread(uint32_t v) {
+  v &= 0x5555u;
+  v = (v | (v >> 1)) & 0x3333u;
+  v = (v | (v >> 2)) & 0x0F0Fu;
+  v = (v | (v >> 4)) & 0x00FFu;
+  return v;
+}
+
+static void log_change(RescueMap *m, int cx, int cy, int8_t before, int8_t after) {
+  if (m->num_changes >= m->max_changes) { m->changes_dropped++; return; }
+  RescueMapChange *c = &m->changes[m->num_changes++];
+  c->cx = cx;
+  c->cy = cy;
+  c->before = before;
+  c->after = after;
+}
+
+// Logs the cells of tile (tx, ty) from Morton index first on whose class
+// changed between before[] and after[].
+static void log_changes(RescueMap *m, int tx, int ty, int first, const int8_t *before, const int8_t *after, int n) {
+  for (int i = 0; i < n; ++i) {
+    if (rescue_map_class(before[i]) == rescue_map_class(after[i])) continue;
+    uint32_t j = (uint32_t)(first + i);
+    log_change(m, tx * RESCUE_MAP_TILE_SIZE + (int)unspread(j), ty * RESCUE_MAP_TILE_SIZE + (int)unspread(j >> 1),
+               before[i], after[i]);
+  }
+}
+
+// Tile storage for writing; assigns a pool tile on first touch, NULL if none is left.
+static int8_t *tile_for_write(RescueMap *m, int tile_index) {
+  int t = m->tile[tile_index];
+  if (!t) {
+    if (m->used_tiles >= m->max_tiles) return NULL;
+    t = ++m->used_tiles;
+    m->tile[tile_index] = (uint16_t)t;
+  }
+  return m->pool + (size_t)(t - 1) * RESCUE_MAP_TILE_CELLS;
+}
+
+static inline void add_log_odds(int8_t *cell, int delta) {
+  int v = *cell + delta;
+  *cell = (int8_t)(v < RESCUE_MAP_L_MIN ? RESCUE_MAP_L_MIN : v > RESCUE_MAP_L_MAX ? RESCUE_MAP_L_MAX : v);
+}
+
+static int cell_coord(double v, double origin) {
+  double c = floor((v - origin) * (1.0 / RESCUE_MAP_RESOLUTION));
+  return c < -1.0 ? -1 : c > RESCUE_MAP_CELLS ? RESCUE_MAP_CELLS : (int)c; // Clamped just off the map
+}
+
+void rescue_map_trace(RescueMap *m, double x0, double y0, double x1, double y1, bool hit) {
+  int cx = cell_coord(x0, m->origin_x), cy = cell_coord(y0, m->origin_y);
+  int ex = cell_coord(x1, m->origin_x), ey = cell_coord(y1, m->origin_y);
+  int dx = abs(ex - cx), dy = -abs(ey - cy);
+  int sx = cx < ex ? 1 : -1, sy = cy < ey ? 1 : -1;
+  int err = dx + dy;
+  int cur_tile = -1;
+  int8_t *base = NULL;
+  m->rays++;
+
+  // --- Bresenham walk, free cells up to the end ---
+  for (;;) {
+    bool last = cx == ex && cy == ey;
+    if ((unsigned)cx < RESCUE_MAP_CELLS && (unsigned)cy < RESCUE_MAP_CELLS) {
+      int tile_index = (cy >> RESCUE_MAP_TILE_BITS) * RESCUE_MAP_TILES + (cx >> RESCUE_MAP_TILE_BITS);
+      if (tile_index != cur_tile) { cur_tile = tile_index; base = tile_for_write(m, tile_index); }
+      if (base) {
+        int8_t *cell = base + rescue_map_morton(cx, cy), before = *cell;
+        add_log_odds(cell, last && hit ? RESCUE_MAP_L_HIT : RESCUE_MAP_L_FREE);
+        if (m->changes && rescue_map_class(before) != rescue_map_class(*cell)) log_change(m, cx, cy, before, *cell);
+        m->cells_updated++;
+      } else {
+        m->cells_dropped++;
+      }
+    } else {
+      m->cells_dropped++;
+    }
+    if (last) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; cx += sx; }
+    if (e2 <= dx) { err += dx; cy += sy; }
+  }
+}
+
+// --- Batched Updates ---
+// Beams are rasterized with a fixed-point DDA along their major axis in
+// window cell coordinates (16.16), so every lane of a vector steps the same
+// way. The window holds a code per cell, or'ed in: a pass marks a cell
+// free, a hit marks it occupied and wins. Cells crossed by several beams get
+// one update and the order the beams are drawn does not matter. A bit per
+// 256-cell block records what was written, so only those blocks are added
+// to the map.
+
+#define CODE_FREE 1
+#define CODE_HIT 2               // Set: occupied, whatever else crossed the cell
+#define WINDOW_SINK WINDOW_CELLS // Spare tile past the window where finished lanes write
+
+typedef struct {
+  uint64_t bits[DIRTY_WORDS + 1]; // A bit per block; the last word catches the sink
+} Dirty;
+
+typedef struct {
+  int count;                     // Beams, padded with finished ones to a multiple of 8
+  uint32_t fx[BATCH_SLOTS], fy[BATCH_SLOTS]; // Current position (16.16)
+  uint32_t sx[BATCH_SLOTS], sy[BATCH_SLOTS]; // Step per cell, two's complement
+  int32_t n[BATCH_SLOTS];        // Index of the last cell, -1 = none
+  int32_t end_code[BATCH_SLOTS]; // Code of the last cell
+} Raster;
+
+static inline uint32_t window_offset(uint32_t fx, uint32_t fy) {
+  uint32_t cx = fx >> 16, cy = fy >> 16;
+  uint32_t tile = ((cy >> RESCUE_MAP_TILE_BITS) << RESCUE_MAP_WINDOW_BITS) | (cx >> RESCUE_MAP_TILE_BITS);
+  return (tile << TILE_CELL_BITS) | rescue_map_morton((int)cx, (int)cy);
+}
+
+// Index of the lowest set bit of v (not 0).
+static inline int lowest_bit(uint64_t v) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(v);
+#else
+  int i = 0;
+  for (; !(v & 1); v >>= 1) ++i;
+  return i;
+#endif
+}
+
+// Beams cross into a new block every dozen cells or so; marking only then
+// keeps the dirty words out of the per-cell dependency chain.
+static inline void dirty_mark(Dirty *dirty, uint32_t off) {
+  dirty->bits[off >> (BLOCK_BITS + 6)] |= 1ull << ((off >> BLOCK_BITS) & 63);
+}
+
+static void raster_scalar(int8_t *window, Dirty *dirty, const Raster *r) {
+  for (int b = 0; b < r->count; ++b) {
+    uint32_t fx = r->fx[b], fy = r->fy[b], block = UINT32_MAX;
+    for (int k = 0; k <= r->n[b]; ++k, fx += r->sx[b], fy += r->sy[b]) {
+      uint32_t off = window_offset(fx, fy);
+      window[off] |= (int8_t)(k == r->n[b] ? r->end_code[b] : CODE_FREE);
+      if (off >> BLOCK_BITS != block) { block = off >> BLOCK_BITS; dirty_mark(dirty, off); }
+    }
+  }
+}
+
+static inline int lanes_kmax(const Raster *r, int b, int lanes) {
+  int kmax = -1;
+  for (int l = 0; l < lanes; ++l) if (r->n[b + l] > kmax) kmax = r->n[b + l];
+  return kmax;
+}
+
+// Writes one step of a vector of beams: offsets and codes computed per lane
+// (finished lanes point at the sink with code 0). moved has a bit per lane
+// that entered a new block.
+static inline void raster_scatter(int8_t *window, Dirty *dirty, int lanes, const uint32_t *off, const int32_t *code,
+                                  unsigned moved) {
+  for (int l = 0; l < lanes; ++l) window[off[l]] |= (int8_t)code[l];
+  for (; moved; moved &= moved - 1) dirty_mark(dirty, off[lowest_bit(moved)]);
+}
+
+static const int8_t code_delta[4] = {0, RESCUE_MAP_L_FREE, RESCUE_MAP_L_HIT, RESCUE_MAP_L_HIT};
+
+// 8 codes as a word, code k in byte k from the bottom whatever the byte order
+// (compilers fold this into one load where it is little-endian).
+static inline uint64_t load_codes(const int8_t *codes) {
+  const uint8_t *c = (const uint8_t *)codes;
+  return (uint64_t)c[0] | (uint64_t)c[1] << 8 | (uint64_t)c[2] << 16 | (uint64_t)c[3] << 24 | (uint64_t)c[4] << 32 |
+         (uint64_t)c[5] << 40 | (uint64_t)c[6] << 48 | (uint64_t)c[7] << 56;
+}
+
+// Scalar fallback for the block add: 8 cells at a time, skipping empty words
+// and visiting only the used bytes of the others.
+static int apply_block_scalar(RescueMap *m, int8_t *cells, int8_t *codes, int tx, int ty, int first) {
+  int changed = 0;
+  for (int i = 0; i < BLOCK_CELLS; i += 8) {
+    uint64_t word = load_codes(codes + i);
+    if (!word) continue;
+    for (uint64_t used = (word | word >> 1) & 0x0101010101010101ull; used; used &= used - 1) {
+      int j = i + (lowest_bit(used) >> 3); // Codes are 1..3: bit 0 of each used byte
+      int8_t before = cells[j];
+      add_log_odds(cells + j, code_delta[codes[j]]);
+      if (m->changes) log_changes(m, tx, ty, first + j, &before, cells + j, 1);
+      changed++;
+    }
+    memset(codes + i, 0, 8);
+  }
+  return changed;
+}
+
+#if defined(__AVX2__)
+static inline __m256i spread_avx2(__m256i v) {
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 4)), _mm256_set1_epi32(0x0F0F));
+  v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 2)), _mm256_set1_epi32(0x3333));
+  return _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 1)), _mm256_set1_epi32(0x5555));
+}
+
+static void raster_simd(int8_t *window, Dirty *dirty, const Raster *r) {
+  const __m256i low = _mm256_set1_epi32(RESCUE_MAP_TILE_SIZE - 1);
+  const __m256i sink = _mm256_set1_epi32(WINDOW_SINK), free_code = _mm256_set1_epi32(CODE_FREE);
+  uint32_t off[8];
+  int32_t code[8];
+  for (int b = 0; b < r->count; b += 8) {
+    __m256i fx = _mm256_loadu_si256((const __m256i *)(r->fx + b)), fy = _mm256_loadu_si256((const __m256i *)(r->fy + b));
+    __m256i sx = _mm256_loadu_si256((const __m256i *)(r->sx + b)), sy = _mm256_loadu_si256((const __m256i *)(r->sy + b));
+    __m256i n = _mm256_loadu_si256((const __m256i *)(r->n + b));
+    __m256i end_code = _mm256_loadu_si256((const __m256i *)(r->end_code + b));
+    __m256i prev = _mm256_set1_epi32(-1);
+    int kmax = lanes_kmax(r, b, 8);
+    for (int k = 0; k <= kmax; ++k) {
+      __m256i vk = _mm256_set1_epi32(k);
+      __m256i done = _mm256_cmpgt_epi32(vk, n), last = _mm256_cmpeq_epi32(vk, n);
+      __m256i cx = _mm256_srli_epi32(fx, 16), cy = _mm256_srli_epi32(fy, 16);
+      __m256i tile = _mm256_or_si256(_mm256_slli_epi32(_mm256_srli_epi32(cy, RESCUE_MAP_TILE_BITS), RESCUE_MAP_WINDOW_BITS),
+                                     _mm256_srli_epi32(cx, RESCUE_MAP_TILE_BITS));
+      __m256i morton = _mm256_or_si256(spread_avx2(_mm256_and_si256(cx, low)),
+                                       _mm256_slli_epi32(spread_avx2(_mm256_and_si256(cy, low)), 1));
+      __m256i o = _mm256_or_si256(_mm256_slli_epi32(tile, TILE_CELL_BITS), morton);
+      o = _mm256_blendv_epi8(o, sink, done);
+      __m256i block = _mm256_srli_epi32(o, BLOCK_BITS);
+      unsigned moved = ~(unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(block, prev))) & 0xFFu;
+      prev = block;
+      _mm256_storeu_si256((__m256i *)off, o);
+      _mm256_storeu_si256((__m256i *)code, _mm256_andnot_si256(done, _mm256_blendv_epi8(free_code, end_code, last)));
+      raster_scatter(window, dirty, 8, off, code, moved);
+      fx = _mm256_add_epi32(fx, sx);
+      fy = _mm256_add_epi32(fy, sy);
+    }
+  }
+}
+
+// Mask of the bytes whose class differs between a and b.
+static inline __m256i class_diff_avx2(__m256i a, __m256i b) {
+  const __m256i occ = _mm256_set1_epi8(RESCUE_MAP_OCCUPIED), free_ = _mm256_set1_epi8(RESCUE_MAP_FREE);
+  return _mm256_or_si256(_mm256_xor_si256(_mm256_cmpgt_epi8(a, occ), _mm256_cmpgt_epi8(b, occ)),
+                         _mm256_xor_si256(_mm256_cmpgt_epi8(free_, a), _mm256_cmpgt_epi8(free_, b)));
+}
+
+// Adds a block of codes to the map as log-odds (saturating, then clamped)
+// and clears them; class changes go to the log when it is on. The block
+// starts at Morton index first of tile (tx, ty). Returns the number of
+// cells updated.
+static int apply_block_simd(RescueMap *m, int8_t *cells, int8_t *codes, int tx, int ty, int first) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i free_code = _mm256_set1_epi8(CODE_FREE), hit_code = _mm256_set1_epi8(CODE_HIT);
+  const __m256i l_free = _mm256_set1_epi8(RESCUE_MAP_L_FREE), l_hit = _mm256_set1_epi8(RESCUE_MAP_L_HIT);
+  const __m256i lo = _mm256_set1_epi8(RESCUE_MAP_L_MIN), hi = _mm256_set1_epi8(RESCUE_MAP_L_MAX);
+  int changed = 0;
+  for (int i = 0; i < BLOCK_CELLS; i += 32) {
+    __m256i c = _mm256_loadu_si256((const __m256i *)(codes + i));
+    if (_mm256_testz_si256(c, c)) continue;
+    __m256i d = _mm256_or_si256(_mm256_and_si256(_mm256_cmpeq_epi8(c, free_code), l_free),
+                                _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(c, hit_code), hit_code), l_hit));
+    __m256i old = _mm256_loadu_si256((const __m256i *)(cells + i));
+    __m256i v = _mm256_min_epi8(_mm256_max_epi8(_mm256_adds_epi8(old, d), lo), hi);
+    _mm256_storeu_si256((__m256i *)(cells + i), v);
+    _mm256_storeu_si256((__m256i *)(codes + i), zero);
+    __m256i diff = class_diff_avx2(old, v);
+    if (m->changes && !_mm256_testz_si256(diff, diff)) {
+      int8_t before[32];
+      _mm256_storeu_si256((__m256i *)before, old);
+      log_changes(m, tx, ty, first + i, before, cells + i, 32);
+    }
+    changed += __builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpgt_epi8(c, zero)));
+  }
+  return changed;
+}
+#elif defined(__SSE2__)
+static inline __m128i spread_sse2(__m128i v) {
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 4)), _mm_set1_epi32(0x0F0F));
+  v = _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 2)), _mm_set1_epi32(0x3333));
+  return _mm_and_si128(_mm_or_si128(v, _mm_slli_epi32(v, 1)), _mm_set1_epi32(0x5555));
+}
+
+static inline __m128i sse_select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void raster_simd(int8_t *window, Dirty *dirty, const Raster *r) {
+  const __m128i low = _mm_set1_epi32(RESCUE_MAP_TILE_SIZE - 1);
+  const __m128i sink = _mm_set1_epi32(WINDOW_SINK), free_code = _mm_set1_epi32(CODE_FREE);
+  uint32_t off[4];
+  int32_t code[4];
+  for (int b = 0; b < r->count; b += 4) {
+    __m128i fx = _mm_loadu_si128((const __m128i *)(r->fx + b)), fy = _mm_loadu_si128((const __m128i *)(r->fy + b));
+    __m128i sx = _mm_loadu_si128((const __m128i *)(r->sx + b)), sy = _mm_loadu_si128((const __m128i *)(r->sy + b));
+    __m128i n = _mm_loadu_si128((const __m128i *)(r->n + b));
+    __m128i end_code = _mm_loadu_si128((const __m128i *)(r->end_code + b));
+    __m128i prev = _mm_set1_epi32(-1);
+    int kmax = lanes_kmax(r, b, 4);
+    for (int k = 0; k <= kmax; ++k) {
+      __m128i vk = _mm_set1_epi32(k);
+      __m128i done = _mm_cmpgt_epi32(vk, n), last = _mm_cmpeq_epi32(vk, n);
+      __m128i cx = _mm_srli_epi32(fx, 16), cy = _mm_srli_epi32(fy, 16);
+      __m128i tile = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(cy, RESCUE_MAP_TILE_BITS), RESCUE_MAP_WINDOW_BITS),
+                                  _mm_srli_epi32(cx, RESCUE_MAP_TILE_BITS));
+      __m128i morton = _mm_or_si128(spread_sse2(_mm_and_si128(cx, low)), _mm_slli_epi32(spread_sse2(_mm_and_si128(cy, low)), 1));
+      __m128i o = _mm_or_si128(_mm_slli_epi32(tile, TILE_CELL_BITS), morton);
+      o = sse_select(done, sink, o);
+      __m128i block = _mm_srli_epi32(o, BLOCK_BITS);
+      unsigned moved = ~(unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, prev))) & 0xFu;
+      prev = block;
+      _mm_storeu_si128((__m128i *)off, o);
+      _mm_storeu_si128((__m128i *)code, _mm_andnot_si128(done, sse_select(last, end_code, free_code)));
+      raster_scatter(window, dirty, 4, off, code, moved);
+      fx = _mm_add_epi32(fx, sx);
+      fy = _mm_add_epi32(fy, sy);
+    }
+  }
+}
+
+static inline __m128i class_diff_sse2(__m128i a, __m128i b) {
+  const __m128i occ = _mm_set1_epi8(RESCUE_MAP_OCCUPIED), free_ = _mm_set1_epi8(RESCUE_MAP_FREE);
+  return _mm_or_si128(_mm_xor_si128(_mm_cmpgt_epi8(a, occ), _mm_cmpgt_epi8(b, occ)),
+                      _mm_xor_si128(_mm_cmplt_epi8(a, free_), _mm_cmplt_epi8(b, free_)));
+}
+
+static int apply_block_simd(RescueMap *m, int8_t *cells, int8_t *codes, int tx, int ty, int first) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i free_code = _mm_set1_epi8(CODE_FREE), hit_code = _mm_set1_epi8(CODE_HIT);
+  const __m128i l_free = _mm_set1_epi8(RESCUE_MAP_L_FREE), l_hit = _mm_set1_epi8(RESCUE_MAP_L_HIT);
+  const __m128i lo = _mm_set1_epi8(RESCUE_MAP_L_MIN), hi = _mm_set1_epi8(RESCUE_MAP_L_MAX);
+  int changed = 0;
+  for (int i = 0; i < BLOCK_CELLS; i += 16) {
+    __m128i c = _mm_loadu_si128((const __m128i *)(codes + i));
+    int used = _mm_movemask_epi8(_mm_cmpgt_epi8(c, zero));
+    if (!used) continue;
+    __m128i d = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(c, free_code), l_free),
+                             _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(c, hit_code), hit_code), l_hit));
+    __m128i old = _mm_loadu_si128((const __m128i *)(cells + i));
+    __m128i v = _mm_adds_epi8(old, d);
+    v = sse_select(_mm_cmplt_epi8(v, lo), lo, v); // No signed byte min/max before SSE4.1
+    v = sse_select(_mm_cmpgt_epi8(v, hi), hi, v);
+    _mm_storeu_si128((__m128i *)(cells + i), v);
+    _mm_storeu_si128((__m128i *)(codes + i), zero);
+    if (m->changes && _mm_movemask_epi8(class_diff_sse2(old, v))) {
+      int8_t before[16];
+      _mm_storeu_si128((__m128i *)before, old);
+      log_changes(m, tx, ty, first + i, before, cells + i, 16);
+    }
+    changed += __builtin_popcount((unsigned)used);
+  }
+  return changed;
+}
+#elif defined(__ARM_NEON)
+static inline uint32x4_t spread_neon(uint32x4_t v) {
+  v = vandq_u32(vorrq_u32(v, vshlq_n_u32(v, 4)), vdupq_n_u32(0x0F0F));
+  v = vandq_u32(vorrq_u32(v, vshlq_n_u32(v, 2)), vdupq_n_u32(0x3333));
+  return vandq_u32(vorrq_u32(v, vshlq_n_u32(v, 1)), vdupq_n_u32(0x5555));
+}
+
+static void raster_simd(int8_t *window, Dirty *dirty, const Raster *r) {
+  const uint32x4_t low = vdupq_n_u32(RESCUE_MAP_TILE_SIZE - 1);
+  const uint32x4_t sink = vdupq_n_u32(WINDOW_SINK);
+  const int32x4_t free_code = vdupq_n_s32(CODE_FREE), zero = vdupq_n_s32(0);
+  const uint32_t lane_bit[4] = {1, 2, 4, 8};
+  const uint32x4_t lane_bits = vld1q_u32(lane_bit);
+  uint32_t off[4];
+  int32_t code[4];
+  for (int b = 0; b < r->count; b += 4) {
+    uint32x4_t fx = vld1q_u32(r->fx + b), fy = vld1q_u32(r->fy + b);
+    uint32x4_t sx = vld1q_u32(r->sx + b), sy = vld1q_u32(r->sy + b);
+    int32x4_t n = vld1q_s32(r->n + b), end_code = vld1q_s32(r->end_code + b);
+    uint32x4_t prev = vdupq_n_u32(UINT32_MAX);
+    int kmax = lanes_kmax(r, b, 4);
+    for (int k = 0; k <= kmax; ++k) {
+      int32x4_t vk = vdupq_n_s32(k);
+      uint32x4_t done = vcgtq_s32(vk, n), last = vceqq_s32(vk, n);
+      uint32x4_t cx = vshrq_n_u32(fx, 16), cy = vshrq_n_u32(fy, 16);
+      uint32x4_t tile = vorrq_u32(vshlq_n_u32(vshrq_n_u32(cy, RESCUE_MAP_TILE_BITS), RESCUE_MAP_WINDOW_BITS),
+                                  vshrq_n_u32(cx, RESCUE_MAP_TILE_BITS));
+      uint32x4_t morton = vorrq_u32(spread_neon(vandq_u32(cx, low)), vshlq_n_u32(spread_neon(vandq_u32(cy, low)), 1));
+      uint32x4_t o = vbslq_u32(done, sink, vorrq_u32(vshlq_n_u32(tile, TILE_CELL_BITS), morton));
+      uint32x4_t block = vshrq_n_u32(o, BLOCK_BITS);
+      unsigned moved = vaddvq_u32(vbicq_u32(lane_bits, vceqq_u32(block, prev)));
+      prev = block;
+      vst1q_u32(off, o);
+      vst1q_s32(code, vbslq_s32(done, zero, vbslq_s32(last, end_code, free_code)));
+      raster_scatter(window, dirty, 4, off, code, moved);
+      fx = vaddq_u32(fx, sx);
+      fy = vaddq_u32(fy, sy);
+    }
+  }
+}
+
+static inline uint8x16_t class_diff_neon(int8x16_t a, int8x16_t b) {
+  const int8x16_t occ = vdupq_n_s8(RESCUE_MAP_OCCUPIED), free_ = vdupq_n_s8(RESCUE_MAP_FREE);
+  return vorrq_u8(veorq_u8(vcgtq_s8(a, occ), vcgtq_s8(b, occ)), veorq_u8(vcltq_s8(a, free_), vcltq_s8(b, free_)));
+}
+
+static int apply_block_simd(RescueMap *m, int8_t *cells, int8_t *codes, int tx, int ty, int first) {
+  const int8x16_t free_code = vdupq_n_s8(CODE_FREE), hit_code = vdupq_n_s8(CODE_HIT);
+  const int8x16_t l_free = vdupq_n_s8(RESCUE_MAP_L_FREE), l_hit = vdupq_n_s8(RESCUE_MAP_L_HIT);
+  const int8x16_t lo = vdupq_n_s8(RESCUE_MAP_L_MIN), hi = vdupq_n_s8(RESCUE_MAP_L_MAX);
+  int changed = 0;
+  for (int i = 0; i < BLOCK_CELLS; i += 16) {
+    int8x16_t c = vld1q_s8(codes + i);
+    if (vmaxvq_u8(vreinterpretq_u8_s8(c)) == 0) continue;
+    int8x16_t d = vbslq_s8(vceqq_s8(c, free_code), l_free, vandq_s8(vreinterpretq_s8_u8(vtstq_s8(c, hit_code)), l_hit));
+    int8x16_t old = vld1q_s8(cells + i);
+    int8x16_t v = vminq_s8(vmaxq_s8(vqaddq_s8(old, d), lo), hi);
+    vst1q_s8(cells + i, v);
+    vst1q_s8(codes + i, vdupq_n_s8(0));
+    if (m->changes && vmaxvq_u8(class_diff_neon(old, v))) {
+      int8_t before[16];
+      vst1q_s8(before, old);
+      log_changes(m, tx, ty, first + i, before, cells + i, 16);
+    }
+    changed += vaddvq_u8(vshrq_n_u8(vtstq_s8(c, c), 7));
+  }
+  return changed;
+}
+#else
+#define raster_simd raster_scalar
+#define apply_block_simd apply_block_scalar
+#endif
+
+static int drop_block(int8_t *codes) {
+  int dropped = 0;
+  for (int i = 0; i < BLOCK_CELLS; ++i) dropped += codes[i] != 0;
+  memset(codes, 0, BLOCK_CELLS);
+  return dropped;
+}
+
+static int floor_tile(int c) { return c < 0 ? -1 : c >> RESCUE_MAP_TILE_BITS; } // Cells are clamped to >= -1
+
+void rescue_map_center(RescueMap *m, double x, double y) {
+  m->origin_x = x - 0.5 * RESCUE_MAP_CELLS * RESCUE_MAP_RESOLUTION;
+  m->origin_y = y - 0.5 * RESCUE_MAP_CELLS * RESCUE_MAP_RESOLUTION;
+  m->anchored = true;
+}
+
+void rescue_map_update_beams(RescueMap *m, const RescueMapBeams *b) {
+  if (b->count <= 0) return;
+  if (!m->anchored) rescue_map_center(m, b->x0[0], b->y0[0]);
+
+  // --- Cells and the window of tiles they fall in ---
+  int count = b->count < RESCUE_MAP_MAX_BEAMS ? b->count : RESCUE_MAP_MAX_BEAMS;
+  int c0x[RESCUE_MAP_MAX_BEAMS], c0y[RESCUE_MAP_MAX_BEAMS], c1x[RESCUE_MAP_MAX_BEAMS], c1y[RESCUE_MAP_MAX_BEAMS];
+  int minx = RESCUE_MAP_CELLS, miny = RESCUE_MAP_CELLS, maxx = -1, maxy = -1;
+  for (int i = 0; i < count; ++i) {
+    c0x[i] = cell_coord(b->x0[i], m->origin_x); c0y[i] = cell_coord(b->y0[i], m->origin_y);
+    c1x[i] = cell_coord(b->x1[i], m->origin_x); c1y[i] = cell_coord(b->y1[i], m->origin_y);
+    int lx = c0x[i] < c1x[i] ? c0x[i] : c1x[i], hx = c0x[i] < c1x[i] ? c1x[i] : c0x[i];
+    int ly = c0y[i] < c1y[i] ? c0y[i] : c1y[i], hy = c0y[i] < c1y[i] ? c1y[i] : c0y[i];
+    if (lx < minx) minx = lx;
+    if (hx > maxx) maxx = hx;
+    if (ly < miny) miny = ly;
+    if (hy > maxy) maxy = hy;
+  }
+  int tx0 = floor_tile(minx), ty0 = floor_tile(miny);
+  if (floor_tile(maxx) - tx0 >= RESCUE_MAP_WINDOW_TILES || floor_tile(maxy) - ty0 >= RESCUE_MAP_WINDOW_TILES) {
+    for (int i = 0; i < count; ++i) rescue_map_trace(m, b->x0[i], b->y0[i], b->x1[i], b->y1[i], b->hit[i]);
+    return; // Beams spread too far for the window
+  }
+
+  // --- Rasterize into the window ---
+  Raster r;
+  int wx = tx0 * RESCUE_MAP_TILE_SIZE, wy = ty0 * RESCUE_MAP_TILE_SIZE;
+  for (int i = 0; i < count; ++i) {
+    int dx = c1x[i] - c0x[i], dy = c1y[i] - c0y[i];
+    int n = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+    r.fx[i] = (uint32_t)((c0x[i] - wx) * 65536 + 32768); // Cell center
+    r.fy[i] = (uint32_t)((c0y[i] - wy) * 65536 + 32768);
+    r.sx[i] = n ? (uint32_t)(dx * 65536 / n) : 0;
+    r.sy[i] = n ? (uint32_t)(dy * 65536 / n) : 0;
+    r.n[i] = n;
+    r.end_code[i] = b->hit[i] ? CODE_HIT : CODE_FREE;
+  }
+  r.count = (count + 7) & ~7;
+  for (int i = count; i < r.count; ++i) {
+    r.fx[i] = r.fy[i] = r.sx[i] = r.sy[i] = 0;
+    r.n[i] = -1;
+    r.end_code[i] = 0;
+  }
+  Dirty dirty;
+  memset(&dirty, 0, sizeof(dirty));
+  if (m->simd) raster_simd(m->window, &dirty, &r);
+  else raster_scalar(m->window, &dirty, &r);
+  m->rays += (unsigned long)count;
+
+  // --- Add the written blocks to the map ---
+  const int blocks_per_tile = RESCUE_MAP_TILE_CELLS / BLOCK_CELLS;
+  for (int w = 0; w < RESCUE_MAP_WINDOW_TILES * RESCUE_MAP_WINDOW_TILES; ++w) {
+    int first = w * blocks_per_tile;
+    uint64_t bits = (dirty.bits[first >> 6] >> (first & 63)) & ((1ull << blocks_per_tile) - 1);
+    if (!bits) continue;
+    int tx = tx0 + (w & (RESCUE_MAP_WINDOW_TILES - 1)), ty = ty0 + (w >> RESCUE_MAP_WINDOW_BITS);
+    bool on_map = (unsigned)tx < RESCUE_MAP_TILES && (unsigned)ty < RESCUE_MAP_TILES;
+    int8_t *tile = on_map ? tile_for_write(m, ty * RESCUE_MAP_TILES + tx) : NULL;
+    for (; bits; bits &= bits - 1) {
+      int block = lowest_bit(bits);
+      int8_t *codes = m->window + (size_t)w * RESCUE_MAP_TILE_CELLS + (size_t)block * BLOCK_CELLS;
+      if (!tile) m->cells_dropped += (unsigned long)drop_block(codes);
+      else if (m->simd) m->cells_updated += (unsigned long)apply_block_simd(m, tile + block * BLOCK_CELLS, codes, tx, ty, block * BLOCK_CELLS);
+      else m->cells_updated += (unsigned long)apply_block_scalar(m, tile + block * BLOCK_CELLS, codes, tx, ty, block * BLOCK_CELLS);
+    }
+  }
+}
+
+void rescue_map_update(RescueMap *m, const double *pose, const RescueInputs *in) {
+  if (!m->anchored) rescue_map_center(m, pose[0], pose[1]); // Start pose at the center of the map
+  double heading = pose[2];
+  double sx = pose[0] + RESCUE_DS_MOUNT_OFFSET * cos(heading);
+  double sy = pose[1] + RESCUE_DS_MOUNT_OFFSET * sin(heading);
+  RescueMapBeams beams;
+  beams.count = 0;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    if (!in->ds_present[i]) continue;
+    double range = in->ds[i];
+    if (!(range >= 0.0)) continue; // NaN or negative
+    bool hit = range < RESCUE_MAP_MAX_RANGE;
+    if (!hit) range = RESCUE_MAP_MAX_RANGE;
+    double bearing = heading + rescue_ds_angle(i);
+    int k = beams.count++;
+    beams.x0[k] = sx;
+    beams.y0[k] = sy;
+    beams.x1[k] = sx + range * cos(bearing);
+    beams.y1[k] = sy + range * sin(bearing);
+    beams.hit[k] = hit;
+  }
+  rescue_map_update_beams(m, &beams);
+}
+
+int rescue_map_get(const RescueMap *m, double x, double y) {
+  if (!m->anchored) return 0;
+  const int8_t *cell = rescue_map_cell(m, cell_coord(x, m->origin_x), cell_coord(y, m->origin_y));
+  return cell ? *cell : 0;
+}
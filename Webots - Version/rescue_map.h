@@ -0,0 +1,177 @@
+/*
+ * Description: Occupancy grid of the area the robot has seen, built from
+ *              ds_front, ds_left and ds_right. Every step each sensor ray
+ *              is walked cell by cell: the cells it crosses become more
+ *              likely free, the cell it ends in (when the reading is a
+ *              hit) more likely occupied. Cells hold int8 log-odds with
+ *              saturating updates; 0 is unknown. A byte per cell rather
+ *              than a bit-packed grid: one or two bits cannot accumulate
+ *              evidence, so a single noisy reading would flip a cell, and
+ *              bytes are what the saturating vector adds take 16 or 32 at
+ *              a time. A tile is 4 KB where two bits would make it 1 KB.
+ *
+ *              Cells are stored in 64x64 tiles (4 KB) with the cells of a
+ *              tile in Morton (Z) order, so a short ray stays within one
+ *              or two tiles and a few cache lines in any direction. Tiles
+ *              come from a pool sized once at init and are only assigned
+ *              to areas a ray has reached: the whole 100 m x 100 m area at
+ *              2 cm costs a 12 KB tile directory plus the pool, and rays
+ *              into unassigned tiles once the pool is used up are counted
+ *              and skipped (cells_dropped). The default pool is 4 MB, a
+ *              41 m x 41 m area. Nothing is allocated while stepping.
+ *
+ *              The map is centered on the arena when its bounds are known
+ *              (rescue_map_center), else on the first pose it is updated
+ *              from, which covers a 100 m arena only from its middle.
+ *
+ *              All beams of a step are updated as one batch: they are
+ *              rasterized together (8 or 4 beams per vector with AVX2,
+ *              SSE2 or NEON) into a delta window of 4x4 tiles around the
+ *              robot, where a cell crossed by several beams gets one
+ *              update, and the blocks of the window that were written are
+ *              added to the map with saturating int8 vector adds.
+ *
+ *              Optionally the map logs every cell whose class (unknown,
+ *              free, occupied) an update changed, so consumers such as the
+ *              frontier explorer only look at what is new.
+ */
+
+#ifndef RESCUE_MAP_H
+#define RESCUE_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rescue_hal.h"
+
+// --- Geometry ---
+#define RESCUE_MAP_RESOLUTION 0.02   // meters per cell
+#define RESCUE_MAP_TILE_BITS 6       // 64x64 cells per tile
+#define RESCUE_MAP_TILE_SIZE (1 << RESCUE_MAP_TILE_BITS)
+#define RESCUE_MAP_TILE_CELLS (RESCUE_MAP_TILE_SIZE * RESCUE_MAP_TILE_SIZE)
+#define RESCUE_MAP_TILES 79          // Tiles per side: 79 * 64 * 2 cm = 101 m, centered on the arena or the start pose
+#define RESCUE_MAP_CELLS (RESCUE_MAP_TILES * RESCUE_MAP_TILE_SIZE)
+#define RESCUE_MAP_MAX_TILES 1024    // Default pool: 4 MB, a sixth of the map
+#define RESCUE_MAP_MAX_RANGE 1.0     // Sensor range (meters); readings at or beyond it hit nothing
+
+// --- Batched Updates ---
+#define RESCUE_MAP_MAX_BEAMS 64      // Beams per batch
+#define RESCUE_MAP_WINDOW_BITS 2     // Delta window of 4x4 tiles (64 KB); larger batches go beam by beam
+#define RESCUE_MAP_WINDOW_TILES (1 << RESCUE_MAP_WINDOW_BITS)
+
+// --- Log-Odds (int8 units, about 0.1 nats) ---
+#define RESCUE_MAP_L_HIT 9           // p(occupied | hit) ~ 0.7
+#define RESCUE_MAP_L_FREE -4         // p(occupied | ray passed) ~ 0.4
+#define RESCUE_MAP_L_MIN -64         // Clamp, so a cell can change its mind in a few readings
+#define RESCUE_MAP_L_MAX 96
+#define RESCUE_MAP_OCCUPIED 20       // Log-odds above this: occupied
+#define RESCUE_MAP_FREE -20          // Below this: free
+
+typedef enum {
+  RESCUE_MAP_UNKNOWN,                // Between the thresholds, or never seen
+  RESCUE_MAP_FREE_CELL,
+  RESCUE_MAP_OCCUPIED_CELL
+} RescueMapClass;
+
+static inline RescueMapClass rescue_map_class(int log_odds) {
+  return log_odds > RESCUE_MAP_OCCUPIED ? RESCUE_MAP_OCCUPIED_CELL
+       : log_odds < RESCUE_MAP_FREE ? RESCUE_MAP_FREE_CELL : RESCUE_MAP_UNKNOWN;
+}
+
+// A cell whose class changed, in map cell coordinates.
+typedef struct {
+  int32_t cx, cy;
+  int8_t before, after;              // Log-odds
+} RescueMapChange;
+
+typedef struct {
+  int8_t *pool;                      // max_tiles * RESCUE_MAP_TILE_CELLS
+  int max_tiles, used_tiles;
+  uint16_t tile[RESCUE_MAP_TILES * RESCUE_MAP_TILES]; // Pool index + 1 per tile, row-major; 0 = not assigned
+  bool anchored;                     // Origin set by rescue_map_center or the first update
+  double origin_x, origin_y;         // World position of the corner of cell (0, 0)
+  bool simd;                         // Use the vector kernels (default when compiled in)
+  // --- Batch Scratch ---
+  int8_t *window;                    // Per-batch update codes, RESCUE_MAP_WINDOW_TILES^2 tiles, zero between batches
+  // --- Change Log (NULL unless tracking) ---
+  RescueMapChange *changes;          // Appended by updates, emptied by the consumer (num_changes = 0)
+  int num_changes, max_changes;
+  unsigned long changes_dropped;     // Class changes lost because the log was full
+  // Statistics
+  unsigned long rays;
+  unsigned long cells_updated;       // Cell updates; a batch updates a cell once
+  unsigned long cells_dropped;       // In unassigned tiles after the pool ran out, or off the map
+} RescueMap;
+
+// One step's beams, from (x0, y0) to (x1, y1) in the world frame.
+typedef struct {
+  int count;
+  double x0[RESCUE_MAP_MAX_BEAMS], y0[RESCUE_MAP_MAX_BEAMS];
+  double x1[RESCUE_MAP_MAX_BEAMS], y1[RESCUE_MAP_MAX_BEAMS];
+  bool hit[RESCUE_MAP_MAX_BEAMS];    // The beam ends on an obstacle
+} RescueMapBeams;
+
+// Allocates the tile pool. Returns false if it cannot be allocated.
+bool rescue_map_init(RescueMap *m, int max_tiles);
+void rescue_map_free(RescueMap *m);
+
+// Starts logging class changes, up to capacity between two reads of the
+// log. Returns false if the log cannot be allocated.
+bool rescue_map_track_changes(RescueMap *m, int capacity);
+
+// Centers the map on (x, y), e.g. the middle of the arena, in the frame of
+// the poses it will be updated from. Call before the first update.
+void rescue_map_center(RescueMap *m, double x, double y);
+
+// Traces the three distance sensors from the robot pose (x, y, heading).
+void rescue_map_update(RescueMap *m, const double *pose, const RescueInputs *in);
+
+// Updates the map with a batch of beams (anchoring it on the first one if needed).
+void rescue_map_update_beams(RescueMap *m, const RescueMapBeams *b);
+
+// Walks one ray from (x0, y0) to (x1, y1) with Bresenham and updates it on
+// its own, marking the end cell occupied if hit.
+void rescue_map_trace(RescueMap *m, double x0, double y0, double x1, double y1, bool hit);
+
+// Name of the compiled-in vector kernel: "avx2", "sse2", "neon" or "scalar".
+const char *rescue_map_simd_name(void);
+
+// Log-odds of the cell containing (x, y); 0 if unknown or off the map.
+int rescue_map_get(const RescueMap *m, double x, double y);
+
+// Bytes allocated for the map: directory, pool, scratch and change log.
+unsigned long rescue_map_memory(const RescueMap *m);
+
+// --- Cell Addressing ---
+// Interleaves the 6 bits of a tile-local coordinate with zeros.
+static inline uint32_t rescue_map_spread(uint32_t v) {
+  v &= RESCUE_MAP_TILE_SIZE - 1;
+  v = (v | (v << 4)) & 0x0F0Fu;
+  v = (v | (v << 2)) & 0x3333u;
+  v = (v | (v << 1)) & 0x5555u;
+  return v;
+}
+
+// Morton index of cell (cx, cy) inside its tile.
+static inline uint32_t rescue_map_morton(int cx, int cy) {
+  return rescue_map_spread((uint32_t)cx) | (rescue_map_spread((uint32_t)cy) << 1);
+}
+
+// Cell storage, NULL if the tile has not been assigned or the cell is off the map.
+static inline const int8_t *rescue_map_cell(const RescueMap *m, int cx, int cy) {
+  if ((unsigned)cx >= RESCUE_MAP_CELLS || (unsigned)cy >= RESCUE_MAP_CELLS) return NULL;
+  int t = m->tile[(cy >> RESCUE_MAP_TILE_BITS) * RESCUE_MAP_TILES + (cx >> RESCUE_MAP_TILE_BITS)];
+  if (!t) return NULL;
+  return m->pool + (size_t)(t - 1) * RESCUE_MAP_TILE_CELLS + rescue_map_morton(cx, cy);
+}
+
+// Whether updates to cell (cx, cy) can be kept: it is on the map and its
+// tile is assigned or the pool still has one for it.
+static inline bool rescue_map_storable(const RescueMap *m, int cx, int cy) {
+  if ((unsigned)cx >= RESCUE_MAP_CELLS || (unsigned)cy >= RESCUE_MAP_CELLS) return false;
+  return m->used_tiles < m->max_tiles ||
+         m->tile[(cy >> RESCUE_MAP_TILE_BITS) * RESCUE_MAP_TILES + (cx >> RESCUE_MAP_TILE_BITS)];
+}
+
+#endif // RESCUE_MAP_H
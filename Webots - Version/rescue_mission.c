@@ -0,0 +1,171 @@
+/*
+ * Description: The rescue mission behavior tree (see rescue_mission.h).
+ */
+
+#include "rescue_mission.h"
+
+#include <math.h>
+
+// --- Leaves ---
+
+static RescueBtStatus survivor_glimpsed(void *ctx, int arg, bool resume) {
+  (void)arg;
+  (void)resume;
+  const RescueMission *m = ctx;
+  return m->glimpse_age < RESCUE_MISSION_GLIMPSE_MEMORY ? RESCUE_BT_SUCCESS : RESCUE_BT_FAILURE;
+}
+
+static RescueBtStatus approach(void *ctx, int arg, bool resume) {
+  (void)arg;
+  RescueMission *m = ctx;
+  if (!resume) {
+    m->approaches++;
+    m->approach_steps = 0;
+  }
+  if (++m->approach_steps > RESCUE_MISSION_APPROACH_STEPS) {
+    m->approaches_abandoned++;
+    m->abandoned_id = m->glimpse_id;
+    m->abandoned_has_pos = m->glimpse_has_pos;
+    m->abandoned[0] = m->glimpse[0];
+    m->abandoned[1] = m->glimpse[1];
+    m->glimpse_age = RESCUE_MISSION_GLIMPSE_MEMORY;
+    return RESCUE_BT_FAILURE;
+  }
+  m->mode = RESCUE_MISSION_GOTO;
+  m->target[0] = m->glimpse[0];
+  m->target[1] = m->glimpse[1];
+  return RESCUE_BT_RUNNING;
+}
+
+static RescueBtStatus search_over(void *ctx, int arg, bool resume) {
+  (void)arg;
+  (void)resume;
+  const RescueMission *m = ctx;
+  // The first selection runs on an empty map and finds no frontier either
+  bool explored = m->explore && m->explore->complete && m->explore->plans > 1;
+  bool over = explored || (m->duration > 0.0 && m->elapsed >= m->duration);
+  return over ? RESCUE_BT_SUCCESS : RESCUE_BT_FAILURE;
+}
+
+static RescueBtStatus go_to_base(void *ctx, int arg, bool resume) {
+  (void)arg;
+  RescueMission *m = ctx;
+  m->returns += !resume;
+  if (hypot(m->base[0] - m->pose[0], m->base[1] - m->pose[1]) < RESCUE_MISSION_HOME_RADIUS) return RESCUE_BT_SUCCESS;
+  m->mode = RESCUE_MISSION_GOTO;
+  m->target[0] = m->base[0];
+  m->target[1] = m->base[1];
+  return RESCUE_BT_RUNNING;
+}
+
+static RescueBtStatus dock(void *ctx, int arg, bool resume) {
+  (void)arg;
+  (void)resume;
+  RescueMission *m = ctx;
+  m->mode = RESCUE_MISSION_HOLD;
+  m->docked_steps++;
+  return RESCUE_BT_RUNNING;
+}
+
+static RescueBtStatus search(void *ctx, int arg, bool resume) {
+  (void)arg;
+  (void)resume;
+  RescueMission *m = ctx;
+  m->mode = RESCUE_MISSION_SEARCH;
+  return RESCUE_BT_RUNNING;
+}
+
+// --- Tree ---
+
+void rescue_mission_init(RescueMission *m, double duration, double slice_ms, bool use_clock) {
+  RescueBt *bt = &m->tree;
+  rescue_bt_init(bt, m, RESCUE_MISSION_TICK_CALLS, slice_ms, use_clock);
+  int root = rescue_bt_composite(bt, RESCUE_BT_SELECTOR, "mission");
+  int survivor = rescue_bt_add(bt, root, rescue_bt_composite(bt, RESCUE_BT_SEQUENCE, "approach survivor"));
+  rescue_bt_add(bt, survivor, rescue_bt_leaf(bt, RESCUE_BT_CONDITION, survivor_glimpsed, 0, "survivor glimpsed"));
+  rescue_bt_add(bt, survivor, rescue_bt_leaf(bt, RESCUE_BT_ACTION, approach, 0, "approach"));
+  int home = rescue_bt_add(bt, root, rescue_bt_composite(bt, RESCUE_BT_SEQUENCE, "return to base"));
+  rescue_bt_add(bt, home, rescue_bt_leaf(bt, RESCUE_BT_CONDITION, search_over, 0, "search over"));
+  rescue_bt_add(bt, home, rescue_bt_leaf(bt, RESCUE_BT_ACTION, go_to_base, 0, "go to base"));
+  rescue_bt_add(bt, home, rescue_bt_leaf(bt, RESCUE_BT_ACTION, dock, 0, "dock"));
+  rescue_bt_add(bt, root, rescue_bt_leaf(bt, RESCUE_BT_ACTION, search, 0, "search"));
+
+  m->duration = duration;
+  m->pose = NULL;
+  m->explore = NULL;
+  m->elapsed = 0.0;
+  m->mode = RESCUE_MISSION_SEARCH;
+  m->target[0] = m->target[1] = 0.0;
+  m->started = false;
+  m->start_time = 0.0;
+  m->base[0] = m->base[1] = 0.0;
+  m->glimpse_age = RESCUE_MISSION_GLIMPSE_MEMORY;
+  m->glimpse_id = -1;
+  m->glimpse_has_pos = false;
+  m->abandoned_id = -1;
+  m->abandoned_has_pos = false;
+  m->approach_steps = 0;
+  m->approaches = m->approaches_served = m->approaches_abandoned = 0;
+  m->returns = m->docked_steps = 0;
+}
+
+// The survivor given up on last, seen again.
+static bool abandoned(const RescueMission *m, int id, double x, double y) {
+  if (id >= 0 && m->abandoned_id >= 0) return id == m->abandoned_id;
+  return m->abandoned_has_pos && hypot(x - m->abandoned[0], y - m->abandoned[1]) < RESCUE_SURVIVOR_MERGE_RADIUS;
+}
+
+void rescue_mission_update(RescueMission *m, const RescueInputs *in, const double *map_pose,
+                           const double *registry_pose, const RescueSurvivorRegistry *survivors,
+                           const RescueExplorer *explore) {
+  if (!m->started) {
+    m->started = true;
+    m->start_time = in->time;
+    m->base[0] = map_pose[0];
+    m->base[1] = map_pose[1];
+  }
+  m->pose = map_pose;
+  m->explore = explore;
+  m->elapsed = in->time - m->start_time;
+
+  // --- Sightings: the glimpse served since, or the closest new one ---
+  if (m->glimpse_age < RESCUE_MISSION_GLIMPSE_MEMORY &&
+      rescue_survivors_served(survivors, m->glimpse_id, m->glimpse_has_pos, m->glimpse_registry[0],
+                              m->glimpse_registry[1])) {
+    m->approaches_served += m->tree.active >= 0 && m->tree.nodes[m->tree.active].fn == approach;
+    m->glimpse_age = RESCUE_MISSION_GLIMPSE_MEMORY;
+  }
+  int best = -1;
+  double best_range = RESCUE_MISSION_GLIMPSE_MAX, x = 0.0, y = 0.0, rx = 0.0, ry = 0.0;
+  bool has_pos = false;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    double range = in->ds[i];
+    if (!in->survivor_seen[i] || range < RESCUE_MISSION_GLIMPSE_MIN || range >= best_range) continue;
+    double sx, sy, sx_registry = 0.0, sy_registry = 0.0;
+    rescue_survivor_estimate(map_pose, range, i, &sx, &sy);
+    bool known = rescue_survivor_estimate(registry_pose, range, i, &sx_registry, &sy_registry);
+    if (rescue_survivors_served(survivors, in->survivor_id[i], known, sx_registry, sy_registry) ||
+        abandoned(m, in->survivor_id[i], sx, sy))
+      continue;
+    best = i;
+    best_range = range;
+    x = sx;
+    y = sy;
+    rx = sx_registry;
+    ry = sy_registry;
+    has_pos = known;
+  }
+  if (best >= 0) {
+    m->glimpse_age = 0;
+    m->glimpse_id = in->survivor_id[best];
+    m->glimpse_has_pos = has_pos;
+    m->glimpse[0] = x;
+    m->glimpse[1] = y;
+    m->glimpse_registry[0] = rx;
+    m->glimpse_registry[1] = ry;
+  } else if (m->glimpse_age < RESCUE_MISSION_GLIMPSE_MEMORY) {
+    m->glimpse_age++;
+  }
+
+  rescue_bt_tick(&m->tree);
+}
@@ -0,0 +1,95 @@
+/*
+ * Description: The rescue mission as a behavior tree (rescue_bt.h) above
+ *              the reactive state machine. The state machine still stops
+ *              for tilt, deploys aid and turns away from obstacles; the
+ *              mission decides where the robot is heading meanwhile:
+ *
+ *              mission (selector)
+ *              +- approach survivor (sequence)
+ *              |  +- survivor glimpsed?  recognized beyond
+ *              |  |                      RESCUE_MISSION_GLIMPSE_MIN, not
+ *              |  |                      served yet, seen in the last
+ *              |  |                      RESCUE_MISSION_GLIMPSE_MEMORY steps
+ *              |  +- approach            head for it until the policy takes
+ *              |                         over; give up after
+ *              |                         RESCUE_MISSION_APPROACH_STEPS
+ *              +- return to base (sequence)
+ *              |  +- search over?        exploration complete, or the
+ *              |  |                      mission time is up
+ *              |  +- go to base          head back to the starting point
+ *              |  +- dock                stop there
+ *              +- search                 explore (or straight ahead)
+ *
+ *              A glimpse preempts the search or the way home, which then
+ *              carries on. A robot with a battery would add a "battery
+ *              low?" sequence ahead of the search that returns to base and
+ *              recharges.
+ */
+
+#ifndef RESCUE_MISSION_H
+#define RESCUE_MISSION_H
+
+#include <stdbool.h>
+
+#include "rescue_bt.h"
+#include "rescue_explore.h"
+#include "rescue_hal.h"
+#include "rescue_survivors.h"
+
+#define RESCUE_MISSION_GLIMPSE_MIN 0.4       // SURVIVOR_DETECTION_RANGE: closer survivors are the policy's (meters)
+#define RESCUE_MISSION_GLIMPSE_MAX 1.0       // Survivors recognized up to this far are approached (meters)
+#define RESCUE_MISSION_GLIMPSE_MEMORY 32     // Steps (2 s) a glimpse is kept after the survivor goes out of view
+#define RESCUE_MISSION_APPROACH_STEPS 160    // An approach is given up after this many steps (10 s)
+#define RESCUE_MISSION_HOME_RADIUS 0.3       // At base within this of the starting point (meters)
+#define RESCUE_MISSION_TICK_CALLS 8          // Leaf calls per tick (the tree has six leaves)
+
+typedef enum {
+  RESCUE_MISSION_SEARCH,                     // Explore, or search straight ahead without a map
+  RESCUE_MISSION_GOTO,                       // Head for target
+  RESCUE_MISSION_HOLD                        // Stay put
+} RescueMissionMode;
+
+typedef struct {
+  RescueBt tree;                             // Its leaves get the mission as ctx: do not move the mission
+  double duration;                           // Return to base after this long (s), 0: once exploration is complete
+  // --- This step (rescue_mission_update) ---
+  const double *pose;                        // Map frame
+  const RescueExplorer *explore;
+  double elapsed;                            // Seconds since the first update
+  // --- Decision ---
+  RescueMissionMode mode;
+  double target[2];                          // RESCUE_MISSION_GOTO: where to head, map frame
+  // --- Memory of the leaves ---
+  bool started;
+  double start_time;
+  double base[2];                            // Starting point, map frame
+  int glimpse_age;                           // Steps since the glimpsed survivor was last seen
+  int glimpse_id;                            // Its identity, -1 if unknown
+  bool glimpse_has_pos;
+  double glimpse[2];                         // Its estimated position, map frame
+  double glimpse_registry[2];                // ... and in the survivor registry's frame (if glimpse_has_pos)
+  int abandoned_id;                          // Last survivor given up on, not approached again
+  bool abandoned_has_pos;
+  double abandoned[2];                       // Its position, map frame
+  int approach_steps;
+  // Statistics
+  unsigned long approaches;                  // Approaches started
+  unsigned long approaches_served;           // ... that ended with the survivor served
+  unsigned long approaches_abandoned;
+  unsigned long returns;                     // Ways home started
+  unsigned long docked_steps;
+} RescueMission;
+
+// Builds the tree; ticks are limited to RESCUE_MISSION_TICK_CALLS leaf
+// calls and, if use_clock, slice_ms. duration: see RescueMission.
+void rescue_mission_init(RescueMission *m, double duration, double slice_ms, bool use_clock);
+
+// Takes in this step's sightings and ticks the tree; mode and target hold
+// the decision. map_pose: the robot in the map frame; registry_pose: in the
+// survivor registry's frame (NULL if unknown, survivors are then told apart
+// by identity only); explore: NULL without a map.
+void rescue_mission_update(RescueMission *m, const RescueInputs *in, const double *map_pose,
+                           const double *registry_pose, const RescueSurvivorRegistry *survivors,
+                           const RescueExplorer *explore);
+
+#endif // RESCUE_MISSION_H
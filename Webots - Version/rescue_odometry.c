@@ -0,0 +1,100 @@
+/*
+ * Description: Wheel odometry with covariance propagation
+ *              (see rescue_odometry.h).
+ */
+
+#include "rescue_odometry.h"
+
+#include <math.h>
+
+_Static_assert(sizeof(RescueTelemetry) == 88, "telemetry packet layout changed");
+
+void rescue_odometry_init(RescueOdometry *o) {
+  memset(o, 0, sizeof(*o));
+  o->source = RESCUE_ODOM_NONE;
+}
+
+static double clamp_command(double w) {
+  if (w > RESCUE_MAX_WHEEL_SPEED) return RESCUE_MAX_WHEEL_SPEED;
+  if (w < -RESCUE_MAX_WHEEL_SPEED) return -RESCUE_MAX_WHEEL_SPEED;
+  return w;
+}
+
+// Midpoint update for wheel travels dl, dr (meters) with variance k|d| each:
+//   P = Fx P Fx' + Fu Q Fu'
+static void integrate(RescueOdometry *o, double dl, double dr, double k) {
+  const double b = RESCUE_AXLE_LENGTH;
+  double ds = 0.5 * (dl + dr);
+  double dth = (dr - dl) / b;
+  double mid = o->pose[2] + 0.5 * dth;
+  double c = cos(mid), s = sin(mid);
+
+  // Jacobian w.r.t. the pose (only the heading column is not identity)
+  double fx02 = -ds * s, fx12 = ds * c;
+  // Jacobian w.r.t. (dr, dl)
+  double h = ds / (2.0 * b);
+  double fu[3][2] = {{0.5 * c - h * s, 0.5 * c + h * s},
+                     {0.5 * s + h * c, 0.5 * s - h * c},
+                     {1.0 / b, -1.0 / b}};
+  double qr = k * fabs(dr), ql = k * fabs(dl);
+
+  // A = Fx P
+  double a[3][3];
+  for (int j = 0; j < 3; ++j) {
+    a[0][j] = o->cov[0][j] + fx02 * o->cov[2][j];
+    a[1][j] = o->cov[1][j] + fx12 * o->cov[2][j];
+    a[2][j] = o->cov[2][j];
+  }
+  // P = A Fx' + Fu Q Fu'
+  for (int i = 0; i < 3; ++i) {
+    double pi0 = a[i][0] + a[i][2] * fx02;
+    double pi1 = a[i][1] + a[i][2] * fx12;
+    double pi2 = a[i][2];
+    o->cov[i][0] = pi0 + fu[i][0] * qr * fu[0][0] + fu[i][1] * ql * fu[0][1];
+    o->cov[i][1] = pi1 + fu[i][0] * qr * fu[1][0] + fu[i][1] * ql * fu[1][1];
+    o->cov[i][2] = pi2 + fu[i][0] * qr * fu[2][0] + fu[i][1] * ql * fu[2][1];
+  }
+
+  o->pose[0] += ds * c;
+  o->pose[1] += ds * s;
+  o->pose[2] = atan2(sin(o->pose[2] + dth), cos(o->pose[2] + dth));
+  o->distance += fabs(ds);
+}
+
+void rescue_odometry_update(RescueOdometry *o, const RescueInputs *in, double dt_default) {
+  if (!o->initialized) {
+    if (in->has_pose) memcpy(o->pose, in->pose, sizeof(o->pose)); // Share the frame of the reported pose
+    o->initialized = true;
+  } else if (in->has_wheels && o->has_wheels) {
+    double dl = (in->wheel[0] - o->last_wheel[0]) * RESCUE_WHEEL_RADIUS;
+    double dr = (in->wheel[1] - o->last_wheel[1]) * RESCUE_WHEEL_RADIUS;
+    integrate(o, dl, dr, RESCUE_ODOM_K_ENCODER);
+    o->source = RESCUE_ODOM_ENCODERS;
+  } else {
+    double dt = in->time > o->last_time ? in->time - o->last_time : dt_default;
+    double dl = clamp_command(o->last_command[0]) * RESCUE_WHEEL_RADIUS * dt;
+    double dr = clamp_command(o->last_command[1]) * RESCUE_WHEEL_RADIUS * dt;
+    integrate(o, dl, dr, RESCUE_ODOM_K_COMMAND);
+    o->source = RESCUE_ODOM_COMMANDS;
+  }
+
+  o->last_time = in->time;
+  o->has_wheels = in->has_wheels;
+  o->last_wheel[0] = in->wheel[0];
+  o->last_wheel[1] = in->wheel[1];
+}
+
+void rescue_telemetry_pack(RescueTelemetry *t, const RescueOdometry *o, double time, uint32_t seq) {
+  memcpy(t->tag, RESCUE_TELEMETRY_TAG, sizeof(t->tag));
+  t->seq = seq;
+  t->time = time;
+  t->x = o->pose[0];
+  t->y = o->pose[1];
+  t->theta = o->pose[2];
+  t->cov_xx = o->cov[0][0];
+  t->cov_xy = o->cov[0][1];
+  t->cov_xt = o->cov[0][2];
+  t->cov_yy = o->cov[1][1];
+  t->cov_yt = o->cov[1][2];
+  t->cov_tt = o->cov[2][2];
+}
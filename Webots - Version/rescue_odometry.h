@@ -0,0 +1,88 @@
+/*
+ * Description: Wheel odometry for the BoeBot. Integrates the wheel position
+ *              sensors (or, without them, the commanded wheel velocities)
+ *              into a 2D pose every control step and propagates its 3x3
+ *              covariance with the usual differential-drive error model:
+ *              each wheel's travel gets a variance proportional to its
+ *              length, pushed through the Jacobians of the midpoint motion
+ *              update. Fixed cost per step, no allocation.
+ *
+ *              The pose is also packed into a small binary telemetry packet
+ *              that the controller sends through the emitter, so the
+ *              supervisor can compare it with the ground truth.
+ */
+
+#ifndef RESCUE_ODOMETRY_H
+#define RESCUE_ODOMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "rescue_hal.h"
+
+// --- BoeBot Geometry ---
+#define RESCUE_WHEEL_RADIUS 0.0335   // meters
+#define RESCUE_AXLE_LENGTH 0.104     // meters between the wheels
+#define RESCUE_MAX_WHEEL_SPEED 6.28  // rad/s, motor maxVelocity; commands above it are clipped by the motor
+
+// --- Error Model (variance per meter of wheel travel, m^2/m) ---
+#define RESCUE_ODOM_K_ENCODER 1e-4   // ~1 cm per meter with encoders
+#define RESCUE_ODOM_K_COMMAND 2.5e-3 // ~5 cm per meter dead-reckoning commands (slip, acceleration)
+
+typedef enum {
+  RESCUE_ODOM_NONE,                  // Not updated yet
+  RESCUE_ODOM_ENCODERS,
+  RESCUE_ODOM_COMMANDS
+} RescueOdometrySource;
+
+typedef struct {
+  double pose[3];                    // x, y (meters), heading (rad) in the odometry frame
+  double cov[3][3];                  // Pose covariance
+  double distance;                   // Path length integrated so far (meters)
+  RescueOdometrySource source;       // What the last update integrated
+  // --- Previous Step ---
+  bool initialized;
+  bool has_wheels;
+  double last_time;
+  double last_wheel[2];              // Encoder angles (rad)
+  double last_command[2];            // Wheel velocities commanded last step (rad/s)
+} RescueOdometry;
+
+// Starts at the origin with zero covariance. The first update snaps to the
+// input pose instead when the backend reports one.
+void rescue_odometry_init(RescueOdometry *o);
+
+// Integrates the motion since the previous step. dt_default (seconds) is
+// used when the inputs carry no usable time.
+void rescue_odometry_update(RescueOdometry *o, const RescueInputs *in, double dt_default);
+
+// Remembers the wheel velocities just commanded, for the fallback.
+static inline void rescue_odometry_command(RescueOdometry *o, double left_speed, double right_speed) {
+  o->last_command[0] = left_speed;
+  o->last_command[1] = right_speed;
+}
+
+// --- Telemetry Packet ---
+// Little-endian, no padding: struct.unpack('<4sI10d') in Python.
+#define RESCUE_TELEMETRY_TAG "ODOM"
+#define RESCUE_TELEMETRY_PERIOD 8    // Control steps between packets
+
+typedef struct {
+  char tag[4];                       // RESCUE_TELEMETRY_TAG, not NUL-terminated
+  uint32_t seq;
+  double time;
+  double x, y, theta;
+  double cov_xx, cov_xy, cov_xt, cov_yy, cov_yt, cov_tt;
+} RescueTelemetry;                   // 88 bytes
+
+void rescue_telemetry_pack(RescueTelemetry *t, const RescueOdometry *o, double time, uint32_t seq);
+
+// Returns true and fills *t if the emitter packet is a telemetry packet.
+static inline bool rescue_telemetry_decode(const void *data, int size, RescueTelemetry *t) {
+  if (size != (int)sizeof(RescueTelemetry) || memcmp(data, RESCUE_TELEMETRY_TAG, 4) != 0) return false;
+  memcpy(t, data, sizeof(*t));
+  return true;
+}
+
+#endif // RESCUE_ODOMETRY_H
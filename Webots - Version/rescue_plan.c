@@ -0,0 +1,451 @@
+/*
+ * Description: Incremental grid path planner, D* Lite (see rescue_plan.h).
+ */
+
+#include "rescue_plan.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "rescue_profile.h"
+
+#define INF RESCUE_PLAN_INFINITY
+#define INF_KEY (((uint64_t)INF << 32) | INF)
+#define INCONS 0x80000000u // RescuePlanNode.closed: also in p->incons
+
+bool rescue_plan_init(RescuePlanner *p, int width, int height, int max_nodes, double slice_ms) {
+  memset(p, 0, sizeof(*p));
+  p->width = width;
+  p->height = height;
+  p->max_nodes = max_nodes;
+  p->cost = malloc((size_t)width * height);
+  p->node_of = malloc((size_t)width * height * sizeof(*p->node_of));
+  p->pool = malloc((size_t)max_nodes * sizeof(*p->pool));
+  p->heap = malloc((size_t)max_nodes * sizeof(*p->heap));
+  p->incons = malloc((size_t)max_nodes * sizeof(*p->incons));
+  if (!p->cost || !p->node_of || !p->pool || !p->heap || !p->incons) {
+    rescue_plan_free(p);
+    return false;
+  }
+  memset(p->cost, 1, (size_t)width * height);
+  memset(p->node_of, 0xFF, (size_t)width * height * sizeof(*p->node_of));
+  p->goal = p->start = p->last = -1;
+  p->status = RESCUE_PLAN_IDLE;
+  rescue_plan_set_slice(p, slice_ms, true);
+  return true;
+}
+
+void rescue_plan_free(RescuePlanner *p) {
+  free(p->cost);
+  free(p->node_of);
+  free(p->pool);
+  free(p->heap);
+  free(p->incons);
+  p->cost = NULL;
+  p->node_of = NULL;
+  p->pool = NULL;
+  p->heap = NULL;
+  p->incons = NULL;
+}
+
+void rescue_plan_set_slice(RescuePlanner *p, double slice_ms, bool use_clock) {
+  p->max_expansions = (int)(slice_ms * RESCUE_PLAN_EXPANSIONS_PER_MS);
+  if (p->max_expansions < 1) p->max_expansions = 1;
+  p->slice_ns = use_clock ? (uint64_t)(slice_ms * 1e6) : 0;
+}
+
+unsigned long rescue_plan_memory(const RescuePlanner *p) {
+  return (unsigned long)sizeof(*p) + (unsigned long)p->width * p->height * (1 + sizeof(*p->node_of)) +
+         (unsigned long)p->max_nodes * (sizeof(*p->pool) + sizeof(*p->heap) + sizeof(*p->incons));
+}
+
+// --- Node Pool ---
+
+static RescuePlanNode *find(const RescuePlanner *p, int cell) {
+  int k = p->node_of[cell];
+  return (unsigned)k < (unsigned)p->used && p->pool[k].cell == cell ? &p->pool[k] : NULL;
+}
+
+static RescuePlanNode *node(RescuePlanner *p, int cell) { // Found or handed out; NULL once the pool is used up
+  RescuePlanNode *n = find(p, cell);
+  if (n) return n;
+  if (p->used >= p->max_nodes) {
+    p->status = RESCUE_PLAN_OUT_OF_NODES;
+    return NULL;
+  }
+  p->node_of[cell] = p->used;
+  n = &p->pool[p->used++];
+  n->cell = cell;
+  n->g = n->rhs = INF;
+  n->heap_index = -1;
+  n->closed = 0;
+  return n;
+}
+
+static uint32_t g_of(const RescuePlanner *p, int cell) {
+  const RescuePlanNode *n = find(p, cell);
+  return n ? n->g : INF;
+}
+
+// --- Indexed Binary Heap ---
+
+static void heap_place(RescuePlanner *p, int i, RescuePlanHeapEntry e) {
+  p->heap[i] = e;
+  p->pool[e.node].heap_index = i;
+}
+
+static void sift_up(RescuePlanner *p, int i) {
+  RescuePlanHeapEntry e = p->heap[i];
+  while (i > 0) {
+    int parent = (i - 1) >> 1;
+    if (p->heap[parent].key <= e.key) break;
+    heap_place(p, i, p->heap[parent]);
+    i = parent;
+  }
+  heap_place(p, i, e);
+}
+
+static void sift_down(RescuePlanner *p, int i) {
+  RescuePlanHeapEntry e = p->heap[i];
+  for (;;) {
+    int child = 2 * i + 1;
+    if (child >= p->heap_size) break;
+    if (child + 1 < p->heap_size && p->heap[child + 1].key < p->heap[child].key) child++;
+    if (e.key <= p->heap[child].key) break;
+    heap_place(p, i, p->heap[child]);
+    i = child;
+  }
+  heap_place(p, i, e);
+}
+
+static void heap_set(RescuePlanner *p, RescuePlanNode *n, uint64_t key) { // Insert or change the key
+  int i = n->heap_index;
+  if (i < 0) {
+    i = p->heap_size++;
+    heap_place(p, i, (RescuePlanHeapEntry){key, (int32_t)(n - p->pool)});
+    sift_up(p, i);
+  } else if (key < p->heap[i].key) {
+    p->heap[i].key = key;
+    sift_up(p, i);
+  } else {
+    p->heap[i].key = key;
+    sift_down(p, i);
+  }
+}
+
+static void heap_remove(RescuePlanner *p, RescuePlanNode *n) {
+  int i = n->heap_index;
+  n->heap_index = -1;
+  RescuePlanHeapEntry last = p->heap[--p->heap_size];
+  if (i == p->heap_size) return;
+  heap_place(p, i, last);
+  if (i > 0 && last.key < p->heap[(i - 1) >> 1].key) sift_up(p, i);
+  else sift_down(p, i);
+}
+
+// --- D* Lite ---
+
+static uint32_t add(uint32_t a, uint32_t b) {
+  uint32_t s = a + b;
+  return a >= INF || b >= INF || s >= INF ? INF : s;
+}
+
+static uint32_t edge_cost(const RescuePlanner *p, int to) {
+  return p->cost[to] == RESCUE_PLAN_BLOCKED ? INF : p->cost[to];
+}
+
+static uint32_t heuristic(const RescuePlanner *p, int a, int b) { // Manhattan, every step costs at least 1
+  int dx = a % p->width - b % p->width, dy = a / p->width - b / p->width;
+  return (uint32_t)((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy));
+}
+
+static uint64_t key_of(const RescuePlanner *p, const RescuePlanNode *n) {
+  uint32_t k2 = n->g < n->rhs ? n->g : n->rhs;
+  if (k2 >= INF) return INF_KEY;
+  return ((uint64_t)add(add(k2, heuristic(p, p->start, n->cell)), p->km) << 32) | k2;
+}
+
+// The four neighbors of cell on the grid; returns how many.
+static int neighbors(const RescuePlanner *p, int cell, int out[4]) {
+  int x = cell % p->width, y = cell / p->width, n = 0;
+  if (x > 0) out[n++] = cell - 1;
+  if (x < p->width - 1) out[n++] = cell + 1;
+  if (y > 0) out[n++] = cell - p->width;
+  if (y < p->height - 1) out[n++] = cell + p->width;
+  return n;
+}
+
+static uint32_t best_successor(const RescuePlanner *p, int cell) {
+  int nb[4];
+  uint32_t best = INF;
+  for (int k = neighbors(p, cell, nb) - 1; k >= 0; --k) {
+    uint32_t v = add(edge_cost(p, nb[k]), g_of(p, nb[k]));
+    if (v < best) best = v;
+  }
+  return best;
+}
+
+static void update_vertex(RescuePlanner *p, RescuePlanNode *n) {
+  if (n->g != n->rhs) heap_set(p, n, key_of(p, n));
+  else if (n->heap_index >= 0) heap_remove(p, n);
+}
+
+void rescue_plan_set_cost(RescuePlanner *p, int cell, uint8_t cost) {
+  uint8_t old = p->cost[cell];
+  if (old == cost) return;
+  p->cost[cell] = cost;
+  p->cost_changes++;
+  if (p->anytime) { p->restart = p->goal >= 0; return; }
+  if (p->goal < 0 || p->status == RESCUE_PLAN_OUT_OF_NODES) return;
+  uint32_t c_old = old == RESCUE_PLAN_BLOCKED ? INF : old, c_new = edge_cost(p, cell);
+  uint32_t g = g_of(p, cell);
+  int nb[4];
+  for (int k = neighbors(p, cell, nb) - 1; k >= 0; --k) { // Edges into cell changed: repair their tails
+    RescuePlanNode *u = find(p, nb[k]);
+    if (!u || u->cell == p->goal) continue; // Not reached yet: nothing to repair
+    if (c_new < c_old) {
+      uint32_t v = add(c_new, g);
+      if (v < u->rhs) u->rhs = v;
+    } else if (u->rhs == add(c_old, g)) {
+      u->rhs = best_successor(p, u->cell);
+    }
+    update_vertex(p, u);
+  }
+}
+
+void rescue_plan_set_goal(RescuePlanner *p, int goal) {
+  if (goal == p->goal) return;
+  p->goal = goal;
+  p->used = 0;
+  p->heap_size = 0;
+  p->km = 0;
+  p->start = p->last = -1;
+  p->status = goal < 0 ? RESCUE_PLAN_IDLE : RESCUE_PLAN_PARTIAL;
+  p->bound = 0;
+  p->restart = false;
+  if (goal >= 0) p->searches++;
+}
+
+void rescue_plan_set_anytime(RescuePlanner *p, double epsilon0) {
+  int goal = p->goal;
+  p->anytime = epsilon0 > 0.0;
+  p->epsilon0 = p->anytime ? (uint32_t)(epsilon0 * RESCUE_PLAN_EPSILON_ONE + 0.5) : 0;
+  if (p->anytime && p->epsilon0 < RESCUE_PLAN_EPSILON_ONE) p->epsilon0 = RESCUE_PLAN_EPSILON_ONE;
+  rescue_plan_set_goal(p, -1);
+  rescue_plan_set_goal(p, goal);
+}
+
+// Whether this step's budget is used up after `expansions`; counts the stop.
+static bool out_of_budget(RescuePlanner *p, int expansions, uint64_t t0) {
+  if (expansions >= p->max_expansions) {
+    p->budget_stops++;
+    return true;
+  }
+  if (p->slice_ns && expansions % RESCUE_PLAN_CLOCK_EVERY == RESCUE_PLAN_CLOCK_EVERY - 1 &&
+      rescue_profile_now() - t0 >= p->slice_ns) {
+    p->deadline_stops++;
+    return true;
+  }
+  return false;
+}
+
+// Repairs until the robot's cell is consistent or the budget is used up.
+static RescuePlanStatus compute(RescuePlanner *p, uint64_t t0) {
+  int expansions = 0;
+  RescuePlanStatus status = RESCUE_PLAN_PARTIAL;
+  for (;;) {
+    const RescuePlanNode *s = find(p, p->start);
+    uint64_t start_key = s ? key_of(p, s) : INF_KEY;
+    bool start_raised = s && s->rhs > s->g;
+    if (p->heap_size == 0 || (p->heap[0].key >= start_key && !start_raised)) {
+      status = s && s->rhs < INF ? RESCUE_PLAN_FOUND : RESCUE_PLAN_NO_PATH;
+      break;
+    }
+    if (out_of_budget(p, expansions, t0)) break;
+    expansions++;
+
+    RescuePlanNode *u = &p->pool[p->heap[0].node];
+    uint64_t k_old = p->heap[0].key, k_new = key_of(p, u);
+    int nb[4], count = neighbors(p, u->cell, nb);
+    if (k_old < k_new) { // Queued before the robot moved: requeue with the current key
+      heap_set(p, u, k_new);
+    } else if (u->g > u->rhs) { // Overconsistent: settle it and relax the cells that can step into it
+      u->g = u->rhs;
+      heap_remove(p, u);
+      uint32_t via = add(edge_cost(p, u->cell), u->g);
+      for (int k = 0; k < count; ++k) {
+        RescuePlanNode *v = node(p, nb[k]);
+        if (!v) {
+          p->expansions += (unsigned long)expansions;
+          return RESCUE_PLAN_OUT_OF_NODES;
+        }
+        if (v->cell != p->goal && via < v->rhs) v->rhs = via;
+        update_vertex(p, v);
+      }
+    } else { // Underconsistent: raise it and recompute the cells that went through it
+      uint32_t via_old = add(edge_cost(p, u->cell), u->g);
+      u->g = INF;
+      for (int k = 0; k < count; ++k) {
+        RescuePlanNode *v = find(p, nb[k]);
+        if (!v) continue;
+        if (v->cell != p->goal && v->rhs == via_old) v->rhs = best_successor(p, v->cell);
+        update_vertex(p, v);
+      }
+      if (u->cell != p->goal) u->rhs = best_successor(p, u->cell);
+      update_vertex(p, u);
+    }
+  }
+  p->expansions += (unsigned long)expansions;
+  if (expansions > p->max_step_expansions) p->max_step_expansions = expansions;
+  return status;
+}
+
+// --- ARA* ---
+
+// f = g + epsilon * h in sixteenths, ties to the larger g (nearer the robot).
+static uint64_t anytime_key(const RescuePlanner *p, const RescuePlanNode *n) {
+  uint64_t f = (uint64_t)n->g * RESCUE_PLAN_EPSILON_ONE + (uint64_t)p->epsilon * heuristic(p, p->start, n->cell);
+  if (f > 0xFFFFFFFFu) f = 0xFFFFFFFFu;
+  return (f << 32) | (INF - n->g);
+}
+
+// Recomputes every open key after epsilon or the robot's cell changed.
+static void anytime_rekey(RescuePlanner *p) {
+  for (int i = 0; i < p->heap_size; ++i) p->heap[i].key = anytime_key(p, &p->pool[p->heap[i].node]);
+  for (int i = p->heap_size / 2 - 1; i >= 0; --i) sift_down(p, i);
+}
+
+static void anytime_restart(RescuePlanner *p) {
+  p->used = 0;
+  p->heap_size = 0;
+  p->num_incons = 0;
+  p->epsilon = p->epsilon0;
+  p->iteration = 1;
+  p->bound = 0;
+  p->restart = false;
+  RescuePlanNode *g = node(p, p->goal);
+  g->g = 0;
+  heap_set(p, g, anytime_key(p, g));
+}
+
+// Expands until the path from the robot's cell is within epsilon of the best
+// one, then lowers epsilon and reopens the improved nodes, until epsilon is
+// 1 and the path optimal or the budget is used up.
+static RescuePlanStatus anytime_compute(RescuePlanner *p, uint64_t t0) {
+  int expansions = 0;
+  RescuePlanStatus status = p->bound && g_of(p, p->start) < INF ? RESCUE_PLAN_FOUND : RESCUE_PLAN_PARTIAL;
+  for (;;) {
+    const RescuePlanNode *s = find(p, p->start);
+    uint64_t start_f = s && s->g < INF ? (uint64_t)s->g * RESCUE_PLAN_EPSILON_ONE : UINT64_MAX;
+    if (p->heap_size == 0 || (p->heap[0].key >> 32) >= start_f) { // This epsilon is done
+      if (start_f == UINT64_MAX) {
+        status = RESCUE_PLAN_NO_PATH;
+        break;
+      }
+      if (!p->bound || p->epsilon < p->bound) {
+        p->bound = p->epsilon;
+        p->solutions++;
+      }
+      status = RESCUE_PLAN_FOUND;
+      if (p->epsilon <= RESCUE_PLAN_EPSILON_ONE) break;
+      p->epsilon = p->epsilon > RESCUE_PLAN_EPSILON_ONE + RESCUE_PLAN_EPSILON_STEP
+                   ? p->epsilon - RESCUE_PLAN_EPSILON_STEP : RESCUE_PLAN_EPSILON_ONE;
+      p->iteration++;
+      for (int k = 0; k < p->num_incons; ++k) {
+        RescuePlanNode *n = &p->pool[p->incons[k]];
+        n->closed &= ~INCONS;
+        heap_set(p, n, 0); // Keyed below
+      }
+      p->num_incons = 0;
+      anytime_rekey(p);
+      continue;
+    }
+    if (out_of_budget(p, expansions, t0)) break;
+    expansions++;
+
+    RescuePlanNode *u = &p->pool[p->heap[0].node];
+    heap_remove(p, u);
+    u->rhs = u->g; // v: g when last expanded
+    u->closed = p->iteration;
+    if (p->cost[u->cell] == RESCUE_PLAN_BLOCKED) continue; // Nothing steps through it
+    uint32_t via = add(p->cost[u->cell], u->g);
+    int nb[4], count = neighbors(p, u->cell, nb);
+    for (int k = 0; k < count; ++k) {
+      RescuePlanNode *v = node(p, nb[k]);
+      if (!v) {
+        p->expansions += (unsigned long)expansions;
+        return RESCUE_PLAN_OUT_OF_NODES;
+      }
+      if (via >= v->g) continue;
+      v->g = via;
+      if ((v->closed & ~INCONS) != p->iteration) {
+        heap_set(p, v, anytime_key(p, v));
+      } else if (!(v->closed & INCONS)) { // Expanded with this epsilon already: next one
+        v->closed |= INCONS;
+        p->incons[p->num_incons++] = (int32_t)(v - p->pool);
+      }
+    }
+  }
+  p->expansions += (unsigned long)expansions;
+  if (expansions > p->max_step_expansions) p->max_step_expansions = expansions;
+  return status;
+}
+
+static void anytime_step(RescuePlanner *p, int start, uint64_t t0) {
+  if (p->start < 0 || p->restart) {
+    if (p->start >= 0) p->restarts++;
+    p->start = p->last = start;
+    anytime_restart(p);
+  } else if (start != p->start) {
+    p->start = p->last = start;
+    anytime_rekey(p);
+  }
+  p->status = anytime_compute(p, t0);
+}
+
+RescuePlanStatus rescue_plan_step(RescuePlanner *p, int start) {
+  if (p->goal < 0) return p->status = RESCUE_PLAN_IDLE;
+  if (p->status == RESCUE_PLAN_OUT_OF_NODES || start < 0 || start >= p->width * p->height) return p->status;
+  uint64_t t0 = rescue_profile_now();
+  p->steps++;
+  if (p->anytime) {
+    anytime_step(p, start, t0);
+  } else if (p->start < 0) { // First step toward this goal: the search starts at it
+    p->start = p->last = start;
+    RescuePlanNode *g = node(p, p->goal);
+    g->rhs = 0;
+    heap_set(p, g, key_of(p, g));
+  } else if (start != p->start) {
+    p->km = add(p->km, heuristic(p, p->last, start));
+    p->start = p->last = start;
+  }
+  if (!p->anytime) {
+    p->status = compute(p, t0);
+    p->bound = p->status == RESCUE_PLAN_FOUND ? RESCUE_PLAN_EPSILON_ONE : 0;
+  }
+  uint64_t elapsed = rescue_profile_now() - t0;
+  if (elapsed > p->max_step_ns) p->max_step_ns = elapsed;
+  return p->status;
+}
+
+int rescue_plan_next(const RescuePlanner *p, int cell) {
+  int nb[4], best = -1;
+  uint32_t best_cost = INF;
+  for (int k = neighbors(p, cell, nb) - 1; k >= 0; --k) {
+    uint32_t v = add(edge_cost(p, nb[k]), g_of(p, nb[k]));
+    if (v < best_cost) {
+      best_cost = v;
+      best = nb[k];
+    }
+  }
+  return best;
+}
+
+uint32_t rescue_plan_cost_to_goal(const RescuePlanner *p, int cell) {
+  const RescuePlanNode *n = find(p, cell);
+  return !n ? INF : n->rhs < n->g ? n->rhs : n->g;
+}
+
+double rescue_plan_bound(const RescuePlanner *p) {
+  return (double)p->bound / RESCUE_PLAN_EPSILON_ONE;
+}
@@ -0,0 +1,148 @@
+/*
+ * Description: Incremental grid path planner (D* Lite, Koenig & Likhachev).
+ *              It searches backward from the goal, so g is the cost to the
+ *              goal and the path is read off by walking downhill from the
+ *              robot. When cell costs change (the sensors reveal an
+ *              obstacle) or the robot moves, only the affected part of the
+ *              search is repaired instead of planning again from scratch.
+ *
+ *              Search nodes come from a pool sized at init and handed out
+ *              to cells as the search reaches them; changing the goal
+ *              empties the pool in O(1). The open list is a binary heap
+ *              indexed by node, so a node's key can be changed or the node
+ *              removed in O(log n). Nothing is allocated while planning.
+ *
+ *              Each step repairs at most max_expansions nodes, and when
+ *              slice_ns is set it also stops once that much wall-clock
+ *              time has passed (checked every RESCUE_PLAN_CLOCK_EVERY
+ *              expansions), so planning never takes more than its share of
+ *              the control period. An unfinished repair carries on in the
+ *              next step.
+ *
+ *              Anytime mode (ARA*, Likhachev et al.) trades the repair for
+ *              a fast first answer: a weighted A* search, also backward
+ *              from the goal, whose heuristic is inflated by epsilon finds
+ *              a path costing at most epsilon times the best one after
+ *              few expansions. Epsilon is then lowered step by step and
+ *              the search goes on from where it was, reopening only the
+ *              nodes whose cost improved, until the path is optimal (1).
+ *              The same per-step budget applies, so a deadline leaves the
+ *              best path found so far in place. Cost changes restart the
+ *              search from the first epsilon rather than repairing it.
+ */
+
+#ifndef RESCUE_PLAN_H
+#define RESCUE_PLAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RESCUE_PLAN_MAX_NODES 131072       // Default pool: 2 MB of nodes plus the heap
+#define RESCUE_PLAN_BLOCKED 0              // Cell cost of an obstacle
+#define RESCUE_PLAN_INFINITY 0x3FFFFFFFu   // g/rhs of cells not (yet) connected to the goal
+#define RESCUE_PLAN_CLOCK_EVERY 32         // Expansions between two clock reads
+#define RESCUE_PLAN_EXPANSIONS_PER_MS 2000 // Budget per ms of slice, a quarter of what a desktop x86 core repairs
+#define RESCUE_PLAN_EPSILON_ONE 16         // Anytime mode: epsilon in sixteenths
+#define RESCUE_PLAN_EPSILON_STEP 8         // Lowered by 0.5 after each path found
+
+typedef enum {
+  RESCUE_PLAN_IDLE,                        // No goal
+  RESCUE_PLAN_FOUND,                       // Search consistent, path to the goal
+  RESCUE_PLAN_PARTIAL,                     // Budget used up before the search was consistent
+  RESCUE_PLAN_NO_PATH,                     // Search consistent, the goal cannot be reached
+  RESCUE_PLAN_OUT_OF_NODES                 // The pool ran out, search stopped until the next goal
+} RescuePlanStatus;
+
+typedef struct {
+  int32_t cell;                            // Row-major cell index
+  uint32_t g, rhs;                         // Cost to the goal and its one-step lookahead
+  int32_t heap_index;                      // Position in the heap, -1 if not queued
+  uint32_t closed;                         // Anytime: search iteration that expanded it (+ INCONS flag, rescue_plan.c)
+} RescuePlanNode;
+
+typedef struct {
+  uint64_t key;                            // (k1 << 32) | k2, compared as one number
+  int32_t node;
+} RescuePlanHeapEntry;
+
+typedef struct {
+  int width, height;
+  uint8_t *cost;                           // Cost of entering each cell, 1 (free) .. 255; RESCUE_PLAN_BLOCKED
+  // --- Node Pool ---
+  RescuePlanNode *pool;
+  int max_nodes, used;
+  int32_t *node_of;                        // Pool index per cell; valid if < used and the node names the cell
+  // --- Open List ---
+  RescuePlanHeapEntry *heap;
+  int heap_size;
+  // --- Search ---
+  int goal, start, last;                   // Cells; last: start when km was last updated
+  uint32_t km;                             // Heuristic offset accumulated as the robot moves
+  RescuePlanStatus status;
+  // --- Budget per step ---
+  int max_expansions;
+  uint64_t slice_ns;                       // 0: no clock, the expansion budget only
+  // --- Anytime Mode (ARA*) ---
+  bool anytime;
+  uint32_t epsilon0, epsilon;              // First and current inflation, in RESCUE_PLAN_EPSILON_ONE units
+  uint32_t iteration;                      // One per epsilon
+  uint32_t bound;                          // Inflation of the last path found, 0: none yet
+  int32_t *incons;                         // Expanded nodes improved again, reopened with the next epsilon
+  int num_incons;
+  bool restart;                            // Costs changed: search again from epsilon0
+  // Statistics
+  unsigned long steps;
+  unsigned long expansions;
+  int max_step_expansions;
+  uint64_t max_step_ns;
+  unsigned long budget_stops;              // Steps cut short by max_expansions
+  unsigned long deadline_stops;            // Steps cut short by slice_ns
+  unsigned long cost_changes;
+  unsigned long searches;                  // New goals, each starting from an empty pool
+  unsigned long solutions;                 // Anytime: paths found, each better bounded than the last
+  unsigned long restarts;                  // Anytime: searches started over after cost changes
+} RescuePlanner;
+
+// Allocates the cost grid (all cells free), the pool and the heap. The
+// budget starts at slice_ms per step (see rescue_plan_set_slice). Returns
+// false if memory cannot be allocated.
+bool rescue_plan_init(RescuePlanner *p, int width, int height, int max_nodes, double slice_ms);
+void rescue_plan_free(RescuePlanner *p);
+
+// Sets the per-step budget: slice_ms * RESCUE_PLAN_EXPANSIONS_PER_MS
+// expansions, and slice_ms of wall-clock time unless use_clock is false
+// (then runs are repeatable whatever the host's speed).
+void rescue_plan_set_slice(RescuePlanner *p, double slice_ms, bool use_clock);
+
+// Plans with ARA* from an inflation of epsilon0 (>= 1) instead of D* Lite;
+// epsilon0 = 0 goes back to D* Lite. Drops the current search.
+void rescue_plan_set_anytime(RescuePlanner *p, double epsilon0);
+
+// Changes the cost of entering a cell and queues the repair of the cells
+// next to it (anytime mode: the search restarts at the next step).
+void rescue_plan_set_cost(RescuePlanner *p, int cell, uint8_t cost);
+
+// Plans to a new goal (a cell, or -1 for none). Setting the current goal
+// again keeps the search.
+void rescue_plan_set_goal(RescuePlanner *p, int goal);
+
+// Moves the robot to cell start and repairs the search within the budget.
+// Anytime mode: FOUND as soon as there is a path, while it keeps improving.
+RescuePlanStatus rescue_plan_step(RescuePlanner *p, int start);
+
+// The neighbor of cell to move to next (lowest cost plus cost to the goal),
+// -1 if the search has not connected cell to the goal.
+int rescue_plan_next(const RescuePlanner *p, int cell);
+
+// Cost to the goal from cell as far as the search knows; RESCUE_PLAN_INFINITY if unknown.
+uint32_t rescue_plan_cost_to_goal(const RescuePlanner *p, int cell);
+
+// The path from rescue_plan_next costs at most this many times the best
+// one over the known costs: 1 for D* Lite, the last epsilon finished in
+// anytime mode; 0 while there is no path yet.
+double rescue_plan_bound(const RescuePlanner *p);
+
+// Bytes allocated by the planner.
+unsigned long rescue_plan_memory(const RescuePlanner *p);
+
+#endif // RESCUE_PLAN_H
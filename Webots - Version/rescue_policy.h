@@ -0,0 +1,105 @@
+/*
+ * Description: The rescue decision policy as one pure, branch-free function,
+ *              generated from the state tables in rescue_states.h.
+ *              rescue_controller_step() runs it for a single BoeBot and the
+ *              headless swarm runs it over structure-of-arrays lanes, so
+ *              both always make exactly the same decisions. Everything is
+ *              written as selects so a loop over robots can vectorize.
+ */
+
+#ifndef RESCUE_POLICY_H
+#define RESCUE_POLICY_H
+
+#include "rescue_controller.h"
+
+// --- Events raised by one decision (bit mask) ---
+#define RESCUE_EV_AID_FINISHED 1u   // aid_deploy_counter just reached 0
+#define RESCUE_EV_SIGNAL 2u         // Survivor newly found: send SURVIVOR_MESSAGE
+
+// The turn on the spot away from the side with less space, the wheel
+// speeds to avoid with when no other steering (rescue_vfh.h) is given.
+static inline void rescue_policy_avoid_turn(double ds_left, double ds_right, double *left_speed, double *right_speed) {
+  int turn_right = ds_left < ds_right; // Left sensor closer -> Turn Right
+  *left_speed = turn_right ? TURN_SPEED : -TURN_SPEED;
+  *right_speed = -*left_speed;
+}
+
+// The state table's columns (rescue_states.h) as expressions of
+// rescue_policy_step()'s locals.
+#define RESCUE_POLICY_DRIVE_LEFT_SEARCH search_left
+#define RESCUE_POLICY_DRIVE_LEFT_AVOID avoid_left
+#define RESCUE_POLICY_DRIVE_LEFT_STOP 0.0
+#define RESCUE_POLICY_DRIVE_RIGHT_SEARCH search_right
+#define RESCUE_POLICY_DRIVE_RIGHT_AVOID avoid_right
+#define RESCUE_POLICY_DRIVE_RIGHT_STOP 0.0
+#define RESCUE_POLICY_LED_OFF 0
+#define RESCUE_POLICY_LED_ON 1
+#define RESCUE_POLICY_LED_BLINK (counter % 4 < 2)
+
+// One select per table row; each chain ends in its default.
+#define RESCUE_POLICY_NEXT(guard, state) (guard) ? state :
+#define RESCUE_POLICY_LEFT(state, drive, led, entry, exit, message) \
+  next_state == state ? RESCUE_POLICY_DRIVE_LEFT_##drive :
+#define RESCUE_POLICY_RIGHT(state, drive, led, entry, exit, message) \
+  next_state == state ? RESCUE_POLICY_DRIVE_RIGHT_##drive :
+#define RESCUE_POLICY_LED(state, drive, led, entry, exit, message) next_state == state ? RESCUE_POLICY_LED_##led :
+#define RESCUE_POLICY_ENTRY(state, drive, led, entry, exit, message) next_state == state ? (entry) :
+#define RESCUE_POLICY_EXIT(state, drive, led, entry, exit, message) current_state == state ? (exit) :
+
+// Replaces *state (a RobotState) with the next state from the transition
+// table, updates the aid timer and writes the wheel speeds and LED level
+// from the state table. obstacle: the front reading is below
+// OBSTACLE_DISTANCE_THRESHOLD (or its debounced trigger is on).
+// search_left/search_right are the wheel speeds to drive while SEARCHING
+// (FORWARD_SPEED for straight ahead, or the exploration command),
+// avoid_left/avoid_right those while AVOIDING_OBSTACLE
+// (rescue_policy_avoid_turn, or the avoidance command). Entering
+// DEPLOYING_AID raises RESCUE_EV_SIGNAL and starts the aid timer.
+// Returns RESCUE_EV_* bits.
+static inline unsigned rescue_policy_step(int *state, int *aid_deploy_counter,
+                                          int obstacle, int survivor, int tilted,
+                                          double search_left, double search_right,
+                                          double avoid_left, double avoid_right,
+                                          double *left_speed, double *right_speed, int *led) {
+  int current_state = *state;
+  int counter = *aid_deploy_counter;
+
+  // Timer logic
+  int was_counting = counter > 0;
+  counter -= was_counting;
+  int deploying = was_counting & (counter > 0);
+  unsigned finished = (unsigned)(was_counting & (counter == 0));
+
+  // Transitions, in priority order: aid still deploying, tilt, survivor
+  // found, obstacle in front (front sensor primarily), clear
+  int next_state = RESCUE_TRANSITION_TABLE(RESCUE_POLICY_NEXT) RESCUE_STATE_DEFAULT;
+  unsigned changed = next_state != current_state;
+  unsigned actions = changed * ((RESCUE_STATE_TABLE(RESCUE_POLICY_ENTRY) 0u) |
+                                (RESCUE_STATE_TABLE(RESCUE_POLICY_EXIT) 0u));
+  counter = (actions & RESCUE_EV_SIGNAL) ? AID_DEPLOY_DURATION : counter; // Start timer
+
+  // Actions of the state: its wheel command and LED (solid / blink)
+  double l = RESCUE_STATE_TABLE(RESCUE_POLICY_LEFT) 0.0;
+  double r = RESCUE_STATE_TABLE(RESCUE_POLICY_RIGHT) 0.0;
+  *led = RESCUE_STATE_TABLE(RESCUE_POLICY_LED) 0;
+
+  *state = next_state;
+  *left_speed = l;
+  *right_speed = r;
+  *aid_deploy_counter = counter;
+  return finished * RESCUE_EV_AID_FINISHED | actions;
+}
+
+#undef RESCUE_POLICY_NEXT
+#undef RESCUE_POLICY_LEFT
+#undef RESCUE_POLICY_RIGHT
+#undef RESCUE_POLICY_LED
+#undef RESCUE_POLICY_ENTRY
+#undef RESCUE_POLICY_EXIT
+
+// Tilt check on one accelerometer sample.
+static inline int rescue_policy_tilted(const double a[3]) {
+  return (a[0] > TILT_THRESHOLD) | (a[0] < -TILT_THRESHOLD) | (a[1] > TILT_THRESHOLD) | (a[1] < -TILT_THRESHOLD);
+}
+
+#endif // RESCUE_POLICY_H
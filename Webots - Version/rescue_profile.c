@@ -0,0 +1,84 @@
+/*
+ * Description: Per-step latency histograms for the control loop
+ *              (see rescue_profile.h).
+ */
+
+#include "rescue_profile.h"
+
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static const char *const phase_names[RESCUE_NUM_PHASES] = {
+  "wait (step)", "sense", "recognize", "odometry/map", "explore", "avoid", "survivor check", "decide", "debug output", "actuate", "control step",
+};
+
+void rescue_profile_init(RescueProfile *p, int time_step_ms) {
+  rescue_profile_reset(p);
+  p->budget_ns = (uint64_t)time_step_ms * 1000000u;
+  p->dump_requested = 0;
+}
+
+void rescue_profile_reset(RescueProfile *p) {
+  memset(p->phase, 0, sizeof(p->phase));
+  p->over_budget = 0;
+}
+
+uint64_t rescue_profile_now(void) {
+#ifdef _WIN32
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER now;
+  if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Lowest value that falls into bucket i.
+static uint64_t bucket_floor(int i) {
+  if (i < RESCUE_PROFILE_SUB) return (uint64_t)i;
+  int shift = i / RESCUE_PROFILE_SUB - 1;
+  return (uint64_t)(RESCUE_PROFILE_SUB + i % RESCUE_PROFILE_SUB) << shift;
+}
+
+// Value at quantile q, reported as the middle of its bucket.
+static uint64_t histogram_quantile(const RescueHistogram *h, double q) {
+  if (!h->count) return 0;
+  uint64_t rank = (uint64_t)(q * (double)h->count);
+  if (rank >= h->count) rank = h->count - 1;
+  uint64_t seen = 0;
+  for (int i = 0; i < RESCUE_PROFILE_BUCKETS; ++i) {
+    seen += h->counts[i];
+    if (seen > rank) {
+      uint64_t lo = bucket_floor(i), hi = i + 1 < RESCUE_PROFILE_BUCKETS ? bucket_floor(i + 1) : lo + 1;
+      uint64_t mid = lo + (hi - lo) / 2;
+      return mid < h->max_ns ? mid : h->max_ns;
+    }
+  }
+  return h->max_ns;
+}
+
+void rescue_profile_dump(const RescueProfile *p, FILE *out) {
+  const RescueHistogram *step = &p->phase[RESCUE_PHASE_STEP];
+  fprintf(out, "--- Control Loop Latency: %llu steps, budget %.1f ms, over budget %llu ---\n",
+          (unsigned long long)step->count, p->budget_ns * 1e-6, (unsigned long long)p->over_budget);
+  fprintf(out, "%-15s %10s %10s %10s %10s %10s %10s %10s\n", "phase (us)", "count", "mean", "p50", "p90", "p99",
+          "p99.9", "max");
+  for (int i = 0; i < RESCUE_NUM_PHASES; ++i) {
+    const RescueHistogram *h = &p->phase[i];
+    if (!h->count) continue;
+    fprintf(out, "%-15s %10llu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", phase_names[i],
+            (unsigned long long)h->count, (double)h->sum_ns / (double)h->count * 1e-3,
+            histogram_quantile(h, 0.50) * 1e-3, histogram_quantile(h, 0.90) * 1e-3,
+            histogram_quantile(h, 0.99) * 1e-3, histogram_quantile(h, 0.999) * 1e-3, h->max_ns * 1e-3);
+  }
+  fflush(out);
+}
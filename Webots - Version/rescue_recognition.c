@@ -0,0 +1,80 @@
+/*
+ * Description: Survivor recognition cache and pattern matching
+ *              (see rescue_recognition.h).
+ */
+
+#include "rescue_recognition.h"
+
+#include <string.h>
+
+static bool pattern_matches(const char *pattern, const char *value) {
+  if (!pattern || !value) return false;
+  size_t n = strlen(pattern);
+  if (n > 0 && pattern[n - 1] == '*') return strncmp(pattern, value, n - 1) == 0;
+  return strcmp(pattern, value) == 0;
+}
+
+int rescue_recognition_match(const RescueSurvivorPattern *patterns, int num_patterns, const char *name,
+                             const char *model) {
+  for (int i = 0; i < num_patterns; ++i) {
+    if (pattern_matches(patterns[i].name, name) || pattern_matches(patterns[i].model, model))
+      return patterns[i].survivor_class;
+  }
+  return RESCUE_RECOG_NOT_SURVIVOR;
+}
+
+void rescue_recognition_cache_init(RescueRecognitionCache *c) {
+  memset(c, 0, sizeof(*c));
+}
+
+void rescue_recognition_cache_clear(RescueRecognitionCache *c) {
+  memset(c->keys, 0, sizeof(c->keys));
+  c->used = 0;
+}
+
+// --- Sampling Rate ---
+
+void rescue_recognition_rate_init(RescueRecognitionRate *r, int period_ms, int relaxed_ms, double escalate_range,
+                                  int hold_steps) {
+  memset(r, 0, sizeof(*r));
+  r->period_ms = period_ms > 0 ? period_ms : 1;
+  r->relaxed_every = relaxed_ms / r->period_ms > 0 ? relaxed_ms / r->period_ms : 1;
+  r->escalate_range = escalate_range;
+  r->hold_steps = hold_steps;
+  r->since = r->relaxed_every; // The first step recognizes
+}
+
+bool rescue_recognition_rate_next(RescueRecognitionRate *r, const double *ds, const bool *present, int num_ds,
+                                  bool survivor_in_view) {
+  r->steps++;
+  bool close = false;
+  if (r->escalate_range > 0.0) {
+    close = survivor_in_view;
+    for (int i = 0; i < num_ds; ++i) close |= present[i] && ds[i] < r->escalate_range;
+  }
+  if (close) {
+    r->escalations += !r->escalated;
+    r->escalated = true;
+    r->hold = r->hold_steps;
+  } else if (r->hold > 0) {
+    r->hold--;
+  } else {
+    r->escalated = false;
+  }
+  r->escalated_steps += r->escalated;
+
+  if (!r->escalated && ++r->since < r->relaxed_every) {
+    r->saved++;
+    return false;
+  }
+  r->since = 0;
+  r->calls++;
+  return true;
+}
+
+void rescue_recognition_rate_defer(RescueRecognitionRate *r) {
+  r->calls--;
+  r->saved++;
+  r->deferred++;
+  r->since = r->relaxed_every;
+}
@@ -0,0 +1,123 @@
+/*
+ * Description: Survivor recognition cache. Recognized objects are
+ *              classified by their name/model against a table of patterns
+ *              only the first time a node is seen; after that the
+ *              classification comes from a small open-addressing hash table
+ *              keyed by the node handle, so the per-step recognition loop
+ *              does no string compares.
+ *
+ *              Node handles are opaque here (a WbNodeRef under Webots), so
+ *              the cache and the pattern matching have no Webots dependency.
+ *
+ *              The sampling rate decides which recognition opportunities
+ *              (the recognition task's runs, or control steps without a
+ *              schedule) recognize at all: every relaxed_every-th while the
+ *              way is clear, and every one from a reading closer than the
+ *              escalation range (or a survivor in view) until hold_steps
+ *              after the last one.
+ */
+
+#ifndef RESCUE_RECOGNITION_H
+#define RESCUE_RECOGNITION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RESCUE_RECOG_NOT_SURVIVOR 0 // Class of anything that matches no pattern
+#define RESCUE_RECOG_CACHE_SLOTS 256 // Power of two
+#define RESCUE_RECOG_CACHE_MAX_LOAD (RESCUE_RECOG_CACHE_SLOTS * 3 / 4)
+#define RESCUE_RECOG_HOLD_STEPS 4    // Opportunities at full rate after the last close reading
+
+// --- Survivor Patterns ---
+// A node matches if its name or its model matches; a pattern ending in '*'
+// matches by prefix, NULL never matches.
+typedef struct {
+  const char *name;
+  const char *model;
+  int survivor_class;      // > 0, reported for matching nodes
+} RescueSurvivorPattern;
+
+// Returns the class of the first matching pattern, RESCUE_RECOG_NOT_SURVIVOR if none.
+int rescue_recognition_match(const RescueSurvivorPattern *patterns, int num_patterns, const char *name,
+                             const char *model);
+
+// --- Node Cache ---
+// Classifies a node on a cache miss (looks up its name/model and matches).
+typedef int (*RescueClassifyFn)(void *ctx, const void *node);
+
+typedef struct {
+  const void *keys[RESCUE_RECOG_CACHE_SLOTS];   // NULL = empty slot
+  int8_t classes[RESCUE_RECOG_CACHE_SLOTS];
+  int used;
+  // Statistics
+  unsigned long lookups;
+  unsigned long misses;    // Classifier calls
+  unsigned long resets;    // Table filled up and was cleared
+} RescueRecognitionCache;
+
+void rescue_recognition_cache_init(RescueRecognitionCache *c);
+
+// Forgets every node, e.g. after nodes were deleted from the world.
+void rescue_recognition_cache_clear(RescueRecognitionCache *c);
+
+// Class of 'node', calling classify(ctx, node) only the first time it is seen.
+static inline int rescue_recognition_lookup(RescueRecognitionCache *c, const void *node, RescueClassifyFn classify,
+                                            void *ctx) {
+  if (!node) return RESCUE_RECOG_NOT_SURVIVOR;
+  c->lookups++;
+  // Fibonacci hashing of the handle; low bits of pointers are alignment
+  uint32_t slot = (uint32_t)(((uint64_t)(uintptr_t)node * 0x9E3779B97F4A7C15ull) >> 32) & (RESCUE_RECOG_CACHE_SLOTS - 1);
+  for (;;) {
+    if (c->keys[slot] == node) return c->classes[slot];
+    if (!c->keys[slot]) break;
+    slot = (slot + 1) & (RESCUE_RECOG_CACHE_SLOTS - 1);
+  }
+
+  // --- Miss: classify once and remember ---
+  c->misses++;
+  int cls = classify(ctx, node);
+  if (c->used >= RESCUE_RECOG_CACHE_MAX_LOAD) {
+    rescue_recognition_cache_clear(c);
+    c->resets++;
+    return cls; // Cached on the next sighting
+  }
+  c->keys[slot] = node;
+  c->classes[slot] = (int8_t)cls;
+  c->used++;
+  return cls;
+}
+
+// --- Sampling Rate ---
+typedef struct {
+  int period_ms;           // Between opportunities: RECOGNIZE_PERIOD with a schedule, else TIME_STEP
+  int relaxed_every;       // Opportunities per recognition while the way is clear
+  double escalate_range;   // Every opportunity below this reading (meters); 0 never escalates
+  int hold_steps;          // ... until this many after the last one
+  int since;               // Opportunities since the last recognition
+  int hold;                // Opportunities left at full rate
+  bool escalated;
+  // Statistics
+  unsigned long steps;     // Opportunities seen
+  unsigned long calls;     // Recognitions run
+  unsigned long saved;     // Opportunities without one
+  unsigned long deferred;  // ... of those, put off to the next (rescue_recognition_rate_defer)
+  unsigned long escalations;
+  unsigned long escalated_steps;
+} RescueRecognitionRate;
+
+// period_ms: between opportunities; relaxed_ms: between recognitions while
+// nothing is closer than escalate_range (rounded to whole opportunities).
+void rescue_recognition_rate_init(RescueRecognitionRate *r, int period_ms, int relaxed_ms, double escalate_range,
+                                  int hold_steps);
+
+// Whether this opportunity recognizes, from its num_ds readings (those not
+// present are ignored) and whether the last recognition saw a survivor.
+bool rescue_recognition_rate_next(RescueRecognitionRate *r, const double *ds, const bool *present, int num_ds,
+                                  bool survivor_in_view);
+
+// The recognition rescue_recognition_rate_next() just granted was not run
+// (the backend's last result predates the shorter sampling period): counted
+// as saved, and the next opportunity recognizes whatever the rate.
+void rescue_recognition_rate_defer(RescueRecognitionRate *r);
+
+#endif // RESCUE_RECOGNITION_H
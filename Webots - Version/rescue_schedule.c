@@ -0,0 +1,72 @@
+/*
+ * Description: Multi-rate task schedule (see rescue_schedule.h).
+ */
+
+#include "rescue_schedule.h"
+
+#include <string.h>
+
+void rescue_schedule_init(RescueSchedule *s) {
+  memset(s, 0, sizeof(*s));
+}
+
+static int gcd(int a, int b) {
+  while (b) {
+    int r = a % b;
+    a = b;
+    b = r;
+  }
+  return a;
+}
+
+int rescue_schedule_add(RescueSchedule *s, const char *name, int period_ms, int offset_ms, unsigned devices) {
+  if (s->count == RESCUE_SCHEDULE_MAX_TASKS || period_ms <= 0 || offset_ms < 0 || offset_ms >= period_ms) {
+    s->invalid = true;
+    return -1;
+  }
+  int i = s->count++;
+  s->tasks[i] = (RescueTask){name, period_ms, offset_ms, devices, 1, 0, 0};
+  // The tick may have shrunk: every task's period and offset in ticks again
+  s->tick_ms = gcd(gcd(s->tick_ms, period_ms), offset_ms);
+  for (int k = 0; k < s->count; ++k) {
+    s->tasks[k].every = s->tasks[k].period_ms / s->tick_ms;
+    s->tasks[k].phase = s->tasks[k].offset_ms / s->tick_ms;
+  }
+  return i;
+}
+
+bool rescue_schedule_due_next(const RescueSchedule *s, int task) {
+  const RescueTask *t = &s->tasks[task];
+  return s->tick % t->every == t->phase;
+}
+
+unsigned rescue_schedule_next(RescueSchedule *s) {
+  unsigned due = 0;
+  for (int i = 0; i < s->count; ++i) {
+    if (!rescue_schedule_due_next(s, i) || ((s->skip >> i) & 1u)) continue;
+    due |= 1u << i;
+    s->tasks[i].runs++;
+  }
+  s->due = due;
+  s->skip = 0;
+  s->tick++;
+  s->ticks++;
+  return due;
+}
+
+int rescue_schedule_device_period(const RescueSchedule *s, unsigned devices, int fallback_ms) {
+  int period = 0;
+  for (int i = 0; i < s->count; ++i)
+    if ((s->tasks[i].devices & devices) && (!period || s->tasks[i].period_ms < period)) period = s->tasks[i].period_ms;
+  return period ? period : fallback_ms;
+}
+
+void rescue_schedule_dump(const RescueSchedule *s, FILE *out) {
+  fprintf(out, "--- Schedule: %lu ticks of %d ms ---\n", s->ticks, s->tick_ms);
+  fprintf(out, "%-12s %10s %10s %10s %6s\n", "task", "period", "offset", "runs", "share");
+  for (int i = 0; i < s->count; ++i) {
+    const RescueTask *t = &s->tasks[i];
+    fprintf(out, "%-12s %7d ms %7d ms %10lu %5.1f%%\n", t->name, t->period_ms, t->offset_ms, t->runs,
+            s->ticks ? 100.0 * t->runs / s->ticks : 0.0);
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Description: Multi-rate task schedule. Instead of running everything at
+ *              one control period, each task declares its own period (and
+ *              an offset, to keep slow tasks off the same tick) and the
+ *              loop steps the robot at the greatest common divisor of them
+ *              all, dispatching only the tasks due on each tick.
+ *
+ *              Tasks also declare the device groups they read
+ *              (RESCUE_DEVICE_*): a backend samples each group at the
+ *              shortest period of the tasks that read it, so sensors are
+ *              not sampled faster than anything looks at them.
+ *
+ *              Ticks are counted, not timed: the same schedule dispatches
+ *              the same tasks on a replay.
+ */
+
+#ifndef RESCUE_SCHEDULE_H
+#define RESCUE_SCHEDULE_H
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define RESCUE_SCHEDULE_MAX_TASKS 8
+
+typedef struct {
+  const char *name;
+  int period_ms;
+  int offset_ms;                             // First run, 0 .. period_ms - 1
+  unsigned devices;                          // RESCUE_DEVICE_* groups it reads
+  int every;                                 // Period in ticks
+  int phase;                                 // Offset in ticks
+  unsigned long runs;
+} RescueTask;
+
+typedef struct {
+  RescueTask tasks[RESCUE_SCHEDULE_MAX_TASKS];
+  int count;
+  int tick_ms;                               // Greatest common divisor of every period and offset
+  bool invalid;                              // A task did not fit or its period / offset was out of range
+  long tick;                                 // Next tick
+  unsigned due;                              // Tasks due on the current tick, bit i for task i
+  unsigned skip;                             // Tasks the next tick leaves out (rescue_schedule_skip_next)
+  unsigned long ticks;
+} RescueSchedule;
+
+void rescue_schedule_init(RescueSchedule *s);
+
+// Adds a task and returns its index (in the order added), -1 (and invalid
+// set) if the schedule is full, period_ms is not positive or offset_ms is
+// not within the period.
+int rescue_schedule_add(RescueSchedule *s, const char *name, int period_ms, int offset_ms, unsigned devices);
+
+// Moves to the next tick and returns the tasks due on it; every task is due
+// on its first tick past the offset, and every period after that.
+unsigned rescue_schedule_next(RescueSchedule *s);
+
+// Whether task is due on the current tick.
+static inline bool rescue_schedule_due(const RescueSchedule *s, int task) {
+  return (s->due >> task) & 1u;
+}
+
+// Whether task will be due on the tick rescue_schedule_next() moves to.
+bool rescue_schedule_due_next(const RescueSchedule *s, int task);
+
+// Leaves task out of the next tick (not due, not counted as a run), for a
+// task its caller decided not to run after all.
+static inline void rescue_schedule_skip_next(RescueSchedule *s, int task) {
+  s->skip |= 1u << task;
+}
+
+// Sampling period for the device groups in devices: the shortest period of
+// the tasks reading any of them, fallback_ms if none does.
+int rescue_schedule_device_period(const RescueSchedule *s, unsigned devices, int fallback_ms);
+
+// Prints each task's period, offset and runs.
+void rescue_schedule_dump(const RescueSchedule *s, FILE *out);
+
+#endif // RESCUE_SCHEDULE_H
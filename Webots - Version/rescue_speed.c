@@ -0,0 +1,58 @@
+/*
+ * Description: Time-to-collision speed governor (see rescue_speed.h).
+ */
+
+#include "rescue_speed.h"
+
+#include <math.h>
+#include <string.h>
+
+void rescue_speed_init(RescueSpeed *s, double top_speed) {
+  memset(s, 0, sizeof(*s));
+  s->top_speed = top_speed;
+  s->governed = true;
+  for (int i = 0; i < RESCUE_MAX_RANGES; ++i) s->last[i] = -1.0;
+  s->ttc = INFINITY;
+  s->min_ttc = INFINITY;
+  s->scale = 1.0;
+}
+
+void rescue_speed_update(RescueSpeed *s, const double *range, int count, double dt) {
+  if (count > RESCUE_MAX_RANGES) count = RESCUE_MAX_RANGES;
+  double ttc = INFINITY;
+  for (int i = 0; i < count; ++i) {
+    double d = range[i];
+    if (!(d < RESCUE_SPEED_RANGE)) { // Nothing in reach
+      s->last[i] = -1.0;
+      s->closing[i] = 0.0;
+      continue;
+    }
+    double closing = s->last[i] < 0.0 ? 0.0 : (s->last[i] - d) / dt;
+    if (fabs(closing) > RESCUE_SPEED_MAX_CLOSING) s->closing[i] = 0.0; // Another surface
+    else s->closing[i] += RESCUE_SPEED_SMOOTHING * (closing - s->closing[i]);
+    s->last[i] = d;
+    if (s->closing[i] > 1e-3) ttc = fmin(ttc, d / s->closing[i]);
+  }
+  for (int i = count; i < RESCUE_MAX_RANGES; ++i) s->last[i] = -1.0;
+
+  double target = (ttc - RESCUE_SPEED_TTC_STOP) / (RESCUE_SPEED_TTC_FULL - RESCUE_SPEED_TTC_STOP);
+  target = fmin(1.0, fmax(RESCUE_SPEED_MIN, target));
+  if (!s->governed) target = 1.0;
+  s->scale = fmin(target, s->scale + RESCUE_SPEED_RISE);
+  s->ttc = ttc;
+  s->min_ttc = fmin(s->min_ttc, ttc);
+  s->updates++;
+  s->slowed += s->scale < 1.0;
+  s->scale_sum += s->scale;
+}
+
+void rescue_speed_apply(const RescueSpeed *s, double nominal, double *left_speed, double *right_speed) {
+  double forward = (*left_speed + *right_speed) / 2.0, turn = (*right_speed - *left_speed) / 2.0;
+  if (forward <= 0.0) return;
+  forward *= s->top_speed / nominal * s->scale;
+  // Keep the turn; the faster wheel stays within the top speed
+  forward = fmin(forward, s->top_speed - fabs(turn));
+  if (forward < 0.0) forward = 0.0;
+  *left_speed = forward - turn;
+  *right_speed = forward + turn;
+}
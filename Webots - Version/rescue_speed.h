@@ -0,0 +1,69 @@
+/*
+ * Description: Speed governor. FORWARD_SPEED is a compromise: slow enough
+ *              that the robot can turn away from whatever the front sensor
+ *              reports within OBSTACLE_DISTANCE_THRESHOLD, and so slower
+ *              than it needs to be in open space. The governor lets the
+ *              robot drive at up to RESCUE_SPEED_TOP and takes speed away as
+ *              the time to collision (TTC) shrinks.
+ *
+ *              Every range reading gives a closing speed: how fast it fell
+ *              since the last step, smoothed over a few steps. A jump larger
+ *              than the robot could drive in one step is a different surface
+ *              coming into view (the robot turned, or something moved past
+ *              the ray), not closing speed, and starts the reading over. The
+ *              TTC is the smallest distance / closing speed over the
+ *              readings; the speed scale falls linearly from 1 at
+ *              RESCUE_SPEED_TTC_FULL to RESCUE_SPEED_MIN at
+ *              RESCUE_SPEED_TTC_STOP. It drops at once and climbs back by at
+ *              most RESCUE_SPEED_RISE per step, so the wheels do not jump
+ *              between speeds as readings flicker. Turning is left alone:
+ *              only the forward part of a command is scaled.
+ */
+
+#ifndef RESCUE_SPEED_H
+#define RESCUE_SPEED_H
+
+#include <stdbool.h>
+
+#include "rescue_hal.h"
+#include "rescue_odometry.h"
+
+// --- Governor ---
+#define RESCUE_SPEED_TOP RESCUE_MAX_WHEEL_SPEED // Governed top wheel speed (rad/s): the motor's limit
+#define RESCUE_SPEED_TTC_FULL 2.0          // Full speed while every TTC is above this (seconds) ...
+#define RESCUE_SPEED_TTC_STOP 0.5          // ... RESCUE_SPEED_MIN at or below this one
+#define RESCUE_SPEED_MIN 0.3               // Fraction of the speed left when a collision is close
+#define RESCUE_SPEED_RISE 0.1              // Largest increase of the scale per step
+#define RESCUE_SPEED_SMOOTHING 0.5         // Weight of the newest closing speed in the average
+#define RESCUE_SPEED_MAX_CLOSING 0.5       // Faster changes (m/s) are a new surface, not motion
+#define RESCUE_SPEED_RANGE 0.95            // Readings at or beyond this (meters) see nothing
+
+typedef struct {
+  double top_speed;                        // Wheel speed FORWARD_SPEED is scaled to (rad/s)
+  bool governed;                           // false: always top_speed (to compare against)
+  // --- Per Reading ---
+  double last[RESCUE_MAX_RANGES];          // Reading last step, negative: none yet
+  double closing[RESCUE_MAX_RANGES];       // Smoothed closing speed (m/s), positive when approaching
+  // --- This Step ---
+  double ttc;                              // Smallest time to collision (seconds), INFINITY if none
+  double scale;                            // RESCUE_SPEED_MIN .. 1
+  // Statistics
+  unsigned long updates;
+  unsigned long slowed;                    // Steps with scale below 1
+  double scale_sum;
+  double min_ttc;
+} RescueSpeed;
+
+// Starts without history; top_speed: the wheel speed FORWARD_SPEED becomes.
+void rescue_speed_init(RescueSpeed *s, double top_speed);
+
+// Updates the closing speeds and the scale from this step's readings (count
+// of them, in the same sensor order every step); dt: control period (seconds).
+void rescue_speed_update(RescueSpeed *s, const double *range, int count, double dt);
+
+// Scales the forward part of a wheel command driving at up to nominal
+// (FORWARD_SPEED) to top_speed times the scale; turns on the spot and
+// reversing are left as they are.
+void rescue_speed_apply(const RescueSpeed *s, double nominal, double *left_speed, double *right_speed);
+
+#endif // RESCUE_SPEED_H
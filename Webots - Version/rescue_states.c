@@ -0,0 +1,49 @@
+/*
+ * Description: State names, messages and profiling counters (see
+ *              rescue_states.h).
+ */
+
+#include "rescue_states.h"
+
+#include <string.h>
+
+#define RESCUE_STATE_NAME(state, drive, led, entry, exit, message) #state,
+#define RESCUE_STATE_MESSAGE(state, drive, led, entry, exit, message) message,
+static const char *const state_names[RESCUE_NUM_STATES] = {RESCUE_STATE_TABLE(RESCUE_STATE_NAME)};
+static const char *const state_messages[RESCUE_NUM_STATES] = {RESCUE_STATE_TABLE(RESCUE_STATE_MESSAGE)};
+
+const char *rescue_state_name(int state) {
+  return state >= 0 && state < RESCUE_NUM_STATES ? state_names[state] : "?";
+}
+
+const char *rescue_state_message(int state) {
+  return state >= 0 && state < RESCUE_NUM_STATES ? state_messages[state] : "?";
+}
+
+void rescue_state_stats_init(RescueStateStats *s, int initial) {
+  memset(s, 0, sizeof(*s));
+  s->entries[initial] = 1;
+}
+
+void rescue_state_stats_dump(const RescueStateStats *s, int time_step_ms, FILE *out) {
+  double step = time_step_ms / 1000.0;
+  unsigned long total = 0;
+  for (int i = 0; i < RESCUE_NUM_STATES; ++i) total += s->steps[i];
+  fprintf(out, "%-18s %10s %10s %6s %8s %9s %11s\n", "state", "steps", "time (s)", "share", "entries", "mean (s)",
+          "longest (s)");
+  for (int i = 0; i < RESCUE_NUM_STATES; ++i)
+    fprintf(out, "%-18s %10lu %10.1f %5.1f%% %8lu %9.2f %11.1f\n", state_names[i], s->steps[i], s->steps[i] * step,
+            total ? 100.0 * s->steps[i] / total : 0.0, s->entries[i],
+            s->entries[i] ? s->steps[i] * step / s->entries[i] : 0.0, s->longest[i] * step);
+  fprintf(out, "%-18s", "transitions to:");
+  for (int j = 0; j < RESCUE_NUM_STATES; ++j) fprintf(out, " %18s", state_names[j]);
+  fprintf(out, "\n");
+  for (int i = 0; i < RESCUE_NUM_STATES; ++i) {
+    fprintf(out, "%-18s", state_names[i]);
+    for (int j = 0; j < RESCUE_NUM_STATES; ++j) {
+      if (i == j) fprintf(out, " %18s", "-");
+      else fprintf(out, " %18lu", s->transitions[i][j]);
+    }
+    fprintf(out, "\n");
+  }
+}
@@ -0,0 +1,92 @@
+/*
+ * Description: The rescue state machine as declarative tables. Each state
+ *              and each transition is one row of an X-macro; the RobotState
+ *              enum, the names, the decision in rescue_policy_step() and the
+ *              console messages are all generated from them, so a new state
+ *              (backing up, approaching a survivor) is a row here rather
+ *              than an edit of several conditionals. The policy expands the
+ *              rows into a chain of selects in priority order, which the
+ *              compiler turns into conditional moves: no table lookups or
+ *              calls through pointers in the control step.
+ *
+ *              Per-state counters (steps spent, entries, longest stay and
+ *              the transitions between every pair of states) are kept for
+ *              profiling and dumped with rescue_state_stats_dump().
+ */
+
+#ifndef RESCUE_STATES_H
+#define RESCUE_STATES_H
+
+#include <stdio.h>
+
+// --- States ---
+// X(state, drive, led, entry, exit, message)
+//   drive: wheel command in the state, SEARCH (the search command), AVOID
+//          (the avoidance command) or STOP
+//   led: OFF, ON or BLINK
+//   entry, exit: RESCUE_EV_* actions raised when the state is entered or
+//                left (rescue_policy.h)
+//   message: printed after "STATE CHANGE: " on entry
+// The first row is the state the controller starts in.
+#define RESCUE_STATE_TABLE(X)                                                                                        \
+  X(SEARCHING, SEARCH, OFF, 0u, 0u, "Clear. Resuming Search.")                                                       \
+  X(AVOIDING_OBSTACLE, AVOID, OFF, 0u, 0u, "Obstacle Detected (Front DS). Avoiding.")                                \
+  X(DEPLOYING_AID, STOP, BLINK, RESCUE_EV_SIGNAL, 0u, "Survivor Detected! Deploying Aid & Emitting Signal.")         \
+  X(ROBOT_TILTED, STOP, ON, 0u, 0u, "Robot Tilted! Halting.")
+
+// --- Transitions ---
+// X(guard, state) in priority order: the first row whose guard holds is the
+// next state, RESCUE_STATE_DEFAULT if none does. Guards are expressions of
+// the policy's inputs: deploying (the aid timer is still running), tilted,
+// survivor (a survivor not served yet is in range) and obstacle.
+#define RESCUE_TRANSITION_TABLE(X)                                                                                   \
+  X(deploying, DEPLOYING_AID)                                                                                        \
+  X(tilted, ROBOT_TILTED)                                                                                            \
+  X(survivor, DEPLOYING_AID)                                                                                         \
+  X(obstacle, AVOIDING_OBSTACLE)
+#define RESCUE_STATE_DEFAULT SEARCHING
+
+#define RESCUE_STATE_ENUM(state, drive, led, entry, exit, message) state,
+typedef enum { RESCUE_STATE_TABLE(RESCUE_STATE_ENUM) RESCUE_NUM_STATES } RobotState;
+#undef RESCUE_STATE_ENUM
+
+// Whether the state drives the wheels (SEARCH or AVOID), as a chain of selects.
+#define RESCUE_STATE_DRIVES(state, drive, led, entry, exit, message) (s) == state ? RESCUE_STATE_DRIVES_##drive :
+#define RESCUE_STATE_DRIVES_SEARCH 1
+#define RESCUE_STATE_DRIVES_AVOID 1
+#define RESCUE_STATE_DRIVES_STOP 0
+static inline int rescue_state_drives(int s) { return RESCUE_STATE_TABLE(RESCUE_STATE_DRIVES) 0; }
+#undef RESCUE_STATE_DRIVES
+#undef RESCUE_STATE_DRIVES_SEARCH
+#undef RESCUE_STATE_DRIVES_AVOID
+#undef RESCUE_STATE_DRIVES_STOP
+
+// --- Profiling ---
+typedef struct {
+  unsigned long steps[RESCUE_NUM_STATES];     // Steps that ended in the state
+  unsigned long entries[RESCUE_NUM_STATES];   // Times entered (the initial state counts once)
+  unsigned long longest[RESCUE_NUM_STATES];   // Longest stay (steps)
+  unsigned long transitions[RESCUE_NUM_STATES][RESCUE_NUM_STATES]; // [from][to], from != to
+  unsigned long dwell;                        // Steps in the current state so far
+} RescueStateStats;
+
+void rescue_state_stats_init(RescueStateStats *s, int initial);
+
+// Counts one step that went from state from to state to (the same state: stayed).
+static inline void rescue_state_stats_count(RescueStateStats *s, int from, int to) {
+  unsigned long changed = from != to;
+  s->transitions[from][to] += changed;
+  s->entries[to] += changed;
+  s->dwell = changed ? 1 : s->dwell + 1;
+  s->steps[to]++;
+  s->longest[to] = s->dwell > s->longest[to] ? s->dwell : s->longest[to];
+}
+
+// Time, share, entries, mean and longest stay of every state, then the
+// transition counts, for steps of time_step_ms.
+void rescue_state_stats_dump(const RescueStateStats *s, int time_step_ms, FILE *out);
+
+const char *rescue_state_name(int state);
+const char *rescue_state_message(int state); // Text after "STATE CHANGE: " on entry
+
+#endif // RESCUE_STATES_H
@@ -0,0 +1,125 @@
+/*
+ * Description: Stuck and oscillation detector with escapes (see
+ *              rescue_stuck.h).
+ */
+
+#include "rescue_stuck.h"
+
+#include <math.h>
+#include <string.h>
+
+void rescue_stuck_init(RescueStuck *s) {
+  memset(s, 0, sizeof(*s));
+  s->phase = RESCUE_STUCK_NONE;
+  s->wall_side = RESCUE_DS_LEFT;
+  s->since_escape = -1;
+  s->random = RESCUE_STUCK_SEED;
+}
+
+// Uniform in [0, 1).
+static double next_random(RescueStuck *s) {
+  uint32_t x = s->random;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  s->random = x;
+  return x / 4294967296.0;
+}
+
+static void clear_window(RescueStuck *s) {
+  s->head = 0;
+  s->filled = 0;
+  s->flips = 0;
+}
+
+static void enter(RescueStuck *s, RescueStuckPhase phase, const double *pose) {
+  s->phase = phase;
+  s->phase_steps = 0;
+  s->turn = 0;
+  s->turned = 0.0;
+  s->last_heading = pose[2];
+  s->steer = 0.0;
+}
+
+// --- Escape Phases ---
+
+static void start_escape(RescueStuck *s, const double *pose, const double *ds, bool oscillating) {
+  s->escapes++;
+  if (oscillating) s->oscillations++;
+  else s->stalls++;
+  s->follow = s->since_escape >= 0 && s->since_escape <= RESCUE_STUCK_REPEAT;
+  s->wall_follows += s->follow;
+  s->wall_side = ds[RESCUE_DS_LEFT] < ds[RESCUE_DS_RIGHT] ? RESCUE_DS_LEFT : RESCUE_DS_RIGHT;
+  enter(s, RESCUE_STUCK_BACKUP, pose);
+}
+
+static void after_backup(RescueStuck *s, const double *pose) {
+  if (s->follow) {
+    enter(s, RESCUE_STUCK_FOLLOW, pose);
+    return;
+  }
+  enter(s, RESCUE_STUCK_TURN, pose);
+  s->turn = next_random(s) < 0.5 ? 1 : -1;
+  s->turn_angle = RESCUE_STUCK_TURN_MIN + (RESCUE_STUCK_TURN_MAX - RESCUE_STUCK_TURN_MIN) * next_random(s);
+}
+
+// Keeps the wall_side reading at RESCUE_STUCK_WALL_DISTANCE; turns away on
+// the spot while the front is closer than that.
+static void follow_wall(RescueStuck *s, const double *ds) {
+  double away = s->wall_side == RESCUE_DS_LEFT ? -1.0 : 1.0; // Left positive
+  if (ds[RESCUE_DS_FRONT] < RESCUE_STUCK_WALL_DISTANCE) {
+    s->turn = (int)away;
+    s->steer = 0.0;
+    return;
+  }
+  s->turn = 0;
+  double error = fmin(ds[s->wall_side], 2.0 * RESCUE_STUCK_WALL_DISTANCE) - RESCUE_STUCK_WALL_DISTANCE;
+  s->steer = fmax(-1.0, fmin(1.0, -away * RESCUE_STUCK_WALL_GAIN * error)); // Too far: toward the wall
+}
+
+static void end_escape(RescueStuck *s) {
+  s->phase = RESCUE_STUCK_NONE;
+  s->turn = 0;
+  s->steer = 0.0;
+  s->since_escape = 0;
+  clear_window(s);
+}
+
+bool rescue_stuck_update(RescueStuck *s, const double *pose, bool flipped, bool driving, const double *ds) {
+  if (s->since_escape >= 0 && s->phase == RESCUE_STUCK_NONE) s->since_escape++;
+  if (!driving) { // Stopped on purpose: neither stuck nor escaping
+    if (s->phase != RESCUE_STUCK_NONE) end_escape(s);
+    clear_window(s);
+    return false;
+  }
+
+  if (s->phase != RESCUE_STUCK_NONE) {
+    s->escape_steps++;
+    s->phase_steps++;
+    double delta = remainder(pose[2] - s->last_heading, 2.0 * M_PI);
+    s->last_heading = pose[2];
+    s->turned += s->turn * delta;
+    if (s->phase == RESCUE_STUCK_BACKUP && s->phase_steps >= RESCUE_STUCK_BACKUP_STEPS) after_backup(s, pose);
+    else if (s->phase == RESCUE_STUCK_TURN && (s->turned >= s->turn_angle || s->phase_steps >= RESCUE_STUCK_TURN_STEPS))
+      end_escape(s);
+    else if (s->phase == RESCUE_STUCK_FOLLOW && s->phase_steps >= RESCUE_STUCK_FOLLOW_STEPS) end_escape(s);
+    if (s->phase == RESCUE_STUCK_FOLLOW) follow_wall(s, ds);
+    return s->phase != RESCUE_STUCK_NONE;
+  }
+
+  // --- Sliding Window ---
+  if (s->filled == RESCUE_STUCK_WINDOW) s->flips -= s->flipped[s->head];
+  else s->filled++;
+  s->x[s->head] = pose[0];
+  s->y[s->head] = pose[1];
+  s->flipped[s->head] = flipped;
+  s->flips += flipped;
+  s->head = (s->head + 1) % RESCUE_STUCK_WINDOW;
+  if (s->filled < RESCUE_STUCK_WINDOW) return false;
+  int oldest = s->head; // Written RESCUE_STUCK_WINDOW - 1 steps ago
+  double moved = hypot(pose[0] - s->x[oldest], pose[1] - s->y[oldest]);
+  bool oscillating = s->flips >= RESCUE_STUCK_FLIPS && moved < RESCUE_STUCK_OSCILLATION;
+  if (!oscillating && moved >= RESCUE_STUCK_STALL) return false;
+  start_escape(s, pose, ds, oscillating);
+  return true;
+}
@@ -0,0 +1,100 @@
+/*
+ * Description: Stuck and oscillation detector with escapes. In a narrow
+ *              passage the front sensor sees the wall, the robot turns
+ *              away, the front clears, it turns back and sees the wall
+ *              again: the state flips between AVOIDING_OBSTACLE and
+ *              SEARCHING every few steps and the robot goes nowhere. Wedged
+ *              against an obstacle the sensors do not see, it does not even
+ *              flip.
+ *
+ *              The detector keeps a sliding window of the last
+ *              RESCUE_STUCK_WINDOW steps: the pose at each step and whether
+ *              the state flipped between the two. It triggers when the
+ *              robot has moved less than RESCUE_STUCK_STALL over the whole
+ *              window (stalled), or less than RESCUE_STUCK_OSCILLATION while
+ *              flipping RESCUE_STUCK_FLIPS times or more (oscillating).
+ *              Steps that are not meant to drive (deploying aid, tilted)
+ *              empty the window.
+ *
+ *              An escape backs up at BACKUP_SPEED for
+ *              RESCUE_STUCK_BACKUP_STEPS steps, then turns on the spot by a
+ *              random angle in a random direction. Triggered again within
+ *              RESCUE_STUCK_REPEAT steps of the last escape, the random
+ *              turn is not enough: after backing up it follows the wall
+ *              on its closer side for RESCUE_STUCK_FOLLOW_STEPS steps
+ *              instead, which gets along a passage that straight lines
+ *              keep bouncing off. The random numbers come from a seeded
+ *              generator, so a replay makes the same escapes.
+ */
+
+#ifndef RESCUE_STUCK_H
+#define RESCUE_STUCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rescue_hal.h"
+
+// --- Detector ---
+#define RESCUE_STUCK_WINDOW 96             // Steps in the sliding window (6 s)
+#define RESCUE_STUCK_STALL 0.1             // Moved less than this over the window (meters): stalled
+#define RESCUE_STUCK_FLIPS 8               // State flips in the window that ...
+#define RESCUE_STUCK_OSCILLATION 0.3       // ... with less than this displacement (meters) are an oscillation
+
+// --- Escapes ---
+#define RESCUE_STUCK_BACKUP_STEPS 12       // Steps reversing at BACKUP_SPEED first (8 cm)
+#define RESCUE_STUCK_TURN_MIN 1.57         // Random turn on the spot between these (rad) ...
+#define RESCUE_STUCK_TURN_MAX 3.14         // ... after backing up
+#define RESCUE_STUCK_TURN_STEPS 48         // Give up on a turn that has not finished after this many steps
+#define RESCUE_STUCK_REPEAT 128            // A trigger this many steps after an escape or sooner follows the wall
+#define RESCUE_STUCK_FOLLOW_STEPS 96       // Steps of wall following (6 s)
+#define RESCUE_STUCK_WALL_DISTANCE 0.2     // Side reading kept while following (meters)
+#define RESCUE_STUCK_WALL_GAIN 4.0         // Steering (rad) per meter off that distance, at most +/- 1
+#define RESCUE_STUCK_SEED 0x2545F491u      // Random turns are the same on every run
+
+typedef enum {
+  RESCUE_STUCK_NONE,                       // Not escaping: the controller drives
+  RESCUE_STUCK_BACKUP,                     // Reversing at BACKUP_SPEED
+  RESCUE_STUCK_TURN,                       // Turning on the spot by the random angle
+  RESCUE_STUCK_FOLLOW                      // Following the wall on the side in wall_side
+} RescueStuckPhase;
+
+typedef struct {
+  // --- Sliding Window: a ring of RESCUE_STUCK_WINDOW steps ---
+  double x[RESCUE_STUCK_WINDOW];
+  double y[RESCUE_STUCK_WINDOW];
+  unsigned char flipped[RESCUE_STUCK_WINDOW];
+  int head;                                // Where the next step goes
+  int filled;                              // Steps in the window
+  int flips;                               // Sum of flipped over the window
+  // --- Escape ---
+  RescueStuckPhase phase;
+  int phase_steps;                         // Steps spent in the phase
+  int turn;                                // Turn on the spot: 1 left, -1 right, 0 none
+  double turn_angle;                       // Random angle to turn by (rad)
+  double turned;                           // Turned so far (rad)
+  double last_heading;
+  int wall_side;                           // RESCUE_DS_LEFT or RESCUE_DS_RIGHT
+  double steer;                            // Wall following: heading change wanted (rad), left positive
+  bool follow;                             // The escape in progress follows the wall after backing up
+  long since_escape;                       // Steps since the last escape ended, -1 before the first
+  uint32_t random;                         // xorshift32 state
+  // Statistics
+  unsigned long escapes;                   // Rescues performed
+  unsigned long stalls;                    // Triggered by displacement alone
+  unsigned long oscillations;              // Triggered by flipping
+  unsigned long wall_follows;              // Escapes that followed the wall
+  unsigned long escape_steps;
+} RescueStuck;
+
+// Empty window, not escaping, the random generator at RESCUE_STUCK_SEED.
+void rescue_stuck_init(RescueStuck *s);
+
+// Adds one control step: the pose (x, y, heading), whether the state
+// flipped between AVOIDING_OBSTACLE and SEARCHING since the step before,
+// and whether the robot is meant to drive (false empties the window). Starts
+// an escape when the window shows the robot stuck and advances the one in
+// progress from the pose and the ds readings. Returns true while escaping.
+bool rescue_stuck_update(RescueStuck *s, const double *pose, bool flipped, bool driving, const double *ds);
+
+#endif // RESCUE_STUCK_H
@@ -0,0 +1,97 @@
+/*
+ * Description: Served-survivor registry (see rescue_survivors.h).
+ */
+
+#include "rescue_survivors.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SLOT_MASK (RESCUE_SURVIVOR_SLOTS - 1)
+
+static unsigned hash_u64(unsigned long long k) {
+  return (unsigned)((k * 0x9E3779B97F4A7C15ull) >> 40) & SLOT_MASK;
+}
+
+static long long cell_key(long long cx, long long cy) {
+  return (long long)(((unsigned long long)cx << 32) ^ (unsigned long long)(cy & 0xffffffffLL));
+}
+
+static long long cell_of(double v) { return (long long)floor(v / RESCUE_SURVIVOR_MERGE_RADIUS); }
+
+void rescue_survivors_init(RescueSurvivorRegistry *r) {
+  memset(r, 0, sizeof(*r));
+}
+
+bool rescue_survivor_estimate(const double *pose, double range, int sensor, double *x, double *y) {
+  if (!pose) return false;
+  double heading = pose[2];
+  double bearing = heading + rescue_ds_angle(sensor);
+  double sx = pose[0] + RESCUE_DS_MOUNT_OFFSET * cos(heading);
+  double sy = pose[1] + RESCUE_DS_MOUNT_OFFSET * sin(heading);
+  *x = sx + range * cos(bearing);
+  *y = sy + range * sin(bearing);
+  return true;
+}
+
+// --- Lookups ---
+
+static int find_id(const RescueSurvivorRegistry *r, int id, unsigned *slot_out) {
+  unsigned slot = hash_u64((unsigned long long)(unsigned)id);
+  while (r->id_slots[slot]) {
+    if (r->id[r->id_slots[slot] - 1] == id) return r->id_slots[slot] - 1;
+    slot = (slot + 1) & SLOT_MASK;
+  }
+  if (slot_out) *slot_out = slot;
+  return -1;
+}
+
+// Slot of a cell, or the empty slot where it would go.
+static unsigned find_cell(const RescueSurvivorRegistry *r, long long key) {
+  unsigned slot = hash_u64((unsigned long long)key);
+  while (r->cell_slots[slot] && r->cell_keys[slot] != key) slot = (slot + 1) & SLOT_MASK;
+  return slot;
+}
+
+bool rescue_survivors_served(const RescueSurvivorRegistry *r, int id, bool has_pos, double x, double y) {
+  if (r->count == 0) return false;
+  if (id >= 0 && find_id(r, id, NULL) >= 0) return true;
+  if (!has_pos) return false;
+
+  const double r2 = RESCUE_SURVIVOR_MERGE_RADIUS * RESCUE_SURVIVOR_MERGE_RADIUS;
+  long long cx = cell_of(x), cy = cell_of(y);
+  for (long long dy = -1; dy <= 1; ++dy) {
+    for (long long dx = -1; dx <= 1; ++dx) {
+      unsigned slot = find_cell(r, cell_key(cx + dx, cy + dy));
+      for (int e = r->cell_slots[slot] - 1; e >= 0; e = r->next_in_cell[e]) {
+        if (id >= 0 && r->id[e] >= 0) continue; // Both identified and different
+        double ex = r->x[e] - x, ey = r->y[e] - y;
+        if (ex * ex + ey * ey <= r2) return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool rescue_survivors_add(RescueSurvivorRegistry *r, int id, bool has_pos, double x, double y) {
+  if (id < 0 && !has_pos) return false;
+  if (r->count >= RESCUE_MAX_SURVIVORS) { r->dropped++; return false; }
+  unsigned id_slot = 0;
+  if (id >= 0 && find_id(r, id, &id_slot) >= 0) return true; // Already known
+
+  int e = r->count++;
+  r->id[e] = id;
+  r->has_pos[e] = has_pos;
+  r->x[e] = x;
+  r->y[e] = y;
+  r->next_in_cell[e] = -1;
+  if (id >= 0) r->id_slots[id_slot] = e + 1;
+  if (has_pos) {
+    long long key = cell_key(cell_of(x), cell_of(y));
+    unsigned slot = find_cell(r, key);
+    r->next_in_cell[e] = r->cell_slots[slot] - 1;
+    r->cell_keys[slot] = key;
+    r->cell_slots[slot] = e + 1;
+  }
+  return true;
+}
@@ -0,0 +1,54 @@
+/*
+ * Description: Registry of survivors that have already been served (aid
+ *              deployed, SURVIVOR_FOUND sent). A survivor is identified by
+ *              its node identity when the backend reports one and by its
+ *              estimated position (robot pose plus the sensor's range and
+ *              bearing) when the pose is known. Both checks are hash
+ *              lookups, so the recognition loop stays O(1) per sighting.
+ *              The controller treats served survivors as plain obstacles.
+ */
+
+#ifndef RESCUE_SURVIVORS_H
+#define RESCUE_SURVIVORS_H
+
+#include <stdbool.h>
+
+#include "rescue_hal.h"
+
+#define RESCUE_MAX_SURVIVORS 64
+#define RESCUE_SURVIVOR_MERGE_RADIUS 0.5 // Sightings closer than this to a served survivor are that survivor (meters)
+#define RESCUE_SURVIVOR_SLOTS 128        // Hash slots per table, power of two, > RESCUE_MAX_SURVIVORS
+
+typedef struct {
+  int count;
+  int id[RESCUE_MAX_SURVIVORS];          // -1 if unknown
+  bool has_pos[RESCUE_MAX_SURVIVORS];
+  double x[RESCUE_MAX_SURVIVORS], y[RESCUE_MAX_SURVIVORS];
+  int next_in_cell[RESCUE_MAX_SURVIVORS]; // Chain of survivors in the same position cell, -1 ends
+
+  // --- Hash Tables (open addressing, entry index + 1, 0 = empty) ---
+  int id_slots[RESCUE_SURVIVOR_SLOTS];
+  long long cell_keys[RESCUE_SURVIVOR_SLOTS];
+  int cell_slots[RESCUE_SURVIVOR_SLOTS];  // First survivor in the cell
+
+  // Statistics
+  unsigned long repeat_sightings;         // Sightings of served survivors that were ignored
+  unsigned long dropped;                  // Survivors not stored because the registry was full
+} RescueSurvivorRegistry;
+
+void rescue_survivors_init(RescueSurvivorRegistry *r);
+
+// Estimated position of the object seen by sensor i at the given range,
+// from the robot pose (x, y, heading). Returns false if pose is NULL.
+bool rescue_survivor_estimate(const double *pose, double range, int sensor, double *x, double *y);
+
+// True if the survivor with this identity (-1 = unknown) and/or position
+// has already been served. Sightings with different known identities are
+// never merged by position.
+bool rescue_survivors_served(const RescueSurvivorRegistry *r, int id, bool has_pos, double x, double y);
+
+// Records a served survivor. Returns false if there is nothing to identify
+// it by or the registry is full.
+bool rescue_survivors_add(RescueSurvivorRegistry *r, int id, bool has_pos, double x, double y);
+
+#endif // RESCUE_SURVIVORS_H
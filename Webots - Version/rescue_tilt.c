@@ -0,0 +1,93 @@
+/*
+ * Description: Tilt estimator (see rescue_tilt.h).
+ */
+
+#include "rescue_tilt.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ONE (1 << RESCUE_TILT_Q)
+#define LIMIT 100000.0 // Larger readings (m/s^2) are clipped before the conversion
+
+static int32_t to_q(double v) {
+  return (int32_t)lround(fmax(-LIMIT, fmin(LIMIT, v)) * ONE);
+}
+
+// est moved 1/2^shift of the way to meas (rounding toward zero either way).
+static int32_t blend(int32_t est, int32_t meas, int shift) {
+  return est + (meas - est) / (1 << shift);
+}
+
+void rescue_tilt_init(RescueTilt *t, double threshold) {
+  memset(t, 0, sizeof(*t));
+  t->threshold = threshold;
+  t->scale = 1.0;
+}
+
+void rescue_tilt_update(RescueTilt *t, const double accel[3], const double *gyro, int dt_ms) {
+  int32_t a[3] = {to_q(accel[0]), to_q(accel[1]), to_q(accel[2])};
+  int32_t *g = t->g;
+  if (!t->initialized) {
+    memcpy(g, a, sizeof(a));
+    t->initialized = true;
+  }
+
+  // --- Predict: gravity turns against the body's rotation, dg/dt = -w x g ---
+  t->gyro = gyro != NULL;
+  if (gyro) {
+    int32_t w[3] = {to_q(gyro[0]), to_q(gyro[1]), to_q(gyro[2])};
+    int64_t den = (int64_t)1000 << RESCUE_TILT_Q; // ms and the Q of w
+    int64_t cx = (int64_t)w[1] * g[2] - (int64_t)w[2] * g[1];
+    int64_t cy = (int64_t)w[2] * g[0] - (int64_t)w[0] * g[2];
+    int64_t cz = (int64_t)w[0] * g[1] - (int64_t)w[1] * g[0];
+    g[0] -= (int32_t)(cx * dt_ms / den);
+    g[1] -= (int32_t)(cy * dt_ms / den);
+    g[2] -= (int32_t)(cz * dt_ms / den);
+  }
+
+  // --- Correct: toward the sample, less when it is mostly motion ---
+  int64_t norm2 = (int64_t)a[0] * a[0] + (int64_t)a[1] * a[1] + (int64_t)a[2] * a[2];
+  int64_t low = to_q(RESCUE_TILT_G - RESCUE_TILT_GATE), high = to_q(RESCUE_TILT_G + RESCUE_TILT_GATE);
+  bool gated = norm2 < low * low || norm2 > high * high;
+  int shift = (gyro ? RESCUE_TILT_GYRO_SHIFT : RESCUE_TILT_SHIFT) + (gated ? RESCUE_TILT_GATE_SHIFT : 0);
+  for (int k = 0; k < 3; ++k) g[k] = blend(g[k], a[k], shift);
+
+  // --- Tilt, its rise and the risk ---
+  int32_t tilt = abs(g[0]) > abs(g[1]) ? abs(g[0]) : abs(g[1]);
+  t->rate_q = t->updates ? blend(t->rate_q, tilt - t->tilt_q, RESCUE_TILT_RATE_SHIFT) : 0;
+  t->tilt_q = tilt;
+  int32_t horizon = dt_ms > 0 ? (int32_t)(RESCUE_TILT_HORIZON * 1000.0) / dt_ms : 0; // Steps
+  int32_t halt_horizon = dt_ms > 0 ? (int32_t)(RESCUE_TILT_HALT_HORIZON * 1000.0) / dt_ms : 0;
+  int32_t start = to_q(RESCUE_TILT_RISK_START * t->threshold), threshold = to_q(t->threshold);
+  int32_t rise = t->rate_q > 0 ? t->rate_q : 0;
+  int64_t ahead = (int64_t)tilt + (int64_t)rise * horizon;
+  int64_t risk = threshold > start ? (ahead - start) * ONE / (threshold - start) : (ahead >= threshold) * ONE;
+  risk = risk < 0 ? 0 : risk > ONE ? ONE : risk;
+  int32_t scale = ONE - (int32_t)(risk * (ONE - to_q(RESCUE_TILT_MIN_SCALE)) / ONE);
+
+  t->tilt = (double)tilt / ONE;
+  t->halt = (double)((int64_t)tilt + (gyro ? 0 : (int64_t)rise * halt_horizon)) / ONE;
+  t->risk = (double)risk / ONE;
+  t->scale = (double)scale / ONE;
+  t->updates++;
+  t->gated += gated;
+  t->slowed += scale < ONE;
+  t->scale_sum += t->scale;
+  if (t->tilt > t->max_tilt) t->max_tilt = t->tilt;
+}
+
+void rescue_tilt_angles(const RescueTilt *t, double *roll, double *pitch) {
+  double gx = t->g[0], gy = t->g[1], gz = t->g[2];
+  *roll = atan2(gy, gz);
+  *pitch = atan2(gx, sqrt(gy * gy + gz * gz));
+}
+
+void rescue_tilt_apply(const RescueTilt *t, double *left_speed, double *right_speed) {
+  double forward = (*left_speed + *right_speed) / 2.0, turn = (*right_speed - *left_speed) / 2.0;
+  if (forward <= 0.0) return;
+  forward *= t->scale;
+  *left_speed = forward - turn;
+  *right_speed = forward + turn;
+}
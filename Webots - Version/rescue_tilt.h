@@ -0,0 +1,90 @@
+/*
+ * Description: Tilt estimator. A single accelerometer sample is gravity
+ *              plus whatever the robot is doing: starting, stopping and
+ *              bumps over rubble all add to it, and checked raw against
+ *              TILT_THRESHOLD they halt the robot on level ground.
+ *
+ *              The estimator keeps gravity in the body frame as a
+ *              complementary filter. With a gyro, gravity is turned by the
+ *              measured rotation every step and the accelerometer only pulls
+ *              it back by 1/2^RESCUE_TILT_GYRO_SHIFT, so it corrects the
+ *              drift and not the shape; without one the accelerometer is
+ *              averaged in by 1/2^RESCUE_TILT_SHIFT. A sample whose length is
+ *              more than RESCUE_TILT_GATE from g is mostly motion and weighs
+ *              RESCUE_TILT_GATE_SHIFT halvings less. Everything in the loop
+ *              is integer: Q10 m/s^2, shifts instead of weights and one
+ *              64-bit product for the rotation, so it runs as is on a
+ *              microcontroller without a floating-point unit.
+ *
+ *              The tilt is the larger of the two horizontal components of
+ *              gravity (the same measure TILT_THRESHOLD has always been);
+ *              roll and pitch come from it for display. The risk adds
+ *              RESCUE_TILT_HORIZON seconds of the tilt's rise to it and
+ *              rises from 0 at RESCUE_TILT_RISK_START of the threshold to 1
+ *              at the threshold; the speed scale falls with it to
+ *              RESCUE_TILT_MIN_SCALE, so the robot slows down on a steepening
+ *              slope before it would have to stop.
+ *
+ *              Averaging lags: without a gyro the estimate trails a
+ *              steepening slope by a few steps, and the confirmation of
+ *              the halt adds more. The halt is therefore decided on the
+ *              tilt plus RESCUE_TILT_HALT_HORIZON seconds of its rise, which
+ *              stops the robot about where a raw sample would have. With a
+ *              gyro the estimate turns with the body and is decided on as
+ *              it is.
+ */
+
+#ifndef RESCUE_TILT_H
+#define RESCUE_TILT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RESCUE_TILT_Q 10                  // Fixed point: 1/1024 m/s^2
+#define RESCUE_TILT_G 9.81                // Gravity (m/s^2)
+#define RESCUE_TILT_SHIFT 2               // Accelerometer weight without a gyro: 1/4 per step ...
+#define RESCUE_TILT_GYRO_SHIFT 5          // ... and with one: 1/32
+#define RESCUE_TILT_GATE 1.5              // Samples this far from g (m/s^2) ...
+#define RESCUE_TILT_GATE_SHIFT 2          // ... weigh a quarter of that
+#define RESCUE_TILT_RISK_START 0.6        // Share of the threshold where the risk starts rising
+#define RESCUE_TILT_HORIZON 1.0           // Seconds of the tilt's rise added to the risk
+#define RESCUE_TILT_RATE_SHIFT 2          // Smoothing of the rise: 1/4 of the newest step
+#define RESCUE_TILT_MIN_SCALE 0.3         // Speed left at full risk
+#define RESCUE_TILT_HALT_HORIZON 0.25     // Seconds of the rise the halt looks ahead without a gyro
+
+typedef struct {
+  double threshold;                       // Tilt (m/s^2) the robot must not exceed
+  // --- Filter State (Q10) ---
+  int32_t g[3];                           // Gravity in the body frame
+  int32_t tilt_q;                         // max(|g x|, |g y|)
+  int32_t rate_q;                         // Smoothed rise of the tilt per step
+  bool initialized;
+  // --- This Step ---
+  double tilt;                            // m/s^2
+  double halt;                            // Tilt the halt is decided on (m/s^2)
+  double risk;                            // 0 .. 1
+  double scale;                           // RESCUE_TILT_MIN_SCALE .. 1
+  bool gyro;                              // The last update used a gyro
+  // Statistics
+  unsigned long updates;
+  unsigned long gated;                    // Samples weighed down as motion
+  unsigned long slowed;                   // Steps with scale below 1
+  double scale_sum;
+  double max_tilt;
+} RescueTilt;
+
+// Starts without history; threshold: the tilt the risk reaches 1 at.
+void rescue_tilt_init(RescueTilt *t, double threshold);
+
+// Folds in one accelerometer sample (m/s^2) and, if gyro is not NULL, the
+// rotation rates (rad/s) over dt_ms since the last update.
+void rescue_tilt_update(RescueTilt *t, const double accel[3], const double *gyro, int dt_ms);
+
+// Roll and pitch (rad) of the estimate.
+void rescue_tilt_angles(const RescueTilt *t, double *roll, double *pitch);
+
+// Scales the forward part of a wheel command by the speed scale; turns on
+// the spot and reversing are left as they are.
+void rescue_tilt_apply(const RescueTilt *t, double *left_speed, double *right_speed);
+
+#endif // RESCUE_TILT_H
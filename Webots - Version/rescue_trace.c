@@ -0,0 +1,93 @@
+/*
+ * Description: Flight recorder for the rescue controller (see rescue_trace.h).
+ */
+
+#include "rescue_trace.h"
+
+#include <string.h>
+
+#define TRACE_BUFFER_SIZE (1 << 16) // stdio buffer, 512 records
+
+_Static_assert(sizeof(RescueTraceRecord) == 152, "trace record layout changed");
+_Static_assert(sizeof(RescueTraceHeader) == 32, "trace header layout changed");
+
+bool rescue_trace_open(RescueTraceWriter *w, const char *path, int time_step, uint32_t config, const double *map_center) {
+  w->records = 0;
+  w->failed = false;
+  w->file = fopen(path, "wb");
+  if (!w->file) return false;
+  setvbuf(w->file, NULL, _IOFBF, TRACE_BUFFER_SIZE);
+
+  RescueTraceHeader h = {RESCUE_TRACE_MAGIC, RESCUE_TRACE_VERSION, sizeof(RescueTraceRecord), (uint32_t)time_step, config,
+                         {0.0, 0.0}};
+  if (map_center) {
+    h.config |= RESCUE_TRACE_CONFIG_MAP_CENTER;
+    h.map_center[0] = map_center[0];
+    h.map_center[1] = map_center[1];
+  }
+  if (fwrite(&h, sizeof(h), 1, w->file) != 1) w->failed = true;
+  return true;
+}
+
+void rescue_trace_pack(RescueTraceRecord *r, const RescueInputs *in, const RescueOutputs *out, int state) {
+  memset(r, 0, sizeof(*r));
+  r->time = in->time;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    r->ds[i] = in->ds[i];
+    if (in->ds_present[i]) r->flags |= RESCUE_TRACE_DS_PRESENT(i);
+    if (in->survivor_seen[i]) r->flags |= RESCUE_TRACE_SURVIVOR(i);
+    r->survivor_id[i] = in->survivor_id[i];
+  }
+  if (in->has_accel) r->flags |= RESCUE_TRACE_HAS_ACCEL;
+  memcpy(r->accel, in->accel, sizeof(r->accel));
+  if (in->has_gyro) r->flags |= RESCUE_TRACE_HAS_GYRO;
+  memcpy(r->gyro, in->gyro, sizeof(r->gyro));
+  if (in->has_pose) r->flags |= RESCUE_TRACE_HAS_POSE;
+  memcpy(r->pose, in->pose, sizeof(r->pose));
+  if (in->has_wheels) r->flags |= RESCUE_TRACE_HAS_WHEELS;
+  memcpy(r->wheel, in->wheel, sizeof(r->wheel));
+
+  r->left_speed = out->left_speed;
+  r->right_speed = out->right_speed;
+  if (out->message) r->flags |= RESCUE_TRACE_MESSAGE;
+  r->state = (uint8_t)state;
+  for (int i = 0; i < RESCUE_NUM_LEDS; ++i) r->led |= (uint8_t)((out->led[i] != 0) << i);
+}
+
+void rescue_trace_append(RescueTraceWriter *w, const RescueInputs *in, const RescueOutputs *out, int state) {
+  if (!w->file || w->failed) return;
+  RescueTraceRecord r;
+  rescue_trace_pack(&r, in, out, state);
+  if (fwrite(&r, sizeof(r), 1, w->file) != 1) { w->failed = true; return; }
+  w->records++;
+}
+
+void rescue_trace_close(RescueTraceWriter *w) {
+  if (!w->file) return;
+  if (fclose(w->file) != 0) w->failed = true;
+  w->file = NULL;
+}
+
+bool rescue_trace_check_header(const RescueTraceHeader *h) {
+  return h->magic == RESCUE_TRACE_MAGIC && h->version == RESCUE_TRACE_VERSION &&
+         h->record_size == sizeof(RescueTraceRecord);
+}
+
+void rescue_trace_inputs(const RescueTraceRecord *r, RescueInputs *in) {
+  in->time = r->time;
+  for (int i = 0; i < RESCUE_NUM_DS; ++i) {
+    in->ds[i] = r->ds[i];
+    in->ds_present[i] = (r->flags & RESCUE_TRACE_DS_PRESENT(i)) != 0;
+    in->survivor_seen[i] = (r->flags & RESCUE_TRACE_SURVIVOR(i)) != 0;
+    in->survivor_id[i] = r->survivor_id[i];
+  }
+  in->has_accel = (r->flags & RESCUE_TRACE_HAS_ACCEL) != 0;
+  memcpy(in->accel, r->accel, sizeof(in->accel));
+  in->has_gyro = (r->flags & RESCUE_TRACE_HAS_GYRO) != 0;
+  memcpy(in->gyro, r->gyro, sizeof(in->gyro));
+  in->has_pose = (r->flags & RESCUE_TRACE_HAS_POSE) != 0;
+  memcpy(in->pose, r->pose, sizeof(in->pose));
+  in->has_wheels = (r->flags & RESCUE_TRACE_HAS_WHEELS) != 0;
+  memcpy(in->wheel, r->wheel, sizeof(in->wheel));
+  in->num_ranges = 0; // Range sensors beyond the three ds are not recorded
+}
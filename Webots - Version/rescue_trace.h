@@ -0,0 +1,98 @@
+/*
+ * Description: Flight recorder for the rescue controller. Appends every
+ *              control step's raw inputs (distances, recognition hits and
+ *              identities, accelerometer, gyro, pose, wheel sensors, sim time)
+ *              and the resulting commands to a binary trace, so a run can
+ *              be replayed offline through the same controller code
+ *              (headless/replay.c) and compared bit for bit.
+ *
+ *              File layout: one RescueTraceHeader followed by fixed-size
+ *              RescueTraceRecords, all little-endian as written by the host.
+ *              A run that is cut short leaves a partial last record, which
+ *              readers ignore.
+ */
+
+#ifndef RESCUE_TRACE_H
+#define RESCUE_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "rescue_hal.h"
+
+#define RESCUE_TRACE_MAGIC 0x43525452u // "RTRC"
+#define RESCUE_TRACE_VERSION 5
+
+// --- Record Flags ---
+#define RESCUE_TRACE_DS_PRESENT(i) (1u << (i))       // Bits 0-2
+#define RESCUE_TRACE_SURVIVOR(i) (1u << (3 + (i)))   // Bits 3-5
+#define RESCUE_TRACE_HAS_ACCEL (1u << 6)
+#define RESCUE_TRACE_MESSAGE (1u << 7)               // The step emitted SURVIVOR_MESSAGE
+#define RESCUE_TRACE_HAS_POSE (1u << 8)
+#define RESCUE_TRACE_HAS_WHEELS (1u << 9)
+#define RESCUE_TRACE_HAS_GYRO (1u << 10)
+
+// --- Header Config: controller features that change its decisions ---
+#define RESCUE_TRACE_CONFIG_EXPLORE (1u << 0)  // Occupancy grid and frontier exploration
+#define RESCUE_TRACE_CONFIG_PLAN (1u << 1)     // Incremental path planner, expansion budget only
+#define RESCUE_TRACE_CONFIG_ANYTIME (1u << 2)  // The planner in anytime mode, from PLAN_EPSILON
+#define RESCUE_TRACE_CONFIG_VFH (1u << 3)      // Polar-histogram avoidance on the three ds (a wider
+                                               // range sensor layout is not recorded)
+#define RESCUE_TRACE_CONFIG_DWA (1u << 4)      // Dynamic window wheel speeds (rescue_dwa.h)
+#define RESCUE_TRACE_CONFIG_SPEED (1u << 5)    // Time-to-collision speed governor (rescue_speed.h)
+#define RESCUE_TRACE_CONFIG_STUCK (1u << 6)    // Stuck detector and escapes (rescue_stuck.h)
+#define RESCUE_TRACE_CONFIG_TRIGGERS (1u << 7) // Debounced state triggers (rescue_trigger.h)
+#define RESCUE_TRACE_CONFIG_MISSION (1u << 8)  // Mission behavior tree, leaf-call budget only (rescue_mission.h)
+#define RESCUE_TRACE_CONFIG_SCHEDULE (1u << 9) // Multi-rate tasks, one record per tick (rescue_schedule.h)
+#define RESCUE_TRACE_CONFIG_RECOGNITION (1u << 10) // Decimated recognition, records hold the results used (rescue_recognition.h)
+#define RESCUE_TRACE_CONFIG_TILT (1u << 11)        // Tilt estimator and its slow-down (rescue_tilt.h)
+#define RESCUE_TRACE_CONFIG_MAP_CENTER (1u << 12)  // The map was centered on map_center, not the first pose
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;   // sizeof(RescueTraceRecord) of the writer
+  uint32_t time_step;     // Control period (ms), the tick with RESCUE_TRACE_CONFIG_SCHEDULE
+  uint32_t config;        // RESCUE_TRACE_CONFIG_* bits; replay sets the controller up the same way
+  double map_center[2];   // With RESCUE_TRACE_CONFIG_MAP_CENTER (rescue_map_center)
+} RescueTraceHeader;
+
+// One control step. Inputs first, then the commands the controller produced.
+typedef struct {
+  double time;
+  double ds[RESCUE_NUM_DS];
+  double accel[3];
+  double gyro[3];
+  double pose[3];
+  double wheel[2];
+  double left_speed;
+  double right_speed;
+  int32_t survivor_id[RESCUE_NUM_DS];
+  uint16_t flags;
+  uint8_t state;          // RobotState after the step
+  uint8_t led;            // Bit i = LED i
+} RescueTraceRecord;      // 152 bytes
+
+typedef struct {
+  FILE *file;
+  long records;
+  bool failed;            // A write failed; recording stopped
+} RescueTraceWriter;
+
+// Creates (truncates) the trace file. map_center: where the map was centered,
+// NULL if on the first pose. Returns false if it cannot be opened.
+bool rescue_trace_open(RescueTraceWriter *w, const char *path, int time_step, uint32_t config, const double *map_center);
+void rescue_trace_append(RescueTraceWriter *w, const RescueInputs *in, const RescueOutputs *out, int state);
+void rescue_trace_close(RescueTraceWriter *w);
+
+// Returns false if the header is not a trace this build can read.
+bool rescue_trace_check_header(const RescueTraceHeader *h);
+
+// Rebuilds the controller inputs stored in a record.
+void rescue_trace_inputs(const RescueTraceRecord *r, RescueInputs *in);
+
+// Packs a step into a record; replay uses it to compare bit for bit.
+void rescue_trace_pack(RescueTraceRecord *r, const RescueInputs *in, const RescueOutputs *out, int state);
+
+#endif // RESCUE_TRACE_H
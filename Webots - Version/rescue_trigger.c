@@ -0,0 +1,56 @@
+/*
+ * Description: Debounced triggers (see rescue_trigger.h).
+ */
+
+#include "rescue_trigger.h"
+
+#include <string.h>
+
+void rescue_trigger_init(RescueTrigger *t, const RescueTriggerConfig *config) {
+  memset(t, 0, sizeof(*t));
+  t->config = *config;
+  if (t->config.m < 1) t->config.m = 1;
+  if (t->config.m > RESCUE_TRIGGER_MAX_M) t->config.m = RESCUE_TRIGGER_MAX_M;
+  if (t->config.n < 1) t->config.n = 1;
+  if (t->config.n > t->config.m) t->config.n = t->config.m;
+  if (t->config.enter_n < 1) t->config.enter_n = 1;
+  if (t->config.enter_n > t->config.m) t->config.enter_n = t->config.m;
+}
+
+// Whether value is past threshold in the trigger's direction.
+static bool past(const RescueTrigger *t, double value, double threshold) {
+  return t->config.below ? value < threshold : value > threshold;
+}
+
+bool rescue_trigger_update(RescueTrigger *t, double value) {
+  const RescueTriggerConfig *cfg = &t->config;
+  bool raw = past(t, value, cfg->enter);
+  t->raw_changes += raw != t->raw;
+  t->raw = raw;
+  t->samples++;
+
+  // Off: a vote to change is a sample past enter; on: one that is no longer past exit
+  unsigned char vote = t->on ? !past(t, value, cfg->exit) : raw;
+  if (t->count == cfg->m) t->agree -= t->votes[t->head];
+  else t->count++;
+  t->votes[t->head] = vote;
+  t->agree += vote;
+  t->head = (t->head + 1) % cfg->m;
+  if (t->agree >= (t->on ? cfg->n : cfg->enter_n)) {
+    t->on = !t->on;
+    t->changes++;
+    t->head = t->count = t->agree = 0;
+  }
+  return t->on;
+}
+
+void rescue_trigger_set(RescueTrigger *t, bool on) {
+  if (t->on == on) return;
+  t->on = on;
+  t->changes++;
+  t->head = t->count = t->agree = 0;
+}
+
+unsigned long rescue_trigger_suppressed(const RescueTrigger *t) {
+  return t->raw_changes > t->changes ? t->raw_changes - t->changes : 0;
+}
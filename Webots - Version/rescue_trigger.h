@@ -0,0 +1,72 @@
+/*
+ * Description: Debounced triggers. A single reading near a threshold (a
+ *              front distance of OBSTACLE_DISTANCE_THRESHOLD give or take
+ *              the sensor noise) flips a plain comparison back and forth
+ *              from one step to the next, and with it the state machine. A
+ *              trigger turns a stream of readings into an on/off decision
+ *              that changes only when the readings mean it:
+ *
+ *              - Hysteresis: it turns on past the enter threshold and off
+ *                again only past the exit threshold, further out.
+ *              - N-of-M confirmation: a sample past the threshold for the
+ *                other state is a vote for changing; the trigger turns on
+ *                once enter_n of the last m samples voted for it and off
+ *                once n did, and then starts counting afresh. An enter_n of
+ *                1 turns it on with the first sample past enter, for
+ *                triggers where reacting late costs more than a spurious
+ *                change (an obstacle ahead), and keeps the confirmation for
+ *                letting go.
+ *
+ *              The votes are kept in a ring of RESCUE_TRIGGER_MAX_M entries
+ *              inside the trigger, so a trigger needs no allocation and a
+ *              sample costs the same whatever m is. Each trigger counts how
+ *              often the plain enter-threshold test changed its answer and
+ *              how often the trigger did; the difference is the transitions
+ *              it suppressed.
+ */
+
+#ifndef RESCUE_TRIGGER_H
+#define RESCUE_TRIGGER_H
+
+#include <stdbool.h>
+
+#define RESCUE_TRIGGER_MAX_M 16            // Longest confirmation window (samples)
+
+typedef struct {
+  double enter;                            // Turns on past this ...
+  double exit;                             // ... and off again past this one
+  bool below;                              // On below enter (distances), else above it (accelerations)
+  int enter_n;                             // enter_n of the last m samples turn it on ...
+  int n, m;                                // ... and n of them off, 1 <= enter_n, n <= m <= RESCUE_TRIGGER_MAX_M
+} RescueTriggerConfig;
+
+typedef struct {
+  RescueTriggerConfig config;
+  unsigned char votes[RESCUE_TRIGGER_MAX_M]; // Ring of the last m samples: 1 if it voted for changing
+  int head;                                // Where the next vote goes
+  int count;                               // Votes in the ring, up to m
+  int agree;                               // Sum of the votes
+  bool on;                                 // The debounced decision
+  bool raw;                                // The enter threshold alone on the last sample
+  // Statistics
+  unsigned long samples;
+  unsigned long raw_changes;               // Changes of raw
+  unsigned long changes;                   // Changes of on
+} RescueTrigger;
+
+// Off with no votes; config is copied and enter_n, n, m clamped into range.
+void rescue_trigger_init(RescueTrigger *t, const RescueTriggerConfig *config);
+
+// Takes one sample (INFINITY, or any value that does not pass enter, for
+// "nothing there") and returns the decision.
+bool rescue_trigger_update(RescueTrigger *t, double value);
+
+// Turns the trigger on or off without samples (e.g. when a copy sampled
+// more often confirmed first) and starts counting afresh; nothing if it
+// already is.
+void rescue_trigger_set(RescueTrigger *t, bool on);
+
+// Changes of the plain threshold test the trigger did not follow.
+unsigned long rescue_trigger_suppressed(const RescueTrigger *t);
+
+#endif // RESCUE_TRIGGER_H
@@ -0,0 +1,290 @@
+/*
+ * Description: Polar-histogram obstacle avoidance (see rescue_vfh.h).
+ */
+
+#include "rescue_vfh.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define RESCUE_VFH_KERNEL "avx"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define RESCUE_VFH_KERNEL "sse2"
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define RESCUE_VFH_KERNEL "neon"
+#else
+#define RESCUE_VFH_KERNEL "scalar"
+#endif
+
+#define SECTORS RESCUE_VFH_SECTORS
+#define SECTOR_ANGLE ((float)(2.0 * M_PI / SECTORS))
+#define TWO_PI ((float)(2.0 * M_PI))
+#define HIGH ((float)RESCUE_VFH_HIGH)
+#define LOW ((float)RESCUE_VFH_LOW)
+
+const char *rescue_vfh_simd_name(void) { return RESCUE_VFH_KERNEL; }
+
+void rescue_vfh_init(RescueVfh *v) {
+  memset(v, 0, sizeof(*v));
+  v->simd = strcmp(RESCUE_VFH_KERNEL, "scalar") != 0;
+  v->previous = -1;
+  v->speed = 1.0;
+}
+
+// --- Histogram Kernels ---
+// polar[k] is the largest weight of the points whose enlarged sector range
+// takes in sector k's direction; binary follows polar with the two
+// thresholds; edges marks the sectors that differ from the one before.
+
+static void histogram_scalar(RescueVfh *v) {
+  float *blocked = v->binary + 1;
+  for (int k = 0; k < SECTORS; ++k) {
+    float theta = (float)k * SECTOR_ANGLE, h = 0.0f;
+    for (int i = 0; i < v->num_points; ++i) {
+      float d = fabsf(theta - v->bearing[i]);
+      d = fminf(d, TWO_PI - d);
+      float w = d <= v->spread[i] ? v->weight[i] : 0.0f;
+      h = w > h ? w : h;
+    }
+    v->polar[k] = h;
+    blocked[k] = h > HIGH ? 1.0f : h < LOW ? 0.0f : blocked[k];
+  }
+  v->binary[0] = blocked[SECTORS - 1];
+  v->edges[0] = v->edges[1] = 0;
+  for (int k = 0; k < SECTORS; ++k)
+    if (blocked[k] != v->binary[k]) v->edges[k >> 6] |= 1ull << (k & 63);
+}
+
+#if defined(__AVX__)
+static void histogram_simd(RescueVfh *v) {
+  const __m256 sector = _mm256_set1_ps(SECTOR_ANGLE), two_pi = _mm256_set1_ps(TWO_PI), sign = _mm256_set1_ps(-0.0f);
+  const __m256 high = _mm256_set1_ps(HIGH), low = _mm256_set1_ps(LOW), one = _mm256_set1_ps(1.0f);
+  float *blocked = v->binary + 1;
+  for (int k = 0; k < SECTORS; k += 8) {
+    __m256 theta = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_setr_epi32(k, k + 1, k + 2, k + 3, k + 4, k + 5, k + 6, k + 7)),
+                                 sector);
+    __m256 h = _mm256_setzero_ps();
+    for (int i = 0; i < v->num_points; ++i) {
+      __m256 d = _mm256_andnot_ps(sign, _mm256_sub_ps(theta, _mm256_set1_ps(v->bearing[i])));
+      d = _mm256_min_ps(d, _mm256_sub_ps(two_pi, d));
+      __m256 in = _mm256_cmp_ps(d, _mm256_set1_ps(v->spread[i]), _CMP_LE_OQ);
+      h = _mm256_max_ps(h, _mm256_and_ps(in, _mm256_set1_ps(v->weight[i])));
+    }
+    _mm256_storeu_ps(v->polar + k, h);
+    __m256 prev = _mm256_loadu_ps(blocked + k);
+    __m256 b = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(h, high, _CMP_GT_OQ), one),
+                            _mm256_andnot_ps(_mm256_cmp_ps(h, low, _CMP_LT_OQ), prev));
+    _mm256_storeu_ps(blocked + k, b);
+  }
+  v->binary[0] = blocked[SECTORS - 1];
+  v->edges[0] = v->edges[1] = 0;
+  for (int k = 0; k < SECTORS; k += 8) {
+    __m256 diff = _mm256_cmp_ps(_mm256_loadu_ps(blocked + k), _mm256_loadu_ps(v->binary + k), _CMP_NEQ_UQ);
+    v->edges[k >> 6] |= (uint64_t)(unsigned)_mm256_movemask_ps(diff) << (k & 63);
+  }
+}
+#elif defined(__SSE2__)
+static void histogram_simd(RescueVfh *v) {
+  const __m128 sector = _mm_set1_ps(SECTOR_ANGLE), two_pi = _mm_set1_ps(TWO_PI), sign = _mm_set1_ps(-0.0f);
+  const __m128 high = _mm_set1_ps(HIGH), low = _mm_set1_ps(LOW), one = _mm_set1_ps(1.0f);
+  float *blocked = v->binary + 1;
+  for (int k = 0; k < SECTORS; k += 4) {
+    __m128 theta = _mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(k, k + 1, k + 2, k + 3)), sector);
+    __m128 h = _mm_setzero_ps();
+    for (int i = 0; i < v->num_points; ++i) {
+      __m128 d = _mm_andnot_ps(sign, _mm_sub_ps(theta, _mm_set1_ps(v->bearing[i])));
+      d = _mm_min_ps(d, _mm_sub_ps(two_pi, d));
+      __m128 in = _mm_cmple_ps(d, _mm_set1_ps(v->spread[i]));
+      h = _mm_max_ps(h, _mm_and_ps(in, _mm_set1_ps(v->weight[i])));
+    }
+    _mm_storeu_ps(v->polar + k, h);
+    __m128 prev = _mm_loadu_ps(blocked + k);
+    __m128 b = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(h, high), one), _mm_andnot_ps(_mm_cmplt_ps(h, low), prev));
+    _mm_storeu_ps(blocked + k, b);
+  }
+  v->binary[0] = blocked[SECTORS - 1];
+  v->edges[0] = v->edges[1] = 0;
+  for (int k = 0; k < SECTORS; k += 4) {
+    __m128 diff = _mm_cmpneq_ps(_mm_loadu_ps(blocked + k), _mm_loadu_ps(v->binary + k));
+    v->edges[k >> 6] |= (uint64_t)(unsigned)_mm_movemask_ps(diff) << (k & 63);
+  }
+}
+#elif defined(__ARM_NEON)
+static void histogram_simd(RescueVfh *v) {
+  const float32x4_t sector = vdupq_n_f32(SECTOR_ANGLE), two_pi = vdupq_n_f32(TWO_PI);
+  const float32x4_t high = vdupq_n_f32(HIGH), low = vdupq_n_f32(LOW), one = vdupq_n_f32(1.0f), zero = vdupq_n_f32(0.0f);
+  const int32_t lane[4] = {0, 1, 2, 3};
+  const uint32_t lane_bit[4] = {1, 2, 4, 8};
+  const int32x4_t lanes = vld1q_s32(lane);
+  const uint32x4_t lane_bits = vld1q_u32(lane_bit);
+  float *blocked = v->binary + 1;
+  for (int k = 0; k < SECTORS; k += 4) {
+    float32x4_t theta = vmulq_f32(vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(k), lanes)), sector);
+    float32x4_t h = zero;
+    for (int i = 0; i < v->num_points; ++i) {
+      float32x4_t d = vabsq_f32(vsubq_f32(theta, vdupq_n_f32(v->bearing[i])));
+      d = vminq_f32(d, vsubq_f32(two_pi, d));
+      uint32x4_t in = vcleq_f32(d, vdupq_n_f32(v->spread[i]));
+      h = vmaxq_f32(h, vbslq_f32(in, vdupq_n_f32(v->weight[i]), zero));
+    }
+    vst1q_f32(v->polar + k, h);
+    float32x4_t prev = vld1q_f32(blocked + k);
+    vst1q_f32(blocked + k, vbslq_f32(vcgtq_f32(h, high), one, vbslq_f32(vcltq_f32(h, low), zero, prev)));
+  }
+  v->binary[0] = blocked[SECTORS - 1];
+  v->edges[0] = v->edges[1] = 0;
+  for (int k = 0; k < SECTORS; k += 4) {
+    uint32x4_t diff = vmvnq_u32(vceqq_f32(vld1q_f32(blocked + k), vld1q_f32(v->binary + k)));
+    v->edges[k >> 6] |= (uint64_t)vaddvq_u32(vandq_u32(diff, lane_bits)) << (k & 63);
+  }
+}
+#else
+#define histogram_simd histogram_scalar
+#endif
+
+void rescue_vfh_histogram(RescueVfh *v) {
+  if (v->simd) histogram_simd(v);
+  else histogram_scalar(v);
+}
+
+// --- Obstacle Points ---
+
+// Stores the hits of this step in the oldest slot, then brings every stored
+// point within RESCUE_VFH_RANGE into the robot's frame.
+static void gather_points(RescueVfh *v, const double *pose, const double *range, const double *angle, int count) {
+  double c = cos(pose[2]), s = sin(pose[2]);
+  double ox = pose[0] + RESCUE_DS_MOUNT_OFFSET * c, oy = pose[1] + RESCUE_DS_MOUNT_OFFSET * s;
+  float *px = v->point_x + v->slot * RESCUE_MAX_RANGES, *py = v->point_y + v->slot * RESCUE_MAX_RANGES;
+  int n = 0;
+  if (count > RESCUE_MAX_RANGES) count = RESCUE_MAX_RANGES;
+  for (int i = 0; i < count; ++i) {
+    if (!(range[i] < RESCUE_VFH_RANGE)) continue; // Nothing in reach (or no reading)
+    double a = pose[2] + angle[i];
+    px[n] = (float)(ox + range[i] * cos(a));
+    py[n] = (float)(oy + range[i] * sin(a));
+    n++;
+  }
+  v->slot_points[v->slot] = n;
+  v->slot = (v->slot + 1) % RESCUE_VFH_MEMORY;
+
+  int m = 0;
+  for (int slot = 0; slot < RESCUE_VFH_MEMORY; ++slot) {
+    const float *sx = v->point_x + slot * RESCUE_MAX_RANGES, *sy = v->point_y + slot * RESCUE_MAX_RANGES;
+    for (int i = 0; i < v->slot_points[slot]; ++i) {
+      double dx = sx[i] - pose[0], dy = sy[i] - pose[1];
+      double d = hypot(dx, dy);
+      if (d >= RESCUE_VFH_RANGE) continue;
+      double b = atan2(dy, dx) - pose[2];
+      b -= 2.0 * M_PI * floor(b / (2.0 * M_PI));
+      v->bearing[m] = (float)b;
+      v->spread[m] = (float)(d > RESCUE_VFH_CLEARANCE ? asin(RESCUE_VFH_CLEARANCE / d) : M_PI / 2.0);
+      v->weight[m] = (float)(RESCUE_VFH_RANGE - d);
+      m++;
+    }
+  }
+  v->num_points = m;
+}
+
+// --- Valley Search ---
+
+static int sector_distance(int a, int b) {
+  int d = abs(a - b) % SECTORS;
+  return d < SECTORS - d ? d : SECTORS - d;
+}
+
+static double candidate_cost(const RescueVfh *v, int c, int target) {
+  double cost = RESCUE_VFH_TARGET_COST * sector_distance(c, target) + RESCUE_VFH_HEADING_COST * sector_distance(c, 0);
+  if (v->previous >= 0) cost += RESCUE_VFH_PREVIOUS_COST * sector_distance(c, v->previous);
+  return cost;
+}
+
+// Index of the lowest set bit of v (not 0).
+static inline int lowest_bit(uint64_t v) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(v);
+#else
+  int i = 0;
+  for (; !(v & 1); v >>= 1) ++i;
+  return i;
+#endif
+}
+
+// Walks the valleys between the edges and returns the best candidate
+// sector, -1 if every sector is blocked. *on_target: the target sector won.
+static int choose_sector(const RescueVfh *v, int target, bool *on_target) {
+  const float *blocked = v->binary + 1;
+  int edge[SECTORS], num_edges = 0;
+  for (int w = 0; w < 2; ++w)
+    for (uint64_t bits = v->edges[w]; bits; bits &= bits - 1) edge[num_edges++] = w * 64 + lowest_bit(bits);
+  *on_target = false;
+  if (!num_edges) {
+    *on_target = blocked[0] == 0.0f;
+    return *on_target ? target : -1; // Open all round, or no way out
+  }
+
+  int best = -1;
+  double best_cost = INFINITY;
+  for (int j = 0; j < num_edges; ++j) {
+    int start = edge[j];
+    if (blocked[start] != 0.0f) continue; // A blocked run starts here
+    int width = (edge[(j + 1) % num_edges] - start + SECTORS) % SECTORS;
+    int candidate[3], n = 0;
+    bool target_inside = (target - start + SECTORS) % SECTORS < width;
+    if (width >= RESCUE_VFH_WIDE) {
+      candidate[n++] = (start + RESCUE_VFH_WIDE / 2) % SECTORS;
+      candidate[n++] = (start + width - 1 - RESCUE_VFH_WIDE / 2) % SECTORS;
+      if (target_inside) candidate[n++] = target;
+    } else {
+      candidate[n++] = (start + (width - 1) / 2) % SECTORS;
+    }
+    for (int i = 0; i < n; ++i) {
+      double cost = candidate_cost(v, candidate[i], target);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = candidate[i];
+        *on_target = target_inside && candidate[i] == target;
+      }
+    }
+  }
+  return best;
+}
+
+void rescue_vfh_update(RescueVfh *v, const double *pose, const double *range, const double *angle, int count,
+                       double target) {
+  gather_points(v, pose, range, angle, count);
+  rescue_vfh_histogram(v);
+  v->updates++;
+
+  target = atan2(sin(target), cos(target));
+  int target_sector = ((int)lround(target / SECTOR_ANGLE) + SECTORS) % SECTORS;
+  bool on_target;
+  int sector = choose_sector(v, target_sector, &on_target);
+  int turn = v->turn;
+  v->blocked = sector < 0;
+  if (v->blocked) {
+    // Nowhere to go: keep turning the same way until a valley opens up
+    v->blocked_steps++;
+    if (!turn) turn = v->direction < 0.0 ? -1 : 1;
+    v->direction = turn * M_PI / 2.0;
+    v->speed = 0.0;
+  } else {
+    v->direction = on_target ? target : (sector <= SECTORS / 2 ? sector : sector - SECTORS) * SECTOR_ANGLE;
+    float h = v->polar[sector] > v->polar[0] ? v->polar[sector] : v->polar[0];
+    v->speed = fmax(RESCUE_VFH_MIN_SPEED, 1.0 - h / RESCUE_VFH_RANGE);
+    v->previous = sector;
+    // A turn on the spot keeps its direction until the chosen one is ahead
+    if (fabs(v->direction) <= RESCUE_VFH_TURN_IN_PLACE) turn = 0;
+    else if (!turn) turn = v->direction > 0.0 ? 1 : -1;
+  }
+  if (turn && !v->turn) {
+    v->reversals += v->last_turn && turn != v->last_turn;
+    v->last_turn = turn;
+  }
+  v->turn = turn;
+  v->turn_steps += turn != 0;
+}
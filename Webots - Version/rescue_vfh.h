@@ -0,0 +1,106 @@
+/*
+ * Description: Obstacle avoidance with a polar histogram (VFH+, Ulrich and
+ *              Borenstein). Every range reading, from however many sensors
+ *              the robot carries, is an obstacle point; the points of the
+ *              last RESCUE_VFH_MEMORY steps are kept in the odometry frame,
+ *              so a wall stays in the histogram after the robot has turned
+ *              away from it. Each step the points are brought into the
+ *              robot's frame and each one covers the sectors within its
+ *              enlargement angle asin(clearance / distance), with a weight
+ *              that grows as it gets closer. A sector keeps the largest
+ *              weight, the nearest obstacle, rather than the sum: a point
+ *              seen on several steps is still one obstacle.
+ *
+ *              The binary histogram has two thresholds, so a sector near
+ *              the limit does not flicker between open and blocked. Runs of
+ *              open sectors are the valleys: a wide one offers its two
+ *              sides, half a wide valley in from the edges, and the target
+ *              direction if that lies inside it, a narrow one its middle.
+ *              The candidate closest to the target wins, with costs for
+ *              turning away from the heading and from the last choice so
+ *              the robot does not swing between two openings. The speed
+ *              drops as the nearest obstacle ahead or in the chosen
+ *              direction gets closer; a direction far off the heading is
+ *              turned to on the spot, in one direction until it is ahead.
+ *              The BoeBot turns on the spot, so the masked histogram of
+ *              VFH+ (directions the turning radius cannot reach) is left out.
+ *
+ *              The histogram and the valley edges are built by vector
+ *              kernels, eight (AVX) or four (SSE2, NEON) sectors at a time
+ *              with each obstacle point broadcast across the lanes, so the
+ *              cost grows with the number of points and not with padding
+ *              to the sensor count; the scalar versions are the reference.
+ */
+
+#ifndef RESCUE_VFH_H
+#define RESCUE_VFH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rescue_hal.h"
+
+// --- Histogram ---
+#define RESCUE_VFH_SECTORS 72              // 5 degrees each, sector 0 straight ahead, counter-clockwise
+#define RESCUE_VFH_MEMORY 16               // Steps an obstacle point is kept (1 s)
+#define RESCUE_VFH_MAX_POINTS (RESCUE_VFH_MEMORY * RESCUE_MAX_RANGES)
+#define RESCUE_VFH_RANGE 1.0               // Points further than this (meters) weigh nothing; weight = range - distance
+#define RESCUE_VFH_CLEARANCE 0.12          // Robot radius plus a margin (meters): points are enlarged by it
+#define RESCUE_VFH_HIGH 0.55               // A sector is blocked above this weight (obstacle within 0.45 m) ...
+#define RESCUE_VFH_LOW 0.4                 // ... and open again below this one (beyond 0.6 m)
+
+// --- Direction & Speed ---
+#define RESCUE_VFH_WIDE 8                  // Valleys of this many sectors (40 degrees) or more are wide
+#define RESCUE_VFH_TARGET_COST 5.0         // Cost per sector off the target direction ...
+#define RESCUE_VFH_HEADING_COST 2.0        // ... off the heading ...
+#define RESCUE_VFH_PREVIOUS_COST 2.0       // ... and off the last direction chosen
+#define RESCUE_VFH_TURN_IN_PLACE 0.6       // Turn on the spot while the direction is more than this off (rad)
+#define RESCUE_VFH_MIN_SPEED 0.3           // Fraction of the speed left next to an obstacle
+
+typedef struct {
+  // --- Obstacle Points (odometry frame): a ring of RESCUE_VFH_MEMORY steps ---
+  float point_x[RESCUE_VFH_MAX_POINTS];    // Step s holds RESCUE_MAX_RANGES entries from s * RESCUE_MAX_RANGES
+  float point_y[RESCUE_VFH_MAX_POINTS];
+  int slot_points[RESCUE_VFH_MEMORY];      // Points stored by each step
+  int slot;                                // Where the next step goes
+  // --- This Step (robot frame), structure of arrays for the kernels ---
+  float bearing[RESCUE_VFH_MAX_POINTS];    // [0, 2 pi), counter-clockwise from the heading
+  float spread[RESCUE_VFH_MAX_POINTS];     // Enlargement half-angle (rad)
+  float weight[RESCUE_VFH_MAX_POINTS];
+  int num_points;
+  float polar[RESCUE_VFH_SECTORS];         // Largest weight per sector
+  float binary[RESCUE_VFH_SECTORS + 1];    // [1 + k]: 1 if sector k is blocked, else 0; [0] repeats the last one
+  uint64_t edges[2];                       // Bit k: sector k differs from sector k - 1 (a valley starts or ends)
+  bool simd;                               // Use the vector kernels (default when compiled in)
+  // --- Steering ---
+  int previous;                            // Sector chosen last step, -1 before the first
+  int turn;                                // Turn on the spot in progress: 1 left, -1 right, 0 none
+  int last_turn;                           // Direction of the last turn on the spot
+  double direction;                        // Chosen direction relative to the heading (rad)
+  double speed;                            // Fraction of the forward speed, RESCUE_VFH_MIN_SPEED .. 1
+  bool blocked;                            // No open sector: turning on the spot
+  // Statistics
+  unsigned long updates;
+  unsigned long blocked_steps;
+  unsigned long turn_steps;                // Steps turning on the spot
+  unsigned long reversals;                 // Turns on the spot the other way from the one before
+} RescueVfh;
+
+// Empties the histogram and the point memory.
+void rescue_vfh_init(RescueVfh *v);
+
+// Name of the vector kernels compiled in ("avx", "sse2", "neon" or "scalar").
+const char *rescue_vfh_simd_name(void);
+
+// Adds this step's readings (count of them: distance in meters from a sensor
+// RESCUE_DS_MOUNT_OFFSET ahead of the center, bearing as rescue_ds_angle)
+// taken at pose (x, y, heading), forgets the oldest step and chooses the
+// direction and speed closest to target (rad, relative to the heading).
+void rescue_vfh_update(RescueVfh *v, const double *pose, const double *range, const double *angle, int count,
+                       double target);
+
+// Rebuilds polar, binary and edges from the points in bearing/spread/weight
+// (num_points of them); rescue_vfh_update calls it.
+void rescue_vfh_histogram(RescueVfh *v);
+
+#endif // RESCUE_VFH_H